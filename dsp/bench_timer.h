@@ -0,0 +1,40 @@
+/* date = October 18th 2026 */
+
+#ifndef BENCH_TIMER_H
+#define BENCH_TIMER_H
+
+// Monotonic wall clock for the headless benchmarks. Kept out of
+// dsp_platform.h so the raylib builds don't pull in the OS headers.
+
+#ifdef _WIN32
+#include "minimal_windows.h"
+#else
+#include <time.h>
+#endif
+
+internal f64
+BenchSeconds(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER Counter, Frequency;
+    QueryPerformanceCounter(&Counter);
+    QueryPerformanceFrequency(&Frequency);
+    return (f64)Counter.QuadPart / (f64)Frequency.QuadPart;
+#else
+    struct timespec Now;
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return (f64)Now.tv_sec + (f64)Now.tv_nsec * 1e-9;
+#endif
+}
+
+// Repeats Call until at least MinSeconds have passed and returns seconds per call.
+#define mx_TimeCalls(MinSeconds, SecondsPerCall, Call) \
+do { \
+    u32 Calls_ = 0; \
+    f64 Start_ = BenchSeconds(); \
+    f64 Elapsed_ = 0; \
+    do { Call; Calls_++; Elapsed_ = BenchSeconds() - Start_; } while (Elapsed_ < (MinSeconds)); \
+    (SecondsPerCall) = Elapsed_ / Calls_; \
+} while (0)
+
+#endif //BENCH_TIMER_H
@@ -0,0 +1,4 @@
+if not exist bin mkdir bin
+pushd bin
+call tcc -o dsp_check.exe ../dsp_check.c -I.. -lmsvcrt -lkernel32 -std=c99
+popd
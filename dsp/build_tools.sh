@@ -0,0 +1,7 @@
+#!/bin/sh
+# Headless test and benchmark suite for the shared DSP core.
+set -e
+cd "$(dirname "$0")"
+mkdir -p bin
+CommonFlags="-std=c99 -D_GNU_SOURCE -O2 -g -Wall -Wno-unused-function -I."
+cc $CommonFlags -pthread -o bin/dsp_check dsp_check.c -lm
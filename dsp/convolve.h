@@ -0,0 +1,351 @@
+/* date = October 18th 2026 */
+
+#ifndef CONVOLVE_H
+#define CONVOLVE_H
+
+// Linear convolution and correlation of long real signals against a fixed
+// kernel: FIR filters, cross-correlation to line two takes up, and
+// autocorrelation for pitch.
+//
+// A convolver streams: ConvolverProcess takes blocks of any size and gives
+// back as many output samples. Short kernels run directly, a multiply-add
+// per tap per sample. Long ones use overlap-save: every BlockSize inputs, the
+// last KernelSize - 1 + BlockSize samples go through one real FFT, get
+// multiplied by the kernel's spectrum and come back, and the first
+// KernelSize - 1 outputs (the ones the circular wrap-around spoiled) are
+// dropped, leaving BlockSize good ones. So the FFT method costs
+// O(log FFTSize) per sample instead of O(KernelSize), but its output lags
+// the input by BlockSize samples, the convolver's Latency.
+//
+// Auto picks direct up to CONVOLVE_DIRECT_MAX_TAPS taps (fewer without AVX2),
+// about where convolve_bench puts the crossover, and otherwise the
+// power-of-two FFT size from twice the kernel up that does the least work per
+// output sample.
+//
+// Convolve and Correlate run a whole signal through a convolver and give the
+// full SignalSize + KernelSize - 1 outputs, with the latency taken out.
+//
+// Needs fft_planner.h.
+
+#define CONVOLVE_DIRECT_MAX_TAPS 128
+#define CONVOLVE_DIRECT_MAX_TAPS_SCALAR 16
+#define CONVOLVE_CHUNK 1024      // direct samples per pass, and offline block.
+#define CONVOLVE_MIN_FFT 64
+
+typedef enum convolve_method
+{
+    ConvolveMethod_Auto,
+    ConvolveMethod_Direct,
+    ConvolveMethod_FFT,
+    ConvolveMethod_Count,
+} convolve_method;
+
+internal const char *
+ConvolveMethodName(convolve_method Value)
+{
+    local_static const char *Names[ConvolveMethod_Count] = {"auto", "direct", "fft"};
+    return ((u32)Value < ConvolveMethod_Count) ? Names[Value] : "?";
+}
+
+typedef struct convolve_config
+{
+    convolve_method Method;
+    u32 BlockSize;   // FFT outputs per transform, so the latency; 0 picks one for throughput.
+    bool Correlate;  // output n is the kernel's match against the KernelSize samples ending at n.
+} convolve_config;
+
+typedef struct convolver
+{
+    convolve_config Config;  // Method is Direct or FFT once created.
+    u32 KernelSize;
+    u32 Latency;             // samples the output lags the input by.
+    f32 *Buffer;             // KernelSize - 1 samples of history, then the block coming in.
+
+    // Direct.
+    f32 *Taps;               // the kernel back to front, so taps run along the buffer.
+    bool Vector;             // AVX2 and FMA.
+
+    // FFT.
+    u32 FFTSize;
+    u32 Fill;                // samples in Buffer, KernelSize - 1 .. KernelSize - 1 + BlockSize.
+    planned_fft *Forward;
+    planned_fft *Inverse;
+    complex32 *KernelSpectrum;
+    complex32 *Spectrum;     // FFTSize/2 + 1 entries each.
+    f32 *Output;             // FFTSize entries, the last block's outputs after KernelSize - 1.
+} convolver;
+
+// The power-of-two FFT size with the least N log N work per output sample,
+// from twice the kernel up to 16 times that.
+internal u32
+ConvolveFFTSize(u32 KernelSize)
+{
+    u32 Smallest = CONVOLVE_MIN_FFT;
+    while (Smallest < 2 * KernelSize) Smallest *= 2;
+    u32 Best = Smallest;
+    f64 BestCost = 0;
+    for (u32 Size = Smallest; Size <= 16 * Smallest; Size *= 2)
+    {
+        f64 Cost = Size * log2((f64)Size) / (Size - KernelSize + 1);
+        if (Size == Smallest || Cost < BestCost)
+        {
+            Best = Size;
+            BestCost = Cost;
+        }
+    }
+    return Best;
+}
+
+// Copies Kernel, so the caller can free it. Returns a convolver with
+// KernelSize == 0 if the kernel is empty.
+internal convolver
+ConvolverCreate(fft_planner *Planner, f32 *Kernel, u32 KernelSize, convolve_config Config)
+{
+    convolver Convolver = {0};
+    if (KernelSize == 0 || Config.Method >= ConvolveMethod_Count) return Convolver;
+#if FFT_SIMD
+    Convolver.Vector = FFTKernelSupported(FFTKernel_AVX2);
+#endif
+    if (Config.Method == ConvolveMethod_Auto)
+    {
+        u32 MaxTaps = Convolver.Vector ? CONVOLVE_DIRECT_MAX_TAPS : CONVOLVE_DIRECT_MAX_TAPS_SCALAR;
+        Config.Method = (KernelSize <= MaxTaps) ? ConvolveMethod_Direct : ConvolveMethod_FFT;
+    }
+
+    // Correlating is convolving with the kernel reversed; the direct taps are
+    // reversed again.
+    f32 *Reversed = (f32 *)malloc(KernelSize * sizeof(f32));
+    for (u32 Tap = 0; Tap < KernelSize; Tap++)
+    {
+        Reversed[Tap] = Config.Correlate ? Kernel[Tap] : Kernel[KernelSize - 1 - Tap];
+    }
+
+    Convolver.KernelSize = KernelSize;
+    if (Config.Method == ConvolveMethod_Direct)
+    {
+        Config.BlockSize = 0;
+        Convolver.Taps = Reversed;
+        Convolver.Buffer = (f32 *)calloc(KernelSize - 1 + CONVOLVE_CHUNK, sizeof(f32));
+        Convolver.Config = Config;
+        return Convolver;
+    }
+
+    if (Config.BlockSize == 0)
+    {
+        Convolver.FFTSize = ConvolveFFTSize(KernelSize);
+        Config.BlockSize = Convolver.FFTSize - KernelSize + 1;
+    }
+    else
+    {
+        Convolver.FFTSize = CONVOLVE_MIN_FFT;
+        while (Convolver.FFTSize < KernelSize - 1 + Config.BlockSize) Convolver.FFTSize *= 2;
+    }
+    u32 FFTSize = Convolver.FFTSize;
+    u32 BinCount = FFTSize/2 + 1;
+    Convolver.Config = Config;
+    Convolver.Latency = Config.BlockSize;
+    Convolver.Fill = KernelSize - 1;
+    Convolver.Forward = FFTPlan(Planner, FFTSize, FFTType_Real, FFTDirection_Forward);
+    Convolver.Inverse = FFTPlan(Planner, FFTSize, FFTType_Real, FFTDirection_Inverse);
+    Convolver.Buffer = (f32 *)calloc(FFTSize, sizeof(f32));
+    Convolver.Output = (f32 *)calloc(FFTSize, sizeof(f32));
+    Convolver.KernelSpectrum = (complex32 *)malloc(BinCount * sizeof(complex32));
+    Convolver.Spectrum = (complex32 *)malloc(BinCount * sizeof(complex32));
+
+    // The kernel forwards (or backwards, to correlate) from sample 0.
+    f32 *Padded = (f32 *)calloc(FFTSize, sizeof(f32));
+    for (u32 Tap = 0; Tap < KernelSize; Tap++) Padded[Tap] = Reversed[KernelSize - 1 - Tap];
+    FFTExecuteReal(Convolver.Forward, Padded, Convolver.KernelSpectrum);
+    free(Padded);
+    free(Reversed);
+    return Convolver;
+}
+
+internal void
+ConvolverDestroy(convolver *Convolver)
+{
+    free(Convolver->Buffer);
+    free(Convolver->Taps);
+    free(Convolver->Output);
+    free(Convolver->KernelSpectrum);
+    free(Convolver->Spectrum);
+    Convolver->Buffer = 0;
+    Convolver->Taps = 0;
+    Convolver->Output = 0;
+    Convolver->KernelSpectrum = 0;
+    Convolver->Spectrum = 0;
+    Convolver->KernelSize = 0;
+}
+
+// Forgets the stream so far, as if it had been silent.
+internal void
+ConvolverReset(convolver *Convolver)
+{
+    if (Convolver->Config.Method == ConvolveMethod_Direct)
+    {
+        memset(Convolver->Buffer, 0, (Convolver->KernelSize - 1) * sizeof(f32));
+        return;
+    }
+    memset(Convolver->Buffer, 0, Convolver->FFTSize * sizeof(f32));
+    memset(Convolver->Output, 0, Convolver->FFTSize * sizeof(f32));
+    Convolver->Fill = Convolver->KernelSize - 1;
+}
+
+// Output[n] = sum(Taps[j] * Samples[n + j]) for n in First .. Count-1.
+internal void
+ConvolverDirectScalar(f32 *Taps, u32 TapCount, f32 *Samples, f32 *Output, u32 First, u32 Count)
+{
+    for (u32 N = First; N < Count; N++)
+    {
+        f32 Sum = 0;
+        for (u32 Tap = 0; Tap < TapCount; Tap++) Sum += Taps[Tap] * Samples[N + Tap];
+        Output[N] = Sum;
+    }
+}
+
+#if FFT_SIMD
+// 32 outputs at a time in four accumulators, one broadcast tap against four
+// unaligned loads per step. Returns how many outputs it did.
+FFT_TARGET_AVX2 internal u32
+ConvolverDirectAVX2(f32 *Taps, u32 TapCount, f32 *Samples, f32 *Output, u32 Count)
+{
+    u32 N = 0;
+    for (; N + 32 <= Count; N += 32)
+    {
+        __m256 Sum0 = _mm256_setzero_ps();
+        __m256 Sum1 = _mm256_setzero_ps();
+        __m256 Sum2 = _mm256_setzero_ps();
+        __m256 Sum3 = _mm256_setzero_ps();
+        f32 *At = Samples + N;
+        for (u32 Tap = 0; Tap < TapCount; Tap++, At++)
+        {
+            __m256 Weight = _mm256_broadcast_ss(Taps + Tap);
+            Sum0 = _mm256_fmadd_ps(Weight, _mm256_loadu_ps(At + 0), Sum0);
+            Sum1 = _mm256_fmadd_ps(Weight, _mm256_loadu_ps(At + 8), Sum1);
+            Sum2 = _mm256_fmadd_ps(Weight, _mm256_loadu_ps(At + 16), Sum2);
+            Sum3 = _mm256_fmadd_ps(Weight, _mm256_loadu_ps(At + 24), Sum3);
+        }
+        _mm256_storeu_ps(Output + N + 0, Sum0);
+        _mm256_storeu_ps(Output + N + 8, Sum1);
+        _mm256_storeu_ps(Output + N + 16, Sum2);
+        _mm256_storeu_ps(Output + N + 24, Sum3);
+    }
+    return N;
+}
+#endif // FFT_SIMD
+
+// Up to CONVOLVE_CHUNK samples, after the history in Buffer.
+internal void
+ConvolverDirect(convolver *Convolver, f32 *Input, f32 *Output, u32 Count)
+{
+    u32 History = Convolver->KernelSize - 1;
+    f32 *Buffer = Convolver->Buffer;
+    memcpy(Buffer + History, Input, Count * sizeof(f32));
+    u32 Done = 0;
+#if FFT_SIMD
+    if (Convolver->Vector) Done = ConvolverDirectAVX2(Convolver->Taps, Convolver->KernelSize, Buffer, Output, Count);
+#endif
+    ConvolverDirectScalar(Convolver->Taps, Convolver->KernelSize, Buffer, Output, Done, Count);
+    memmove(Buffer, Buffer + Count, History * sizeof(f32));
+}
+
+// One overlap-save block: Buffer is full, its transform times the kernel's
+// comes back into Output, and the history moves up to the front.
+internal void
+ConvolverBlock(convolver *Convolver)
+{
+    u32 BinCount = Convolver->FFTSize/2 + 1;
+    FFTExecuteReal(Convolver->Forward, Convolver->Buffer, Convolver->Spectrum);
+    for (u32 Bin = 0; Bin < BinCount; Bin++)
+    {
+        Convolver->Spectrum[Bin] = ComplexMul(Convolver->Spectrum[Bin], Convolver->KernelSpectrum[Bin]);
+    }
+    FFTExecuteReal(Convolver->Inverse, Convolver->Output, Convolver->Spectrum);
+    memmove(Convolver->Buffer, Convolver->Buffer + Convolver->Config.BlockSize,
+            (Convolver->KernelSize - 1) * sizeof(f32));
+    Convolver->Fill = Convolver->KernelSize - 1;
+}
+
+// Filters Count samples of the stream into Output, which may be Input. With
+// the FFT method, Output is Latency samples behind: each input sample goes
+// into the block being filled and the matching output comes out of the last
+// block, which starts out silent.
+internal void
+ConvolverProcess(convolver *Convolver, f32 *Input, f32 *Output, u32 Count)
+{
+    bool Direct = (Convolver->Config.Method == ConvolveMethod_Direct);
+    u32 End = Convolver->KernelSize - 1 + Convolver->Config.BlockSize;
+    while (Count > 0)
+    {
+        u32 Step = Direct ? CONVOLVE_CHUNK : End - Convolver->Fill;
+        if (Step > Count) Step = Count;
+        if (Direct)
+        {
+            ConvolverDirect(Convolver, Input, Output, Step);
+        }
+        else
+        {
+            memcpy(Convolver->Buffer + Convolver->Fill, Input, Step * sizeof(f32));
+            memcpy(Output, Convolver->Output + Convolver->Fill, Step * sizeof(f32));
+            Convolver->Fill += Step;
+            if (Convolver->Fill == End) ConvolverBlock(Convolver);
+        }
+        Input += Step;
+        Output += Step;
+        Count -= Step;
+    }
+}
+
+// Runs Signal and then silence through a convolver, dropping the first
+// Latency outputs, so Output gets SignalSize + KernelSize - 1 of them.
+internal bool
+ConvolveSignal(fft_planner *Planner, f32 *Signal, u32 SignalSize, f32 *Kernel, u32 KernelSize,
+               f32 *Output, convolve_config Config)
+{
+    convolver Convolver = ConvolverCreate(Planner, Kernel, KernelSize, Config);
+    if (Convolver.KernelSize == 0) return false;
+
+    u64 OutputSize = (u64)SignalSize + KernelSize - 1;
+    u64 StreamSize = OutputSize + Convolver.Latency;
+    f32 Chunk[CONVOLVE_CHUNK];
+    for (u64 Start = 0; Start < StreamSize; Start += CONVOLVE_CHUNK)
+    {
+        u32 Count = (StreamSize - Start < CONVOLVE_CHUNK) ? (u32)(StreamSize - Start) : CONVOLVE_CHUNK;
+        for (u32 Index = 0; Index < Count; Index++)
+        {
+            Chunk[Index] = (Start + Index < SignalSize) ? Signal[Start + Index] : 0;
+        }
+        ConvolverProcess(&Convolver, Chunk, Chunk, Count);
+        for (u32 Index = 0; Index < Count; Index++)
+        {
+            u64 At = Start + Index;
+            if (At >= Convolver.Latency) Output[At - Convolver.Latency] = Chunk[Index];
+        }
+    }
+    ConvolverDestroy(&Convolver);
+    return true;
+}
+
+// Output[n] = sum(Signal[n - k] * Kernel[k]), SignalSize + KernelSize - 1
+// outputs. Returns false if the kernel is empty.
+internal bool
+Convolve(fft_planner *Planner, f32 *Signal, u32 SignalSize, f32 *Kernel, u32 KernelSize,
+         f32 *Output, convolve_method Method)
+{
+    convolve_config Config = {Method, 0, false};
+    return ConvolveSignal(Planner, Signal, SignalSize, Kernel, KernelSize, Output, Config);
+}
+
+// Output[n] = sum(Signal[n - (KernelSize - 1) + k] * Kernel[k]): the
+// correlation at lag n - (KernelSize - 1), so Output[KernelSize - 1] is
+// Kernel lined up with the start of Signal. With Kernel == Signal, that's
+// the autocorrelation's lag 0.
+internal bool
+Correlate(fft_planner *Planner, f32 *Signal, u32 SignalSize, f32 *Kernel, u32 KernelSize,
+          f32 *Output, convolve_method Method)
+{
+    convolve_config Config = {Method, 0, true};
+    return ConvolveSignal(Planner, Signal, SignalSize, Kernel, KernelSize, Output, Config);
+}
+
+#endif //CONVOLVE_H
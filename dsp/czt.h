@@ -0,0 +1,151 @@
+/* date = October 18th 2026 */
+
+#ifndef CZT_H
+#define CZT_H
+
+// Chirp-Z zoom transform (Bluestein's algorithm).
+//
+// Evaluates the DTFT of InputSize samples at OutputSize evenly spaced
+// frequencies StartFreq + k*FreqStep (in cycles per sample), anywhere in the
+// band and at any spacing:
+//
+//   X[k] = sum(x[n] * e^(-2*pi*i*(StartFreq + k*FreqStep)*n))
+//
+// Writing n*k = (n^2 + k^2 - (k-n)^2)/2 turns the sum into a convolution
+// with the chirp e^(i*pi*FreqStep*m^2), done with one forward and one inverse
+// FFT of the next power of two >= InputSize + OutputSize - 1. The chirps and
+// the kernel's spectrum only depend on the plan, so they're computed once.
+//
+// Needs fft.h.
+
+typedef struct czt_plan
+{
+    u32 InputSize;
+    u32 OutputSize;
+    f64 StartFreq;
+    f64 FreqStep;
+    fft_plan FFT;
+    complex32 *InputChirp;     // InputSize entries: e^(-2*pi*i*StartFreq*n) * e^(-i*pi*FreqStep*n^2).
+    complex32 *OutputChirp;    // OutputSize entries: e^(-i*pi*FreqStep*k^2).
+    complex32 *KernelSpectrum; // FFT.Size entries.
+    complex32 *Work;           // FFT.Size entries.
+} czt_plan;
+
+// e^(i*pi*Step*m^2), keeping the phase in [0, 2) half-turns before it's
+// multiplied by pi so large m don't lose precision.
+internal complex32
+CZTChirp(f64 Step, f64 M, f64 Sign)
+{
+    f64 HalfTurns = fmod(Step * M * M, 2.0);
+    f64 Theta = Sign * (FFT_TAU / 2) * HalfTurns;
+    complex32 Result;
+    Result.Re = (f32)cos(Theta);
+    Result.Im = (f32)sin(Theta);
+    return Result;
+}
+
+internal czt_plan
+CZTCreatePlan(u32 InputSize, u32 OutputSize, f64 StartFreq, f64 FreqStep)
+{
+    czt_plan Plan = {0};
+    Plan.InputSize = InputSize;
+    Plan.OutputSize = OutputSize;
+    Plan.StartFreq = StartFreq;
+    Plan.FreqStep = FreqStep;
+
+    u32 FFTSize = 1;
+    while (FFTSize < InputSize + OutputSize - 1) FFTSize *= 2;
+    Plan.FFT = FFTCreatePlan(FFTSize);
+    Plan.InputChirp = (complex32 *)malloc(InputSize * sizeof(complex32));
+    Plan.OutputChirp = (complex32 *)malloc(OutputSize * sizeof(complex32));
+    Plan.KernelSpectrum = (complex32 *)calloc(FFTSize, sizeof(complex32));
+    Plan.Work = (complex32 *)malloc(FFTSize * sizeof(complex32));
+
+    for (u32 N = 0; N < InputSize; N++)
+    {
+        f64 StartTurns = fmod(StartFreq * N, 1.0);
+        complex32 Shift;
+        Shift.Re = (f32)cos(FFT_TAU * StartTurns);
+        Shift.Im = (f32)-sin(FFT_TAU * StartTurns);
+        Plan.InputChirp[N] = ComplexMul(Shift, CZTChirp(FreqStep, N, -1));
+    }
+    for (u32 K = 0; K < OutputSize; K++)
+    {
+        Plan.OutputChirp[K] = CZTChirp(FreqStep, K, -1);
+    }
+
+    // The kernel covers lags -(InputSize-1) .. OutputSize-1; negative lags
+    // wrap around to the end of the circular buffer.
+    for (u32 M = 0; M < OutputSize; M++)
+    {
+        Plan.KernelSpectrum[M] = CZTChirp(FreqStep, M, 1);
+    }
+    for (u32 M = 1; M < InputSize; M++)
+    {
+        Plan.KernelSpectrum[FFTSize - M] = CZTChirp(FreqStep, M, 1);
+    }
+    FFTForward(&Plan.FFT, Plan.KernelSpectrum);
+
+    return Plan;
+}
+
+internal void
+CZTDestroyPlan(czt_plan *Plan)
+{
+    FFTDestroyPlan(&Plan->FFT);
+    free(Plan->InputChirp);
+    free(Plan->OutputChirp);
+    free(Plan->KernelSpectrum);
+    free(Plan->Work);
+    Plan->InputChirp = 0;
+    Plan->OutputChirp = 0;
+    Plan->KernelSpectrum = 0;
+    Plan->Work = 0;
+}
+
+// Work holds the chirped input; convolves it with the kernel and writes the
+// OutputSize results.
+internal void
+CZTFinish(czt_plan *Plan, complex32 *Output)
+{
+    u32 FFTSize = Plan->FFT.Size;
+    FFTForward(&Plan->FFT, Plan->Work);
+    for (u32 Index = 0; Index < FFTSize; Index++)
+    {
+        Plan->Work[Index] = ComplexMul(Plan->Work[Index], Plan->KernelSpectrum[Index]);
+    }
+    FFTInverse(&Plan->FFT, Plan->Work);
+    for (u32 K = 0; K < Plan->OutputSize; K++)
+    {
+        Output[K] = ComplexMul(Plan->Work[K], Plan->OutputChirp[K]);
+    }
+}
+
+// Input has InputSize samples, Output gets OutputSize bins.
+internal void
+CZTTransform(czt_plan *Plan, complex32 *Input, complex32 *Output)
+{
+    for (u32 Index = 0; Index < Plan->FFT.Size; Index++)
+    {
+        Plan->Work[Index] = (Index < Plan->InputSize) ? ComplexMul(Input[Index], Plan->InputChirp[Index]) : (complex32){0};
+    }
+    CZTFinish(Plan, Output);
+}
+
+internal void
+CZTTransformReal(czt_plan *Plan, f32 *Input, complex32 *Output)
+{
+    for (u32 Index = 0; Index < Plan->FFT.Size; Index++)
+    {
+        complex32 Value = {0};
+        if (Index < Plan->InputSize)
+        {
+            Value.Re = Input[Index] * Plan->InputChirp[Index].Re;
+            Value.Im = Input[Index] * Plan->InputChirp[Index].Im;
+        }
+        Plan->Work[Index] = Value;
+    }
+    CZTFinish(Plan, Output);
+}
+
+#endif //CZT_H
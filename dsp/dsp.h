@@ -0,0 +1,38 @@
+/* date = October 18th 2026 */
+
+#ifndef DSP_H
+#define DSP_H
+
+// The shared DSP core: everything in dsp/, in dependency order, for
+// programs that want all of it. Builds put dsp/ on the include path (-I../dsp
+// from an app directory) and then include this or the headers they need; each
+// header says what it needs before it. Like the rest of the repo it's a
+// unity build, so there is nothing to compile or link separately.
+// work_queue.h and fft_batch.h start threads, so they're left out; programs
+// that batch include them after this and build with -pthread.
+//
+// dsp_check is its test and benchmark suite; dsp_test.h, which isn't included
+// here, holds the reference DFT, test signal and error measure it and the
+// fourier_transforms benchmarks check against.
+
+#include "dsp_platform.h"
+#include "dsp_math.h"
+#include "dsp_simd_math.h"
+#include "dsp_window.h"
+#include "dsp_filter.h"
+#include "dsp_oscillator.h"
+#include "dsp_fixed.h"
+#include "fft.h"
+#include "real_fft.h"
+#include "fft_split.h"
+#include "fft_mixed.h"
+#include "fft_fixed.h"
+#include "bench_timer.h"
+#include "fft_planner.h"
+#include "czt.h"
+#include "single_bin.h"
+#include "convolve.h"
+#include "filterbank.h"
+#include "pitch.h"
+
+#endif //DSP_H
@@ -0,0 +1,1661 @@
+// Test and benchmark suite for the shared DSP core (dsp.h).
+//
+// Checks, one section per header:
+//   dsp_math        the semitone and decibel conversions round trip.
+//   dsp_simd_math   every function, tier and kernel against libm in double,
+//                   in ULPs, over its domain: every STRIDE-th f32 of it, or
+//                   every one with --exhaustive (15 minutes; pow stays on
+//                   a grid), and the oscillators' sin of cycles. Each has
+//                   to stay within DSPMathMaxULP.
+//   dsp_window      every window is symmetric and overlap-adds flat at a
+//                   quarter-window hop, as the STFT and vocoder use them,
+//                   and so does its square (but Blackman's, which needs a
+//                   fifth).
+//   dsp_filter      each biquad kind hits its design target (-3dB at a low
+//                   pass cutoff, GainDB at a peak, ...), and a sine run
+//                   through it comes out at the level its response says; a
+//                   one-pole covers 1 - 1/e of a step in its time.
+//   dsp_oscillator  the phase stays in [0, 1), each shape stays in range
+//                   and averages to 0, and the PolyBLEP saw and square alias
+//                   at least ALIAS_GAIN_DB less than the naive ones.
+//   fft, real_fft,  the radix-2, real-input and every split-array kernel the
+//   fft_split       CPU has, 4 to 65536 points, against a direct DFT in
+//                   double, and forward then inverse gives the input back.
+//   fft_planner     complex and real transforms, power-of-two, mixed radix
+//                   and Bluestein sizes, the same way.
+//   czt             zoom transforms of a few bands and sizes, the explorer's
+//                   0-10Hz view among them, against the direct sum.
+//   single_bin      Goertzel, the phasor winding and a sliding DFT streamed
+//                   far past its window, at bin and off-bin frequencies.
+//   convolve        both methods, convolution and correlation, offline and
+//                   streamed in uneven blocks, against a direct convolution.
+//   fft_batch       frames and interleaved batches on four threads, both
+//                   types and directions, against the single-frame plans.
+//   filterbank      a sine at a spread of band centres peaks in its own band
+//                   at its amplitude, for each kind, and the sparse constant-Q
+//                   matches correlating every full kernel with the frame.
+//   dsp_fixed       saturation and rounding, the precise sine within
+//                   FIXED_SIN_LSB, and the SNR of each Q31 and Q15 shape on
+//                   the integer phase against the shape in double (the float
+//                   one's alongside).
+//   fft_fixed       SNR of the Q31 and Q15 transforms against a direct DFT
+//                   of the same input (the float planner's alongside), for
+//                   noise at full scale and 60dB down, and of a Q15 round
+//                   trip. Then a hash of every fixed-point output, which has
+//                   to match FIXED_HASH whatever the compiler and flags.
+//
+// The direct DFT, the test signal and the error measure are dsp_test.h's,
+// shared with the benchmarks in fourier_transforms.
+//
+// Then throughput: ns per value for each dsp_simd_math function, tier and
+// kernel next to libm's f32 one, ns per sample for each oscillator shape, the
+// biquad and the one-pole, per point for planned FFTs, and per frame for each
+// filterbank, the sparse constant-Q next to the direct one; then the fixed
+// point shapes and FFTs next to the float ones. Exits 1 if any check fails.
+//
+// Usage: dsp_check [--seconds S] [--exhaustive]   (S: time per benchmark, default 0.1)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dsp.h"
+#include "work_queue.h"
+#include "fft_batch.h"
+#include "dsp_test.h"
+
+#define mx_ArrayCount(Array) (sizeof(Array) / sizeof((Array)[0]))
+
+#define CHECK_RATE 48000.0f
+#define ROUND_TRIP_TOLERANCE 1e-4f
+#define WINDOW_SIZE 1024
+#define OVERLAP_TOLERANCE 1e-5
+#define RESPONSE_TOLERANCE_DB 0.05
+#define LEVEL_TOLERANCE_DB 0.05
+#define ALIAS_SIZE 65536
+#define ALIAS_CYCLES 3413  // per ALIAS_SIZE samples, about 2.5kHz.
+#define ALIAS_GAIN_DB 10.0
+#define FFT_TOLERANCE 1e-5  // relative to the largest bin.
+#define FFT_CHECKED_BINS 1024
+#define KERNEL_CHECKED_BINS 64
+#define CZT_TOLERANCE 1e-4
+#define SINGLE_BIN_TOLERANCE 1e-4  // relative to the loudest bin checked.
+#define SINGLE_BIN_SIZE 1024
+#define SINGLE_BIN_STREAM (SINGLE_BIN_SIZE * 20 + 37)
+#define CONVOLVE_TOLERANCE 1e-5
+#define CONVOLVE_SAMPLES 5000
+#define BATCH_TOLERANCE 1e-5
+#define BATCH_FRAMES 37  // not a multiple of the lanes, so one job is short.
+#define BATCH_THREADS 4
+#define FILTERBANK_FFT 16384  // enough for constant-Q down to C2.
+#define FILTERBANK_RATE 44100.0f
+#define FILTERBANK_BANDS 40
+#define FILTERBANK_TONES 12
+#define TONE_AMPLITUDE 0.5f
+#define AMPLITUDE_TOLERANCE 0.2f  // relative; a sine between bins scallops.
+#define DIRECT_CQ_TOLERANCE 0.02  // relative to the loudest band.
+#define C2_FREQ 65.406f
+#define C8_FREQ 4186.0f
+#define BENCH_SAMPLES 4096
+#define STRIDE 509
+#define ULP_CHUNK 4096
+#define POW_EXPONENT_LIMIT 16.0f  // |y log2 x| DSPMathMaxULP's pow figures hold to.
+#define FIXED_SIN_LSB 4.0
+#define FIXED_OSC_SNR_Q31 100.0
+#define FIXED_OSC_SNR_Q15 90.0
+#define FIXED_FFT_SNR_Q31 150.0
+#define FIXED_FFT_SNR_Q15 58.0  // to 4096 points, at full scale or 60dB down.
+#define FIXED_ROUND_TRIP_SNR_Q15 55.0
+#define FIXED_HASH 0x7094a97bu
+
+global f32 BenchSink;
+
+internal bool
+Report(u32 *FailCount, bool Passed)
+{
+    *FailCount += Passed ? 0 : 1;
+    return Passed;
+}
+
+internal f64
+ToDecibels(f64 Ratio)
+{
+    return 20.0 * log10(Ratio + 1e-30);
+}
+
+//
+// dsp_math
+//
+
+internal void
+CheckMath(u32 *FailCount)
+{
+    printf("dsp_math\n");
+    f32 WorstSemitones = 0;
+    f32 WorstDecibels = 0;
+    for (i32 Step = -480; Step <= 480; Step++)
+    {
+        f32 Semitones = Step / 10.0f;
+        WorstSemitones = fmaxf(WorstSemitones, fabsf(DSPSemitonesFromRatio(DSPRatioFromSemitones(Semitones)) - Semitones));
+        f32 Decibels = Step / 4.0f;
+        WorstDecibels = fmaxf(WorstDecibels, fabsf(DSPDecibelsFromAmplitude(DSPAmplitudeFromDecibels(Decibels)) - Decibels));
+    }
+    printf("  semitones round trip, +-48: %.1e  %s\n", WorstSemitones,
+           Report(FailCount, WorstSemitones <= ROUND_TRIP_TOLERANCE) ? "ok" : "FAILED");
+    printf("  decibels round trip, +-120: %.1e  %s\n", WorstDecibels,
+           Report(FailCount, WorstDecibels <= ROUND_TRIP_TOLERANCE) ? "ok" : "FAILED");
+
+    bool Wrapped = true;
+    for (i32 Step = -1000; Step <= 1000; Step++)
+    {
+        f32 Cycles = DSPWrapCycles(Step * 0.37f);
+        Wrapped = Wrapped && Cycles >= 0 && Cycles < 1;
+    }
+    printf("  wrapped cycles in [0, 1)  %s\n", Report(FailCount, Wrapped) ? "ok" : "FAILED");
+}
+
+//
+// dsp_simd_math
+//
+
+internal f64
+ExactMath(dsp_math_function Function, f64 X, f64 Y)
+{
+    switch (Function)
+    {
+        case DSPMathFunction_Sin: return sin(X);
+        case DSPMathFunction_Cos: return cos(X);
+        case DSPMathFunction_Exp2: return exp2(X);
+        case DSPMathFunction_Log2: return log2(X);
+        case DSPMathFunction_Pow: return pow(X, Y);
+        case DSPMathFunction_Tanh: return tanh(X);
+        default: return 0;
+    }
+}
+
+// How far Value is from Exact in units of the last place of an f32 there.
+// sin(2 pi Cycles) with the whole quarter turns taken off first, so whole
+// and half cycles come out as exactly 0.
+internal f64
+ExactSinCycles(f64 Cycles)
+{
+    f64 Quarters = 4.0 * Cycles;
+    f64 Whole = nearbyint(Quarters);
+    f64 Angle = (Quarters - Whole) * (DSP_PI / 2);
+    i64 Quadrant = (i64)Whole & 3;
+    f64 Value = (Quadrant & 1) ? cos(Angle) : sin(Angle);
+    return (Quadrant & 2) ? -Value : Value;
+}
+
+internal f64
+ULPError(f32 Value, f64 Exact)
+{
+    if ((f64)Value == Exact) return 0;
+    if (Value != Value || isinf(Value) || isinf(Exact)) return INFINITY;
+    i32 Exponent = -200;
+    if (Exact != 0) frexp(Exact, &Exponent);
+    return fabs(Value - Exact) / ldexp(1.0, (Exponent - 24 < -149) ? -149 : Exponent - 24);
+}
+
+// f32s in order as integers, negatives below 0, so a domain is a range.
+internal i64
+OrderedFromF32(f32 Value)
+{
+    u32 Bits = DSPBitsFromF32(Value);
+    return (Bits & 0x80000000) ? -(i64)(Bits & 0x7FFFFFFF) : (i64)Bits;
+}
+
+internal f32
+F32FromOrdered(i64 Ordered)
+{
+    return (Ordered < 0) ? DSPF32FromBits((u32)(-Ordered) | 0x80000000) : DSPF32FromBits((u32)Ordered);
+}
+
+typedef struct ulp_worst
+{
+    f64 ULP[DSPMathTier_Count][DSPMathKernel_Count];
+    f32 At[DSPMathTier_Count][DSPMathKernel_Count];
+} ulp_worst;
+
+// Runs a chunk through every tier and kernel and keeps the worst error.
+internal void
+MeasureChunk(dsp_math_function Function, f32 *X, f32 *Y, f64 *Exact, u32 Count, f32 *Out, ulp_worst *Worst)
+{
+    for (u32 Kernel = 0; Kernel < DSPMathKernel_Count; Kernel++)
+    {
+        if (!DSPMathKernelSupported((dsp_math_kernel)Kernel)) continue;
+        DSPMathSetKernel((dsp_math_kernel)Kernel);
+        for (u32 Tier = 0; Tier < DSPMathTier_Count; Tier++)
+        {
+            DSPMathBlock(Function, Out, X, Y, Count, (dsp_math_tier)Tier);
+            for (u32 N = 0; N < Count; N++)
+            {
+                f64 Error = ULPError(Out[N], Exact[N]);
+                if (Error > Worst->ULP[Tier][Kernel])
+                {
+                    Worst->ULP[Tier][Kernel] = Error;
+                    Worst->At[Tier][Kernel] = X[N];
+                }
+            }
+        }
+    }
+}
+
+internal void
+ReportWorst(u32 *FailCount, dsp_math_function Function, const char *Domain, ulp_worst *Worst)
+{
+    for (u32 Tier = 0; Tier < DSPMathTier_Count; Tier++)
+    {
+        f64 Bound = DSPMathMaxULP[Function][Tier];
+        bool Passed = true;
+        printf("  %-4s %-8s", DSPMathFunctionName(Function), DSPMathTierName(Tier));
+        for (u32 Kernel = 0; Kernel < DSPMathKernel_Count; Kernel++)
+        {
+            if (!DSPMathKernelSupported((dsp_math_kernel)Kernel)) continue;
+            Passed = Passed && Worst->ULP[Tier][Kernel] <= Bound;
+            printf(" %s %8.1f (at %-13g)", DSPMathKernelName(Kernel), Worst->ULP[Tier][Kernel], Worst->At[Tier][Kernel]);
+        }
+        printf("  bound %6.0f ULP, %s  %s\n", Bound, Domain, Report(FailCount, Passed) ? "ok" : "FAILED");
+    }
+}
+
+typedef struct math_domain
+{
+    dsp_math_function Function;
+    f32 Low;
+    f32 High;
+    const char *Name;
+} math_domain;
+
+internal void
+CheckSIMDMath(u32 *FailCount, bool Exhaustive)
+{
+    i64 Stride = Exhaustive ? 1 : STRIDE;
+    if (Exhaustive) printf("\ndsp_simd_math, max ULP error, every f32\n");
+    else printf("\ndsp_simd_math, max ULP error, every %dth f32\n", STRIDE);
+    f32 *X = (f32 *)malloc(ULP_CHUNK * sizeof(f32));
+    f32 *Y = (f32 *)malloc(ULP_CHUNK * sizeof(f32));
+    f32 *Out = (f32 *)malloc(ULP_CHUNK * sizeof(f32));
+    f64 *Exact = (f64 *)malloc(ULP_CHUNK * sizeof(f64));
+
+    math_domain Domains[] =
+    {
+        {DSPMathFunction_Sin, -8192.0f, 8192.0f, "|x| <= 8192"},
+        {DSPMathFunction_Cos, -8192.0f, 8192.0f, "|x| <= 8192"},
+        {DSPMathFunction_Exp2, -125.0f, 127.99999f, "-125 <= x < 128"},
+        {DSPMathFunction_Log2, F32FromOrdered(1), FLT_MAX, "x > 0"},
+        {DSPMathFunction_Tanh, -FLT_MAX, FLT_MAX, "all finite x"},
+    };
+    for (u32 Index = 0; Index < mx_ArrayCount(Domains); Index++)
+    {
+        math_domain *Domain = &Domains[Index];
+        ulp_worst Worst = {0};
+        i64 Last = OrderedFromF32(Domain->High);
+        for (i64 Ordered = OrderedFromF32(Domain->Low); Ordered <= Last; )
+        {
+            u32 Count = 0;
+            for (; Count < ULP_CHUNK && Ordered <= Last; Count++, Ordered += Stride)
+            {
+                X[Count] = F32FromOrdered(Ordered);
+                Exact[Count] = ExactMath(Domain->Function, X[Count], 0);
+            }
+            MeasureChunk(Domain->Function, X, 0, Exact, Count, Out, &Worst);
+        }
+        ReportWorst(FailCount, Domain->Function, Domain->Name, &Worst);
+    }
+
+    // The oscillators' sin of a phase in cycles, against sin(2 pi x).
+    {
+        bool Passed = true;
+        printf("  sin of cycles in [-1, 1], scalar:");
+        for (u32 Tier = 0; Tier < DSPMathTier_Count; Tier++)
+        {
+            f64 Worst = 0;
+            for (i64 Ordered = OrderedFromF32(-1.0f); Ordered <= OrderedFromF32(1.0f); Ordered += Stride)
+            {
+                f32 Cycles = F32FromOrdered(Ordered);
+                f64 Error = ULPError(DSPSinCycles(Cycles, (dsp_math_tier)Tier), ExactSinCycles(Cycles));
+                Worst = (Error > Worst) ? Error : Worst;
+            }
+            Passed = Passed && Worst <= DSPMathMaxULP[DSPMathFunction_Sin][Tier];
+            printf(" %s %.1f", DSPMathTierName(Tier), Worst);
+        }
+        printf(" ULP  %s\n", Report(FailCount, Passed) ? "ok" : "FAILED");
+    }
+
+    // pow on a grid: x over the floats in [2^-30, 2^30], y over +-16 off the
+    // whole and half numbers, where |y log2 x| stays within the limit.
+    {
+        ulp_worst Worst = {0};
+        i64 XStride = Exhaustive ? 1024 : 65536;
+        u32 Count = 0;
+        for (i64 Ordered = OrderedFromF32(0x1p-30f); Ordered <= OrderedFromF32(0x1p30f); Ordered += XStride)
+        {
+            f32 Base = F32FromOrdered(Ordered);
+            for (i32 Step = -64; Step <= 64; Step++)
+            {
+                f32 Exponent = Step * 0.25f + 0.0371f;
+                if (fabs(Exponent * log2(Base)) > POW_EXPONENT_LIMIT) continue;
+                X[Count] = Base;
+                Y[Count] = Exponent;
+                Exact[Count] = pow(Base, Exponent);
+                if (++Count == ULP_CHUNK)
+                {
+                    MeasureChunk(DSPMathFunction_Pow, X, Y, Exact, Count, Out, &Worst);
+                    Count = 0;
+                }
+            }
+        }
+        MeasureChunk(DSPMathFunction_Pow, X, Y, Exact, Count, Out, &Worst);
+        ReportWorst(FailCount, DSPMathFunction_Pow, "|y log2 x| <= 16", &Worst);
+    }
+
+    // The special values.
+    bool Special = true;
+    for (u32 Kernel = 0; Kernel < DSPMathKernel_Count; Kernel++)
+    {
+        if (!DSPMathKernelSupported((dsp_math_kernel)Kernel)) continue;
+        DSPMathSetKernel((dsp_math_kernel)Kernel);
+        for (u32 Tier = 0; Tier < DSPMathTier_Count; Tier++)
+        {
+            f32 In[8] = {0.0f, -1.0f, INFINITY, NAN, 0.0f, 2.0f, 0.0f, 200.0f};
+            f32 Powers[8] = {2.0f, 2.0f, 1.0f, 1.0f, -1.0f, 0.0f, 0.0f, 1.0f};
+            f32 Logs[8], Pows[8], Exps[8], Tanhs[8];
+            DSPLog2Block(Logs, In, 8, (dsp_math_tier)Tier);
+            DSPPowBlock(Pows, In, Powers, 8, (dsp_math_tier)Tier);
+            DSPExp2Block(Exps, In, 8, (dsp_math_tier)Tier);
+            DSPTanhBlock(Tanhs, In, 8, (dsp_math_tier)Tier);
+            Special = (Special && Logs[0] == -INFINITY && Logs[1] != Logs[1] && Logs[2] == INFINITY && Logs[3] != Logs[3] &&
+                       Pows[0] == 0 && Pows[1] != Pows[1] && Pows[4] == INFINITY && Pows[5] == 1 && Pows[6] == 1 &&
+                       Exps[2] == INFINITY && Exps[3] != Exps[3] && Exps[7] == INFINITY && DSPExp2(-130.0f, (dsp_math_tier)Tier) == 0 &&
+                       Tanhs[0] == 0 && Tanhs[2] == 1 && Tanhs[3] != Tanhs[3] && Tanhs[7] == 1);
+        }
+    }
+    printf("  log2(0) = -inf, log2(-1) = NaN, pow(0, -1) = inf, pow(x, 0) = 1, exp2(200) = inf, tanh(inf) = 1, ...  %s\n",
+           Report(FailCount, Special) ? "ok" : "FAILED");
+    DSPMathSetKernel(DSPMathKernel_AVX2);
+
+    free(X);
+    free(Y);
+    free(Out);
+    free(Exact);
+}
+
+//
+// dsp_window
+//
+
+internal void
+CheckWindows(u32 *FailCount)
+{
+    printf("\ndsp_window, %u samples, hop %u\n", WINDOW_SIZE, WINDOW_SIZE / 4);
+    local_static f32 Window[WINDOW_SIZE];
+    for (u32 Kind = 0; Kind < DSPWindow_Count; Kind++)
+    {
+        DSPFillWindow(Window, WINDOW_SIZE, (dsp_window)Kind);
+        f32 Asymmetry = 0;
+        for (u32 N = 1; N < WINDOW_SIZE; N++) Asymmetry = fmaxf(Asymmetry, fabsf(Window[N] - Window[WINDOW_SIZE - N]));
+        f64 Spread, PowerSpread;
+        f64 Sum = DSPWindowOverlap(Window, WINDOW_SIZE, WINDOW_SIZE / 4, false, &Spread);
+        f64 PowerSum = DSPWindowOverlap(Window, WINDOW_SIZE, WINDOW_SIZE / 4, true, &PowerSpread);
+        bool PowerFlat = (Kind == DSPWindow_Blackman) || PowerSpread - 1 <= OVERLAP_TOLERANCE;
+        bool Passed = Report(FailCount, Asymmetry <= 1e-6f && Spread - 1 <= OVERLAP_TOLERANCE && PowerFlat);
+        printf("  %-12s overlap %.4f (ripple %.1e), squared %.4f (ripple %.1e)  %s\n", DSPWindowName(Kind),
+               Sum, Spread - 1, PowerSum, PowerSpread - 1, Passed ? "ok" : "FAILED");
+    }
+}
+
+//
+// dsp_filter
+//
+
+typedef struct biquad_target
+{
+    dsp_biquad_kind Kind;
+    f32 Freq;
+    f32 Q;
+    f32 GainDB;
+    f32 ProbeFreq;   // where the design says the response is TargetDB.
+    f64 TargetDB;
+} biquad_target;
+
+// RMS of a sine through the filter, after it settles, against the sine's.
+internal f64
+FilteredLevelDB(dsp_biquad Biquad, f32 Freq, f32 *Buffer, u32 Count)
+{
+    for (u32 N = 0; N < Count; N++) Buffer[N] = (f32)sin(DSP_TAU * Freq * N / CHECK_RATE);
+    DSPBiquadReset(&Biquad);
+    DSPBiquadProcess(&Biquad, Buffer, Count);
+    f64 Sum = 0;
+    for (u32 N = Count / 2; N < Count; N++) Sum += (f64)Buffer[N] * Buffer[N];
+    return ToDecibels(sqrt(Sum / (Count - Count / 2)) / sqrt(0.5));
+}
+
+internal void
+CheckFilters(u32 *FailCount)
+{
+    printf("\ndsp_filter, %.0f Hz\n", CHECK_RATE);
+    biquad_target Targets[] =
+    {
+        {DSPBiquad_LowPass, 1000, 0.70710678f, 0, 1000, -3.0103},
+        {DSPBiquad_HighPass, 1000, 0.70710678f, 0, 1000, -3.0103},
+        {DSPBiquad_BandPass, 1000, 2.0f, 0, 1000, 0},
+        {DSPBiquad_Notch, 1000, 2.0f, 0, 1000, -200},
+        {DSPBiquad_Peak, 1000, 1.0f, 6.0f, 1000, 6.0},
+        {DSPBiquad_LowShelf, 1000, 0.70710678f, 6.0f, 20, 6.0},
+        {DSPBiquad_HighShelf, 1000, 0.70710678f, 6.0f, 20000, 6.0},
+    };
+    f32 LevelFreqs[] = {300, 1000, 5000};
+    u32 Count = (u32)CHECK_RATE / 2;
+    f32 *Buffer = (f32 *)malloc(Count * sizeof(f32));
+    for (u32 Index = 0; Index < mx_ArrayCount(Targets); Index++)
+    {
+        biquad_target *Target = &Targets[Index];
+        dsp_biquad Biquad = DSPBiquadDesign(Target->Kind, CHECK_RATE, Target->Freq, Target->Q, Target->GainDB);
+        f64 ResponseDB = ToDecibels(DSPBiquadMagnitude(&Biquad, CHECK_RATE, Target->ProbeFreq));
+        // A notch only has to be deep.
+        bool Passed = (Target->TargetDB < -100) ? (ResponseDB < -60) : (fabs(ResponseDB - Target->TargetDB) <= RESPONSE_TOLERANCE_DB);
+        f64 WorstLevel = 0;
+        for (u32 FreqIndex = 0; FreqIndex < mx_ArrayCount(LevelFreqs); FreqIndex++)
+        {
+            f32 Freq = LevelFreqs[FreqIndex];
+            f64 Expected = ToDecibels(DSPBiquadMagnitude(&Biquad, CHECK_RATE, Freq));
+            if (Expected < -60) continue;
+            f64 Error = fabs(FilteredLevelDB(Biquad, Freq, Buffer, Count) - Expected);
+            WorstLevel = (Error > WorstLevel) ? Error : WorstLevel;
+        }
+        Passed = Report(FailCount, Passed && WorstLevel <= LEVEL_TOLERANCE_DB);
+        printf("  %-10s %+7.2fdB at %5.0f Hz (want %+.2f), sines within %.3fdB of the response  %s\n",
+               DSPBiquadKindName(Target->Kind), ResponseDB, Target->ProbeFreq, Target->TargetDB, WorstLevel,
+               Passed ? "ok" : "FAILED");
+    }
+    free(Buffer);
+
+    f32 Seconds = 0.01f;
+    dsp_one_pole OnePole = DSPOnePoleCreate(CHECK_RATE, Seconds, 0);
+    f32 Value = 0;
+    for (u32 N = 0; N < (u32)(Seconds * CHECK_RATE); N++) Value = DSPOnePoleNext(&OnePole, 1.0f);
+    f32 Expected = 1.0f - expf(-1.0f);
+    printf("  one-pole step after %.0fms: %.4f (want %.4f)  %s\n", Seconds * 1000, Value, Expected,
+           Report(FailCount, fabsf(Value - Expected) <= 0.01f * Expected) ? "ok" : "FAILED");
+}
+
+//
+// dsp_oscillator
+//
+
+typedef enum osc_shape
+{
+    OscShape_Sine,
+    OscShape_Saw,
+    OscShape_Square,
+    OscShape_Triangle,
+    OscShape_RoundedSquare,
+    OscShape_NaiveSaw,
+    OscShape_NaiveSquare,
+    OscShape_Count,
+} osc_shape;
+
+global const char *OscShapeNames[OscShape_Count] = {"sine", "saw", "square", "triangle", "rounded square",
+                                                    "naive saw", "naive square"};
+
+internal f32
+OscSample(osc_shape Shape, f32 Phase, f32 Step)
+{
+    switch (Shape)
+    {
+        case OscShape_Sine: return DSPSineWave(Phase);
+        case OscShape_Saw: return DSPSawWave(Phase, Step);
+        case OscShape_Square: return DSPSquareWave(Phase, Step, 0.5f);
+        case OscShape_Triangle: return DSPTriangleWave(Phase);
+        case OscShape_RoundedSquare: return DSPRoundedSquareWave(Phase, 0.5f);
+        case OscShape_NaiveSaw: return 2*Phase - 1;
+        case OscShape_NaiveSquare: return (Phase < 0.5f) ? 1.0f : -1.0f;
+        default: return 0;
+    }
+}
+
+// Energy off the harmonics that fit under Nyquist, against the energy on
+// them, for one exactly periodic stretch of the shape.
+internal f64
+AliasDB(fft_planner *Planner, osc_shape Shape, f32 *Samples, complex32 *Spectrum)
+{
+    f32 Step = (f32)ALIAS_CYCLES / ALIAS_SIZE;
+    for (u32 N = 0; N < ALIAS_SIZE; N++)
+    {
+        f32 Phase = (f32)(((u64)N * ALIAS_CYCLES % ALIAS_SIZE) / (f64)ALIAS_SIZE);
+        Samples[N] = OscSample(Shape, Phase, Step);
+    }
+    FFTExecuteReal(FFTPlan(Planner, ALIAS_SIZE, FFTType_Real, FFTDirection_Forward), Samples, Spectrum);
+    f64 Wanted = 0, Total = 0;
+    for (u32 Bin = 1; Bin <= ALIAS_SIZE / 2; Bin++)
+    {
+        f64 Energy = (f64)Spectrum[Bin].Re * Spectrum[Bin].Re + (f64)Spectrum[Bin].Im * Spectrum[Bin].Im;
+        Total += Energy;
+        Wanted += (Bin % ALIAS_CYCLES == 0) ? Energy : 0;
+    }
+    return 10.0 * log10((Total - Wanted) / Wanted + 1e-30);
+}
+
+internal void
+CheckOscillators(u32 *FailCount, fft_planner *Planner)
+{
+    printf("\ndsp_oscillator\n");
+    bool InRange = true;
+    f32 Phase = 0;
+    for (u32 N = 0; N < 1000000; N++)
+    {
+        DSPAdvancePhase(&Phase, (N < 500000) ? 0.37f : -0.011f);
+        InRange = InRange && Phase >= 0 && Phase < 1;
+    }
+    printf("  phase stays in [0, 1) stepping up and down  %s\n", Report(FailCount, InRange) ? "ok" : "FAILED");
+
+    // 100 cycles at about 440Hz.
+    f32 Step = 440.0f / CHECK_RATE;
+    u32 Count = (u32)(100 / Step);
+    for (u32 Shape = 0; Shape < OscShape_NaiveSaw; Shape++)
+    {
+        f32 Low = 0, High = 0;
+        f64 Sum = 0;
+        Phase = 0;
+        for (u32 N = 0; N < Count; N++)
+        {
+            f32 Sample = OscSample((osc_shape)Shape, Phase, Step);
+            Low = fminf(Low, Sample);
+            High = fmaxf(High, Sample);
+            Sum += Sample;
+            DSPAdvancePhase(&Phase, Step);
+        }
+        f64 Mean = Sum / Count;
+        bool Passed = Report(FailCount, Low >= -1.0f && High <= 1.0f && fabs(Mean) <= 0.01);
+        printf("  %-15s range [%+.3f, %+.3f], mean %+.4f  %s\n", OscShapeNames[Shape], Low, High, Mean, Passed ? "ok" : "FAILED");
+    }
+
+    f32 *Samples = (f32 *)malloc(ALIAS_SIZE * sizeof(f32));
+    complex32 *Spectrum = (complex32 *)malloc((ALIAS_SIZE/2 + 1) * sizeof(complex32));
+    osc_shape Pairs[2][2] = {{OscShape_Saw, OscShape_NaiveSaw}, {OscShape_Square, OscShape_NaiveSquare}};
+    for (u32 Pair = 0; Pair < 2; Pair++)
+    {
+        f64 Blep = AliasDB(Planner, Pairs[Pair][0], Samples, Spectrum);
+        f64 Naive = AliasDB(Planner, Pairs[Pair][1], Samples, Spectrum);
+        bool Passed = Report(FailCount, Naive - Blep >= ALIAS_GAIN_DB);
+        printf("  %-15s aliasing at %.0f Hz: %.1fdB, naive %.1fdB  %s\n", OscShapeNames[Pairs[Pair][0]],
+               CHECK_RATE * ALIAS_CYCLES / ALIAS_SIZE, Blep, Naive, Passed ? "ok" : "FAILED");
+    }
+    free(Samples);
+    free(Spectrum);
+}
+
+//
+// fft_planner
+//
+
+global u32 KernelCheckSizes[] = {4, 16, 64, 256, 1024, 4096, 16384, 65536};
+
+internal void
+CheckKernels(u32 *FailCount)
+{
+    printf("\nfft, real_fft and fft_split against a direct DFT\n");
+    bool Supported[FFTKernel_Count];
+    printf("  %6s %9s %9s", "", "radix-2", "real");
+    for (u32 Kernel = 0; Kernel < FFTKernel_Count; Kernel++)
+    {
+        Supported[Kernel] = FFTKernelSupported((fft_kernel)Kernel);
+        if (Supported[Kernel]) printf(" %9s", FFTKernelName(Kernel));
+    }
+    printf(" %11s\n", "round trips");
+
+    u32 MaxSize = KernelCheckSizes[mx_ArrayCount(KernelCheckSizes) - 1];
+    f32 *Samples = (f32 *)malloc(MaxSize * sizeof(f32));
+    f32 *Resynth = (f32 *)malloc(MaxSize * sizeof(f32));
+    f32 *Re = (f32 *)malloc(MaxSize * sizeof(f32));
+    f32 *Im = (f32 *)malloc(MaxSize * sizeof(f32));
+    complex32 *Input = (complex32 *)malloc(MaxSize * sizeof(complex32));
+    complex32 *Data = (complex32 *)malloc(MaxSize * sizeof(complex32));
+    for (u32 Index = 0; Index < mx_ArrayCount(KernelCheckSizes); Index++)
+    {
+        u32 Size = KernelCheckSizes[Index];
+        DSPTestSignal(Samples, Input, Size, Size);
+        dsp_test_error RoundTrip = {0};
+
+        fft_plan Plan = FFTCreatePlan(Size);
+        memcpy(Data, Input, Size * sizeof(complex32));
+        FFTForward(&Plan, Data);
+        f64 Radix2Error = DSPTestSpectrumError(Data, Size, 0, Input, Size, KERNEL_CHECKED_BINS);
+        FFTInverse(&Plan, Data);
+        for (u32 N = 0; N < Size; N++) DSPTestErrorAdd(&RoundTrip, Data[N].Re, Data[N].Im, Input[N].Re, Input[N].Im);
+        FFTDestroyPlan(&Plan);
+
+        real_fft_plan RealPlan = RealFFTCreatePlan(Size);
+        RealFFTForward(&RealPlan, Samples, Size, Data);
+        f64 RealError = DSPTestSpectrumError(Data, Size/2 + 1, Samples, 0, Size, KERNEL_CHECKED_BINS);
+        RealFFTInverse(&RealPlan, Data, Resynth);
+        for (u32 N = 0; N < Size; N++) DSPTestErrorAdd(&RoundTrip, Resynth[N], 0, Samples[N], 0);
+        RealFFTDestroyPlan(&RealPlan);
+
+        f64 WorstError = fmax(Radix2Error, RealError);
+        printf("  %6u %9.1e %9.1e", Size, Radix2Error, RealError);
+        fft_split_plan SplitPlan = FFTSplitCreatePlan(Size);
+        for (u32 Kernel = 0; Kernel < FFTKernel_Count; Kernel++)
+        {
+            if (!Supported[Kernel]) continue;
+            FFTSplitSetKernel(&SplitPlan, (fft_kernel)Kernel);
+            for (u32 N = 0; N < Size; N++) { Re[N] = Input[N].Re; Im[N] = Input[N].Im; }
+            FFTSplitForward(&SplitPlan, Re, Im);
+            for (u32 K = 0; K < Size; K++) { Data[K].Re = Re[K]; Data[K].Im = Im[K]; }
+            f64 Error = DSPTestSpectrumError(Data, Size, 0, Input, Size, KERNEL_CHECKED_BINS);
+            FFTSplitInverse(&SplitPlan, Re, Im);
+            for (u32 N = 0; N < Size; N++) DSPTestErrorAdd(&RoundTrip, Re[N], Im[N], Input[N].Re, Input[N].Im);
+            WorstError = fmax(WorstError, Error);
+            printf(" %9.1e", Error);
+        }
+        FFTSplitDestroyPlan(&SplitPlan);
+
+        f64 RoundTripError = DSPTestErrorRelative(RoundTrip);
+        bool Passed = Report(FailCount, WorstError <= FFT_TOLERANCE && RoundTripError <= FFT_TOLERANCE);
+        printf(" %11.1e  %s\n", RoundTripError, Passed ? "ok" : "FAILED");
+    }
+    free(Samples);
+    free(Resynth);
+    free(Re);
+    free(Im);
+    free(Input);
+    free(Data);
+}
+
+// Largest error of the planned transform against a direct DFT in double,
+// relative to the largest bin, and of forward then inverse against the input.
+internal void
+FFTErrors(fft_planner *Planner, u32 Size, fft_type Type, f64 *Error, f64 *RoundTrip)
+{
+    complex32 *Input = (complex32 *)malloc(Size * sizeof(complex32));
+    complex32 *Data = (complex32 *)malloc((Size + 1) * sizeof(complex32));
+    f32 *Samples = (f32 *)malloc(Size * sizeof(f32));
+    DSPTestSignal(Samples, Input, Size, Size);
+    planned_fft *Forward = FFTPlan(Planner, Size, Type, FFTDirection_Forward);
+    planned_fft *Inverse = FFTPlan(Planner, Size, Type, FFTDirection_Inverse);
+    dsp_test_error RoundTripError = {0};
+    if (Type == FFTType_Real)
+    {
+        FFTExecuteReal(Forward, Samples, Data);
+        *Error = DSPTestSpectrumError(Data, Size/2 + 1, Samples, 0, Size, FFT_CHECKED_BINS);
+        FFTExecuteReal(Inverse, Samples, Data);
+        for (u32 N = 0; N < Size; N++) DSPTestErrorAdd(&RoundTripError, Samples[N], 0, Input[N].Re, 0);
+    }
+    else
+    {
+        memcpy(Data, Input, Size * sizeof(complex32));
+        FFTExecuteComplex(Forward, Data);
+        *Error = DSPTestSpectrumError(Data, Size, 0, Input, Size, FFT_CHECKED_BINS);
+        FFTExecuteComplex(Inverse, Data);
+        for (u32 N = 0; N < Size; N++) DSPTestErrorAdd(&RoundTripError, Data[N].Re, Data[N].Im, Input[N].Re, Input[N].Im);
+    }
+    *RoundTrip = DSPTestErrorRelative(RoundTripError);
+    free(Input);
+    free(Data);
+    free(Samples);
+}
+
+global u32 FFTCheckSizes[] = {16, 64, 1024, 4096, 6, 60, 360, 441, 1000, 2401, 4410, 97, 1031, 10007};
+
+internal void
+CheckFFT(u32 *FailCount, fft_planner *Planner)
+{
+    printf("\nfft_planner against a direct DFT\n");
+    for (u32 Type = 0; Type < FFTType_Count; Type++)
+    {
+        for (u32 Index = 0; Index < mx_ArrayCount(FFTCheckSizes); Index++)
+        {
+            u32 Size = FFTCheckSizes[Index];
+            if (!FFTPlanSizeValid(Size, (fft_type)Type)) continue;
+            f64 Error, RoundTrip;
+            FFTErrors(Planner, Size, (fft_type)Type, &Error, &RoundTrip);
+            bool Passed = Report(FailCount, Error <= FFT_TOLERANCE && RoundTrip <= FFT_TOLERANCE);
+            printf("  %-7s %5u: error %.1e, round trip %.1e  %s\n", FFTTypeNames[Type], Size, Error, RoundTrip,
+                   Passed ? "ok" : "FAILED");
+        }
+    }
+}
+
+//
+// czt
+//
+
+typedef struct czt_case
+{
+    const char *Name;
+    u32 InputSize;
+    u32 OutputSize;
+    f64 StartFreq;  // cycles per sample.
+    f64 FreqStep;
+} czt_case;
+
+global czt_case CZTCases[] =
+{
+    {"explorer 0-10 cycles/window", 1024, 1024, 0.0, 10.0 / (1024.0 * 1024.0)},
+    {"full DFT (matches FFT bins)",  512,  512, 0.0, 1.0 / 512.0},
+    {"narrow band near 0.3",        1000,  300, 0.3, 1e-5},
+    {"wide band, fewer outputs",    4096,   64, 0.05, 0.005},
+    {"more outputs than inputs",     100, 2000, 0.0, 0.5 / 2000.0},
+    {"one output",                   777,    1, 0.123, 0.0},
+};
+
+internal void
+CheckCZT(u32 *FailCount)
+{
+    printf("\nczt against the direct sum\n");
+    u32 MaxInput = 0;
+    for (u32 Index = 0; Index < mx_ArrayCount(CZTCases); Index++)
+    {
+        MaxInput = (CZTCases[Index].InputSize > MaxInput) ? CZTCases[Index].InputSize : MaxInput;
+    }
+    f32 *Signal = (f32 *)malloc(MaxInput * sizeof(f32));
+    f64 *Reference = (f64 *)malloc(MaxInput * sizeof(f64));
+    DSPTestSignal(Signal, 0, MaxInput, 1024);
+    for (u32 N = 0; N < MaxInput; N++) Reference[N] = Signal[N];
+
+    for (u32 Index = 0; Index < mx_ArrayCount(CZTCases); Index++)
+    {
+        czt_case *Case = &CZTCases[Index];
+        czt_plan Plan = CZTCreatePlan(Case->InputSize, Case->OutputSize, Case->StartFreq, Case->FreqStep);
+        complex32 *Output = (complex32 *)malloc(Case->OutputSize * sizeof(complex32));
+        CZTTransformReal(&Plan, Signal, Output);
+        dsp_test_error Error = {0};
+        for (u32 K = 0; K < Case->OutputSize; K++)
+        {
+            f64 Re, Im;
+            DSPTestDFT(Reference, 0, Case->InputSize, Case->StartFreq + K * Case->FreqStep, &Re, &Im);
+            DSPTestErrorAdd(&Error, Output[K].Re, Output[K].Im, Re, Im);
+        }
+        free(Output);
+        CZTDestroyPlan(&Plan);
+
+        f64 RelativeError = DSPTestErrorRelative(Error);
+        bool Passed = Report(FailCount, RelativeError <= CZT_TOLERANCE);
+        printf("  %-28s %5u in %5u out: error %.1e  %s\n", Case->Name, Case->InputSize, Case->OutputSize,
+               RelativeError, Passed ? "ok" : "FAILED");
+    }
+    free(Signal);
+    free(Reference);
+}
+
+//
+// single_bin
+//
+
+global f32 SingleBinFreqs[] = {0.0f, 0.37f, 4.0f, 7.25f, 9.99f, 100.5f, 511.0f};  // cycles per window.
+
+internal void
+AddBinError(dsp_test_error *Error, complex32 Value, f64 *Samples, f32 CyclesPerSample)
+{
+    f64 Re, Im;
+    DSPTestDFT(Samples, 0, SINGLE_BIN_SIZE, CyclesPerSample, &Re, &Im);
+    DSPTestErrorAdd(Error, Value.Re, Value.Im, Re, Im);
+}
+
+internal void
+CheckSingleBin(u32 *FailCount)
+{
+    printf("\nsingle_bin against the direct sum, %u samples\n", SINGLE_BIN_SIZE);
+    f32 *Stream = (f32 *)malloc(SINGLE_BIN_STREAM * sizeof(f32));
+    f64 *Reference = (f64 *)malloc(SINGLE_BIN_STREAM * sizeof(f64));
+    DSPTestSignal(Stream, 0, SINGLE_BIN_STREAM, SINGLE_BIN_SIZE);
+    for (u32 N = 0; N < SINGLE_BIN_STREAM; N++) Reference[N] = Stream[N];
+
+    // Every probe's error is relative to the loudest of the first window's
+    // bins, so the quiet ones aren't held to their own tiny peaks.
+    f64 Loudest = 0;
+    for (u32 Index = 0; Index < mx_ArrayCount(SingleBinFreqs); Index++)
+    {
+        f64 Re, Im;
+        DSPTestDFT(Reference, 0, SINGLE_BIN_SIZE, SingleBinFreqs[Index] / SINGLE_BIN_SIZE, &Re, &Im);
+        Loudest = fmax(Loudest, hypot(Re, Im));
+    }
+
+    printf("  %-12s %9s %9s %9s\n", "cycles", "goertzel", "phasor", "sliding");
+    for (u32 Index = 0; Index < mx_ArrayCount(SingleBinFreqs); Index++)
+    {
+        f32 CyclesPerSample = SingleBinFreqs[Index] / SINGLE_BIN_SIZE;
+        dsp_test_error Goertzel = {0, Loudest};
+        AddBinError(&Goertzel, GoertzelBin(Stream, SINGLE_BIN_SIZE, CyclesPerSample), Reference, CyclesPerSample);
+
+        complex32 Wound = PhasorWind(Stream, SINGLE_BIN_SIZE, CyclesPerSample, 0);
+        Wound.Im = -Wound.Im;
+        dsp_test_error Phasor = {0, Loudest};
+        AddBinError(&Phasor, Wound, Reference, CyclesPerSample);
+
+        // Stream far past one window, checking a window every so often.
+        sliding_dft Sliding = SlidingDFTCreate(SINGLE_BIN_SIZE, CyclesPerSample);
+        dsp_test_error Slide = {0, Loudest};
+        for (u32 N = 0; N < SINGLE_BIN_STREAM; N++)
+        {
+            SlidingDFTPush(&Sliding, Stream[N]);
+            if (N + 1 >= SINGLE_BIN_SIZE && ((N + 1) % 997 == 0 || N + 1 == SINGLE_BIN_STREAM))
+            {
+                AddBinError(&Slide, Sliding.Value, Reference + N + 1 - SINGLE_BIN_SIZE, CyclesPerSample);
+            }
+        }
+        SlidingDFTDestroy(&Sliding);
+
+        f64 GoertzelError = DSPTestErrorRelative(Goertzel);
+        f64 PhasorError = DSPTestErrorRelative(Phasor);
+        f64 SlidingError = DSPTestErrorRelative(Slide);
+        bool Passed = Report(FailCount, GoertzelError <= SINGLE_BIN_TOLERANCE && PhasorError <= SINGLE_BIN_TOLERANCE &&
+                             SlidingError <= SINGLE_BIN_TOLERANCE);
+        printf("  %-12.2f %9.1e %9.1e %9.1e  %s\n", SingleBinFreqs[Index], GoertzelError, PhasorError, SlidingError,
+               Passed ? "ok" : "FAILED");
+    }
+    free(Stream);
+    free(Reference);
+}
+
+//
+// convolve
+//
+
+global u32 ConvolveCheckSizes[] = {1, 3, 16, 33, 100, 128, 129, 257, 1000, 3001};
+
+// Worst error of one kernel size over both methods, convolution and
+// correlation, offline and streamed.
+internal f64
+ConvolveError(fft_planner *Planner, f32 *Signal, f32 *Kernel, u32 KernelSize)
+{
+    u32 OutputSize = CONVOLVE_SAMPLES + KernelSize - 1;
+    f32 *Reference = (f32 *)malloc(OutputSize * sizeof(f32));
+    f32 *Output = (f32 *)malloc(OutputSize * sizeof(f32));
+    f32 *Streamed = (f32 *)malloc(CONVOLVE_SAMPLES * sizeof(f32));
+    f64 Error = 0;
+    for (u32 Correlating = 0; Correlating < 2; Correlating++)
+    {
+        for (u32 N = 0; N < OutputSize; N++)
+        {
+            f64 Sum = 0;
+            for (u32 K = 0; K < KernelSize; K++)
+            {
+                i64 At = Correlating ? (i64)N - (KernelSize - 1) + K : (i64)N - K;
+                if (At >= 0 && At < CONVOLVE_SAMPLES) Sum += (f64)Signal[At] * Kernel[K];
+            }
+            Reference[N] = (f32)Sum;
+        }
+
+        for (u32 Method = ConvolveMethod_Direct; Method < ConvolveMethod_Count; Method++)
+        {
+            if (Correlating) Correlate(Planner, Signal, CONVOLVE_SAMPLES, Kernel, KernelSize, Output, (convolve_method)Method);
+            else Convolve(Planner, Signal, CONVOLVE_SAMPLES, Kernel, KernelSize, Output, (convolve_method)Method);
+            Error = fmax(Error, DSPTestRelativeError(Output, Reference, OutputSize));
+
+            // Streamed in blocks of 1, 2, 3 ... samples, with a block size that
+            // isn't the one Auto would pick, and again after a reset.
+            convolve_config Config = {(convolve_method)Method, 100, (Correlating == 1)};
+            convolver Convolver = ConvolverCreate(Planner, Kernel, KernelSize, Config);
+            for (u32 Pass = 0; Pass < 2; Pass++)
+            {
+                ConvolverReset(&Convolver);
+                memcpy(Streamed, Signal, CONVOLVE_SAMPLES * sizeof(f32));
+                for (u32 Start = 0, Step = 1; Start < CONVOLVE_SAMPLES; Start += Step, Step++)
+                {
+                    u32 Count = (CONVOLVE_SAMPLES - Start < Step) ? CONVOLVE_SAMPLES - Start : Step;
+                    ConvolverProcess(&Convolver, Streamed + Start, Streamed + Start, Count);
+                }
+                u32 Latency = Convolver.Latency;
+                Error = fmax(Error, DSPTestRelativeError(Streamed + Latency, Reference, CONVOLVE_SAMPLES - Latency));
+            }
+            ConvolverDestroy(&Convolver);
+        }
+    }
+    free(Streamed);
+    free(Output);
+    free(Reference);
+    return Error;
+}
+
+internal void
+CheckConvolve(u32 *FailCount, fft_planner *Planner)
+{
+    printf("\nconvolve against a direct convolution, %u samples\n", CONVOLVE_SAMPLES);
+    u32 MaxKernel = ConvolveCheckSizes[mx_ArrayCount(ConvolveCheckSizes) - 1];
+    f32 *Signal = (f32 *)malloc(CONVOLVE_SAMPLES * sizeof(f32));
+    f32 *Kernel = (f32 *)malloc(MaxKernel * sizeof(f32));
+    DSPTestSignal(Signal, 0, CONVOLVE_SAMPLES, 1024);
+    for (u32 K = 0; K < MaxKernel; K++) Kernel[K] = (RandomF32(K + CONVOLVE_SAMPLES) - 0.5f) / sqrtf((f32)(K + 1));
+    for (u32 Index = 0; Index < mx_ArrayCount(ConvolveCheckSizes); Index++)
+    {
+        f64 Error = ConvolveError(Planner, Signal, Kernel, ConvolveCheckSizes[Index]);
+        bool Passed = Report(FailCount, Error <= CONVOLVE_TOLERANCE);
+        printf("  %5u taps: error %.1e  %s\n", ConvolveCheckSizes[Index], Error, Passed ? "ok" : "FAILED");
+    }
+    free(Signal);
+    free(Kernel);
+}
+
+//
+// fft_batch
+//
+
+global u32 BatchCheckSizes[] = {64, 256, 1024, 4096, 1000};
+
+// Runs BATCH_FRAMES frames through a batch in Mode and through the planner's
+// plan one at a time, both directions, and returns the worst error, or -1 if
+// Mode can't run the size.
+internal f64
+BatchError(fft_planner *Planner, u32 Size, fft_type Type, fft_batch_mode Mode)
+{
+    f64 Error = 0;
+    u32 BinCount = Size/2 + 1;
+    usize FrameStride = Size + 3;  // frames that don't start on a vector.
+    usize Points = FrameStride * BATCH_FRAMES;
+    complex32 *Frames = (complex32 *)malloc(Points * sizeof(complex32));
+    complex32 *Expected = (complex32 *)malloc(Points * sizeof(complex32));
+    f32 *Samples = (f32 *)malloc(Points * sizeof(f32));
+    f32 *ExpectedSamples = (f32 *)malloc(Points * sizeof(f32));
+    DSPTestSignal(Samples, Frames, (u32)Points, Size);
+
+    for (u32 Direction = 0; Direction < FFTDirection_Count; Direction++)
+    {
+        fft_batch Batch = FFTBatchCreate(Planner, Size, Type, (fft_direction)Direction, Mode, BATCH_THREADS);
+        if (Batch.Size == 0)
+        {
+            Error = -1;
+            break;
+        }
+        planned_fft *Plan = FFTPlan(Planner, Size, Type, (fft_direction)Direction);
+        if (Type == FFTType_Complex)
+        {
+            memcpy(Expected, Frames, Points * sizeof(complex32));
+            for (u32 Frame = 0; Frame < BATCH_FRAMES; Frame++) FFTExecuteComplex(Plan, Expected + Frame*FrameStride);
+            FFTBatchExecuteComplex(&Batch, Frames, FrameStride, BATCH_FRAMES);
+            Error = fmax(Error, DSPTestRelativeError((f32 *)Frames, (f32 *)Expected, Points * 2));
+        }
+        else if (Direction == FFTDirection_Forward)
+        {
+            // Spectra at FrameStride too; the samples overlap by half a frame.
+            for (u32 Frame = 0; Frame < BATCH_FRAMES; Frame++)
+            {
+                FFTExecuteReal(Plan, Samples + Frame*(Size/2), Expected + Frame*FrameStride);
+            }
+            FFTBatchExecuteReal(&Batch, Samples, Size/2, Frames, FrameStride, BATCH_FRAMES);
+            for (u32 Frame = 0; Frame < BATCH_FRAMES; Frame++)
+            {
+                Error = fmax(Error, DSPTestRelativeError((f32 *)(Frames + Frame*FrameStride),
+                                                         (f32 *)(Expected + Frame*FrameStride), BinCount * 2));
+            }
+        }
+        else
+        {
+            // Back from the forward spectra; the inverse uses them as scratch.
+            memcpy(Expected, Frames, Points * sizeof(complex32));
+            for (u32 Frame = 0; Frame < BATCH_FRAMES; Frame++)
+            {
+                FFTExecuteReal(Plan, ExpectedSamples + Frame*FrameStride, Expected + Frame*FrameStride);
+            }
+            FFTBatchExecuteReal(&Batch, Samples, FrameStride, Frames, FrameStride, BATCH_FRAMES);
+            for (u32 Frame = 0; Frame < BATCH_FRAMES; Frame++)
+            {
+                Error = fmax(Error, DSPTestRelativeError(Samples + Frame*FrameStride, ExpectedSamples + Frame*FrameStride, Size));
+            }
+        }
+        FFTBatchDestroy(&Batch);
+    }
+
+    free(ExpectedSamples);
+    free(Samples);
+    free(Expected);
+    free(Frames);
+    return Error;
+}
+
+internal void
+CheckBatch(u32 *FailCount, fft_planner *Planner)
+{
+    printf("\nfft_batch against single-frame plans, %u frames on %u threads\n", BATCH_FRAMES, BATCH_THREADS);
+    for (u32 Index = 0; Index < mx_ArrayCount(BatchCheckSizes); Index++)
+    {
+        u32 Size = BatchCheckSizes[Index];
+        for (u32 Type = 0; Type < FFTType_Count; Type++)
+        {
+            if (!FFTPlanSizeValid(Size, (fft_type)Type)) continue;
+            for (u32 Mode = FFTBatch_Frames; Mode < FFTBatch_Count; Mode++)
+            {
+                f64 Error = BatchError(Planner, Size, (fft_type)Type, (fft_batch_mode)Mode);
+                if (Error < 0) continue;
+                bool Passed = Report(FailCount, Error <= BATCH_TOLERANCE);
+                printf("  %-7s %5u %-11s error %.1e  %s\n", FFTTypeNames[Type], Size, FFTBatchModeName((fft_batch_mode)Mode), Error,
+                       Passed ? "ok" : "FAILED");
+            }
+        }
+    }
+}
+
+//
+// filterbank
+//
+
+// Band centre nearest Freq, in log frequency.
+internal u32
+NearestBand(filterbank *Filterbank, f32 Freq)
+{
+    u32 Best = 0;
+    for (u32 Band = 1; Band < Filterbank->BandCount; Band++)
+    {
+        if (fabsf(log2f(Filterbank->Bands[Band].Freq / Freq)) < fabsf(log2f(Filterbank->Bands[Best].Freq / Freq))) Best = Band;
+    }
+    return Best;
+}
+
+// Constant-Q the slow way: every band's full kernel against the frame.
+internal void
+DirectConstantQ(filterbank *Filterbank, f32 *Samples, f32 *Bands)
+{
+    filterbank_config *Config = &Filterbank->Config;
+    for (u32 Band = 0; Band < Filterbank->BandCount; Band++)
+    {
+        filterbank_band *Info = &Filterbank->Bands[Band];
+        u32 Start = Config->FFTSize - Info->Length;
+        f64 WindowSum = 0;
+        f64 SumRe = 0;
+        f64 SumIm = 0;
+        for (u32 N = 0; N < Info->Length; N++)
+        {
+            f64 Window = 0.5 - 0.5*cos(DSP_TAU * (N + 0.5) / Info->Length);
+            f64 Phase = DSP_TAU * Info->Freq * (f64)(Start + N) / Config->SampleRate;
+            WindowSum += Window;
+            SumRe += Samples[Start + N] * Window * cos(Phase);
+            SumIm -= Samples[Start + N] * Window * sin(Phase);
+        }
+        Bands[Band] = (f32)(2.0 * sqrt(SumRe*SumRe + SumIm*SumIm) / WindowSum);
+    }
+}
+
+internal filterbank
+CheckFilterbankCreate(fft_planner *Planner, filterbank_kind Kind)
+{
+    filterbank_config Config = {0};
+    Config.Kind = Kind;
+    Config.FFTSize = FILTERBANK_FFT;
+    Config.SampleRate = FILTERBANK_RATE;
+    Config.MinFreq = (Kind == FilterbankKind_Mel) ? 20.0f : C2_FREQ;
+    Config.MaxFreq = (Kind == FilterbankKind_Mel) ? 8000.0f : C8_FREQ;
+    Config.BandCount = FILTERBANK_BANDS;
+    return FilterbankCreate(Planner, Config);
+}
+
+// Noise plus a chord, for the direct comparison and the timings.
+internal void
+FilterbankChord(f32 *Samples)
+{
+    for (u32 N = 0; N < FILTERBANK_FFT; N++)
+    {
+        Samples[N] = 0.1f * (RandomF32(N) - 0.5f);
+        for (u32 Note = 0; Note < 3; Note++)
+        {
+            f32 Freq = 220.0f * powf(2.0f, (f32)(4 * Note) / 12.0f);
+            Samples[N] += 0.2f * (f32)sin(DSP_TAU * Freq * N / FILTERBANK_RATE);
+        }
+    }
+}
+
+internal void
+CheckFilterbanks(u32 *FailCount, fft_planner *Planner)
+{
+    printf("\nfilterbank, %u-point frames at %.0f Hz\n", FILTERBANK_FFT, FILTERBANK_RATE);
+    f32 *Samples = (f32 *)malloc(FILTERBANK_FFT * sizeof(f32));
+    for (u32 Kind = 0; Kind < FilterbankKind_Count; Kind++)
+    {
+        filterbank Filterbank = CheckFilterbankCreate(Planner, (filterbank_kind)Kind);
+        if (!Report(FailCount, Filterbank.BandCount > 0))
+        {
+            printf("  %s can't be made  FAILED\n", FilterbankKindName(Kind));
+            continue;
+        }
+        f32 *Bands = (f32 *)malloc(Filterbank.BandCount * sizeof(f32));
+
+        // Sines at band centres, and a quarter of a band off them.
+        u32 Misses = 0;
+        f32 WorstAmplitude = 0;
+        for (u32 Tone = 0; Tone < FILTERBANK_TONES; Tone++)
+        {
+            u32 Band = Tone * (Filterbank.BandCount - 1) / (FILTERBANK_TONES - 1);
+            f32 Freq = Filterbank.Bands[Band].Freq;
+            if (Tone & 1)
+            {
+                f32 Next = (Band + 1 < Filterbank.BandCount) ? Filterbank.Bands[Band + 1].Freq : Freq * 1.05f;
+                Freq = Freq * powf(Next / Freq, 0.25f);
+            }
+            for (u32 N = 0; N < FILTERBANK_FFT; N++)
+            {
+                Samples[N] = TONE_AMPLITUDE * (f32)sin(DSP_TAU * Freq * N / FILTERBANK_RATE + 0.3);
+            }
+            FilterbankTransform(&Filterbank, Samples, Bands);
+            u32 Peak = 0;
+            for (u32 Index = 1; Index < Filterbank.BandCount; Index++) Peak = (Bands[Index] > Bands[Peak]) ? Index : Peak;
+            Misses += (Peak == NearestBand(&Filterbank, Freq)) ? 0 : 1;
+            WorstAmplitude = fmaxf(WorstAmplitude, fabsf(Bands[Peak] - TONE_AMPLITUDE) / TONE_AMPLITUDE);
+        }
+        bool Passed = Report(FailCount, Misses == 0 && WorstAmplitude <= AMPLITUDE_TOLERANCE);
+        printf("  %-10s %3u bands: %u of %u tones in the wrong band, amplitude off by up to %.1f%%  %s\n",
+               FilterbankKindName(Kind), Filterbank.BandCount, Misses, FILTERBANK_TONES, 100.0f * WorstAmplitude,
+               Passed ? "ok" : "FAILED");
+
+        if (Kind == FilterbankKind_ConstantQ)
+        {
+            f32 *Direct = (f32 *)malloc(Filterbank.BandCount * sizeof(f32));
+            FilterbankChord(Samples);
+            FilterbankTransform(&Filterbank, Samples, Bands);
+            DirectConstantQ(&Filterbank, Samples, Direct);
+            f64 Error = DSPTestRelativeError(Bands, Direct, Filterbank.BandCount);
+            Passed = Report(FailCount, Error <= DIRECT_CQ_TOLERANCE);
+            printf("  %-10s sparse against direct: error %.1e  %s\n", "", Error, Passed ? "ok" : "FAILED");
+            free(Direct);
+        }
+        free(Bands);
+        FilterbankDestroy(&Filterbank);
+    }
+    free(Samples);
+}
+
+//
+// dsp_fixed and fft_fixed
+//
+
+// A fixed sequence made with integers only, so the fixed-point inputs, and
+// what comes out, are the same bits everywhere.
+internal u32
+FixedRandom(u32 *State)
+{
+    *State = *State * 1664525u + 1013904223u;
+    return *State;
+}
+
+internal u32
+FixedHash(u32 Hash, i32 Value)
+{
+    return (Hash ^ (u32)Value) * 16777619u;
+}
+
+internal f64
+SNRDB(f64 Signal, f64 Noise)
+{
+    return (Noise > 0) ? 10.0 * log10(Signal / Noise) : INFINITY;
+}
+
+internal f64
+ReferencePolyBlep(f64 Phase, f64 Step)
+{
+    if (Phase < Step)
+    {
+        Phase /= Step;
+        return (Phase+Phase) - (Phase*Phase) - 1.0;
+    }
+    else if (Phase > 1.0 - Step)
+    {
+        Phase = (Phase - 1.0) / Step;
+        return (Phase*Phase) + (Phase+Phase) + 1.0;
+    }
+    return 0;
+}
+
+// dsp_oscillator.h's shapes in double, at the duty and shape OscSample uses.
+internal f64
+ReferenceShape(osc_shape Shape, f64 Phase, f64 Step)
+{
+    switch (Shape)
+    {
+        case OscShape_Sine: return sin(DSP_TAU * Phase);
+        case OscShape_Saw: return (2*Phase - 1) - ReferencePolyBlep(Phase, Step);
+        case OscShape_Square:
+        {
+            f64 Fall = Phase + 0.5;
+            if (Fall >= 1) Fall -= 1;
+            return ((Phase < 0.5) ? 1.0 : -1.0) + ReferencePolyBlep(Phase, Step) - ReferencePolyBlep(Fall, Step);
+        }
+        case OscShape_Triangle: return (Phase < 0.5) ? 4*Phase - 1 : 3 - 4*Phase;
+        case OscShape_RoundedSquare: return 2.0 / (pow(6.0, 6.0 * sin(DSP_TAU * Phase)) + 1.0) - 1.0;
+        default: return 0;
+    }
+}
+
+internal q31
+FixedSample(osc_shape Shape, u32 Phase, u32 Step, q31 Drive)
+{
+    switch (Shape)
+    {
+        case OscShape_Sine: return DSPFixedSineWave(Phase);
+        case OscShape_Saw: return DSPFixedSawWave(Phase, Step);
+        case OscShape_Square: return DSPFixedSquareWave(Phase, Step, 0x80000000u);
+        case OscShape_Triangle: return DSPFixedTriangleWave(Phase);
+        case OscShape_RoundedSquare: return DSPFixedRoundedSquareWave(Phase, Drive);
+        default: return 0;
+    }
+}
+
+// Direct DFT in double of Input (Q units), for the transforms' SNRs.
+internal void
+ReferenceSpectrum(f64 *InputRe, f64 *InputIm, f64 *OutputRe, f64 *OutputIm, u32 Size)
+{
+    for (u32 Bin = 0; Bin < Size; Bin++)
+    {
+        DSPTestDFT(InputRe, InputIm, Size, (f64)Bin / Size, &OutputRe[Bin], &OutputIm[Bin]);
+    }
+}
+
+internal f64
+SpectrumSNR(f64 *RefRe, f64 *RefIm, f64 *Re, f64 *Im, u32 Size)
+{
+    f64 Signal = 0, Noise = 0;
+    for (u32 Bin = 0; Bin < Size; Bin++)
+    {
+        Signal += RefRe[Bin]*RefRe[Bin] + RefIm[Bin]*RefIm[Bin];
+        Noise += (Re[Bin] - RefRe[Bin])*(Re[Bin] - RefRe[Bin]) + (Im[Bin] - RefIm[Bin])*(Im[Bin] - RefIm[Bin]);
+    }
+    return SNRDB(Signal, Noise);
+}
+
+global u32 FixedFFTSizes[] = {64, 256, 1024, 4096};
+global i32 FixedFFTLevelsDB[] = {0, -60};
+
+internal void
+CheckFixed(u32 *FailCount, fft_planner *Planner)
+{
+    printf("\ndsp_fixed\n");
+    bool Saturates = DSPQ15Add(30000, 30000) == DSP_Q15_MAX && DSPQ15Sub(-30000, 30000) == DSP_Q15_MIN &&
+                     DSPQ15Mul(DSP_Q15_MIN, DSP_Q15_MIN) == DSP_Q15_MAX && DSPQ15Mul(16384, -16384) == -8192 &&
+                     DSPQ31Add(DSP_Q31_MAX, 1) == DSP_Q31_MAX && DSPQ31Mul(DSP_Q31_MIN, DSP_Q31_MIN) == DSP_Q31_MAX &&
+                     DSPQ31Shift(1 << 20, -12) == DSP_Q31_MAX && DSPQ31Shift(-3, 1) == -1 &&
+                     DSPQ15FromQ31(DSP_Q31_MAX) == DSP_Q15_MAX && DSPQ15FromF32(-2.0f) == DSP_Q15_MIN;
+    printf("  saturating and rounding arithmetic  %s\n", Report(FailCount, Saturates) ? "ok" : "FAILED");
+
+    f64 SinError = 0;
+    for (u64 Phase = 0; Phase < (1ull << 32); Phase += 1000003)
+    {
+        f64 Exact = sin(DSP_TAU * (f64)Phase / 4294967296.0) * 2147483648.0;
+        SinError = fmax(SinError, fabs(DSPFixedSinPrecise((u32)Phase) - fmin(Exact, DSP_Q31_MAX)));
+    }
+    bool Passed = Report(FailCount, SinError <= FIXED_SIN_LSB);
+    printf("  precise sine within %.1f Q31 LSBs  %s\n", SinError, Passed ? "ok" : "FAILED");
+
+    // One second at about 440Hz, on the integer phase.
+    u32 Hash = 2166136261u;
+    u32 Step = DSPFixedPhaseStep(440 << 16, (u32)CHECK_RATE);
+    q31 Drive = DSPFixedRoundedSquareDrive(DSPQ31FromF32(0.5f));
+    printf("  %-15s %9s %9s %9s   SNR against double\n", "", "float", "Q31", "Q15");
+    for (u32 Shape = 0; Shape < OscShape_NaiveSaw; Shape++)
+    {
+        f64 Signal = 0, FloatNoise = 0, Q31Noise = 0, Q15Noise = 0;
+        u32 Phase = 0;
+        for (u32 N = 0; N < (u32)CHECK_RATE; N++)
+        {
+            f64 Cycles = Phase / 4294967296.0;
+            f64 Reference = ReferenceShape((osc_shape)Shape, Cycles, Step / 4294967296.0);
+            q31 Sample = FixedSample((osc_shape)Shape, Phase, Step, Drive);
+            f64 Float = OscSample((osc_shape)Shape, (f32)Cycles, Step / 4294967296.0f);
+            Signal += Reference * Reference;
+            FloatNoise += (Float - Reference) * (Float - Reference);
+            Q31Noise += (DSPF32FromQ31(Sample) - Reference) * (DSPF32FromQ31(Sample) - Reference);
+            f64 Q15 = DSPQ15FromQ31(Sample) / 32768.0;
+            Q15Noise += (Q15 - Reference) * (Q15 - Reference);
+            Hash = FixedHash(Hash, Sample);
+            Phase += Step;
+        }
+        f64 Q31SNR = SNRDB(Signal, Q31Noise);
+        f64 Q15SNR = SNRDB(Signal, Q15Noise);
+        Passed = Report(FailCount, Q31SNR >= FIXED_OSC_SNR_Q31 && Q15SNR >= FIXED_OSC_SNR_Q15);
+        printf("  %-15s %7.1fdB %7.1fdB %7.1fdB  %s\n", OscShapeNames[Shape], SNRDB(Signal, FloatNoise), Q31SNR, Q15SNR,
+               Passed ? "ok" : "FAILED");
+    }
+
+    printf("\nfft_fixed against a direct DFT\n");
+    printf("  %-13s %9s %9s %9s   SNR, complex noise input\n", "", "float", "Q31", "Q15");
+    u32 MaxSize = FixedFFTSizes[mx_ArrayCount(FixedFFTSizes) - 1];
+    f64 *InRe = (f64 *)malloc(MaxSize * sizeof(f64));
+    f64 *InIm = (f64 *)malloc(MaxSize * sizeof(f64));
+    f64 *RefRe = (f64 *)malloc(MaxSize * sizeof(f64));
+    f64 *RefIm = (f64 *)malloc(MaxSize * sizeof(f64));
+    f64 *OutRe = (f64 *)malloc(MaxSize * sizeof(f64));
+    f64 *OutIm = (f64 *)malloc(MaxSize * sizeof(f64));
+    complex_q15 *Q15 = (complex_q15 *)malloc(MaxSize * sizeof(complex_q15));
+    complex_q15 *Q15Input = (complex_q15 *)malloc(MaxSize * sizeof(complex_q15));
+    complex_q31 *Q31 = (complex_q31 *)malloc(MaxSize * sizeof(complex_q31));
+    complex32 *Float = (complex32 *)malloc((MaxSize + 1) * sizeof(complex32));
+    for (u32 Index = 0; Index < mx_ArrayCount(FixedFFTSizes); Index++)
+    {
+        u32 Size = FixedFFTSizes[Index];
+        fft_fixed_plan Plan = FFTFixedCreatePlan(Size);
+        planned_fft *FloatPlan = FFTPlan(Planner, Size, FFTType_Complex, FFTDirection_Forward);
+        for (u32 Level = 0; Level < mx_ArrayCount(FixedFFTLevelsDB); Level++)
+        {
+            // Uniform noise at the level, peaking just under full scale at 0dB.
+            u32 State = Size + Level;
+            i32 LevelShift = -FixedFFTLevelsDB[Level] / 6;
+            for (u32 N = 0; N < Size; N++)
+            {
+                Q31[N].Re = (q31)FixedRandom(&State) >> LevelShift;
+                Q31[N].Im = (q31)FixedRandom(&State) >> LevelShift;
+                Q15Input[N].Re = DSPQ15FromQ31(Q31[N].Re);
+                Q15Input[N].Im = DSPQ15FromQ31(Q31[N].Im);
+                Q15[N] = Q15Input[N];
+            }
+
+            // Q31 against the DFT of its own input, Q15 and float of the Q15 input.
+            for (u32 N = 0; N < Size; N++) { InRe[N] = Q31[N].Re / 2147483648.0; InIm[N] = Q31[N].Im / 2147483648.0; }
+            ReferenceSpectrum(InRe, InIm, RefRe, RefIm, Size);
+            i32 Exponent = FFTFixedForwardQ31(&Plan, Q31);
+            f64 Scale = ldexp(1.0, Exponent) / 2147483648.0;
+            for (u32 N = 0; N < Size; N++) { OutRe[N] = Q31[N].Re * Scale; OutIm[N] = Q31[N].Im * Scale; }
+            f64 Q31SNR = SpectrumSNR(RefRe, RefIm, OutRe, OutIm, Size);
+            for (u32 N = 0; N < Size; N++) Hash = FixedHash(FixedHash(Hash, Q31[N].Re), Q31[N].Im);
+            Hash = FixedHash(Hash, Exponent);
+
+            for (u32 N = 0; N < Size; N++) { InRe[N] = Q15[N].Re / 32768.0; InIm[N] = Q15[N].Im / 32768.0; }
+            ReferenceSpectrum(InRe, InIm, RefRe, RefIm, Size);
+            for (u32 N = 0; N < Size; N++) { Float[N].Re = (f32)InRe[N]; Float[N].Im = (f32)InIm[N]; }
+            FFTExecuteComplex(FloatPlan, Float);
+            for (u32 N = 0; N < Size; N++) { OutRe[N] = Float[N].Re; OutIm[N] = Float[N].Im; }
+            f64 FloatSNR = SpectrumSNR(RefRe, RefIm, OutRe, OutIm, Size);
+            i32 ForwardExponent = FFTFixedForwardQ15(&Plan, Q15);
+            Scale = ldexp(1.0, ForwardExponent) / 32768.0;
+            for (u32 N = 0; N < Size; N++) { OutRe[N] = Q15[N].Re * Scale; OutIm[N] = Q15[N].Im * Scale; }
+            f64 Q15SNR = SpectrumSNR(RefRe, RefIm, OutRe, OutIm, Size);
+            for (u32 N = 0; N < Size; N++) Hash = FixedHash(FixedHash(Hash, Q15[N].Re), Q15[N].Im);
+            Hash = FixedHash(Hash, ForwardExponent);
+
+            // And back to the input's scale, within a few LSBs.
+            FFTFixedScaleQ15(Q15, Size, ForwardExponent + FFTFixedInverseQ15(&Plan, Q15));
+            f64 Signal = 0, Noise = 0;
+            for (u32 N = 0; N < Size; N++)
+            {
+                f64 Re = Q15Input[N].Re, Im = Q15Input[N].Im;
+                Signal += Re*Re + Im*Im;
+                Noise += (Q15[N].Re - Re)*(Q15[N].Re - Re) + (Q15[N].Im - Im)*(Q15[N].Im - Im);
+            }
+            f64 RoundTripSNR = SNRDB(Signal, Noise);
+
+            Passed = Report(FailCount, Q31SNR >= FIXED_FFT_SNR_Q31 && Q15SNR >= FIXED_FFT_SNR_Q15 &&
+                            RoundTripSNR >= FIXED_ROUND_TRIP_SNR_Q15);
+            char Name[32];
+            snprintf(Name, sizeof(Name), "%u at %ddB", Size, FixedFFTLevelsDB[Level]);
+            printf("  %-13s %7.1fdB %7.1fdB %7.1fdB   Q15 round trip %5.1fdB  %s\n", Name, FloatSNR, Q31SNR, Q15SNR,
+                   RoundTripSNR, Passed ? "ok" : "FAILED");
+        }
+        FFTFixedDestroyPlan(&Plan);
+    }
+    free(InRe); free(InIm); free(RefRe); free(RefIm); free(OutRe); free(OutIm);
+    free(Q15); free(Q15Input); free(Q31); free(Float);
+
+    // Integer arithmetic only, so any compiler and optimization level has to
+    // land on the same bits.
+    Passed = Report(FailCount, Hash == FIXED_HASH);
+    printf("  bit exact: hash of the Q31 shapes and fixed transforms %08x, expected %08x  %s\n", Hash, FIXED_HASH,
+           Passed ? "ok" : "FAILED");
+}
+
+//
+// Throughput
+//
+
+internal void
+BenchOscillator(osc_shape Shape, f32 *Buffer)
+{
+    f32 Step = 440.0f / CHECK_RATE;
+    f32 Phase = 0;
+    for (u32 N = 0; N < BENCH_SAMPLES; N++)
+    {
+        Buffer[N] = OscSample(Shape, Phase, Step);
+        DSPAdvancePhase(&Phase, Step);
+    }
+    BenchSink += Buffer[BENCH_SAMPLES - 1];
+}
+
+internal void
+BenchOnePole(dsp_one_pole *OnePole, f32 *Buffer)
+{
+    for (u32 N = 0; N < BENCH_SAMPLES; N++) Buffer[N] = DSPOnePoleNext(OnePole, Buffer[N]);
+    BenchSink += Buffer[BENCH_SAMPLES - 1];
+}
+
+internal void
+LibmBlock(dsp_math_function Function, f32 *Out, f32 *X, f32 *Y, u32 Count)
+{
+    switch (Function)
+    {
+        case DSPMathFunction_Sin: for (u32 N = 0; N < Count; N++) Out[N] = sinf(X[N]); break;
+        case DSPMathFunction_Cos: for (u32 N = 0; N < Count; N++) Out[N] = cosf(X[N]); break;
+        case DSPMathFunction_Exp2: for (u32 N = 0; N < Count; N++) Out[N] = exp2f(X[N]); break;
+        case DSPMathFunction_Log2: for (u32 N = 0; N < Count; N++) Out[N] = log2f(X[N]); break;
+        case DSPMathFunction_Pow: for (u32 N = 0; N < Count; N++) Out[N] = powf(X[N], Y[N]); break;
+        case DSPMathFunction_Tanh: for (u32 N = 0; N < Count; N++) Out[N] = tanhf(X[N]); break;
+        default: break;
+    }
+    BenchSink += Out[Count - 1];
+}
+
+internal void
+BenchMath(f64 MinSeconds)
+{
+    printf("\ndsp_simd_math throughput, ns per value over %u values\n", BENCH_SAMPLES);
+    printf("  %-6s %8s", "", "libm");
+    for (u32 Kernel = 0; Kernel < DSPMathKernel_Count; Kernel++)
+    {
+        for (u32 Tier = 0; Tier < DSPMathTier_Count; Tier++)
+        {
+            char Name[32];
+            snprintf(Name, sizeof(Name), "%s %s", DSPMathKernelName(Kernel), DSPMathTierName(Tier));
+            printf(" %15s", Name);
+        }
+    }
+    printf("\n");
+
+    f32 *X = (f32 *)malloc(BENCH_SAMPLES * sizeof(f32));
+    f32 *Y = (f32 *)malloc(BENCH_SAMPLES * sizeof(f32));
+    f32 *Out = (f32 *)malloc(BENCH_SAMPLES * sizeof(f32));
+    for (u32 Function = 0; Function < DSPMathFunction_Count; Function++)
+    {
+        // Arguments of the size the apps use.
+        for (u32 N = 0; N < BENCH_SAMPLES; N++)
+        {
+            f32 Random = RandomF32(N);
+            switch (Function)
+            {
+                case DSPMathFunction_Sin:
+                case DSPMathFunction_Cos: X[N] = (Random - 0.5f) * 8 * (f32)DSP_TAU; break;
+                case DSPMathFunction_Exp2: X[N] = (Random - 0.5f) * 40; break;
+                case DSPMathFunction_Log2: X[N] = 1e-3f + Random * 1000; break;
+                case DSPMathFunction_Pow: X[N] = 2 + Random * 8; Y[N] = (RandomF32(N + BENCH_SAMPLES) - 0.5f) * 20; break;
+                default: X[N] = (Random - 0.5f) * 8; break;
+            }
+        }
+
+        f64 Seconds;
+        mx_TimeCalls(MinSeconds, Seconds, LibmBlock((dsp_math_function)Function, Out, X, Y, BENCH_SAMPLES));
+        printf("  %-6s %8.2f", DSPMathFunctionName(Function), Seconds * 1e9 / BENCH_SAMPLES);
+        for (u32 Kernel = 0; Kernel < DSPMathKernel_Count; Kernel++)
+        {
+            for (u32 Tier = 0; Tier < DSPMathTier_Count; Tier++)
+            {
+                if (!DSPMathKernelSupported((dsp_math_kernel)Kernel))
+                {
+                    printf(" %15s", "-");
+                    continue;
+                }
+                DSPMathSetKernel((dsp_math_kernel)Kernel);
+                mx_TimeCalls(MinSeconds, Seconds, DSPMathBlock((dsp_math_function)Function, Out, X, Y, BENCH_SAMPLES, (dsp_math_tier)Tier));
+                printf(" %15.2f", Seconds * 1e9 / BENCH_SAMPLES);
+            }
+        }
+        printf("\n");
+    }
+    DSPMathSetKernel(DSPMathKernel_AVX2);
+    free(X);
+    free(Y);
+    free(Out);
+}
+
+internal void
+Bench(fft_planner *Planner, f64 MinSeconds)
+{
+    printf("\nthroughput, %u-sample blocks\n", BENCH_SAMPLES);
+    f32 *Buffer = (f32 *)malloc(BENCH_SAMPLES * sizeof(f32));
+    f64 Seconds;
+    for (u32 Shape = 0; Shape < OscShape_Count; Shape++)
+    {
+        // Through a switch per sample, like the synth's shape pointer.
+        mx_TimeCalls(MinSeconds, Seconds, BenchOscillator((osc_shape)Shape, Buffer));
+        printf("  %-15s %6.2f ns/sample\n", OscShapeNames[Shape], Seconds * 1e9 / BENCH_SAMPLES);
+    }
+
+    for (u32 N = 0; N < BENCH_SAMPLES; N++) Buffer[N] = RandomF32(N) - 0.5f;
+    dsp_biquad Biquad = DSPBiquadDesign(DSPBiquad_LowPass, CHECK_RATE, 1000, 0.70710678f, 0);
+    mx_TimeCalls(MinSeconds, Seconds, DSPBiquadProcess(&Biquad, Buffer, BENCH_SAMPLES));
+    printf("  %-15s %6.2f ns/sample\n", "biquad", Seconds * 1e9 / BENCH_SAMPLES);
+    dsp_one_pole OnePole = DSPOnePoleCreate(CHECK_RATE, 0.01f, 0);
+    mx_TimeCalls(MinSeconds, Seconds, BenchOnePole(&OnePole, Buffer));
+    printf("  %-15s %6.2f ns/sample\n", "one-pole", Seconds * 1e9 / BENCH_SAMPLES);
+
+    u32 Sizes[] = {256, 1024, 4096, 16384, 1000, 1031};
+    complex32 *Data = (complex32 *)calloc(16384 + 1, sizeof(complex32));
+    f32 *Samples = (f32 *)calloc(16384, sizeof(f32));
+    printf("  %-15s %10s %10s\n", "fft size", "complex", "real");
+    for (u32 Index = 0; Index < mx_ArrayCount(Sizes); Index++)
+    {
+        u32 Size = Sizes[Index];
+        f64 ComplexSeconds = 0, RealSeconds = 0;
+        planned_fft *Complex = FFTPlan(Planner, Size, FFTType_Complex, FFTDirection_Forward);
+        mx_TimeCalls(MinSeconds, ComplexSeconds, FFTExecuteComplex(Complex, Data));
+        if (FFTPlanSizeValid(Size, FFTType_Real))
+        {
+            planned_fft *Real = FFTPlan(Planner, Size, FFTType_Real, FFTDirection_Forward);
+            mx_TimeCalls(MinSeconds, RealSeconds, FFTExecuteReal(Real, Samples, Data));
+        }
+        if (RealSeconds > 0) printf("  %-15u %7.2f ns %7.2f ns  per point\n", Size, ComplexSeconds * 1e9 / Size, RealSeconds * 1e9 / Size);
+        else printf("  %-15u %7.2f ns %10s  per point\n", Size, ComplexSeconds * 1e9 / Size, "-");
+    }
+
+    // The FFT plus the sparse weights, per frame; constant-Q also by
+    // correlating every full kernel with the frame, which it stands in for.
+    f32 *Frame = (f32 *)malloc(FILTERBANK_FFT * sizeof(f32));
+    FilterbankChord(Frame);
+    printf("  %-15s %10s %10s\n", "filterbank", "sparse", "direct");
+    for (u32 Kind = 0; Kind < FilterbankKind_Count; Kind++)
+    {
+        filterbank Filterbank = CheckFilterbankCreate(Planner, (filterbank_kind)Kind);
+        if (Filterbank.BandCount == 0) continue;
+        f32 *Bands = (f32 *)malloc(Filterbank.BandCount * sizeof(f32));
+        mx_TimeCalls(MinSeconds, Seconds, FilterbankTransform(&Filterbank, Frame, Bands));
+        printf("  %-15s %7.1f us", FilterbankKindName(Kind), Seconds * 1e6);
+        if (Kind == FilterbankKind_ConstantQ)
+        {
+            f64 DirectSeconds;
+            mx_TimeCalls(MinSeconds, DirectSeconds, DirectConstantQ(&Filterbank, Frame, Bands));
+            printf(" %7.1f us  per frame (%.0fx)\n", DirectSeconds * 1e6, DirectSeconds / Seconds);
+        }
+        else printf(" %10s  per frame\n", "-");
+        free(Bands);
+        FilterbankDestroy(&Filterbank);
+    }
+    free(Frame);
+    free(Data);
+    free(Samples);
+    free(Buffer);
+}
+
+internal void
+BenchFixedOscillator(osc_shape Shape, q31 *Buffer, q31 Drive)
+{
+    u32 Step = DSPFixedPhaseStep(440 << 16, (u32)CHECK_RATE);
+    u32 Phase = 0;
+    for (u32 N = 0; N < BENCH_SAMPLES; N++)
+    {
+        Buffer[N] = FixedSample(Shape, Phase, Step, Drive);
+        Phase += Step;
+    }
+    BenchSink += (f32)Buffer[BENCH_SAMPLES - 1];
+}
+
+internal void
+BenchFixed(fft_planner *Planner, f64 MinSeconds)
+{
+    printf("\nfixed point throughput, %u-sample blocks\n", BENCH_SAMPLES);
+    printf("  %-15s %10s %10s\n", "", "float", "Q31");
+    f32 *Buffer = (f32 *)malloc(BENCH_SAMPLES * sizeof(f32));
+    q31 *FixedBuffer = (q31 *)malloc(BENCH_SAMPLES * sizeof(q31));
+    q31 Drive = DSPFixedRoundedSquareDrive(DSPQ31FromF32(0.5f));
+    f64 Seconds, FixedSeconds;
+    for (u32 Shape = 0; Shape < OscShape_NaiveSaw; Shape++)
+    {
+        mx_TimeCalls(MinSeconds, Seconds, BenchOscillator((osc_shape)Shape, Buffer));
+        mx_TimeCalls(MinSeconds, FixedSeconds, BenchFixedOscillator((osc_shape)Shape, FixedBuffer, Drive));
+        printf("  %-15s %7.2f ns %7.2f ns  per sample\n", OscShapeNames[Shape], Seconds * 1e9 / BENCH_SAMPLES,
+               FixedSeconds * 1e9 / BENCH_SAMPLES);
+    }
+
+    u32 Sizes[] = {256, 1024, 4096};
+    complex32 *Data = (complex32 *)calloc(4096 + 1, sizeof(complex32));
+    complex_q15 *Q15 = (complex_q15 *)malloc(4096 * sizeof(complex_q15));
+    complex_q31 *Q31 = (complex_q31 *)malloc(4096 * sizeof(complex_q31));
+    u32 State = 1;
+    for (u32 N = 0; N < 4096; N++)
+    {
+        Q31[N].Re = (q31)FixedRandom(&State);
+        Q31[N].Im = (q31)FixedRandom(&State);
+        Q15[N].Re = DSPQ15FromQ31(Q31[N].Re);
+        Q15[N].Im = DSPQ15FromQ31(Q31[N].Im);
+    }
+    printf("  %-15s %10s %10s %10s\n", "fft size", "float", "Q31", "Q15");
+    for (u32 Index = 0; Index < mx_ArrayCount(Sizes); Index++)
+    {
+        u32 Size = Sizes[Index];
+        fft_fixed_plan Plan = FFTFixedCreatePlan(Size);
+        f64 Q15Seconds;
+        planned_fft *Complex = FFTPlan(Planner, Size, FFTType_Complex, FFTDirection_Forward);
+        mx_TimeCalls(MinSeconds, Seconds, FFTExecuteComplex(Complex, Data));
+        mx_TimeCalls(MinSeconds, FixedSeconds, FFTFixedForwardQ31(&Plan, Q31));
+        mx_TimeCalls(MinSeconds, Q15Seconds, FFTFixedForwardQ15(&Plan, Q15));
+        printf("  %-15u %7.2f ns %7.2f ns %7.2f ns  per point\n", Size, Seconds * 1e9 / Size,
+               FixedSeconds * 1e9 / Size, Q15Seconds * 1e9 / Size);
+        FFTFixedDestroyPlan(&Plan);
+    }
+    free(Data);
+    free(Q15);
+    free(Q31);
+    free(FixedBuffer);
+    free(Buffer);
+}
+
+i32
+main(i32 ArgCount, char **Args)
+{
+    f64 MinSeconds = 0.1;
+    bool Exhaustive = false;
+    for (i32 ArgIndex = 1; ArgIndex < ArgCount; ArgIndex++)
+    {
+        if (strcmp(Args[ArgIndex], "--seconds") == 0 && ArgIndex + 1 < ArgCount) MinSeconds = atof(Args[++ArgIndex]);
+        else if (strcmp(Args[ArgIndex], "--exhaustive") == 0) Exhaustive = true;
+        else
+        {
+            printf("Unknown argument: %s\n", Args[ArgIndex]);
+            return 2;
+        }
+    }
+
+    fft_planner Planner = FFTPlannerCreate(FFTPlanner_Estimate, 0);
+    DSPFixedInit();
+    u32 FailCount = 0;
+    CheckMath(&FailCount);
+    CheckSIMDMath(&FailCount, Exhaustive);
+    CheckWindows(&FailCount);
+    CheckFilters(&FailCount);
+    CheckOscillators(&FailCount, &Planner);
+    CheckKernels(&FailCount);
+    CheckFFT(&FailCount, &Planner);
+    CheckCZT(&FailCount);
+    CheckSingleBin(&FailCount);
+    CheckConvolve(&FailCount, &Planner);
+    CheckBatch(&FailCount, &Planner);
+    CheckFilterbanks(&FailCount, &Planner);
+    CheckFixed(&FailCount, &Planner);
+    BenchMath(MinSeconds);
+    Bench(&Planner, MinSeconds);
+    BenchFixed(&Planner, MinSeconds);
+    FFTPlannerDestroy(&Planner);
+
+    printf("\n%s\n", FailCount ? "FAILED" : "all checks passed");
+    return FailCount ? 1 : 0;
+}
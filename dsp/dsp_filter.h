@@ -0,0 +1,171 @@
+/* date = October 18th 2026 */
+
+#ifndef DSP_FILTER_H
+#define DSP_FILTER_H
+
+// Biquads designed from Robert Bristow-Johnson's cookbook, run in transposed
+// direct form II, and one-pole smoothers for parameters.
+//
+// Coefficients are computed in double precision and normalised by a0; the
+// state is f32, which is fine for cutoffs above about Fs/5000 (a low pass
+// much lower than that wants double state).
+//
+// Needs dsp_math.h.
+
+typedef enum dsp_biquad_kind
+{
+    DSPBiquad_LowPass,
+    DSPBiquad_HighPass,
+    DSPBiquad_BandPass,   // 0dB at Freq.
+    DSPBiquad_Notch,
+    DSPBiquad_Peak,       // GainDB at Freq.
+    DSPBiquad_LowShelf,   // GainDB below Freq.
+    DSPBiquad_HighShelf,  // GainDB above Freq.
+    DSPBiquad_Count,
+} dsp_biquad_kind;
+
+internal const char *
+DSPBiquadKindName(dsp_biquad_kind Value)
+{
+    local_static const char *Names[DSPBiquad_Count] = {"low pass", "high pass", "band pass", "notch", "peak", "low shelf", "high shelf"};
+    return ((u32)Value < DSPBiquad_Count) ? Names[Value] : "?";
+}
+
+typedef struct dsp_biquad
+{
+    f32 B0, B1, B2;
+    f32 A1, A2;
+    f32 Z1, Z2;
+} dsp_biquad;
+
+typedef struct dsp_one_pole
+{
+    f32 Coefficient;
+    f32 Value;
+} dsp_one_pole;
+
+// Q is the usual resonance (0.7071 for Butterworth); GainDB is only used by
+// the peak and shelves. The state starts at 0.
+internal dsp_biquad
+DSPBiquadDesign(dsp_biquad_kind Kind, f32 SampleRate, f32 Freq, f32 Q, f32 GainDB)
+{
+    f64 W0 = DSP_TAU * Freq / SampleRate;
+    f64 Cos = cos(W0);
+    f64 Alpha = sin(W0) / (2.0 * Q);
+    f64 A = pow(10.0, GainDB / 40.0);
+    f64 RootA = sqrt(A);
+    f64 B0 = 1, B1 = 0, B2 = 0, A0 = 1, A1 = 0, A2 = 0;
+    switch (Kind)
+    {
+        case DSPBiquad_LowPass:
+        {
+            B0 = (1 - Cos) / 2; B1 = 1 - Cos; B2 = B0;
+            A0 = 1 + Alpha; A1 = -2*Cos; A2 = 1 - Alpha;
+        } break;
+        case DSPBiquad_HighPass:
+        {
+            B0 = (1 + Cos) / 2; B1 = -(1 + Cos); B2 = B0;
+            A0 = 1 + Alpha; A1 = -2*Cos; A2 = 1 - Alpha;
+        } break;
+        case DSPBiquad_BandPass:
+        {
+            B0 = Alpha; B1 = 0; B2 = -Alpha;
+            A0 = 1 + Alpha; A1 = -2*Cos; A2 = 1 - Alpha;
+        } break;
+        case DSPBiquad_Notch:
+        {
+            B0 = 1; B1 = -2*Cos; B2 = 1;
+            A0 = 1 + Alpha; A1 = -2*Cos; A2 = 1 - Alpha;
+        } break;
+        case DSPBiquad_Peak:
+        {
+            B0 = 1 + Alpha*A; B1 = -2*Cos; B2 = 1 - Alpha*A;
+            A0 = 1 + Alpha/A; A1 = -2*Cos; A2 = 1 - Alpha/A;
+        } break;
+        case DSPBiquad_LowShelf:
+        {
+            B0 = A*((A + 1) - (A - 1)*Cos + 2*RootA*Alpha);
+            B1 = 2*A*((A - 1) - (A + 1)*Cos);
+            B2 = A*((A + 1) - (A - 1)*Cos - 2*RootA*Alpha);
+            A0 = (A + 1) + (A - 1)*Cos + 2*RootA*Alpha;
+            A1 = -2*((A - 1) + (A + 1)*Cos);
+            A2 = (A + 1) + (A - 1)*Cos - 2*RootA*Alpha;
+        } break;
+        case DSPBiquad_HighShelf:
+        {
+            B0 = A*((A + 1) + (A - 1)*Cos + 2*RootA*Alpha);
+            B1 = -2*A*((A - 1) + (A + 1)*Cos);
+            B2 = A*((A + 1) + (A - 1)*Cos - 2*RootA*Alpha);
+            A0 = (A + 1) - (A - 1)*Cos + 2*RootA*Alpha;
+            A1 = 2*((A - 1) - (A + 1)*Cos);
+            A2 = (A + 1) - (A - 1)*Cos - 2*RootA*Alpha;
+        } break;
+        default: break;
+    }
+
+    dsp_biquad Biquad = {0};
+    Biquad.B0 = (f32)(B0 / A0);
+    Biquad.B1 = (f32)(B1 / A0);
+    Biquad.B2 = (f32)(B2 / A0);
+    Biquad.A1 = (f32)(A1 / A0);
+    Biquad.A2 = (f32)(A2 / A0);
+    return Biquad;
+}
+
+internal void
+DSPBiquadReset(dsp_biquad *Biquad)
+{
+    Biquad->Z1 = 0;
+    Biquad->Z2 = 0;
+}
+
+// Filters Count samples in place.
+internal void
+DSPBiquadProcess(dsp_biquad *Biquad, f32 *Samples, u32 Count)
+{
+    f32 B0 = Biquad->B0, B1 = Biquad->B1, B2 = Biquad->B2;
+    f32 A1 = Biquad->A1, A2 = Biquad->A2;
+    f32 Z1 = Biquad->Z1, Z2 = Biquad->Z2;
+    for (u32 N = 0; N < Count; N++)
+    {
+        f32 In = Samples[N];
+        f32 Out = B0*In + Z1;
+        Z1 = B1*In - A1*Out + Z2;
+        Z2 = B2*In - A2*Out;
+        Samples[N] = Out;
+    }
+    Biquad->Z1 = Z1;
+    Biquad->Z2 = Z2;
+}
+
+// |H| at Freq, from the coefficients.
+internal f64
+DSPBiquadMagnitude(dsp_biquad *Biquad, f32 SampleRate, f32 Freq)
+{
+    f64 W = DSP_TAU * Freq / SampleRate;
+    f64 C1 = cos(W), S1 = sin(W), C2 = cos(2*W), S2 = sin(2*W);
+    f64 NumRe = Biquad->B0 + Biquad->B1*C1 + Biquad->B2*C2;
+    f64 NumIm = -(Biquad->B1*S1 + Biquad->B2*S2);
+    f64 DenRe = 1 + Biquad->A1*C1 + Biquad->A2*C2;
+    f64 DenIm = -(Biquad->A1*S1 + Biquad->A2*S2);
+    return sqrt((NumRe*NumRe + NumIm*NumIm) / (DenRe*DenRe + DenIm*DenIm));
+}
+
+// A smoother that covers 1 - 1/e of a step in Seconds.
+internal dsp_one_pole
+DSPOnePoleCreate(f32 SampleRate, f32 Seconds, f32 Value)
+{
+    dsp_one_pole OnePole;
+    OnePole.Coefficient = (Seconds > 0) ? (f32)(1.0 - exp(-1.0 / (Seconds * SampleRate))) : 1.0f;
+    OnePole.Value = Value;
+    return OnePole;
+}
+
+internal inline f32
+DSPOnePoleNext(dsp_one_pole *OnePole, f32 Target)
+{
+    OnePole->Value += OnePole->Coefficient * (Target - OnePole->Value);
+    return OnePole->Value;
+}
+
+#endif //DSP_FILTER_H
@@ -0,0 +1,323 @@
+/* date = October 18th 2026 */
+
+#ifndef DSP_FIXED_H
+#define DSP_FIXED_H
+
+// Fixed point for targets where float is slow or missing, and for output
+// that has to be bit-exact across compilers: Q15 and Q31 samples
+// (fractions of full scale in an i16 or i32) with rounding, saturating
+// arithmetic, and the oscillator shapes of dsp_oscillator.h on an integer
+// phase. fft_fixed.h is the FFT to go with them.
+//
+// The phase is a u32 counting 2^32 to the cycle, so advancing it is a plain
+// Phase += Step that wraps by itself. The shapes compute in Q31 (the Q15
+// versions round that); the sine and rounded square read tables that
+// DSPFixedInit fills using integer arithmetic only, so they come out the
+// same everywhere. Everything here is integers after that but the float
+// conversions.
+//
+// DSP_FIXED picks the format for a build that goes fixed point: 0 (the
+// default) stays float, 15 or 31 defines dsp_fixed and its conversions for
+// that format. The synth's wave shapes use these when it's set
+// (DSP_FIXED=15 ./build_tools.sh); dsp_check compares both formats with the
+// float shapes either way.
+
+#ifndef DSP_FIXED
+#define DSP_FIXED 0
+#endif
+
+typedef i16 q15;
+typedef i32 q31;
+
+#define DSP_Q15_MAX 32767
+#define DSP_Q15_MIN (-32768)
+#define DSP_Q31_MAX 2147483647
+#define DSP_Q31_MIN (-2147483647 - 1)
+
+#define DSP_FIXED_SINE_BITS 10    // 1024 entries a cycle, about -106dB interpolated.
+#define DSP_FIXED_TANH_SIZE 1024  // 128 per unit out to 8, past which it's 1 in Q31.
+#define DSP_FIXED_DRIVE_SIZE 256  // rounded square drive over its shape, [0, 1].
+
+global q31 DSPFixedSineTable[(1 << DSP_FIXED_SINE_BITS) + 1];
+global q31 DSPFixedTanhTable[DSP_FIXED_TANH_SIZE + 1];
+global q31 DSPFixedDriveTable[DSP_FIXED_DRIVE_SIZE + 1];  // Q26.
+
+//
+// Saturating arithmetic
+//
+
+internal inline q15
+DSPQ15Saturate(i32 X)
+{
+    return (q15)((X > DSP_Q15_MAX) ? DSP_Q15_MAX : (X < DSP_Q15_MIN) ? DSP_Q15_MIN : X);
+}
+
+internal inline q31
+DSPQ31Saturate(i64 X)
+{
+    return (q31)((X > DSP_Q31_MAX) ? DSP_Q31_MAX : (X < DSP_Q31_MIN) ? DSP_Q31_MIN : X);
+}
+
+internal inline q15 DSPQ15Add(q15 A, q15 B) { return DSPQ15Saturate((i32)A + B); }
+internal inline q15 DSPQ15Sub(q15 A, q15 B) { return DSPQ15Saturate((i32)A - B); }
+internal inline q31 DSPQ31Add(q31 A, q31 B) { return DSPQ31Saturate((i64)A + B); }
+internal inline q31 DSPQ31Sub(q31 A, q31 B) { return DSPQ31Saturate((i64)A - B); }
+
+// Rounded to nearest; only -1 * -1 saturates.
+internal inline q15
+DSPQ15Mul(q15 A, q15 B)
+{
+    return DSPQ15Saturate(((i32)A*B + (1 << 14)) >> 15);
+}
+
+internal inline q31
+DSPQ31Mul(q31 A, q31 B)
+{
+    return DSPQ31Saturate(((i64)A*B + (1ll << 30)) >> 31);
+}
+
+// X / 2^Shift rounded, or X * 2^-Shift saturated for a negative Shift.
+internal inline q31
+DSPQ31Shift(q31 X, i32 Shift)
+{
+    if (Shift > 62) Shift = 62;
+    if (Shift < -31) Shift = -31;
+    if (Shift > 0) return (q31)(((i64)X + (1ll << (Shift - 1))) >> Shift);
+    return DSPQ31Saturate((i64)X * ((i64)1 << -Shift));
+}
+
+//
+// Conversions
+//
+
+internal inline q15 DSPQ15FromQ31(q31 X) { return DSPQ15Saturate((i32)(((i64)X + (1 << 15)) >> 16)); }
+internal inline q31 DSPQ31FromQ15(q15 X) { return (q31)X * (1 << 16); }
+internal inline f32 DSPF32FromQ15(q15 X) { return (f32)X * (1.0f / 32768.0f); }
+internal inline f32 DSPF32FromQ31(q31 X) { return (f32)X * (1.0f / 2147483648.0f); }
+
+internal inline q15
+DSPQ15FromF32(f32 X)
+{
+    f32 Scaled = X * 32768.0f;
+    Scaled = (Scaled > 32767.0f) ? 32767.0f : (Scaled < -32768.0f) ? -32768.0f : Scaled;
+    return (q15)lrintf(Scaled);
+}
+
+internal inline q31
+DSPQ31FromF32(f32 X)
+{
+    return DSPQ31Saturate(llrint((f64)X * 2147483648.0));
+}
+
+// Cycles to the u32 phase, wrapping, so a negative step comes out as one.
+internal inline u32
+DSPFixedPhaseFromCycles(f32 Cycles)
+{
+    return (u32)(i64)llrint((f64)Cycles * 4294967296.0);
+}
+
+// The phase step for Frequency in Q16 Hz (Hz * 65536) at SampleRate.
+internal inline u32
+DSPFixedPhaseStep(u32 FrequencyQ16, u32 SampleRate)
+{
+    return (u32)(((u64)FrequencyQ16 << 16) / SampleRate);
+}
+
+//
+// Table setup, integers only
+//
+
+// sin(pi/2 * y) = sum(C[k] * y^(2k+1)), Taylor, Q30. Over a quarter cycle
+// in y = [0, 1] the powers don't grow, so rounding the coefficients costs a
+// couple of Q31 LSBs.
+global const i64 DSPFixedSinCoefficients[8] = {1686629713, -693598668, 85569306, -5026995,
+                                               172272, -3864, 61, -1};
+
+// The accurate sine the tables and fft_fixed.h's twiddles come from, within
+// a few LSBs. Slow next to DSPFixedSineWave.
+internal q31
+DSPFixedSinPrecise(u32 Phase)
+{
+    u32 Quadrant = Phase >> 30;
+    i64 Y = Phase & 0x3FFFFFFF;
+    if (Quadrant & 1) Y = (1 << 30) - Y;
+    i64 Y2 = (Y*Y + (1 << 29)) >> 30;
+    i64 Sum = DSPFixedSinCoefficients[7];
+    for (i32 Index = 6; Index >= 0; Index--)
+    {
+        Sum = DSPFixedSinCoefficients[Index] + ((Sum*Y2 + (1 << 29)) >> 30);
+    }
+    Sum = (Sum*Y + (1 << 29)) >> 30;
+    return DSPQ31Saturate((Quadrant & 2) ? -2*Sum : 2*Sum);
+}
+
+// log2(X) for X >= 1, both Q30 in an i64, a bit at a time by squaring.
+internal i64
+DSPFixedLog2(i64 X)
+{
+    i64 Result = 0;
+    while (X >= (2ll << 30))
+    {
+        X >>= 1;
+        Result += 1ll << 30;
+    }
+    for (i32 Bit = 29; Bit >= 0; Bit--)
+    {
+        X = (X*X + (1 << 29)) >> 30;
+        if (X >= (2ll << 30))
+        {
+            X >>= 1;
+            Result += 1ll << Bit;
+        }
+    }
+    return Result;
+}
+
+global bool DSPFixedTablesFilled;
+
+// Fills the tables, the first time it's called; call it before the first
+// sine or rounded square.
+internal void
+DSPFixedInit(void)
+{
+    if (DSPFixedTablesFilled) return;
+    u32 SineSize = 1u << DSP_FIXED_SINE_BITS;
+    for (u32 Index = 0; Index <= SineSize; Index++)
+    {
+        DSPFixedSineTable[Index] = DSPFixedSinPrecise(Index << (32 - DSP_FIXED_SINE_BITS));
+    }
+
+    // tanh(x) = (1 - e^-2x) / (1 + e^-2x), with e^-2x stepped along by
+    // e^(-2/128) = e^(-1/64) in Q30.
+    i64 Decay = 1057095000;
+    i64 Exp = 1ll << 30;
+    for (u32 Index = 0; Index <= DSP_FIXED_TANH_SIZE; Index++)
+    {
+        DSPFixedTanhTable[Index] = DSPQ31Saturate((((1ll << 30) - Exp) << 31) / ((1ll << 30) + Exp));
+        Exp = (Exp*Decay + (1 << 29)) >> 30;
+    }
+
+    // Drive = S ln(S) / 2 with S = 8 Shape + 2: the rounded square is
+    // 2 / (S^(S sin) + 1) - 1 = -tanh(Drive * sin).
+    i64 Ln2 = 744261118;
+    for (u32 Index = 0; Index <= DSP_FIXED_DRIVE_SIZE; Index++)
+    {
+        i64 S = (2ll << 30) + (((i64)Index << 33) / DSP_FIXED_DRIVE_SIZE);
+        i64 SLog2S = ((S >> 4) * DSPFixedLog2(S) + (1 << 29)) >> 30;  // Q26, to fit.
+        DSPFixedDriveTable[Index] = (q31)((SLog2S * Ln2 + (1 << 30)) >> 31);
+    }
+    DSPFixedTablesFilled = true;
+}
+
+//
+// Oscillators, Q31
+//
+
+// dsp_oscillator.h's DSPPolyBlep on the integer phase. Step has to be below
+// half a cycle; a negative one gets no correction, as there.
+internal q31
+DSPFixedPolyBlep(u32 Phase, u32 Step)
+{
+    if ((i32)Step <= 0) return 0;
+    if (Phase < Step)
+    {
+        u64 Rest = (1ull << 31) - (((u64)Phase << 31) / Step);
+        return (q31)-(i64)((Rest*Rest + (1ull << 30)) >> 31);
+    }
+    u32 ToWrap = 0u - Phase;
+    if (ToWrap < Step)
+    {
+        u64 Rest = (1ull << 31) - (((u64)ToWrap << 31) / Step);
+        return (q31)((Rest*Rest + (1ull << 30)) >> 31);
+    }
+    return 0;
+}
+
+// Linear interpolation in DSPFixedSineTable.
+internal q31
+DSPFixedSineWave(u32 Phase)
+{
+    u32 Index = Phase >> (32 - DSP_FIXED_SINE_BITS);
+    i64 Fraction = (Phase >> (16 - DSP_FIXED_SINE_BITS)) & 0xFFFF;
+    i64 A = DSPFixedSineTable[Index];
+    i64 B = DSPFixedSineTable[Index + 1];
+    return (q31)(A + (((B - A)*Fraction + (1 << 15)) >> 16));
+}
+
+internal q31
+DSPFixedSawWave(u32 Phase, u32 Step)
+{
+    i64 Sample = (i32)(Phase - 0x80000000u);
+    return DSPQ31Saturate(Sample - DSPFixedPolyBlep(Phase, Step));
+}
+
+// Not band-limited. Folding the second half over the first with the sign
+// bit makes it branch free.
+internal q31
+DSPFixedTriangleWave(u32 Phase)
+{
+    u32 Folded = Phase ^ (u32)((i32)Phase >> 31);
+    return (q31)((Folded << 1) - 0x80000000u);
+}
+
+// High for Duty (a phase) of the cycle.
+internal q31
+DSPFixedSquareWave(u32 Phase, u32 Step, u32 Duty)
+{
+    i64 Sample = (Phase < Duty) ? DSP_Q31_MAX : DSP_Q31_MIN;
+    Sample += DSPFixedPolyBlep(Phase, Step);
+    Sample -= DSPFixedPolyBlep(Phase - Duty, Step);
+    return DSPQ31Saturate(Sample);
+}
+
+// The drive for DSPFixedRoundedSquareWave from its Shape in [0, 1], Q26.
+// Cheap, but worth keeping for as long as the shape stays put.
+internal q31
+DSPFixedRoundedSquareDrive(q31 Shape)
+{
+    if (Shape < 0) Shape = 0;
+    u32 Index = (u32)Shape >> 23;
+    i64 Fraction = Shape & ((1 << 23) - 1);
+    i64 A = DSPFixedDriveTable[Index];
+    i64 B = DSPFixedDriveTable[Index + 1];
+    return (q31)(A + (((B - A)*Fraction + (1 << 22)) >> 23));
+}
+
+internal q31
+DSPFixedRoundedSquareWave(u32 Phase, q31 Drive)
+{
+    i64 Argument = ((i64)Drive * DSPFixedSineWave(Phase)) >> 31;  // Q26.
+    i64 Magnitude = (Argument < 0) ? -Argument : Argument;
+    u32 Index = (u32)(Magnitude >> 19);
+    i64 Tanh = DSP_Q31_MAX;
+    if (Index < DSP_FIXED_TANH_SIZE)
+    {
+        i64 Fraction = Magnitude & ((1 << 19) - 1);
+        i64 A = DSPFixedTanhTable[Index];
+        i64 B = DSPFixedTanhTable[Index + 1];
+        Tanh = A + (((B - A)*Fraction + (1 << 18)) >> 19);
+    }
+    return (q31)((Argument > 0) ? -Tanh : Tanh);
+}
+
+//
+// Build-time format
+//
+
+#if DSP_FIXED == 15
+typedef q15 dsp_fixed;
+#define DSP_FIXED_NAME "Q15"
+#define DSPFixedFromQ31(X) DSPQ15FromQ31(X)
+#define DSPF32FromFixed(X) DSPF32FromQ15(X)
+#define DSPFixedFromF32(X) DSPQ15FromF32(X)
+#elif DSP_FIXED == 31
+typedef q31 dsp_fixed;
+#define DSP_FIXED_NAME "Q31"
+#define DSPFixedFromQ31(X) (X)
+#define DSPF32FromFixed(X) DSPF32FromQ31(X)
+#define DSPFixedFromF32(X) DSPQ31FromF32(X)
+#elif DSP_FIXED != 0
+#error "DSP_FIXED is 0 (float), 15 or 31"
+#endif
+
+#endif //DSP_FIXED_H
@@ -0,0 +1,44 @@
+/* date = October 18th 2026 */
+
+#ifndef DSP_MATH_H
+#define DSP_MATH_H
+
+// Scalar conversions shared by the apps: pitch ratios, decibels, phase
+// wrapping. The approximations are in dsp_simd_math.h.
+
+#define DSP_PI 3.14159265358979323846
+#define DSP_TAU 6.28318530717958647692
+
+// Fractional part, for phases counted in cycles: the result is in [0, 1).
+internal inline f32
+DSPWrapCycles(f32 Phase)
+{
+    return Phase - floorf(Phase);
+}
+
+internal inline f32
+DSPRatioFromSemitones(f32 Semitones)
+{
+    return powf(2.f, Semitones/12.f);
+}
+
+internal inline f32
+DSPSemitonesFromRatio(f32 Ratio)
+{
+    return 12.f * Log2f(Ratio);
+}
+
+// Amplitude ratios; 0 gives -inf.
+internal inline f32
+DSPDecibelsFromAmplitude(f32 Amplitude)
+{
+    return 20.0f * log10f(Amplitude);
+}
+
+internal inline f32
+DSPAmplitudeFromDecibels(f32 Decibels)
+{
+    return powf(10.0f, Decibels / 20.0f);
+}
+
+#endif //DSP_MATH_H
@@ -0,0 +1,91 @@
+/* date = October 18th 2026 */
+
+#ifndef DSP_OSCILLATOR_H
+#define DSP_OSCILLATOR_H
+
+// Oscillator shapes over a phase counted in cycles, [0, 1), and the phase
+// accumulator that drives them. Step is the phase advance per sample
+// (frequency over sample rate); the shapes with corners use it to round them
+// off with a polynomial band-limited step (PolyBLEP), so they alias far less
+// than the naive ones. The synth's wave shapes are these. The sine and the
+// rounded square use dsp_simd_math's fast tier, about 1e-4 off at worst.
+//
+// Needs dsp_math.h and dsp_simd_math.h.
+
+// Adds Step and wraps back into [0, 1); |Step| has to be below 1.
+internal inline void
+DSPAdvancePhase(f32 *Phase, f32 Step)
+{
+    *Phase = *Phase + Step;
+    if (*Phase < 0.0f)
+        *Phase += 1.0f;
+    if (*Phase >= 1.0f)
+        *Phase -= 1.0f;
+}
+
+// Correction for a unit step at phase 0, spread over the sample on either
+// side of it.
+internal f32
+DSPPolyBlep(f32 Phase, f32 Step)
+{
+    if (Phase < Step)
+    {
+        Phase /= Step;
+        return (Phase+Phase) - (Phase*Phase) - 1.0f;
+    }
+    else if (Phase > 1.0f - Step)
+    {
+        Phase = (Phase - 1.0f) / Step;
+        return (Phase*Phase) + (Phase+Phase) + 1.0f;
+    }
+    else return 0.0f;
+}
+
+internal f32
+DSPSineWave(f32 Phase)
+{
+    return DSPSinCycles(Phase, DSPMathTier_Fast);
+}
+
+internal f32
+DSPSawWave(f32 Phase, f32 Step)
+{
+    f32 Sample = (Phase * 2.0f) - 1.0f;
+    Sample -= DSPPolyBlep(Phase, Step);
+    return Sample;
+}
+
+// Not band-limited.
+internal f32
+DSPTriangleWave(f32 Phase)
+{
+    if (Phase < 0.5f)
+        return (Phase * 4.0f) - 1.0f;
+    else
+        return (Phase * -4.0f) + 3.0f;
+}
+
+// High for Duty of the cycle.
+internal f32
+DSPSquareWave(f32 Phase, f32 Step, f32 Duty)
+{
+    f32 Sample = (Phase < Duty) ? 1.0f : -1.0f;
+    f32 FallPhase = Phase + (1.f - Duty);
+    if (FallPhase >= 1.0f) FallPhase -= 1.0f;
+    Sample += DSPPolyBlep(Phase, Step);
+    Sample -= DSPPolyBlep(FallPhase, Step);
+    return Sample;
+}
+
+// A logistic squashed sine: Shape 0 is close to a sine, 1 close to a square.
+internal f32
+DSPRoundedSquareWave(f32 Phase, f32 Shape)
+{
+    f32 S = (Shape * 8.f) + 2.f;
+    f32 Base = (f32)fabs(S);
+    f32 Power = S * DSPSinCycles(Phase, DSPMathTier_Fast);
+    f32 Denominator = DSPPow(Base, Power, DSPMathTier_Fast) + 1.f;
+    return (2.f / Denominator) - 1.f;
+}
+
+#endif //DSP_OSCILLATOR_H
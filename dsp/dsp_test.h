@@ -0,0 +1,140 @@
+/* date = October 18th 2026 */
+
+#ifndef DSP_TEST_H
+#define DSP_TEST_H
+
+// What dsp_check and the benchmarks measure the core against, so every
+// transform is checked the same way:
+//
+//   DSPTestSignal  tones at 4 and 37 cycles per Period samples plus a little
+//                  noise, within +-0.6, the same bits every time. Real, or
+//                  complex with the tones turning one way and different
+//                  noise on the imaginary part.
+//   DSPTestDFT     one bin of the DTFT, sum(x[n] * e^(-2*pi*i*f*n)), of real or
+//                  complex samples at any f in cycles per sample, all in double
+//                  so it can stand in for fixed point inputs too.
+//   dsp_test_error the largest difference from a reference, relative to the
+//                  reference's largest magnitude (vectors compare by distance,
+//                  so a bin counts once). DSPTestRelativeError measures two
+//                  arrays of samples this way, and DSPTestSpectrumError a
+//                  spectrum against DSPTestDFT.
+//
+// Needs fft.h (for complex32).
+
+typedef struct dsp_test_error
+{
+    f64 Error;
+    f64 Peak;
+} dsp_test_error;
+
+// Uniform in [-0.5, 0.5) from a hash of Index. RandomF32 keeps state between
+// calls, which would make the signal depend on whatever ran before it.
+internal f32
+DSPTestNoise(u32 Index)
+{
+    u32 Hash = Index;
+    Hash ^= Hash >> 16;
+    Hash *= 0x7feb352du;
+    Hash ^= Hash >> 15;
+    Hash *= 0x846ca68bu;
+    Hash ^= Hash >> 16;
+    return (f32)(Hash / 4294967296.0) - 0.5f;
+}
+
+// Fills whichever of Samples and Complex isn't 0.
+internal void
+DSPTestSignal(f32 *Samples, complex32 *Complex, u32 Count, u32 Period)
+{
+    for (u32 N = 0; N < Count; N++)
+    {
+        f32 T = (f32)N / Period;
+        f32 Noise = 0.25f*DSPTestNoise(N);
+        f32 Re = (sinf((f32)FFT_TAU * 4 * T) + 0.5f*sinf((f32)FFT_TAU * 37 * T) + Noise) / 3;
+        if (Samples) Samples[N] = Re;
+        if (Complex)
+        {
+            Complex[N].Re = Re;
+            Complex[N].Im = (-cosf((f32)FFT_TAU * 4 * T) - 0.5f*cosf((f32)FFT_TAU * 37 * T) +
+                             0.25f*DSPTestNoise(N + Count)) / 3;
+        }
+    }
+}
+
+// Count samples (Im 0 for real ones) at Freq cycles per sample, in double. A
+// bin k of an N-point DFT is Freq k/N.
+internal void
+DSPTestDFT(f64 *Re, f64 *Im, u32 Count, f64 Freq, f64 *OutRe, f64 *OutIm)
+{
+    f64 SumRe = 0;
+    f64 SumIm = 0;
+    for (u32 N = 0; N < Count; N++)
+    {
+        f64 Theta = FFT_TAU * fmod(Freq * N, 1.0);
+        f64 InputIm = Im ? Im[N] : 0;
+        SumRe += Re[N]*cos(Theta) + InputIm*sin(Theta);
+        SumIm += InputIm*cos(Theta) - Re[N]*sin(Theta);
+    }
+    *OutRe = SumRe;
+    *OutIm = SumIm;
+}
+
+internal void
+DSPTestErrorAdd(dsp_test_error *Error, f64 Re, f64 Im, f64 ReferenceRe, f64 ReferenceIm)
+{
+    Error->Error = fmax(Error->Error, hypot(Re - ReferenceRe, Im - ReferenceIm));
+    Error->Peak = fmax(Error->Peak, hypot(ReferenceRe, ReferenceIm));
+}
+
+internal f64
+DSPTestErrorRelative(dsp_test_error Error)
+{
+    return (Error.Peak > 0) ? Error.Error / Error.Peak : Error.Error;
+}
+
+internal f64
+DSPTestRelativeError(f32 *Values, f32 *Reference, usize Count)
+{
+    dsp_test_error Error = {0};
+    for (usize Index = 0; Index < Count; Index++) DSPTestErrorAdd(&Error, Values[Index], 0, Reference[Index], 0);
+    return DSPTestErrorRelative(Error);
+}
+
+// Spectrum's first BinCount bins against a direct DFT of Size real Samples or
+// complex Input (the other 0), over up to CheckedBins of them spread across it
+// and its loudest one, so the peak the error is relative to is a real one.
+internal f64
+DSPTestSpectrumError(complex32 *Spectrum, u32 BinCount, f32 *Samples, complex32 *Input, u32 Size, u32 CheckedBins)
+{
+    f64 *Re = (f64 *)malloc(Size * sizeof(f64));
+    f64 *Im = Input ? (f64 *)malloc(Size * sizeof(f64)) : 0;
+    for (u32 N = 0; N < Size; N++)
+    {
+        Re[N] = Samples ? Samples[N] : Input[N].Re;
+        if (Im) Im[N] = Input[N].Im;
+    }
+
+    u32 Loudest = 0;
+    for (u32 K = 1; K < BinCount; K++)
+    {
+        if (hypotf(Spectrum[K].Re, Spectrum[K].Im) > hypotf(Spectrum[Loudest].Re, Spectrum[Loudest].Im)) Loudest = K;
+    }
+
+    dsp_test_error Error = {0};
+    u32 Step = (BinCount > CheckedBins) ? BinCount / CheckedBins : 1;
+    for (u32 K = 0; K < BinCount; K += Step)
+    {
+        f64 BinRe, BinIm;
+        DSPTestDFT(Re, Im, Size, (f64)K / Size, &BinRe, &BinIm);
+        DSPTestErrorAdd(&Error, Spectrum[K].Re, Spectrum[K].Im, BinRe, BinIm);
+        if (K < Loudest && K + Step > Loudest)
+        {
+            DSPTestDFT(Re, Im, Size, (f64)Loudest / Size, &BinRe, &BinIm);
+            DSPTestErrorAdd(&Error, Spectrum[Loudest].Re, Spectrum[Loudest].Im, BinRe, BinIm);
+        }
+    }
+    free(Im);
+    free(Re);
+    return DSPTestErrorRelative(Error);
+}
+
+#endif //DSP_TEST_H
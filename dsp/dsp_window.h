@@ -0,0 +1,62 @@
+/* date = October 18th 2026 */
+
+#ifndef DSP_WINDOW_H
+#define DSP_WINDOW_H
+
+// Window functions for the STFT, the vocoder and the analysers.
+//
+// Needs dsp_math.h.
+
+typedef enum dsp_window
+{
+    DSPWindow_Rectangular,
+    DSPWindow_Hann,
+    DSPWindow_Hamming,
+    DSPWindow_Blackman,
+    DSPWindow_Count,
+} dsp_window;
+
+internal const char *
+DSPWindowName(dsp_window Value)
+{
+    local_static const char *Names[DSPWindow_Count] = {"rectangular", "hann", "hamming", "blackman"};
+    return ((u32)Value < DSPWindow_Count) ? Names[Value] : "?";
+}
+
+// Periodic windows (the last sample isn't repeated), so hops that divide the
+// window overlap evenly.
+internal void
+DSPFillWindow(f32 *Window, u32 Size, dsp_window Kind)
+{
+    for (u32 N = 0; N < Size; N++)
+    {
+        f64 Phase = DSP_TAU * (f64)N / (f64)Size;
+        switch (Kind)
+        {
+            case DSPWindow_Hann: Window[N] = (f32)(0.5 - 0.5*cos(Phase)); break;
+            case DSPWindow_Hamming: Window[N] = (f32)(0.54 - 0.46*cos(Phase)); break;
+            case DSPWindow_Blackman: Window[N] = (f32)(0.42 - 0.5*cos(Phase) + 0.08*cos(2*Phase)); break;
+            default: Window[N] = 1.0f; break;
+        }
+    }
+}
+
+// Sum of the window over every frame covering a sample, Hop apart, at each
+// of the Hop positions; Power sums the squared window instead. Constant
+// (within Spread, max over min) means frames overlap-add without ripple.
+internal f64
+DSPWindowOverlap(f32 *Window, u32 Size, u32 Hop, bool Power, f64 *Spread)
+{
+    f64 Lowest = 0, Highest = 0;
+    for (u32 Offset = 0; Offset < Hop; Offset++)
+    {
+        f64 Sum = 0;
+        for (u32 N = Offset; N < Size; N += Hop) Sum += Power ? (f64)Window[N]*Window[N] : Window[N];
+        if (Offset == 0 || Sum < Lowest) Lowest = Sum;
+        if (Offset == 0 || Sum > Highest) Highest = Sum;
+    }
+    if (Spread) *Spread = (Lowest > 0) ? Highest / Lowest : 0;
+    return Highest;
+}
+
+#endif //DSP_WINDOW_H
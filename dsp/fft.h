@@ -0,0 +1,231 @@
+/* date = October 18th 2026 */
+
+#ifndef FFT_H
+#define FFT_H
+
+// In-place iterative radix-2 FFT.
+//
+// A plan holds everything that only depends on the size: the bit-reversal
+// permutation and the twiddle factors e^(-2*pi*i*k/Size), computed once in
+// double precision. Transforms then do no transcendental calls at all.
+//
+// Expects dsp_platform.h (both apps' platform headers include it) to be
+// included first.
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define FFT_TAU 6.28318530717958647692
+
+typedef struct complex32
+{
+    f32 Re;
+    f32 Im;
+} complex32;
+
+typedef struct fft_plan
+{
+    u32 Size;
+    u32 Log2Size;
+    u32 *BitReverse;      // Size entries.
+    complex32 *Twiddles;  // Size/2 + 1 entries.
+} fft_plan;
+
+internal bool
+FFTIsPowerOfTwo(u32 Size)
+{
+    return (Size != 0) && ((Size & (Size - 1)) == 0);
+}
+
+// Size must be a power of two. Returns a plan with Size == 0 otherwise.
+internal fft_plan
+FFTCreatePlan(u32 Size)
+{
+    fft_plan Plan = {0};
+    if (!FFTIsPowerOfTwo(Size)) return Plan;
+
+    Plan.Size = Size;
+    while ((1u << Plan.Log2Size) < Size) Plan.Log2Size++;
+    Plan.BitReverse = (u32 *)malloc(Size * sizeof(u32));
+    Plan.Twiddles = (complex32 *)malloc((Size/2 + 1) * sizeof(complex32));
+
+    for (u32 Index = 0; Index < Size; Index++)
+    {
+        u32 Reversed = 0;
+        for (u32 Bit = 0; Bit < Plan.Log2Size; Bit++)
+        {
+            Reversed |= ((Index >> Bit) & 1) << (Plan.Log2Size - 1 - Bit);
+        }
+        Plan.BitReverse[Index] = Reversed;
+    }
+
+    for (u32 K = 0; K < Size/2 + 1; K++)
+    {
+        f64 Theta = FFT_TAU * (f64)K / (f64)Size;
+        Plan.Twiddles[K].Re = (f32)cos(Theta);
+        Plan.Twiddles[K].Im = (f32)-sin(Theta);
+    }
+
+    return Plan;
+}
+
+internal void
+FFTDestroyPlan(fft_plan *Plan)
+{
+    free(Plan->BitReverse);
+    free(Plan->Twiddles);
+    Plan->BitReverse = 0;
+    Plan->Twiddles = 0;
+    Plan->Size = 0;
+}
+
+internal void
+FFTBitReversePermute(fft_plan *Plan, complex32 *Data)
+{
+    for (u32 Index = 0; Index < Plan->Size; Index++)
+    {
+        u32 Reversed = Plan->BitReverse[Index];
+        if (Index < Reversed)
+        {
+            complex32 Temp = Data[Index];
+            Data[Index] = Data[Reversed];
+            Data[Reversed] = Temp;
+        }
+    }
+}
+
+// Decimation in time. Direction is -1 for forward, +1 for inverse; the inverse
+// uses the conjugate twiddles.
+internal void
+FFTTransform(fft_plan *Plan, complex32 *Data, f32 Direction)
+{
+    FFTBitReversePermute(Plan, Data);
+
+    u32 Size = Plan->Size;
+    f32 ImSign = -Direction;
+    for (u32 Half = 1; Half < Size; Half *= 2)
+    {
+        u32 TwiddleStride = Size / (Half * 2);
+        for (u32 Start = 0; Start < Size; Start += Half * 2)
+        {
+            for (u32 K = 0; K < Half; K++)
+            {
+                complex32 W = Plan->Twiddles[K * TwiddleStride];
+                W.Im *= ImSign;
+                complex32 *A = &Data[Start + K];
+                complex32 *B = &Data[Start + K + Half];
+                complex32 T;
+                T.Re = B->Re*W.Re - B->Im*W.Im;
+                T.Im = B->Re*W.Im + B->Im*W.Re;
+                B->Re = A->Re - T.Re;
+                B->Im = A->Im - T.Im;
+                A->Re += T.Re;
+                A->Im += T.Im;
+            }
+        }
+    }
+}
+
+// X[k] = sum(x[n] * e^(-2*pi*i*k*n/Size)), in place.
+internal void
+FFTForward(fft_plan *Plan, complex32 *Data)
+{
+    FFTTransform(Plan, Data, -1.0f);
+}
+
+// Undoes FFTForward, including the 1/Size scale.
+internal void
+FFTInverse(fft_plan *Plan, complex32 *Data)
+{
+    FFTTransform(Plan, Data, 1.0f);
+    f32 Scale = 1.0f / (f32)Plan->Size;
+    for (u32 Index = 0; Index < Plan->Size; Index++)
+    {
+        Data[Index].Re *= Scale;
+        Data[Index].Im *= Scale;
+    }
+}
+
+// Packs Count real samples into Data and zero-pads the rest of the plan.
+internal void
+FFTLoadReal(fft_plan *Plan, complex32 *Data, f32 *Samples, u32 Count)
+{
+    for (u32 Index = 0; Index < Plan->Size; Index++)
+    {
+        Data[Index].Re = (Index < Count) ? Samples[Index] : 0.0f;
+        Data[Index].Im = 0.0f;
+    }
+}
+
+internal f32
+ComplexMagnitude(complex32 Value)
+{
+    return sqrtf(Value.Re*Value.Re + Value.Im*Value.Im);
+}
+
+// Radians in (-pi, pi].
+internal f32
+ComplexPhase(complex32 Value)
+{
+    return atan2f(Value.Im, Value.Re);
+}
+
+internal complex32
+ComplexMul(complex32 A, complex32 B)
+{
+    complex32 Result;
+    Result.Re = A.Re*B.Re - A.Im*B.Im;
+    Result.Im = A.Re*B.Im + A.Im*B.Re;
+    return Result;
+}
+
+internal complex32
+ComplexAdd(complex32 A, complex32 B)
+{
+    complex32 Result = {A.Re + B.Re, A.Im + B.Im};
+    return Result;
+}
+
+internal complex32
+ComplexSub(complex32 A, complex32 B)
+{
+    complex32 Result = {A.Re - B.Re, A.Im - B.Im};
+    return Result;
+}
+
+internal complex32
+ComplexScale(complex32 A, f32 Scale)
+{
+    complex32 Result = {A.Re*Scale, A.Im*Scale};
+    return Result;
+}
+
+internal complex32
+ComplexLerp(complex32 A, complex32 B, f32 T)
+{
+    complex32 Result;
+    Result.Re = A.Re + (B.Re - A.Re)*T;
+    Result.Im = A.Im + (B.Im - A.Im)*T;
+    return Result;
+}
+
+internal void
+FFTMagnitudes(complex32 *Spectrum, f32 *Magnitudes, u32 Count)
+{
+    for (u32 Index = 0; Index < Count; Index++)
+    {
+        Magnitudes[Index] = ComplexMagnitude(Spectrum[Index]);
+    }
+}
+
+internal void
+FFTPhases(complex32 *Spectrum, f32 *Phases, u32 Count)
+{
+    for (u32 Index = 0; Index < Count; Index++)
+    {
+        Phases[Index] = ComplexPhase(Spectrum[Index]);
+    }
+}
+
+#endif //FFT_H
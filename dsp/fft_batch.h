@@ -0,0 +1,394 @@
+/* date = October 18th 2026 */
+
+#ifndef FFT_BATCH_H
+#define FFT_BATCH_H
+
+// Many transforms of one size and direction in one call, e.g. every frame of
+// an STFT over a long file or one frame per channel of a capture.
+//
+//   fft_batch Batch = FFTBatchCreate(&Planner, 1024, FFTType_Real, FFTDirection_Forward,
+//                                    FFTBatch_Auto, WorkCpuCount());
+//   FFTBatchExecuteReal(&Batch, Samples, Hop, Spectra, 513, FrameCount);
+//
+// Frames are strided: frame f starts Stride elements after frame f-1, so
+// they can overlap (real frames at the hop of an unwindowed STFT), have gaps,
+// or sit in a ring. The frames are split into jobs of FFT_BATCH_LANES and
+// the jobs are shared out over the batch's threads (work_queue.h). Within a
+// job, either:
+//
+//   Frames:      each frame runs through the thread's own copy of the plan
+//                the planner picked for the size.
+//   Interleaved: Lanes frames at a time are interleaved into one fft_split.h
+//                batch plan, so every stage runs across frames on full
+//                vectors and reads each twiddle once for all of them.
+//                Power-of-two transforms only.
+//
+// Interleaving only pays while a pass and its work buffers stay in the L1
+// cache: Lanes is picked so a pass is at most FFT_BATCH_PASS_POINTS points,
+// and Auto interleaves when that still leaves FFT_BATCH_MIN_LANES frames, a
+// vector's worth. Bigger frames fill vectors on their own anyway.
+// fft_batch_bench measures both modes against the thread count.
+//
+// Every thread owns its plans and scratch, so a batch can't be executed
+// from two threads at once, same as a plan.
+//
+// Needs fft_planner.h and work_queue.h.
+
+#define FFT_BATCH_LANES 16       // frames per job, and the most per interleaved pass.
+#define FFT_BATCH_MIN_LANES 8
+#define FFT_BATCH_PASS_POINTS 2048
+
+typedef enum fft_batch_mode
+{
+    FFTBatch_Auto,
+    FFTBatch_Frames,
+    FFTBatch_Interleaved,
+    FFTBatch_Count,
+} fft_batch_mode;
+
+internal const char *
+FFTBatchModeName(fft_batch_mode Value)
+{
+    local_static const char *Names[FFTBatch_Count] = {"auto", "frames", "interleaved"};
+    return ((u32)Value < FFTBatch_Count) ? Names[Value] : "?";
+}
+
+typedef struct fft_batch_thread
+{
+    planned_fft *Plan;           // this thread's copy; real plans' twiddles too.
+    fft_split_plan Interleaved;  // Lanes frames per pass.
+    f32 *Re;                     // TransformSize * Lanes entries each.
+    f32 *Im;
+    f32 *Zero;                   // TransformSize pairs each, standing in for the
+    f32 *Discard;                // frames of lanes a short pass doesn't use.
+} fft_batch_thread;
+
+typedef struct fft_batch
+{
+    u32 Size;
+    fft_type Type;
+    fft_direction Direction;
+    fft_batch_mode Mode;  // Frames or Interleaved once created.
+    u32 Lanes;            // frames per interleaved pass.
+    bool VectorTranspose; // AVX2 gathers and scatters.
+    u32 ThreadCount;
+    fft_batch_thread Threads[MAX_WORK_THREADS];
+
+    // The call in flight.
+    complex32 *Frames;
+    f32 *Samples;
+    complex32 *Spectra;
+    usize FrameStride;
+    usize SampleStride;
+    usize SpectrumStride;
+    u32 FrameCount;
+} fft_batch;
+
+// Picks the algorithm for the per-thread plans through Planner, so its
+// measurements and wisdom apply. Returns a batch with Size == 0 if the size
+// can't be planned, or if Interleaved is asked for a size it can't run.
+internal fft_batch
+FFTBatchCreate(fft_planner *Planner, u32 Size, fft_type Type, fft_direction Direction,
+               fft_batch_mode Mode, u32 ThreadCount)
+{
+    fft_batch Batch = {0};
+    planned_fft *Model = FFTPlan(Planner, Size, Type, Direction);
+    if (!Model) return Batch;
+    u32 TransformSize = Model->TransformSize;
+    bool CanInterleave = FFTIsPowerOfTwo(TransformSize) && TransformSize >= 2;
+    u32 Lanes = FFT_BATCH_LANES;
+    while (Lanes > 1 && TransformSize * Lanes > FFT_BATCH_PASS_POINTS) Lanes /= 2;
+    if (Mode == FFTBatch_Auto)
+    {
+        Mode = (CanInterleave && Lanes >= FFT_BATCH_MIN_LANES) ? FFTBatch_Interleaved : FFTBatch_Frames;
+    }
+    if (Mode == FFTBatch_Interleaved && !CanInterleave) return Batch;
+
+    if (ThreadCount == 0) ThreadCount = 1;
+    if (ThreadCount > MAX_WORK_THREADS) ThreadCount = MAX_WORK_THREADS;
+    Batch.Size = Size;
+    Batch.Type = Type;
+    Batch.Direction = Direction;
+    Batch.Mode = Mode;
+    Batch.Lanes = Lanes;
+#if FFT_SIMD
+    Batch.VectorTranspose = (Lanes % 8 == 0 && TransformSize % 4 == 0 && FFTKernelSupported(FFTKernel_AVX2));
+#endif
+    Batch.ThreadCount = ThreadCount;
+    for (u32 Index = 0; Index < ThreadCount; Index++)
+    {
+        fft_batch_thread *Thread = &Batch.Threads[Index];
+        Thread->Plan = FFTCreatePlannedFFT(Size, Type, Direction, Model->Algorithm);
+        if (Mode == FFTBatch_Interleaved)
+        {
+            Thread->Interleaved = FFTSplitCreateBatchPlan(TransformSize, Lanes);
+            Thread->Re = (f32 *)malloc((usize)TransformSize * Lanes * sizeof(f32));
+            Thread->Im = (f32 *)malloc((usize)TransformSize * Lanes * sizeof(f32));
+            Thread->Zero = (f32 *)calloc(2 * TransformSize, sizeof(f32));
+            Thread->Discard = (f32 *)malloc(2 * TransformSize * sizeof(f32));
+        }
+    }
+    return Batch;
+}
+
+internal void
+FFTBatchDestroy(fft_batch *Batch)
+{
+    for (u32 Index = 0; Index < Batch->ThreadCount; Index++)
+    {
+        fft_batch_thread *Thread = &Batch->Threads[Index];
+        FFTDestroyPlannedFFT(Thread->Plan);
+        if (Thread->Interleaved.Size) FFTSplitDestroyPlan(&Thread->Interleaved);
+        free(Thread->Re);
+        free(Thread->Im);
+        free(Thread->Zero);
+        free(Thread->Discard);
+    }
+    Batch->ThreadCount = 0;
+    Batch->Size = 0;
+}
+
+// Interleaving works on pairs of floats, which complex frames, even/odd real
+// samples and half-spectra all are: pair n of lane l, Pairs[l][2n] and
+// Pairs[l][2n + 1], goes to Re[n*Lanes + l] and Im[n*Lanes + l].
+internal void
+FFTBatchGatherScalar(f32 **Pairs, u32 Lanes, u32 Count, f32 *Re, f32 *Im)
+{
+    for (u32 N = 0; N < Count; N++, Re += Lanes, Im += Lanes)
+    {
+        for (u32 Lane = 0; Lane < Lanes; Lane++)
+        {
+            Re[Lane] = Pairs[Lane][2*N];
+            Im[Lane] = Pairs[Lane][2*N + 1];
+        }
+    }
+}
+
+internal void
+FFTBatchScatterScalar(f32 **Pairs, u32 Lanes, u32 Count, f32 *Re, f32 *Im)
+{
+    for (u32 N = 0; N < Count; N++, Re += Lanes, Im += Lanes)
+    {
+        for (u32 Lane = 0; Lane < Lanes; Lane++)
+        {
+            Pairs[Lane][2*N] = Re[Lane];
+            Pairs[Lane][2*N + 1] = Im[Lane];
+        }
+    }
+}
+
+#if FFT_SIMD
+FFT_TARGET_AVX2 internal void
+FFTBatchTranspose8(__m256 *R)
+{
+    __m256 T0 = _mm256_unpacklo_ps(R[0], R[1]);
+    __m256 T1 = _mm256_unpackhi_ps(R[0], R[1]);
+    __m256 T2 = _mm256_unpacklo_ps(R[2], R[3]);
+    __m256 T3 = _mm256_unpackhi_ps(R[2], R[3]);
+    __m256 T4 = _mm256_unpacklo_ps(R[4], R[5]);
+    __m256 T5 = _mm256_unpackhi_ps(R[4], R[5]);
+    __m256 T6 = _mm256_unpacklo_ps(R[6], R[7]);
+    __m256 T7 = _mm256_unpackhi_ps(R[6], R[7]);
+    __m256 U0 = _mm256_shuffle_ps(T0, T2, 0x44);
+    __m256 U1 = _mm256_shuffle_ps(T0, T2, 0xEE);
+    __m256 U2 = _mm256_shuffle_ps(T1, T3, 0x44);
+    __m256 U3 = _mm256_shuffle_ps(T1, T3, 0xEE);
+    __m256 U4 = _mm256_shuffle_ps(T4, T6, 0x44);
+    __m256 U5 = _mm256_shuffle_ps(T4, T6, 0xEE);
+    __m256 U6 = _mm256_shuffle_ps(T5, T7, 0x44);
+    __m256 U7 = _mm256_shuffle_ps(T5, T7, 0xEE);
+    R[0] = _mm256_permute2f128_ps(U0, U4, 0x20);
+    R[1] = _mm256_permute2f128_ps(U1, U5, 0x20);
+    R[2] = _mm256_permute2f128_ps(U2, U6, 0x20);
+    R[3] = _mm256_permute2f128_ps(U3, U7, 0x20);
+    R[4] = _mm256_permute2f128_ps(U0, U4, 0x31);
+    R[5] = _mm256_permute2f128_ps(U1, U5, 0x31);
+    R[6] = _mm256_permute2f128_ps(U2, U6, 0x31);
+    R[7] = _mm256_permute2f128_ps(U3, U7, 0x31);
+}
+
+// 8 lanes by 4 pairs at a time: each lane's 4 pairs are a row of an 8x8
+// transpose, whose columns are then alternately Re and Im rows. Lanes must be
+// a multiple of 8 and Count of 4.
+FFT_TARGET_AVX2 internal void
+FFTBatchGatherAVX2(f32 **Pairs, u32 Lanes, u32 Count, f32 *Re, f32 *Im)
+{
+    for (u32 Group = 0; Group < Lanes; Group += 8)
+    {
+        for (u32 N = 0; N < Count; N += 4)
+        {
+            __m256 R[8];
+            for (u32 Row = 0; Row < 8; Row++) R[Row] = _mm256_loadu_ps(Pairs[Group + Row] + 2*N);
+            FFTBatchTranspose8(R);
+            for (u32 K = 0; K < 4; K++)
+            {
+                _mm256_storeu_ps(Re + (N + K)*Lanes + Group, R[2*K]);
+                _mm256_storeu_ps(Im + (N + K)*Lanes + Group, R[2*K + 1]);
+            }
+        }
+    }
+}
+
+FFT_TARGET_AVX2 internal void
+FFTBatchScatterAVX2(f32 **Pairs, u32 Lanes, u32 Count, f32 *Re, f32 *Im)
+{
+    for (u32 Group = 0; Group < Lanes; Group += 8)
+    {
+        for (u32 N = 0; N < Count; N += 4)
+        {
+            __m256 R[8];
+            for (u32 K = 0; K < 4; K++)
+            {
+                R[2*K] = _mm256_loadu_ps(Re + (N + K)*Lanes + Group);
+                R[2*K + 1] = _mm256_loadu_ps(Im + (N + K)*Lanes + Group);
+            }
+            FFTBatchTranspose8(R);
+            for (u32 Row = 0; Row < 8; Row++) _mm256_storeu_ps(Pairs[Group + Row] + 2*N, R[Row]);
+        }
+    }
+}
+#endif // FFT_SIMD
+
+// Interleaves the lanes' pairs into the thread's Re and Im, runs the batch
+// plan over them and writes them back out to Outputs, which can be Inputs.
+internal void
+FFTBatchRunInterleaved(fft_batch *Batch, fft_batch_thread *Thread, f32 **Inputs, f32 **Outputs)
+{
+    u32 Count = Thread->Interleaved.Size;
+#if FFT_SIMD
+    if (Batch->VectorTranspose) FFTBatchGatherAVX2(Inputs, Batch->Lanes, Count, Thread->Re, Thread->Im);
+    else
+#endif
+    FFTBatchGatherScalar(Inputs, Batch->Lanes, Count, Thread->Re, Thread->Im);
+
+    if (Batch->Direction == FFTDirection_Forward) FFTSplitForward(&Thread->Interleaved, Thread->Re, Thread->Im);
+    else FFTSplitInverse(&Thread->Interleaved, Thread->Re, Thread->Im);
+
+#if FFT_SIMD
+    if (Batch->VectorTranspose) FFTBatchScatterAVX2(Outputs, Batch->Lanes, Count, Thread->Re, Thread->Im);
+    else
+#endif
+    FFTBatchScatterScalar(Outputs, Batch->Lanes, Count, Thread->Re, Thread->Im);
+}
+
+// One interleaved pass over frames First .. First+Count-1, Count <= Lanes.
+// Real plans run the twiddle passes per frame on either side.
+internal void
+FFTBatchPass(fft_batch *Batch, fft_batch_thread *Thread, u32 First, u32 Count)
+{
+    f32 *Inputs[FFT_BATCH_LANES];
+    f32 *Outputs[FFT_BATCH_LANES];
+    for (u32 Lane = 0; Lane < Batch->Lanes; Lane++)
+    {
+        Inputs[Lane] = Thread->Zero;
+        Outputs[Lane] = Thread->Discard;
+    }
+
+    for (u32 Lane = 0; Lane < Count; Lane++)
+    {
+        u32 Frame = First + Lane;
+        if (Batch->Type == FFTType_Complex)
+        {
+            Inputs[Lane] = Outputs[Lane] = (f32 *)(Batch->Frames + Frame*Batch->FrameStride);
+            continue;
+        }
+        f32 *Samples = Batch->Samples + Frame*Batch->SampleStride;
+        complex32 *Spectrum = Batch->Spectra + Frame*Batch->SpectrumStride;
+        if (Batch->Direction == FFTDirection_Forward)
+        {
+            Inputs[Lane] = Samples;
+            Outputs[Lane] = (f32 *)Spectrum;
+        }
+        else
+        {
+            RealFFTPreTwiddle(&Thread->Plan->Real, Spectrum);
+            Inputs[Lane] = (f32 *)Spectrum;
+            Outputs[Lane] = Samples;
+        }
+    }
+
+    FFTBatchRunInterleaved(Batch, Thread, Inputs, Outputs);
+
+    if (Batch->Type == FFTType_Real && Batch->Direction == FFTDirection_Forward)
+    {
+        for (u32 Lane = 0; Lane < Count; Lane++)
+        {
+            RealFFTPostTwiddle(&Thread->Plan->Real, (complex32 *)Outputs[Lane]);
+        }
+    }
+}
+
+// Frames First .. First+Count-1 on one thread, a pass of Lanes at a time or
+// one by one through the thread's plan.
+internal void
+FFTBatchFrames(fft_batch *Batch, fft_batch_thread *Thread, u32 First, u32 Count)
+{
+    bool Complex = (Batch->Type == FFTType_Complex);
+    if (Batch->Mode == FFTBatch_Interleaved)
+    {
+        for (u32 Pass = First; Pass < First + Count; Pass += Batch->Lanes)
+        {
+            u32 PassCount = First + Count - Pass;
+            if (PassCount > Batch->Lanes) PassCount = Batch->Lanes;
+            FFTBatchPass(Batch, Thread, Pass, PassCount);
+        }
+        return;
+    }
+    for (u32 Frame = First; Frame < First + Count; Frame++)
+    {
+        if (Complex)
+        {
+            FFTExecuteComplex(Thread->Plan, Batch->Frames + Frame*Batch->FrameStride);
+        }
+        else
+        {
+            FFTExecuteReal(Thread->Plan, Batch->Samples + Frame*Batch->SampleStride,
+                           Batch->Spectra + Frame*Batch->SpectrumStride);
+        }
+    }
+}
+
+// work_proc: one job is FFT_BATCH_LANES frames.
+internal void
+FFTBatchJob(void *Data, u32 Job, u32 Thread)
+{
+    fft_batch *Batch = (fft_batch *)Data;
+    u32 First = Job * FFT_BATCH_LANES;
+    u32 Count = Batch->FrameCount - First;
+    if (Count > FFT_BATCH_LANES) Count = FFT_BATCH_LANES;
+    FFTBatchFrames(Batch, &Batch->Threads[Thread], First, Count);
+}
+
+internal void
+FFTBatchRun(fft_batch *Batch, u32 FrameCount)
+{
+    Batch->FrameCount = FrameCount;
+    u32 JobCount = (FrameCount + FFT_BATCH_LANES - 1) / FFT_BATCH_LANES;
+    WorkQueueRun(FFTBatchJob, Batch, JobCount, Batch->ThreadCount);
+}
+
+// Complex batches: transforms FrameCount frames of Size points in place,
+// frame f at Frames + f*FrameStride. Frames mustn't overlap.
+internal void
+FFTBatchExecuteComplex(fft_batch *Batch, complex32 *Frames, usize FrameStride, u32 FrameCount)
+{
+    Batch->Frames = Frames;
+    Batch->FrameStride = FrameStride;
+    FFTBatchRun(Batch, FrameCount);
+}
+
+// Real batches: frame f is Samples + f*SampleStride and its Size/2 + 1 bins
+// Spectra + f*SpectrumStride. Forward batches read the samples, which may
+// overlap; inverse ones use the spectra as scratch, as FFTExecuteReal does.
+internal void
+FFTBatchExecuteReal(fft_batch *Batch, f32 *Samples, usize SampleStride,
+                    complex32 *Spectra, usize SpectrumStride, u32 FrameCount)
+{
+    Batch->Samples = Samples;
+    Batch->SampleStride = SampleStride;
+    Batch->Spectra = Spectra;
+    Batch->SpectrumStride = SpectrumStride;
+    FFTBatchRun(Batch, FrameCount);
+}
+
+#endif //FFT_BATCH_H
@@ -0,0 +1,311 @@
+/* date = October 18th 2026 */
+
+#ifndef FFT_FIXED_H
+#define FFT_FIXED_H
+
+// fft.h's in-place radix-2 FFT on Q15 or Q31 complex values, with block
+// floating point scaling.
+//
+// A fixed-point butterfly grows its values by up to 1 + sqrt(2), so
+// something has to give over log2(Size) stages. Scaling every stage by 1/2
+// throws away a bit each time whether it was needed or not; block floating
+// point instead keeps one exponent for the whole block and shifts right
+// before a stage only when the largest value is past the headroom the
+// butterfly needs (2^13 in Q15, 2^29 in Q31), and scales a quiet input up
+// to it first. Quiet signals keep their precision and loud ones can't
+// overflow, so the adds need no saturation. The largest value is tracked by
+// OR-ing magnitudes as the stage writes them, which costs no extra pass.
+//
+// The transforms return the exponent: the true result is Data * 2^Exponent
+// (in units of the Q format). The inverse includes the 1/Size, as fft.h's
+// does. FFTFixedScaleQ15/Q31 apply an exponent with saturation, e.g. to
+// get samples back after the inverse. The twiddles come from
+// DSPFixedSinPrecise, so the whole thing is integer arithmetic and gives the
+// same bits on every compiler. A real signal goes in with Im = 0.
+//
+// Needs fft.h and dsp_fixed.h.
+
+#define FFT_FIXED_Q15_HEADROOM 13
+#define FFT_FIXED_Q31_HEADROOM 29
+
+typedef struct complex_q15
+{
+    q15 Re;
+    q15 Im;
+} complex_q15;
+
+typedef struct complex_q31
+{
+    q31 Re;
+    q31 Im;
+} complex_q31;
+
+typedef struct fft_fixed_plan
+{
+    u32 Size;
+    u32 Log2Size;
+    u32 *BitReverse;             // Size entries.
+    complex_q31 *TwiddlesQ31;    // Size/2 entries, e^(-2*pi*i*k/Size).
+    complex_q15 *TwiddlesQ15;
+} fft_fixed_plan;
+
+// Size must be a power of two. Returns a plan with Size == 0 otherwise.
+internal fft_fixed_plan
+FFTFixedCreatePlan(u32 Size)
+{
+    fft_fixed_plan Plan = {0};
+    if (!FFTIsPowerOfTwo(Size) || Size < 2) return Plan;
+
+    Plan.Size = Size;
+    while ((1u << Plan.Log2Size) < Size) Plan.Log2Size++;
+    Plan.BitReverse = (u32 *)malloc(Size * sizeof(u32));
+    Plan.TwiddlesQ31 = (complex_q31 *)malloc((Size/2) * sizeof(complex_q31));
+    Plan.TwiddlesQ15 = (complex_q15 *)malloc((Size/2) * sizeof(complex_q15));
+
+    for (u32 Index = 0; Index < Size; Index++)
+    {
+        u32 Reversed = 0;
+        for (u32 Bit = 0; Bit < Plan.Log2Size; Bit++)
+        {
+            Reversed |= ((Index >> Bit) & 1) << (Plan.Log2Size - 1 - Bit);
+        }
+        Plan.BitReverse[Index] = Reversed;
+    }
+
+    for (u32 K = 0; K < Size/2; K++)
+    {
+        u32 Phase = K << (32 - Plan.Log2Size);
+        Plan.TwiddlesQ31[K].Re = DSPFixedSinPrecise(Phase + 0x40000000u);
+        Plan.TwiddlesQ31[K].Im = -DSPFixedSinPrecise(Phase);
+        Plan.TwiddlesQ15[K].Re = DSPQ15FromQ31(Plan.TwiddlesQ31[K].Re);
+        Plan.TwiddlesQ15[K].Im = DSPQ15FromQ31(Plan.TwiddlesQ31[K].Im);
+    }
+
+    return Plan;
+}
+
+internal void
+FFTFixedDestroyPlan(fft_fixed_plan *Plan)
+{
+    free(Plan->BitReverse);
+    free(Plan->TwiddlesQ31);
+    free(Plan->TwiddlesQ15);
+    Plan->BitReverse = 0;
+    Plan->TwiddlesQ31 = 0;
+    Plan->TwiddlesQ15 = 0;
+    Plan->Size = 0;
+}
+
+// |X|, or |X| - 1 for a negative X, which is as good for finding the top bit.
+#define mx_FixedMagnitudeBits(X) ((u32)((X) ^ ((X) >> 31)))
+
+// How far to shift a block with magnitude bits Bits right to bring it under
+// 2^Headroom; negative to shift a quiet one left up to 2^(Headroom - 1).
+internal i32
+FFTFixedBlockShift(u32 Bits, u32 Headroom)
+{
+    if (Bits == 0) return 0;
+    i32 TopBit = 31;
+    while (!(Bits & (1u << TopBit))) TopBit--;
+    return TopBit - ((i32)Headroom - 1);
+}
+
+// The block shift, rounding halves to even: rounding them up would add a
+// bias every stage that the later ones sum into one bin, and rounding them
+// away from zero a gain. Odd is 1 when Shift is above 0 and 0 otherwise,
+// and Round then 2^(Shift - 1) - 1.
+#define mx_FixedShiftRound(X, Shift, Round, Odd) (((X) + (Round) + (((X) >> (Shift)) & (Odd))) >> (Shift))
+
+internal i32
+FFTFixedTransformQ15(fft_fixed_plan *Plan, complex_q15 *Data, i32 ImSign)
+{
+    u32 Size = Plan->Size;
+    u32 Bits = 0;
+    for (u32 Index = 0; Index < Size; Index++)
+    {
+        u32 Reversed = Plan->BitReverse[Index];
+        if (Index < Reversed)
+        {
+            complex_q15 Temp = Data[Index];
+            Data[Index] = Data[Reversed];
+            Data[Reversed] = Temp;
+        }
+        Bits |= mx_FixedMagnitudeBits((i32)Data[Index].Re) | mx_FixedMagnitudeBits((i32)Data[Index].Im);
+    }
+
+    i32 Exponent = 0;
+    i32 Shift = FFTFixedBlockShift(Bits, FFT_FIXED_Q15_HEADROOM);
+    if (Shift < 0)
+    {
+        for (u32 Index = 0; Index < Size; Index++)
+        {
+            Data[Index].Re = (q15)(Data[Index].Re * (1 << -Shift));
+            Data[Index].Im = (q15)(Data[Index].Im * (1 << -Shift));
+        }
+        Exponent = Shift;
+        Shift = 0;
+    }
+
+    for (u32 Half = 1; Half < Size; Half *= 2)
+    {
+        if (Half > 1) Shift = FFTFixedBlockShift(Bits, FFT_FIXED_Q15_HEADROOM);
+        if (Shift < 0) Shift = 0;
+        i32 Odd = (Shift > 0);
+        i32 Round = ((1 << Shift) >> 1) - Odd;
+        Exponent += Shift;
+        Bits = 0;
+        u32 TwiddleStride = Size / (Half * 2);
+        for (u32 Start = 0; Start < Size; Start += Half * 2)
+        {
+            for (u32 K = 0; K < Half; K++)
+            {
+                complex_q15 W = Plan->TwiddlesQ15[K * TwiddleStride];
+                i32 WRe = W.Re;
+                i32 WIm = ImSign * W.Im;
+                complex_q15 *A = &Data[Start + K];
+                complex_q15 *B = &Data[Start + K + Half];
+                i32 ARe = mx_FixedShiftRound((i32)A->Re, Shift, Round, Odd);
+                i32 AIm = mx_FixedShiftRound((i32)A->Im, Shift, Round, Odd);
+                i32 BRe = mx_FixedShiftRound((i32)B->Re, Shift, Round, Odd);
+                i32 BIm = mx_FixedShiftRound((i32)B->Im, Shift, Round, Odd);
+                i32 TRe = (BRe*WRe - BIm*WIm + (1 << 14)) >> 15;
+                i32 TIm = (BRe*WIm + BIm*WRe + (1 << 14)) >> 15;
+                A->Re = (q15)(ARe + TRe);
+                A->Im = (q15)(AIm + TIm);
+                B->Re = (q15)(ARe - TRe);
+                B->Im = (q15)(AIm - TIm);
+                Bits |= mx_FixedMagnitudeBits((i32)A->Re) | mx_FixedMagnitudeBits((i32)A->Im) |
+                        mx_FixedMagnitudeBits((i32)B->Re) | mx_FixedMagnitudeBits((i32)B->Im);
+            }
+        }
+    }
+    return Exponent;
+}
+
+internal i32
+FFTFixedTransformQ31(fft_fixed_plan *Plan, complex_q31 *Data, i32 ImSign)
+{
+    u32 Size = Plan->Size;
+    u32 Bits = 0;
+    for (u32 Index = 0; Index < Size; Index++)
+    {
+        u32 Reversed = Plan->BitReverse[Index];
+        if (Index < Reversed)
+        {
+            complex_q31 Temp = Data[Index];
+            Data[Index] = Data[Reversed];
+            Data[Reversed] = Temp;
+        }
+        Bits |= mx_FixedMagnitudeBits(Data[Index].Re) | mx_FixedMagnitudeBits(Data[Index].Im);
+    }
+
+    i32 Exponent = 0;
+    i32 Shift = FFTFixedBlockShift(Bits, FFT_FIXED_Q31_HEADROOM);
+    if (Shift < 0)
+    {
+        for (u32 Index = 0; Index < Size; Index++)
+        {
+            Data[Index].Re = (q31)((i64)Data[Index].Re * (1ll << -Shift));
+            Data[Index].Im = (q31)((i64)Data[Index].Im * (1ll << -Shift));
+        }
+        Exponent = Shift;
+        Shift = 0;
+    }
+
+    for (u32 Half = 1; Half < Size; Half *= 2)
+    {
+        if (Half > 1) Shift = FFTFixedBlockShift(Bits, FFT_FIXED_Q31_HEADROOM);
+        if (Shift < 0) Shift = 0;
+        i64 Odd = (Shift > 0);
+        i64 Round = ((1ll << Shift) >> 1) - Odd;
+        Exponent += Shift;
+        Bits = 0;
+        u32 TwiddleStride = Size / (Half * 2);
+        for (u32 Start = 0; Start < Size; Start += Half * 2)
+        {
+            for (u32 K = 0; K < Half; K++)
+            {
+                complex_q31 W = Plan->TwiddlesQ31[K * TwiddleStride];
+                i64 WRe = W.Re;
+                i64 WIm = ImSign * (i64)W.Im;
+                complex_q31 *A = &Data[Start + K];
+                complex_q31 *B = &Data[Start + K + Half];
+                i64 ARe = mx_FixedShiftRound((i64)A->Re, Shift, Round, Odd);
+                i64 AIm = mx_FixedShiftRound((i64)A->Im, Shift, Round, Odd);
+                i64 BRe = mx_FixedShiftRound((i64)B->Re, Shift, Round, Odd);
+                i64 BIm = mx_FixedShiftRound((i64)B->Im, Shift, Round, Odd);
+                i64 TRe = (BRe*WRe - BIm*WIm + (1ll << 30)) >> 31;
+                i64 TIm = (BRe*WIm + BIm*WRe + (1ll << 30)) >> 31;
+                A->Re = (q31)(ARe + TRe);
+                A->Im = (q31)(AIm + TIm);
+                B->Re = (q31)(ARe - TRe);
+                B->Im = (q31)(AIm - TIm);
+                Bits |= mx_FixedMagnitudeBits(A->Re) | mx_FixedMagnitudeBits(A->Im) |
+                        mx_FixedMagnitudeBits(B->Re) | mx_FixedMagnitudeBits(B->Im);
+            }
+        }
+    }
+    return Exponent;
+}
+
+// X[k] = sum(x[n] * e^(-2*pi*i*k*n/Size)) * 2^-Exponent, in place.
+internal i32
+FFTFixedForwardQ15(fft_fixed_plan *Plan, complex_q15 *Data)
+{
+    return FFTFixedTransformQ15(Plan, Data, 1);
+}
+
+internal i32
+FFTFixedForwardQ31(fft_fixed_plan *Plan, complex_q31 *Data)
+{
+    return FFTFixedTransformQ31(Plan, Data, 1);
+}
+
+// Undoes the forward transform, including the 1/Size scale, which is only
+// the exponent's business; add the forward one to get the input's scale.
+internal i32
+FFTFixedInverseQ15(fft_fixed_plan *Plan, complex_q15 *Data)
+{
+    return FFTFixedTransformQ15(Plan, Data, -1) - (i32)Plan->Log2Size;
+}
+
+internal i32
+FFTFixedInverseQ31(fft_fixed_plan *Plan, complex_q31 *Data)
+{
+    return FFTFixedTransformQ31(Plan, Data, -1) - (i32)Plan->Log2Size;
+}
+
+// Data *= 2^Exponent, rounded and saturated.
+internal void
+FFTFixedScaleQ15(complex_q15 *Data, u32 Count, i32 Exponent)
+{
+    for (u32 Index = 0; Index < Count; Index++)
+    {
+        Data[Index].Re = DSPQ15Saturate(DSPQ31Shift(Data[Index].Re, -Exponent));
+        Data[Index].Im = DSPQ15Saturate(DSPQ31Shift(Data[Index].Im, -Exponent));
+    }
+}
+
+internal void
+FFTFixedScaleQ31(complex_q31 *Data, u32 Count, i32 Exponent)
+{
+    for (u32 Index = 0; Index < Count; Index++)
+    {
+        Data[Index].Re = DSPQ31Shift(Data[Index].Re, -Exponent);
+        Data[Index].Im = DSPQ31Shift(Data[Index].Im, -Exponent);
+    }
+}
+
+#if DSP_FIXED == 15
+typedef complex_q15 complex_fixed;
+#define FFTFixedForward FFTFixedForwardQ15
+#define FFTFixedInverse FFTFixedInverseQ15
+#define FFTFixedScale FFTFixedScaleQ15
+#elif DSP_FIXED == 31
+typedef complex_q31 complex_fixed;
+#define FFTFixedForward FFTFixedForwardQ31
+#define FFTFixedInverse FFTFixedInverseQ31
+#define FFTFixedScale FFTFixedScaleQ31
+#endif
+
+#endif //FFT_FIXED_H
@@ -0,0 +1,433 @@
+/* date = October 18th 2026 */
+
+#ifndef FFT_MIXED_H
+#define FFT_MIXED_H
+
+// FFT of any size: mixed radix 2/3/4/5/7, with Bluestein's algorithm for
+// sizes that have a larger prime factor.
+//
+// Sizes made of 2s, 3s, 5s and 7s (44100 = 4*9*25*49, 48000 = 4*4*4*2*3*125)
+// are split into one Stockham stage per factor, the same scheme as
+// fft_split.h: a stage of radix P over sub-transforms of Points points, with
+// M = Points/P of them interleaved at stride S,
+//
+//   for q < M, k < S
+//     a[j] = x[k + S*(q + j*M)] for j = 0..P-1
+//     y[k + S*(P*q + t)] = W^(t*q) * sum(a[j] * e^(-2*pi*i*j*t/P))
+//
+// with W = e^(-2*pi*i/Points), then Points /= P and S *= P. There's no
+// reordering pass; the last stage leaves the bins in order. Each radix has
+// its own butterfly with the roots of unity as constants.
+//
+// Any other size uses Bluestein's algorithm, as czt.h does: with
+// n*k = (n^2 + k^2 - (k-n)^2)/2 the DFT becomes a convolution with the chirp
+// e^(i*pi*m^2/Size), done with the split-array FFT (fft_split.h) at the next
+// power of two >= 2*Size - 1. That costs several times a mixed-radix size,
+// but it stays N log N instead of N^2.
+//
+// Inverses conjugate on the way in and out, and include the 1/Size scale.
+//
+// Needs fft.h and fft_split.h.
+
+#include <string.h>
+
+#define FFT_MIXED_MAX_STAGES 32
+#define FFT_MIXED_MAX_RADIX 7
+
+typedef struct fft_mixed_stage
+{
+    u32 Radix;
+    u32 Points;
+    u32 Stride;
+    complex32 *Twiddles;  // Radix-1 per q: W^q .. W^((Radix-1)*q).
+} fft_mixed_stage;
+
+typedef struct fft_mixed_plan
+{
+    u32 Size;
+    bool Bluestein;
+    u32 StageCount;
+    fft_mixed_stage Stages[FFT_MIXED_MAX_STAGES];
+    complex32 *Twiddles;  // every stage's table in one block.
+    complex32 *Work;      // Size entries, the other Stockham buffer.
+
+    // Bluestein plans.
+    fft_split_plan Convolution;  // the next power of two >= 2*Size - 1.
+    complex32 *Chirp;            // Size entries: e^(-i*pi*n^2/Size).
+    f32 *KernelRe;               // Convolution.Size entries: the spectrum of
+    f32 *KernelIm;               // conj(Chirp), divided by Convolution.Size.
+    f32 *WorkRe;                 // Convolution.Size entries each.
+    f32 *WorkIm;
+} fft_mixed_plan;
+
+// Splits Size into radices, fours first. Returns the number of factors, or 0
+// if Size has a prime factor above 7 (or is under 2).
+internal u32
+FFTMixedFactor(u32 Size, u32 *Radices)
+{
+    u32 Count = 0;
+    if (Size < 2) return 0;
+    while (Size % 4 == 0) { Radices[Count++] = 4; Size /= 4; }
+    if (Size % 2 == 0) { Radices[Count++] = 2; Size /= 2; }
+    for (u32 Radix = 3; Radix <= FFT_MIXED_MAX_RADIX; Radix += 2)
+    {
+        while (Size % Radix == 0) { Radices[Count++] = Radix; Size /= Radix; }
+    }
+    return (Size == 1) ? Count : 0;
+}
+
+// True if Size runs as mixed radix, false if it needs Bluestein.
+internal bool
+FFTMixedFactorable(u32 Size)
+{
+    u32 Radices[FFT_MIXED_MAX_STAGES];
+    return FFTMixedFactor(Size, Radices) > 0;
+}
+
+internal void
+FFTMixedCreateBluestein(fft_mixed_plan *Plan)
+{
+    u32 Size = Plan->Size;
+    u32 ConvolutionSize = 2;
+    while (ConvolutionSize < 2*Size - 1) ConvolutionSize *= 2;
+    Plan->Bluestein = true;
+    Plan->Convolution = FFTSplitCreatePlan(ConvolutionSize);
+    Plan->Chirp = (complex32 *)malloc(Size * sizeof(complex32));
+    Plan->KernelRe = (f32 *)calloc(ConvolutionSize, sizeof(f32));
+    Plan->KernelIm = (f32 *)calloc(ConvolutionSize, sizeof(f32));
+    Plan->WorkRe = (f32 *)malloc(ConvolutionSize * sizeof(f32));
+    Plan->WorkIm = (f32 *)malloc(ConvolutionSize * sizeof(f32));
+
+    for (u32 N = 0; N < Size; N++)
+    {
+        // n^2 mod 2*Size keeps the phase exact however big n gets.
+        f64 Theta = (FFT_TAU / 2) * (f64)(((u64)N * N) % (2*(u64)Size)) / Size;
+        Plan->Chirp[N].Re = (f32)cos(Theta);
+        Plan->Chirp[N].Im = (f32)-sin(Theta);
+    }
+    // The kernel covers lags -(Size-1) .. Size-1; negative ones wrap around.
+    for (u32 M = 0; M < Size; M++)
+    {
+        Plan->KernelRe[M] = Plan->Chirp[M].Re;
+        Plan->KernelIm[M] = -Plan->Chirp[M].Im;
+        if (M == 0) continue;
+        Plan->KernelRe[ConvolutionSize - M] = Plan->Chirp[M].Re;
+        Plan->KernelIm[ConvolutionSize - M] = -Plan->Chirp[M].Im;
+    }
+    FFTSplitForward(&Plan->Convolution, Plan->KernelRe, Plan->KernelIm);
+    f32 Scale = 1.0f / (f32)ConvolutionSize;
+    for (u32 Index = 0; Index < ConvolutionSize; Index++)
+    {
+        Plan->KernelRe[Index] *= Scale;
+        Plan->KernelIm[Index] *= Scale;
+    }
+}
+
+// Size must be at least 2. Returns a plan with Size == 0 otherwise.
+internal fft_mixed_plan
+FFTMixedCreatePlan(u32 Size)
+{
+    fft_mixed_plan Plan = {0};
+    if (Size < 2) return Plan;
+
+    u32 Radices[FFT_MIXED_MAX_STAGES];
+    Plan.Size = Size;
+    Plan.StageCount = FFTMixedFactor(Size, Radices);
+    if (Plan.StageCount == 0)
+    {
+        FFTMixedCreateBluestein(&Plan);
+        return Plan;
+    }
+
+    u32 TwiddleCount = 0;
+    u32 Points = Size;
+    for (u32 StageIndex = 0; StageIndex < Plan.StageCount; StageIndex++)
+    {
+        TwiddleCount += (Radices[StageIndex] - 1) * (Points / Radices[StageIndex]);
+        Points /= Radices[StageIndex];
+    }
+    Plan.Twiddles = (complex32 *)malloc((TwiddleCount + 1) * sizeof(complex32));
+    Plan.Work = (complex32 *)malloc(Size * sizeof(complex32));
+
+    complex32 *NextTwiddle = Plan.Twiddles;
+    u32 Stride = 1;
+    Points = Size;
+    for (u32 StageIndex = 0; StageIndex < Plan.StageCount; StageIndex++)
+    {
+        fft_mixed_stage *Stage = &Plan.Stages[StageIndex];
+        u32 Radix = Radices[StageIndex];
+        Stage->Radix = Radix;
+        Stage->Points = Points;
+        Stage->Stride = Stride;
+        Stage->Twiddles = NextTwiddle;
+        for (u32 Q = 0; Q < Points / Radix; Q++)
+        {
+            for (u32 T = 1; T < Radix; T++)
+            {
+                f64 Theta = FFT_TAU * (f64)(T * Q) / (f64)Points;
+                NextTwiddle->Re = (f32)cos(Theta);
+                NextTwiddle->Im = (f32)-sin(Theta);
+                NextTwiddle++;
+            }
+        }
+        Points /= Radix;
+        Stride *= Radix;
+    }
+    return Plan;
+}
+
+internal void
+FFTMixedDestroyPlan(fft_mixed_plan *Plan)
+{
+    if (Plan->Bluestein) FFTSplitDestroyPlan(&Plan->Convolution);
+    free(Plan->Twiddles);
+    free(Plan->Work);
+    free(Plan->Chirp);
+    free(Plan->KernelRe);
+    free(Plan->KernelIm);
+    free(Plan->WorkRe);
+    free(Plan->WorkIm);
+    Plan->Twiddles = 0;
+    Plan->Work = 0;
+    Plan->Chirp = 0;
+    Plan->KernelRe = 0;
+    Plan->KernelIm = 0;
+    Plan->WorkRe = 0;
+    Plan->WorkIm = 0;
+    Plan->Size = 0;
+}
+
+// -i*Value.
+internal complex32
+FFTMixedRotate(complex32 Value)
+{
+    complex32 Result = {Value.Im, -Value.Re};
+    return Result;
+}
+
+// The butterflies below read a[j] = In[j*Span] and write b[t] = Out[t*Stride]
+// times its twiddle, for Stride butterflies in a row. For the odd radices,
+// S[j] = a[j] + a[P-j] and D[j] = a[j] - a[P-j] give both b[t] and b[P-t]:
+//
+//   b[t], b[P-t] = a[0] + sum(S[j]*cos(2*pi*j*t/P)) -/+ i*sum(D[j]*sin(2*pi*j*t/P))
+
+internal void
+FFTMixedStage2(fft_mixed_stage *Stage, complex32 *X, complex32 *Y)
+{
+    u32 Stride = Stage->Stride;
+    u32 Count = Stage->Points / 2;
+    u32 Span = Stride*Count;
+    for (u32 Q = 0; Q < Count; Q++)
+    {
+        complex32 W1 = Stage->Twiddles[Q];
+        complex32 *In = X + Stride*Q;
+        complex32 *Out = Y + 2*Stride*Q;
+        for (u32 K = 0; K < Stride; K++)
+        {
+            complex32 A0 = In[K], A1 = In[K + Span];
+            Out[K] = ComplexAdd(A0, A1);
+            Out[K + Stride] = ComplexMul(ComplexSub(A0, A1), W1);
+        }
+    }
+}
+
+internal void
+FFTMixedStage3(fft_mixed_stage *Stage, complex32 *X, complex32 *Y)
+{
+    const f32 C1 = -0.5f;
+    const f32 S1 = 0.86602540378443865f;
+    u32 Stride = Stage->Stride;
+    u32 Count = Stage->Points / 3;
+    u32 Span = Stride*Count;
+    for (u32 Q = 0; Q < Count; Q++)
+    {
+        complex32 W1 = Stage->Twiddles[2*Q], W2 = Stage->Twiddles[2*Q + 1];
+        complex32 *In = X + Stride*Q;
+        complex32 *Out = Y + 3*Stride*Q;
+        for (u32 K = 0; K < Stride; K++)
+        {
+            complex32 A0 = In[K], A1 = In[K + Span], A2 = In[K + 2*Span];
+            complex32 Sum = ComplexAdd(A1, A2);
+            complex32 Even = ComplexAdd(A0, ComplexScale(Sum, C1));
+            complex32 Odd = ComplexScale(FFTMixedRotate(ComplexSub(A1, A2)), S1);
+            Out[K] = ComplexAdd(A0, Sum);
+            Out[K + Stride] = ComplexMul(ComplexAdd(Even, Odd), W1);
+            Out[K + 2*Stride] = ComplexMul(ComplexSub(Even, Odd), W2);
+        }
+    }
+}
+
+internal void
+FFTMixedStage4(fft_mixed_stage *Stage, complex32 *X, complex32 *Y)
+{
+    u32 Stride = Stage->Stride;
+    u32 Count = Stage->Points / 4;
+    u32 Span = Stride*Count;
+    for (u32 Q = 0; Q < Count; Q++)
+    {
+        complex32 W1 = Stage->Twiddles[3*Q], W2 = Stage->Twiddles[3*Q + 1], W3 = Stage->Twiddles[3*Q + 2];
+        complex32 *In = X + Stride*Q;
+        complex32 *Out = Y + 4*Stride*Q;
+        for (u32 K = 0; K < Stride; K++)
+        {
+            complex32 A0 = In[K], A1 = In[K + Span], A2 = In[K + 2*Span], A3 = In[K + 3*Span];
+            complex32 T0 = ComplexAdd(A0, A2), T1 = ComplexSub(A0, A2);
+            complex32 T2 = ComplexAdd(A1, A3), T3 = FFTMixedRotate(ComplexSub(A1, A3));
+            Out[K] = ComplexAdd(T0, T2);
+            Out[K + Stride] = ComplexMul(ComplexAdd(T1, T3), W1);
+            Out[K + 2*Stride] = ComplexMul(ComplexSub(T0, T2), W2);
+            Out[K + 3*Stride] = ComplexMul(ComplexSub(T1, T3), W3);
+        }
+    }
+}
+
+internal void
+FFTMixedStage5(fft_mixed_stage *Stage, complex32 *X, complex32 *Y)
+{
+    const f32 C1 = 0.30901699437494742f, C2 = -0.80901699437494742f;
+    const f32 S1 = 0.95105651629515357f, S2 = 0.58778525229247313f;
+    u32 Stride = Stage->Stride;
+    u32 Count = Stage->Points / 5;
+    u32 Span = Stride*Count;
+    for (u32 Q = 0; Q < Count; Q++)
+    {
+        complex32 *W = Stage->Twiddles + 4*Q;
+        complex32 *In = X + Stride*Q;
+        complex32 *Out = Y + 5*Stride*Q;
+        for (u32 K = 0; K < Stride; K++)
+        {
+            complex32 A0 = In[K];
+            complex32 A1 = In[K + Span], A2 = In[K + 2*Span], A3 = In[K + 3*Span], A4 = In[K + 4*Span];
+            complex32 Sum1 = ComplexAdd(A1, A4), Diff1 = FFTMixedRotate(ComplexSub(A1, A4));
+            complex32 Sum2 = ComplexAdd(A2, A3), Diff2 = FFTMixedRotate(ComplexSub(A2, A3));
+            complex32 Even1 = ComplexAdd(A0, ComplexAdd(ComplexScale(Sum1, C1), ComplexScale(Sum2, C2)));
+            complex32 Even2 = ComplexAdd(A0, ComplexAdd(ComplexScale(Sum1, C2), ComplexScale(Sum2, C1)));
+            complex32 Odd1 = ComplexAdd(ComplexScale(Diff1, S1), ComplexScale(Diff2, S2));
+            complex32 Odd2 = ComplexSub(ComplexScale(Diff1, S2), ComplexScale(Diff2, S1));
+            Out[K] = ComplexAdd(A0, ComplexAdd(Sum1, Sum2));
+            Out[K + Stride] = ComplexMul(ComplexAdd(Even1, Odd1), W[0]);
+            Out[K + 2*Stride] = ComplexMul(ComplexAdd(Even2, Odd2), W[1]);
+            Out[K + 3*Stride] = ComplexMul(ComplexSub(Even2, Odd2), W[2]);
+            Out[K + 4*Stride] = ComplexMul(ComplexSub(Even1, Odd1), W[3]);
+        }
+    }
+}
+
+internal void
+FFTMixedStage7(fft_mixed_stage *Stage, complex32 *X, complex32 *Y)
+{
+    const f32 C1 = 0.62348980185873353f, C2 = -0.22252093395631440f, C3 = -0.90096886790241913f;
+    const f32 S1 = 0.78183148246802981f, S2 = 0.97492791218182361f, S3 = 0.43388373911755812f;
+    u32 Stride = Stage->Stride;
+    u32 Count = Stage->Points / 7;
+    u32 Span = Stride*Count;
+    for (u32 Q = 0; Q < Count; Q++)
+    {
+        complex32 *W = Stage->Twiddles + 6*Q;
+        complex32 *In = X + Stride*Q;
+        complex32 *Out = Y + 7*Stride*Q;
+        for (u32 K = 0; K < Stride; K++)
+        {
+            complex32 A0 = In[K];
+            complex32 Sum1 = ComplexAdd(In[K + Span], In[K + 6*Span]);
+            complex32 Sum2 = ComplexAdd(In[K + 2*Span], In[K + 5*Span]);
+            complex32 Sum3 = ComplexAdd(In[K + 3*Span], In[K + 4*Span]);
+            complex32 Diff1 = FFTMixedRotate(ComplexSub(In[K + Span], In[K + 6*Span]));
+            complex32 Diff2 = FFTMixedRotate(ComplexSub(In[K + 2*Span], In[K + 5*Span]));
+            complex32 Diff3 = FFTMixedRotate(ComplexSub(In[K + 3*Span], In[K + 4*Span]));
+            // j*t mod 7 picks the roots: t = 2 uses 2, 4, 6 and t = 3 uses 3, 6, 2,
+            // with sin(4*pi*2/7) = -sin(2*pi*3/7) and so on.
+            complex32 Even1 = ComplexAdd(A0, ComplexAdd(ComplexScale(Sum1, C1),
+                                                        ComplexAdd(ComplexScale(Sum2, C2), ComplexScale(Sum3, C3))));
+            complex32 Even2 = ComplexAdd(A0, ComplexAdd(ComplexScale(Sum1, C2),
+                                                        ComplexAdd(ComplexScale(Sum2, C3), ComplexScale(Sum3, C1))));
+            complex32 Even3 = ComplexAdd(A0, ComplexAdd(ComplexScale(Sum1, C3),
+                                                        ComplexAdd(ComplexScale(Sum2, C1), ComplexScale(Sum3, C2))));
+            complex32 Odd1 = ComplexAdd(ComplexScale(Diff1, S1), ComplexAdd(ComplexScale(Diff2, S2), ComplexScale(Diff3, S3)));
+            complex32 Odd2 = ComplexSub(ComplexScale(Diff1, S2), ComplexAdd(ComplexScale(Diff2, S3), ComplexScale(Diff3, S1)));
+            complex32 Odd3 = ComplexAdd(ComplexSub(ComplexScale(Diff1, S3), ComplexScale(Diff2, S1)), ComplexScale(Diff3, S2));
+            Out[K] = ComplexAdd(A0, ComplexAdd(Sum1, ComplexAdd(Sum2, Sum3)));
+            Out[K + Stride] = ComplexMul(ComplexAdd(Even1, Odd1), W[0]);
+            Out[K + 2*Stride] = ComplexMul(ComplexAdd(Even2, Odd2), W[1]);
+            Out[K + 3*Stride] = ComplexMul(ComplexAdd(Even3, Odd3), W[2]);
+            Out[K + 4*Stride] = ComplexMul(ComplexSub(Even3, Odd3), W[3]);
+            Out[K + 5*Stride] = ComplexMul(ComplexSub(Even2, Odd2), W[4]);
+            Out[K + 6*Stride] = ComplexMul(ComplexSub(Even1, Odd1), W[5]);
+        }
+    }
+}
+
+// Chirps Data, convolves it with the kernel and chirps the result.
+internal void
+FFTMixedBluestein(fft_mixed_plan *Plan, complex32 *Data)
+{
+    u32 ConvolutionSize = Plan->Convolution.Size;
+    for (u32 N = 0; N < Plan->Size; N++)
+    {
+        complex32 Value = ComplexMul(Data[N], Plan->Chirp[N]);
+        Plan->WorkRe[N] = Value.Re;
+        Plan->WorkIm[N] = Value.Im;
+    }
+    memset(Plan->WorkRe + Plan->Size, 0, (ConvolutionSize - Plan->Size) * sizeof(f32));
+    memset(Plan->WorkIm + Plan->Size, 0, (ConvolutionSize - Plan->Size) * sizeof(f32));
+    FFTSplitForward(&Plan->Convolution, Plan->WorkRe, Plan->WorkIm);
+    for (u32 Index = 0; Index < ConvolutionSize; Index++)
+    {
+        f32 Re = Plan->WorkRe[Index];
+        f32 Im = Plan->WorkIm[Index];
+        Plan->WorkRe[Index] = Re*Plan->KernelRe[Index] - Im*Plan->KernelIm[Index];
+        Plan->WorkIm[Index] = Re*Plan->KernelIm[Index] + Im*Plan->KernelRe[Index];
+    }
+    // The inverse, unscaled (the kernel has the scale): see FFTSplitInverse.
+    FFTSplitForward(&Plan->Convolution, Plan->WorkIm, Plan->WorkRe);
+    for (u32 K = 0; K < Plan->Size; K++)
+    {
+        complex32 Value = {Plan->WorkRe[K], Plan->WorkIm[K]};
+        Data[K] = ComplexMul(Value, Plan->Chirp[K]);
+    }
+}
+
+// X[k] = sum(x[n] * e^(-2*pi*i*k*n/Size)), in place.
+internal void
+FFTMixedForward(fft_mixed_plan *Plan, complex32 *Data)
+{
+    if (Plan->Bluestein)
+    {
+        FFTMixedBluestein(Plan, Data);
+        return;
+    }
+    complex32 *X = Data;
+    complex32 *Y = Plan->Work;
+    for (u32 StageIndex = 0; StageIndex < Plan->StageCount; StageIndex++)
+    {
+        fft_mixed_stage *Stage = &Plan->Stages[StageIndex];
+        switch (Stage->Radix)
+        {
+            case 2: FFTMixedStage2(Stage, X, Y); break;
+            case 3: FFTMixedStage3(Stage, X, Y); break;
+            case 4: FFTMixedStage4(Stage, X, Y); break;
+            case 5: FFTMixedStage5(Stage, X, Y); break;
+            default: FFTMixedStage7(Stage, X, Y); break;
+        }
+        complex32 *Swap = X;
+        X = Y;
+        Y = Swap;
+    }
+    if (X != Data) memcpy(Data, X, Plan->Size * sizeof(complex32));
+}
+
+// Undoes FFTMixedForward, including the 1/Size scale.
+internal void
+FFTMixedInverse(fft_mixed_plan *Plan, complex32 *Data)
+{
+    for (u32 Index = 0; Index < Plan->Size; Index++) Data[Index].Im = -Data[Index].Im;
+    FFTMixedForward(Plan, Data);
+    f32 Scale = 1.0f / (f32)Plan->Size;
+    for (u32 Index = 0; Index < Plan->Size; Index++)
+    {
+        Data[Index].Re *= Scale;
+        Data[Index].Im *= -Scale;
+    }
+}
+
+#endif //FFT_MIXED_H
@@ -0,0 +1,532 @@
+/* date = October 18th 2026 */
+
+#ifndef FFT_PLANNER_H
+#define FFT_PLANNER_H
+
+// One front end for every FFT in the tree.
+//
+//   fft_planner Planner = FFTPlannerCreate(FFTPlanner_Measure, "fft.wisdom");
+//   planned_fft *Plan = FFTPlan(&Planner, 4096, FFTType_Real, FFTDirection_Forward);
+//   FFTExecuteReal(Plan, Samples, Spectrum);   // as often as needed
+//   FFTPlannerDestroy(&Planner);               // saves any new wisdom
+//
+// Plans are cached by (size, type, direction); asking again returns the same
+// plan. Each one runs one of several algorithms: the radix-2 FFT in fft.h,
+// the split-array FFT in fft_split.h with any kernel this CPU supports, or
+// the mixed-radix FFT in fft_mixed.h (real plans run them at half size, see
+// real_fft.h). Powers of two can use any of them; other sizes run mixed
+// radix, or Bluestein if they have a prime factor above 7. Which one is
+// fastest depends on the size and the machine, so:
+//
+//   Estimate: picks by rule of thumb. Costs nothing.
+//   Measure:  times every candidate on the first request for a key and keeps
+//             the fastest.
+//
+// Either way a choice found in the wisdom file wins, and measured choices
+// are written back to it, so only the first launch on a machine pays for
+// tuning. Wisdom for an algorithm this CPU can't run is ignored.
+//
+// A plan owns scratch memory, so one plan can't be executed from two threads
+// at once.
+//
+// Needs fft.h, real_fft.h, fft_split.h, fft_mixed.h and bench_timer.h.
+
+#define FFT_PLANNER_MAX_PLANS 128
+#define FFT_PLANNER_MAX_WISDOM 256
+// Time spent on each candidate when measuring.
+#define FFT_MEASURE_SECONDS 0.005
+#define FFT_WISDOM_HEADER "fft_wisdom 1"
+
+typedef enum fft_type
+{
+    FFTType_Complex,
+    FFTType_Real,
+    FFTType_Count,
+} fft_type;
+
+typedef enum fft_direction
+{
+    FFTDirection_Forward,
+    FFTDirection_Inverse,
+    FFTDirection_Count,
+} fft_direction;
+
+// The split algorithms are in fft_kernel order.
+typedef enum fft_algorithm
+{
+    FFTAlgorithm_Radix2,
+    FFTAlgorithm_SplitScalar,
+    FFTAlgorithm_SplitAVX2,
+    FFTAlgorithm_SplitAVX512,
+    FFTAlgorithm_MixedRadix,
+    FFTAlgorithm_Bluestein,
+    FFTAlgorithm_Count,
+} fft_algorithm;
+
+typedef enum fft_planner_mode
+{
+    FFTPlanner_Estimate,
+    FFTPlanner_Measure,
+} fft_planner_mode;
+
+global const char *FFTTypeNames[FFTType_Count] = {"complex", "real"};
+global const char *FFTDirectionNames[FFTDirection_Count] = {"forward", "inverse"};
+global const char *FFTAlgorithmNames[FFTAlgorithm_Count] = {"radix2", "split-scalar", "split-avx2", "split-avx512",
+                                                         "mixed-radix", "bluestein"};
+
+typedef struct planned_fft
+{
+    u32 Size;
+    fft_type Type;
+    fft_direction Direction;
+    fft_algorithm Algorithm;
+    u32 TransformSize;     // Size, or Size/2 for real plans.
+    fft_plan Radix2;       // Complex radix-2 plans.
+    real_fft_plan Real;    // Real plans; its Half plan is the radix-2 transform.
+    fft_split_plan Split;  // Split plans.
+    f32 *SplitRe;          // TransformSize entries each, for split plans.
+    f32 *SplitIm;
+    fft_mixed_plan Mixed;  // Mixed-radix and Bluestein plans.
+} planned_fft;
+
+typedef struct fft_wisdom
+{
+    u32 Size;
+    fft_type Type;
+    fft_direction Direction;
+    fft_algorithm Algorithm;
+} fft_wisdom;
+
+typedef struct fft_planner
+{
+    fft_planner_mode Mode;
+    const char *WisdomPath;
+    planned_fft *Plans[FFT_PLANNER_MAX_PLANS];
+    u32 PlanCount;
+    fft_wisdom Wisdom[FFT_PLANNER_MAX_WISDOM];
+    u32 WisdomCount;
+    bool WisdomChanged;
+    u32 MeasuredCount;
+    f64 MeasureSeconds;
+} fft_planner;
+
+internal bool
+FFTAlgorithmIsSplit(fft_algorithm Algorithm)
+{
+    return Algorithm >= FFTAlgorithm_SplitScalar && Algorithm <= FFTAlgorithm_SplitAVX512;
+}
+
+internal bool
+FFTAlgorithmSupported(fft_algorithm Algorithm)
+{
+    if (!FFTAlgorithmIsSplit(Algorithm)) return true;
+    return FFTKernelSupported((fft_kernel)(Algorithm - FFTAlgorithm_SplitScalar));
+}
+
+// Whether Algorithm can run a transform of TransformSize points. Bluestein
+// only takes the sizes mixed radix can't.
+internal bool
+FFTAlgorithmFits(fft_algorithm Algorithm, u32 TransformSize)
+{
+    if (Algorithm == FFTAlgorithm_MixedRadix) return FFTMixedFactorable(TransformSize);
+    if (Algorithm == FFTAlgorithm_Bluestein) return !FFTMixedFactorable(TransformSize);
+    return FFTIsPowerOfTwo(TransformSize);
+}
+
+internal u32
+FFTTransformSize(u32 Size, fft_type Type)
+{
+    return (Type == FFTType_Real) ? Size / 2 : Size;
+}
+
+// Complex plans take any size from 2 up, real plans any even size from 4 up.
+internal bool
+FFTPlanSizeValid(u32 Size, fft_type Type)
+{
+    if (Type == FFTType_Real) return (Size & 1) == 0 && Size >= 4;
+    return Size >= 2;
+}
+
+//
+// Plans.
+//
+
+internal planned_fft *
+FFTCreatePlannedFFT(u32 Size, fft_type Type, fft_direction Direction, fft_algorithm Algorithm)
+{
+    planned_fft *Plan = (planned_fft *)calloc(1, sizeof(planned_fft));
+    Plan->Size = Size;
+    Plan->Type = Type;
+    Plan->Direction = Direction;
+    Plan->Algorithm = Algorithm;
+    Plan->TransformSize = FFTTransformSize(Size, Type);
+
+    if (Type == FFTType_Real)
+    {
+        Plan->Real = RealFFTCreatePlan(Size);
+    }
+    else if (Algorithm == FFTAlgorithm_Radix2)
+    {
+        Plan->Radix2 = FFTCreatePlan(Size);
+    }
+    if (Algorithm == FFTAlgorithm_MixedRadix || Algorithm == FFTAlgorithm_Bluestein)
+    {
+        Plan->Mixed = FFTMixedCreatePlan(Plan->TransformSize);
+    }
+    if (FFTAlgorithmIsSplit(Algorithm))
+    {
+        Plan->Split = FFTSplitCreatePlan(Plan->TransformSize);
+        FFTSplitSetKernel(&Plan->Split, (fft_kernel)(Algorithm - FFTAlgorithm_SplitScalar));
+        Plan->SplitRe = (f32 *)malloc(Plan->TransformSize * sizeof(f32));
+        Plan->SplitIm = (f32 *)malloc(Plan->TransformSize * sizeof(f32));
+    }
+    return Plan;
+}
+
+internal void
+FFTDestroyPlannedFFT(planned_fft *Plan)
+{
+    if (Plan->Type == FFTType_Real) RealFFTDestroyPlan(&Plan->Real);
+    if (Plan->Radix2.Size) FFTDestroyPlan(&Plan->Radix2);
+    if (Plan->Split.Size) FFTSplitDestroyPlan(&Plan->Split);
+    if (Plan->Mixed.Size) FFTMixedDestroyPlan(&Plan->Mixed);
+    free(Plan->SplitRe);
+    free(Plan->SplitIm);
+    free(Plan);
+}
+
+internal void
+FFTSplitFromComplex(planned_fft *Plan, complex32 *Data)
+{
+    for (u32 Index = 0; Index < Plan->TransformSize; Index++)
+    {
+        Plan->SplitRe[Index] = Data[Index].Re;
+        Plan->SplitIm[Index] = Data[Index].Im;
+    }
+}
+
+internal void
+FFTSplitToComplex(planned_fft *Plan, complex32 *Data)
+{
+    for (u32 Index = 0; Index < Plan->TransformSize; Index++)
+    {
+        Data[Index].Re = Plan->SplitRe[Index];
+        Data[Index].Im = Plan->SplitIm[Index];
+    }
+}
+
+// Complex plans: transforms Size points in place. Inverse plans include the
+// 1/Size scale.
+internal void
+FFTExecuteComplex(planned_fft *Plan, complex32 *Data)
+{
+    bool Forward = (Plan->Direction == FFTDirection_Forward);
+    if (Plan->Algorithm == FFTAlgorithm_Radix2)
+    {
+        if (Forward) FFTForward(&Plan->Radix2, Data);
+        else FFTInverse(&Plan->Radix2, Data);
+        return;
+    }
+    if (Plan->Mixed.Size)
+    {
+        if (Forward) FFTMixedForward(&Plan->Mixed, Data);
+        else FFTMixedInverse(&Plan->Mixed, Data);
+        return;
+    }
+    FFTSplitFromComplex(Plan, Data);
+    if (Forward) FFTSplitForward(&Plan->Split, Plan->SplitRe, Plan->SplitIm);
+    else FFTSplitInverse(&Plan->Split, Plan->SplitRe, Plan->SplitIm);
+    FFTSplitToComplex(Plan, Data);
+}
+
+// Real plans. Forward reads Size samples and writes the Size/2 + 1 bin
+// half-spectrum; inverse reads the half-spectrum (and uses it as scratch) and
+// writes Size samples, scaled by 1/Size.
+internal void
+FFTExecuteReal(planned_fft *Plan, f32 *Samples, complex32 *Spectrum)
+{
+    u32 HalfSize = Plan->TransformSize;
+    bool Forward = (Plan->Direction == FFTDirection_Forward);
+    if (Plan->Algorithm == FFTAlgorithm_Radix2)
+    {
+        if (Forward) RealFFTForward(&Plan->Real, Samples, Plan->Size, Spectrum);
+        else RealFFTInverse(&Plan->Real, Spectrum, Samples);
+        return;
+    }
+    if (Plan->Mixed.Size)
+    {
+        // The same packing RealFFTForward does, without the zero-padding.
+        if (Forward)
+        {
+            for (u32 Index = 0; Index < HalfSize; Index++)
+            {
+                Spectrum[Index].Re = Samples[2*Index];
+                Spectrum[Index].Im = Samples[2*Index + 1];
+            }
+            FFTMixedForward(&Plan->Mixed, Spectrum);
+            RealFFTPostTwiddle(&Plan->Real, Spectrum);
+        }
+        else
+        {
+            RealFFTPreTwiddle(&Plan->Real, Spectrum);
+            FFTMixedInverse(&Plan->Mixed, Spectrum);
+            for (u32 Index = 0; Index < HalfSize; Index++)
+            {
+                Samples[2*Index] = Spectrum[Index].Re;
+                Samples[2*Index + 1] = Spectrum[Index].Im;
+            }
+        }
+        return;
+    }
+
+    // The even and odd samples are already split arrays.
+    if (Forward)
+    {
+        for (u32 Index = 0; Index < HalfSize; Index++)
+        {
+            Plan->SplitRe[Index] = Samples[2*Index];
+            Plan->SplitIm[Index] = Samples[2*Index + 1];
+        }
+        FFTSplitForward(&Plan->Split, Plan->SplitRe, Plan->SplitIm);
+        FFTSplitToComplex(Plan, Spectrum);
+        RealFFTPostTwiddle(&Plan->Real, Spectrum);
+    }
+    else
+    {
+        RealFFTPreTwiddle(&Plan->Real, Spectrum);
+        FFTSplitFromComplex(Plan, Spectrum);
+        FFTSplitInverse(&Plan->Split, Plan->SplitRe, Plan->SplitIm);
+        for (u32 Index = 0; Index < HalfSize; Index++)
+        {
+            Samples[2*Index] = Plan->SplitRe[Index];
+            Samples[2*Index + 1] = Plan->SplitIm[Index];
+        }
+    }
+}
+
+//
+// Wisdom.
+//
+
+internal fft_wisdom *
+FFTFindWisdom(fft_planner *Planner, u32 Size, fft_type Type, fft_direction Direction)
+{
+    for (u32 Index = 0; Index < Planner->WisdomCount; Index++)
+    {
+        fft_wisdom *Wisdom = &Planner->Wisdom[Index];
+        if (Wisdom->Size == Size && Wisdom->Type == Type && Wisdom->Direction == Direction) return Wisdom;
+    }
+    return 0;
+}
+
+internal void
+FFTAddWisdom(fft_planner *Planner, u32 Size, fft_type Type, fft_direction Direction, fft_algorithm Algorithm)
+{
+    fft_wisdom *Wisdom = FFTFindWisdom(Planner, Size, Type, Direction);
+    if (!Wisdom)
+    {
+        if (Planner->WisdomCount == FFT_PLANNER_MAX_WISDOM) return;
+        Wisdom = &Planner->Wisdom[Planner->WisdomCount++];
+    }
+    Wisdom->Size = Size;
+    Wisdom->Type = Type;
+    Wisdom->Direction = Direction;
+    Wisdom->Algorithm = Algorithm;
+}
+
+internal i32
+FFTFindName(const char **Names, i32 Count, const char *Name)
+{
+    for (i32 Index = 0; Index < Count; Index++)
+    {
+        if (strcmp(Names[Index], Name) == 0) return Index;
+    }
+    return -1;
+}
+
+// Adds the file's entries to the planner's. Returns false if it can't be
+// read; entries that don't parse or can't run here are skipped.
+internal bool
+FFTPlannerLoadWisdom(fft_planner *Planner, const char *Path)
+{
+    FILE *File = fopen(Path, "r");
+    if (!File) return false;
+
+    char Line[128];
+    bool Valid = (fgets(Line, sizeof(Line), File) != 0 &&
+                  strncmp(Line, FFT_WISDOM_HEADER, strlen(FFT_WISDOM_HEADER)) == 0);
+    while (Valid && fgets(Line, sizeof(Line), File))
+    {
+        u32 Size;
+        char TypeName[16], DirectionName[16], AlgorithmName[32];
+        if (Line[0] == '#') continue;
+        if (sscanf(Line, "%u %15s %15s %31s", &Size, TypeName, DirectionName, AlgorithmName) != 4) continue;
+        i32 Type = FFTFindName(FFTTypeNames, FFTType_Count, TypeName);
+        i32 Direction = FFTFindName(FFTDirectionNames, FFTDirection_Count, DirectionName);
+        i32 Algorithm = FFTFindName(FFTAlgorithmNames, FFTAlgorithm_Count, AlgorithmName);
+        if (Type < 0 || Direction < 0 || Algorithm < 0) continue;
+        if (!FFTPlanSizeValid(Size, (fft_type)Type) || !FFTAlgorithmSupported((fft_algorithm)Algorithm) ||
+            !FFTAlgorithmFits((fft_algorithm)Algorithm, FFTTransformSize(Size, (fft_type)Type))) continue;
+        FFTAddWisdom(Planner, Size, (fft_type)Type, (fft_direction)Direction, (fft_algorithm)Algorithm);
+    }
+    fclose(File);
+    return Valid;
+}
+
+internal bool
+FFTPlannerSaveWisdom(fft_planner *Planner, const char *Path)
+{
+    FILE *File = fopen(Path, "w");
+    if (!File) return false;
+    fprintf(File, "%s\n# size type direction algorithm\n", FFT_WISDOM_HEADER);
+    for (u32 Index = 0; Index < Planner->WisdomCount; Index++)
+    {
+        fft_wisdom *Wisdom = &Planner->Wisdom[Index];
+        fprintf(File, "%u %s %s %s\n", Wisdom->Size, FFTTypeNames[Wisdom->Type],
+                FFTDirectionNames[Wisdom->Direction], FFTAlgorithmNames[Wisdom->Algorithm]);
+    }
+    fclose(File);
+    return true;
+}
+
+//
+// Planning.
+//
+
+// Without wisdom or measurements: the widest split kernel, except for sizes
+// too small for its vector paths to kick in. Other sizes have one choice.
+internal fft_algorithm
+FFTEstimateAlgorithm(u32 Size, fft_type Type)
+{
+    u32 TransformSize = FFTTransformSize(Size, Type);
+    if (!FFTIsPowerOfTwo(TransformSize))
+    {
+        return FFTMixedFactorable(TransformSize) ? FFTAlgorithm_MixedRadix : FFTAlgorithm_Bluestein;
+    }
+    if (TransformSize < 16) return FFTAlgorithm_Radix2;
+    return (fft_algorithm)(FFTAlgorithm_SplitScalar + FFTBestKernel());
+}
+
+// Seconds per execution of Plan, on noise.
+internal f64
+FFTMeasurePlan(planned_fft *Plan, complex32 *Input, complex32 *Data, f32 *Samples)
+{
+    u32 ComplexCount = (Plan->Type == FFTType_Real) ? Plan->Size/2 + 1 : Plan->Size;
+    f64 Seconds;
+    if (Plan->Type == FFTType_Complex)
+    {
+        // Inverses run on a fresh copy each time so repeated scaling can't
+        // drift into denormals; the copy costs every candidate the same.
+        mx_TimeCalls(FFT_MEASURE_SECONDS, Seconds,
+                     (memcpy(Data, Input, ComplexCount * sizeof(complex32)), FFTExecuteComplex(Plan, Data)));
+    }
+    else
+    {
+        for (u32 Index = 0; Index < Plan->Size; Index++) Samples[Index] = Input[Index / 2].Re;
+        mx_TimeCalls(FFT_MEASURE_SECONDS, Seconds,
+                     (memcpy(Data, Input, ComplexCount * sizeof(complex32)), FFTExecuteReal(Plan, Samples, Data)));
+    }
+    return Seconds;
+}
+
+internal planned_fft *
+FFTMeasureBestPlan(fft_planner *Planner, u32 Size, fft_type Type, fft_direction Direction)
+{
+    f64 Start = BenchSeconds();
+    complex32 *Input = (complex32 *)malloc(Size * sizeof(complex32));
+    complex32 *Data = (complex32 *)malloc(Size * sizeof(complex32));
+    f32 *Samples = (f32 *)malloc(Size * sizeof(f32));
+    for (u32 Index = 0; Index < Size; Index++)
+    {
+        Input[Index].Re = RandomF32(Index) - 0.5f;
+        Input[Index].Im = RandomF32(Index + Size) - 0.5f;
+    }
+
+    planned_fft *Best = 0;
+    f64 BestSeconds = 0;
+    for (i32 Algorithm = 0; Algorithm < FFTAlgorithm_Count; Algorithm++)
+    {
+        if (!FFTAlgorithmSupported((fft_algorithm)Algorithm) ||
+            !FFTAlgorithmFits((fft_algorithm)Algorithm, FFTTransformSize(Size, Type))) continue;
+        planned_fft *Candidate = FFTCreatePlannedFFT(Size, Type, Direction, (fft_algorithm)Algorithm);
+        f64 Seconds = FFTMeasurePlan(Candidate, Input, Data, Samples);
+        if (!Best || Seconds < BestSeconds)
+        {
+            if (Best) FFTDestroyPlannedFFT(Best);
+            Best = Candidate;
+            BestSeconds = Seconds;
+        }
+        else
+        {
+            FFTDestroyPlannedFFT(Candidate);
+        }
+    }
+
+    free(Samples);
+    free(Data);
+    free(Input);
+    Planner->MeasuredCount++;
+    Planner->MeasureSeconds += BenchSeconds() - Start;
+    return Best;
+}
+
+// Loads the wisdom at WisdomPath, if there is one. WisdomPath can be 0.
+internal fft_planner
+FFTPlannerCreate(fft_planner_mode Mode, const char *WisdomPath)
+{
+    fft_planner Planner = {0};
+    Planner.Mode = Mode;
+    Planner.WisdomPath = WisdomPath;
+    if (WisdomPath) FFTPlannerLoadWisdom(&Planner, WisdomPath);
+    return Planner;
+}
+
+// Destroys every plan, so pointers from FFTPlan are invalid afterwards. Saves
+// the wisdom if anything new was measured.
+internal void
+FFTPlannerDestroy(fft_planner *Planner)
+{
+    if (Planner->WisdomPath && Planner->WisdomChanged)
+    {
+        FFTPlannerSaveWisdom(Planner, Planner->WisdomPath);
+    }
+    for (u32 Index = 0; Index < Planner->PlanCount; Index++)
+    {
+        FFTDestroyPlannedFFT(Planner->Plans[Index]);
+    }
+    Planner->PlanCount = 0;
+}
+
+// Returns the cached plan for the key, or makes one. Returns 0 if Size is
+// under 2, or odd or under 4 for real plans, or if the cache is full.
+internal planned_fft *
+FFTPlan(fft_planner *Planner, u32 Size, fft_type Type, fft_direction Direction)
+{
+    for (u32 Index = 0; Index < Planner->PlanCount; Index++)
+    {
+        planned_fft *Plan = Planner->Plans[Index];
+        if (Plan->Size == Size && Plan->Type == Type && Plan->Direction == Direction) return Plan;
+    }
+    if (!FFTPlanSizeValid(Size, Type) || Planner->PlanCount == FFT_PLANNER_MAX_PLANS) return 0;
+
+    planned_fft *Plan;
+    fft_wisdom *Wisdom = FFTFindWisdom(Planner, Size, Type, Direction);
+    if (Wisdom)
+    {
+        Plan = FFTCreatePlannedFFT(Size, Type, Direction, Wisdom->Algorithm);
+    }
+    else if (Planner->Mode == FFTPlanner_Measure)
+    {
+        Plan = FFTMeasureBestPlan(Planner, Size, Type, Direction);
+        FFTAddWisdom(Planner, Size, Type, Direction, Plan->Algorithm);
+        Planner->WisdomChanged = true;
+    }
+    else
+    {
+        Plan = FFTCreatePlannedFFT(Size, Type, Direction, FFTEstimateAlgorithm(Size, Type));
+    }
+    Planner->Plans[Planner->PlanCount++] = Plan;
+    return Plan;
+}
+
+#endif //FFT_PLANNER_H
@@ -0,0 +1,546 @@
+/* date = October 18th 2026 */
+
+#ifndef FFT_SPLIT_H
+#define FFT_SPLIT_H
+
+// Radix-4 FFT on split real/imaginary arrays, with scalar, AVX2 and
+// AVX-512 kernels picked at runtime.
+//
+// Split arrays (one f32 array of real parts, one of imaginary parts) let a
+// vector register hold 8 or 16 real parts with no shuffling, which the
+// interleaved complex32 layout of fft.h can't. The transform is a Stockham
+// autosort one: every stage reads one buffer and writes the other in order,
+// so there's no bit-reversal pass, and a stage with stride S does S
+// independent butterflies per twiddle, which is what gets vectorized:
+//
+//   stage (N/S points, S interleaved): for p < N/S/4, q < S
+//     a, b, c, d = x[q + S*(p + k*N/S/4)] for k = 0..3
+//     y[q + S*(4p + 0)] = (a + c) + (b + d)
+//     y[q + S*(4p + 1)] = W^p  * ((a - c) - i*(b - d))
+//     y[q + S*(4p + 2)] = W^2p * ((a + c) - (b + d))
+//     y[q + S*(4p + 3)] = W^3p * ((a - c) + i*(b - d))
+//
+// with W = e^(-2*pi*i*S/N). S goes 1, 4, 16, ...; an odd power of two ends
+// with one radix-2 stage. The first two stages (S = 1 and 4) have less than a
+// vector's worth of butterflies per twiddle, so the AVX2 kernel vectorizes
+// them across p instead and transposes on the way out; AVX-512 uses the AVX2
+// code for those.
+//
+// A batch plan starts at S = Batch instead of 1, which transforms Batch
+// frames stored interleaved (element n of frame b at n*Batch + b) in one
+// pass: every stage then has at least Batch butterflies per twiddle, so with
+// a Batch of 16 all of them run on full vectors, across frames.
+//
+// dsp_check checks every kernel against a direct DFT; fft_split_bench times
+// them. Builds without intrinsics (tcc, non-x86) set FFT_SIMD to 0 and only
+// get the scalar kernel.
+//
+// Needs fft.h.
+
+#include <string.h>
+
+#ifndef FFT_SIMD
+#if defined(__TINYC__) || !(defined(__x86_64__) || defined(_M_X64))
+#define FFT_SIMD 0
+#else
+#define FFT_SIMD 1
+#endif
+#endif
+
+#if FFT_SIMD
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define FFT_TARGET_AVX2
+#define FFT_TARGET_AVX512
+#else
+#define FFT_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define FFT_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+#endif
+#endif
+
+#define FFT_SPLIT_MAX_STAGES 16
+
+typedef enum fft_kernel
+{
+    FFTKernel_Scalar,
+    FFTKernel_AVX2,
+    FFTKernel_AVX512,
+    FFTKernel_Count,
+} fft_kernel;
+
+internal const char *
+FFTKernelName(fft_kernel Value)
+{
+    local_static const char *Names[FFTKernel_Count] = {"scalar", "avx2", "avx512"};
+    return ((u32)Value < FFTKernel_Count) ? Names[Value] : "?";
+}
+
+typedef struct fft_split_stage
+{
+    u32 Stride;    // S
+    u32 Quarter;   // N/S/4 butterflies per q; 0 for the radix-2 stage.
+    f32 *WRe[3];   // W^p, W^2p, W^3p for p < Quarter.
+    f32 *WIm[3];
+} fft_split_stage;
+
+typedef void fft_split_stage_fn(fft_split_stage *Stage, f32 *XRe, f32 *XIm, f32 *YRe, f32 *YIm);
+
+typedef struct fft_split_plan
+{
+    u32 Size;
+    u32 Log2Size;
+    u32 Batch;       // frames per transform, interleaved; 1 for a plain plan.
+    u32 StageCount;
+    fft_split_stage Stages[FFT_SPLIT_MAX_STAGES];
+    f32 *Twiddles;   // every stage's twiddles, one allocation.
+    f32 *WorkRe;     // Size*Batch entries each; the buffer stages ping-pong with.
+    f32 *WorkIm;
+    fft_kernel Kernel;
+    fft_split_stage_fn *RunStage;
+} fft_split_plan;
+
+//
+// Scalar reference.
+//
+
+internal void
+FFTSplitStageScalar(fft_split_stage *Stage, f32 *XRe, f32 *XIm, f32 *YRe, f32 *YIm)
+{
+    u32 S = Stage->Stride;
+    u32 M = Stage->Quarter;
+    if (M == 0)
+    {
+        for (u32 Q = 0; Q < S; Q++)
+        {
+            f32 ARe = XRe[Q], AIm = XIm[Q];
+            f32 BRe = XRe[Q + S], BIm = XIm[Q + S];
+            YRe[Q] = ARe + BRe;
+            YIm[Q] = AIm + BIm;
+            YRe[Q + S] = ARe - BRe;
+            YIm[Q + S] = AIm - BIm;
+        }
+        return;
+    }
+
+    for (u32 P = 0; P < M; P++)
+    {
+        f32 W1Re = Stage->WRe[0][P], W1Im = Stage->WIm[0][P];
+        f32 W2Re = Stage->WRe[1][P], W2Im = Stage->WIm[1][P];
+        f32 W3Re = Stage->WRe[2][P], W3Im = Stage->WIm[2][P];
+        for (u32 Q = 0; Q < S; Q++)
+        {
+            u32 In = Q + S*P;
+            u32 Out = Q + S*4*P;
+            f32 ARe = XRe[In], AIm = XIm[In];
+            f32 BRe = XRe[In + S*M], BIm = XIm[In + S*M];
+            f32 CRe = XRe[In + 2*S*M], CIm = XIm[In + 2*S*M];
+            f32 DRe = XRe[In + 3*S*M], DIm = XIm[In + 3*S*M];
+
+            f32 APCRe = ARe + CRe, APCIm = AIm + CIm;
+            f32 AMCRe = ARe - CRe, AMCIm = AIm - CIm;
+            f32 BPDRe = BRe + DRe, BPDIm = BIm + DIm;
+            // i*(b - d)
+            f32 JBMDRe = -(BIm - DIm), JBMDIm = BRe - DRe;
+
+            f32 T1Re = AMCRe - JBMDRe, T1Im = AMCIm - JBMDIm;
+            f32 T2Re = APCRe - BPDRe, T2Im = APCIm - BPDIm;
+            f32 T3Re = AMCRe + JBMDRe, T3Im = AMCIm + JBMDIm;
+
+            YRe[Out] = APCRe + BPDRe;
+            YIm[Out] = APCIm + BPDIm;
+            YRe[Out + S] = W1Re*T1Re - W1Im*T1Im;
+            YIm[Out + S] = W1Re*T1Im + W1Im*T1Re;
+            YRe[Out + 2*S] = W2Re*T2Re - W2Im*T2Im;
+            YIm[Out + 2*S] = W2Re*T2Im + W2Im*T2Re;
+            YRe[Out + 3*S] = W3Re*T3Re - W3Im*T3Im;
+            YIm[Out + 3*S] = W3Re*T3Im + W3Im*T3Re;
+        }
+    }
+}
+
+#if FFT_SIMD
+
+//
+// AVX2.
+//
+
+// The radix-4 butterfly on whole vectors, for either width. Writes the four
+// outputs, twiddled.
+#define mx_FFTButterfly4(Vec, Add, Sub, Mul, MulAdd, MulSub, ARe, AIm, BRe, BIm, CRe, CIm, DRe, DIm, W1Re, W1Im, W2Re, W2Im, W3Re, W3Im, Y0Re, Y0Im, Y1Re, Y1Im, Y2Re, Y2Im, Y3Re, Y3Im) \
+do { \
+    Vec APCRe_ = Add(ARe, CRe), APCIm_ = Add(AIm, CIm); \
+    Vec AMCRe_ = Sub(ARe, CRe), AMCIm_ = Sub(AIm, CIm); \
+    Vec BPDRe_ = Add(BRe, DRe), BPDIm_ = Add(BIm, DIm); \
+    Vec BMDRe_ = Sub(BRe, DRe), BMDIm_ = Sub(BIm, DIm); \
+    Vec T1Re_ = Add(AMCRe_, BMDIm_), T1Im_ = Sub(AMCIm_, BMDRe_); \
+    Vec T2Re_ = Sub(APCRe_, BPDRe_), T2Im_ = Sub(APCIm_, BPDIm_); \
+    Vec T3Re_ = Sub(AMCRe_, BMDIm_), T3Im_ = Add(AMCIm_, BMDRe_); \
+    Y0Re = Add(APCRe_, BPDRe_); Y0Im = Add(APCIm_, BPDIm_); \
+    Y1Re = MulSub(W1Re, T1Re_, Mul(W1Im, T1Im_)); Y1Im = MulAdd(W1Re, T1Im_, Mul(W1Im, T1Re_)); \
+    Y2Re = MulSub(W2Re, T2Re_, Mul(W2Im, T2Im_)); Y2Im = MulAdd(W2Re, T2Im_, Mul(W2Im, T2Re_)); \
+    Y3Re = MulSub(W3Re, T3Re_, Mul(W3Im, T3Im_)); Y3Im = MulAdd(W3Re, T3Im_, Mul(W3Im, T3Re_)); \
+} while (0)
+
+#define mx_FFTButterfly4AVX2(...) mx_FFTButterfly4(__m256, _mm256_add_ps, _mm256_sub_ps, _mm256_mul_ps, _mm256_fmadd_ps, _mm256_fmsub_ps, __VA_ARGS__)
+
+// Lane l of Y0..Y3 goes to Out[4l + 0..3].
+FFT_TARGET_AVX2 internal void
+FFTSplitStoreInterleaved4AVX2(f32 *Out, __m256 Y0, __m256 Y1, __m256 Y2, __m256 Y3)
+{
+    __m256 T0 = _mm256_unpacklo_ps(Y0, Y1);
+    __m256 T1 = _mm256_unpackhi_ps(Y0, Y1);
+    __m256 T2 = _mm256_unpacklo_ps(Y2, Y3);
+    __m256 T3 = _mm256_unpackhi_ps(Y2, Y3);
+    __m256 U0 = _mm256_shuffle_ps(T0, T2, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 U1 = _mm256_shuffle_ps(T0, T2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 U2 = _mm256_shuffle_ps(T1, T3, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 U3 = _mm256_shuffle_ps(T1, T3, _MM_SHUFFLE(3, 2, 3, 2));
+    _mm256_storeu_ps(Out + 0, _mm256_permute2f128_ps(U0, U1, 0x20));
+    _mm256_storeu_ps(Out + 8, _mm256_permute2f128_ps(U2, U3, 0x20));
+    _mm256_storeu_ps(Out + 16, _mm256_permute2f128_ps(U0, U1, 0x31));
+    _mm256_storeu_ps(Out + 24, _mm256_permute2f128_ps(U2, U3, 0x31));
+}
+
+// Low half to Out, high half to Out + HighOffset.
+FFT_TARGET_AVX2 internal void
+FFTSplitStoreHalvesAVX2(f32 *Out, u32 HighOffset, __m256 Y)
+{
+    _mm_storeu_ps(Out, _mm256_castps256_ps128(Y));
+    _mm_storeu_ps(Out + HighOffset, _mm256_extractf128_ps(Y, 1));
+}
+
+// Twiddle p in the low half, p+1 in the high half.
+FFT_TARGET_AVX2 internal __m256
+FFTSplitTwiddlePairAVX2(f32 *W, u32 P)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(W[P])), _mm_set1_ps(W[P + 1]), 1);
+}
+
+FFT_TARGET_AVX2 internal void
+FFTSplitStageAVX2(fft_split_stage *Stage, f32 *XRe, f32 *XIm, f32 *YRe, f32 *YIm)
+{
+    u32 S = Stage->Stride;
+    u32 M = Stage->Quarter;
+    if (M == 0)
+    {
+        if (S % 8 != 0)
+        {
+            FFTSplitStageScalar(Stage, XRe, XIm, YRe, YIm);
+            return;
+        }
+        for (u32 Q = 0; Q < S; Q += 8)
+        {
+            __m256 ARe = _mm256_loadu_ps(XRe + Q), AIm = _mm256_loadu_ps(XIm + Q);
+            __m256 BRe = _mm256_loadu_ps(XRe + Q + S), BIm = _mm256_loadu_ps(XIm + Q + S);
+            _mm256_storeu_ps(YRe + Q, _mm256_add_ps(ARe, BRe));
+            _mm256_storeu_ps(YIm + Q, _mm256_add_ps(AIm, BIm));
+            _mm256_storeu_ps(YRe + Q + S, _mm256_sub_ps(ARe, BRe));
+            _mm256_storeu_ps(YIm + Q + S, _mm256_sub_ps(AIm, BIm));
+        }
+        return;
+    }
+
+    __m256 Y0Re, Y0Im, Y1Re, Y1Im, Y2Re, Y2Im, Y3Re, Y3Im;
+    if (S == 1 && M % 8 == 0)
+    {
+        // 8 values of p per vector; the outputs for one p are adjacent.
+        for (u32 P = 0; P < M; P += 8)
+        {
+            __m256 ARe = _mm256_loadu_ps(XRe + P), AIm = _mm256_loadu_ps(XIm + P);
+            __m256 BRe = _mm256_loadu_ps(XRe + P + M), BIm = _mm256_loadu_ps(XIm + P + M);
+            __m256 CRe = _mm256_loadu_ps(XRe + P + 2*M), CIm = _mm256_loadu_ps(XIm + P + 2*M);
+            __m256 DRe = _mm256_loadu_ps(XRe + P + 3*M), DIm = _mm256_loadu_ps(XIm + P + 3*M);
+            __m256 W1Re = _mm256_loadu_ps(Stage->WRe[0] + P), W1Im = _mm256_loadu_ps(Stage->WIm[0] + P);
+            __m256 W2Re = _mm256_loadu_ps(Stage->WRe[1] + P), W2Im = _mm256_loadu_ps(Stage->WIm[1] + P);
+            __m256 W3Re = _mm256_loadu_ps(Stage->WRe[2] + P), W3Im = _mm256_loadu_ps(Stage->WIm[2] + P);
+            mx_FFTButterfly4AVX2(ARe, AIm, BRe, BIm, CRe, CIm, DRe, DIm, W1Re, W1Im, W2Re, W2Im, W3Re, W3Im,
+                                 Y0Re, Y0Im, Y1Re, Y1Im, Y2Re, Y2Im, Y3Re, Y3Im);
+            FFTSplitStoreInterleaved4AVX2(YRe + 4*P, Y0Re, Y1Re, Y2Re, Y3Re);
+            FFTSplitStoreInterleaved4AVX2(YIm + 4*P, Y0Im, Y1Im, Y2Im, Y3Im);
+        }
+    }
+    else if (S == 4 && M % 2 == 0)
+    {
+        // Two values of p per vector, 4 of q each; each output k is two
+        // 4-wide runs, 16 apart.
+        for (u32 P = 0; P < M; P += 2)
+        {
+            u32 In = 4*P;
+            __m256 ARe = _mm256_loadu_ps(XRe + In), AIm = _mm256_loadu_ps(XIm + In);
+            __m256 BRe = _mm256_loadu_ps(XRe + In + 4*M), BIm = _mm256_loadu_ps(XIm + In + 4*M);
+            __m256 CRe = _mm256_loadu_ps(XRe + In + 8*M), CIm = _mm256_loadu_ps(XIm + In + 8*M);
+            __m256 DRe = _mm256_loadu_ps(XRe + In + 12*M), DIm = _mm256_loadu_ps(XIm + In + 12*M);
+            __m256 W1Re = FFTSplitTwiddlePairAVX2(Stage->WRe[0], P), W1Im = FFTSplitTwiddlePairAVX2(Stage->WIm[0], P);
+            __m256 W2Re = FFTSplitTwiddlePairAVX2(Stage->WRe[1], P), W2Im = FFTSplitTwiddlePairAVX2(Stage->WIm[1], P);
+            __m256 W3Re = FFTSplitTwiddlePairAVX2(Stage->WRe[2], P), W3Im = FFTSplitTwiddlePairAVX2(Stage->WIm[2], P);
+            mx_FFTButterfly4AVX2(ARe, AIm, BRe, BIm, CRe, CIm, DRe, DIm, W1Re, W1Im, W2Re, W2Im, W3Re, W3Im,
+                                 Y0Re, Y0Im, Y1Re, Y1Im, Y2Re, Y2Im, Y3Re, Y3Im);
+            u32 Out = 16*P;
+            FFTSplitStoreHalvesAVX2(YRe + Out, 16, Y0Re);
+            FFTSplitStoreHalvesAVX2(YIm + Out, 16, Y0Im);
+            FFTSplitStoreHalvesAVX2(YRe + Out + 4, 16, Y1Re);
+            FFTSplitStoreHalvesAVX2(YIm + Out + 4, 16, Y1Im);
+            FFTSplitStoreHalvesAVX2(YRe + Out + 8, 16, Y2Re);
+            FFTSplitStoreHalvesAVX2(YIm + Out + 8, 16, Y2Im);
+            FFTSplitStoreHalvesAVX2(YRe + Out + 12, 16, Y3Re);
+            FFTSplitStoreHalvesAVX2(YIm + Out + 12, 16, Y3Im);
+        }
+    }
+    else if (S % 8 == 0)
+    {
+        for (u32 P = 0; P < M; P++)
+        {
+            __m256 W1Re = _mm256_set1_ps(Stage->WRe[0][P]), W1Im = _mm256_set1_ps(Stage->WIm[0][P]);
+            __m256 W2Re = _mm256_set1_ps(Stage->WRe[1][P]), W2Im = _mm256_set1_ps(Stage->WIm[1][P]);
+            __m256 W3Re = _mm256_set1_ps(Stage->WRe[2][P]), W3Im = _mm256_set1_ps(Stage->WIm[2][P]);
+            for (u32 Q = 0; Q < S; Q += 8)
+            {
+                u32 In = Q + S*P;
+                u32 Out = Q + S*4*P;
+                __m256 ARe = _mm256_loadu_ps(XRe + In), AIm = _mm256_loadu_ps(XIm + In);
+                __m256 BRe = _mm256_loadu_ps(XRe + In + S*M), BIm = _mm256_loadu_ps(XIm + In + S*M);
+                __m256 CRe = _mm256_loadu_ps(XRe + In + 2*S*M), CIm = _mm256_loadu_ps(XIm + In + 2*S*M);
+                __m256 DRe = _mm256_loadu_ps(XRe + In + 3*S*M), DIm = _mm256_loadu_ps(XIm + In + 3*S*M);
+                mx_FFTButterfly4AVX2(ARe, AIm, BRe, BIm, CRe, CIm, DRe, DIm, W1Re, W1Im, W2Re, W2Im, W3Re, W3Im,
+                                     Y0Re, Y0Im, Y1Re, Y1Im, Y2Re, Y2Im, Y3Re, Y3Im);
+                _mm256_storeu_ps(YRe + Out, Y0Re);
+                _mm256_storeu_ps(YIm + Out, Y0Im);
+                _mm256_storeu_ps(YRe + Out + S, Y1Re);
+                _mm256_storeu_ps(YIm + Out + S, Y1Im);
+                _mm256_storeu_ps(YRe + Out + 2*S, Y2Re);
+                _mm256_storeu_ps(YIm + Out + 2*S, Y2Im);
+                _mm256_storeu_ps(YRe + Out + 3*S, Y3Re);
+                _mm256_storeu_ps(YIm + Out + 3*S, Y3Im);
+            }
+        }
+    }
+    else
+    {
+        FFTSplitStageScalar(Stage, XRe, XIm, YRe, YIm);
+    }
+}
+
+//
+// AVX-512. Only the wide stages; the first two go through the AVX2 kernel.
+//
+
+#define mx_FFTButterfly4AVX512(...) mx_FFTButterfly4(__m512, _mm512_add_ps, _mm512_sub_ps, _mm512_mul_ps, _mm512_fmadd_ps, _mm512_fmsub_ps, __VA_ARGS__)
+
+FFT_TARGET_AVX512 internal void
+FFTSplitStageAVX512(fft_split_stage *Stage, f32 *XRe, f32 *XIm, f32 *YRe, f32 *YIm)
+{
+    u32 S = Stage->Stride;
+    u32 M = Stage->Quarter;
+    if (S % 16 != 0)
+    {
+        FFTSplitStageAVX2(Stage, XRe, XIm, YRe, YIm);
+        return;
+    }
+    if (M == 0)
+    {
+        for (u32 Q = 0; Q < S; Q += 16)
+        {
+            __m512 ARe = _mm512_loadu_ps(XRe + Q), AIm = _mm512_loadu_ps(XIm + Q);
+            __m512 BRe = _mm512_loadu_ps(XRe + Q + S), BIm = _mm512_loadu_ps(XIm + Q + S);
+            _mm512_storeu_ps(YRe + Q, _mm512_add_ps(ARe, BRe));
+            _mm512_storeu_ps(YIm + Q, _mm512_add_ps(AIm, BIm));
+            _mm512_storeu_ps(YRe + Q + S, _mm512_sub_ps(ARe, BRe));
+            _mm512_storeu_ps(YIm + Q + S, _mm512_sub_ps(AIm, BIm));
+        }
+        return;
+    }
+
+    __m512 Y0Re, Y0Im, Y1Re, Y1Im, Y2Re, Y2Im, Y3Re, Y3Im;
+    for (u32 P = 0; P < M; P++)
+    {
+        __m512 W1Re = _mm512_set1_ps(Stage->WRe[0][P]), W1Im = _mm512_set1_ps(Stage->WIm[0][P]);
+        __m512 W2Re = _mm512_set1_ps(Stage->WRe[1][P]), W2Im = _mm512_set1_ps(Stage->WIm[1][P]);
+        __m512 W3Re = _mm512_set1_ps(Stage->WRe[2][P]), W3Im = _mm512_set1_ps(Stage->WIm[2][P]);
+        for (u32 Q = 0; Q < S; Q += 16)
+        {
+            u32 In = Q + S*P;
+            u32 Out = Q + S*4*P;
+            __m512 ARe = _mm512_loadu_ps(XRe + In), AIm = _mm512_loadu_ps(XIm + In);
+            __m512 BRe = _mm512_loadu_ps(XRe + In + S*M), BIm = _mm512_loadu_ps(XIm + In + S*M);
+            __m512 CRe = _mm512_loadu_ps(XRe + In + 2*S*M), CIm = _mm512_loadu_ps(XIm + In + 2*S*M);
+            __m512 DRe = _mm512_loadu_ps(XRe + In + 3*S*M), DIm = _mm512_loadu_ps(XIm + In + 3*S*M);
+            mx_FFTButterfly4AVX512(ARe, AIm, BRe, BIm, CRe, CIm, DRe, DIm, W1Re, W1Im, W2Re, W2Im, W3Re, W3Im,
+                                   Y0Re, Y0Im, Y1Re, Y1Im, Y2Re, Y2Im, Y3Re, Y3Im);
+            _mm512_storeu_ps(YRe + Out, Y0Re);
+            _mm512_storeu_ps(YIm + Out, Y0Im);
+            _mm512_storeu_ps(YRe + Out + S, Y1Re);
+            _mm512_storeu_ps(YIm + Out + S, Y1Im);
+            _mm512_storeu_ps(YRe + Out + 2*S, Y2Re);
+            _mm512_storeu_ps(YIm + Out + 2*S, Y2Im);
+            _mm512_storeu_ps(YRe + Out + 3*S, Y3Re);
+            _mm512_storeu_ps(YIm + Out + 3*S, Y3Im);
+        }
+    }
+}
+
+#endif // FFT_SIMD
+
+//
+// Dispatch.
+//
+
+internal bool
+FFTKernelSupported(fft_kernel Kernel)
+{
+    if (Kernel == FFTKernel_Scalar) return true;
+#if FFT_SIMD
+#if defined(_MSC_VER) && !defined(__clang__)
+    i32 Info[4];
+    __cpuid(Info, 0);
+    if (Info[0] < 7) return false;
+    __cpuid(Info, 1);
+    bool HasFMA = (Info[2] & (1 << 12)) != 0;
+    bool HasOSXSave = (Info[2] & (1 << 27)) != 0;
+    if (!HasFMA || !HasOSXSave) return false;
+    u64 XCR0 = _xgetbv(0);
+    bool OSSavesYMM = (XCR0 & 0x6) == 0x6;
+    bool OSSavesZMM = (XCR0 & 0xE6) == 0xE6;
+    __cpuidex(Info, 7, 0);
+    bool HasAVX2 = (Info[1] & (1 << 5)) != 0;
+    bool HasAVX512F = (Info[1] & (1 << 16)) != 0;
+    if (Kernel == FFTKernel_AVX2) return HasAVX2 && OSSavesYMM;
+    if (Kernel == FFTKernel_AVX512) return HasAVX2 && HasAVX512F && OSSavesZMM;
+#else
+    __builtin_cpu_init();
+    bool HasAVX2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    if (Kernel == FFTKernel_AVX2) return HasAVX2;
+    if (Kernel == FFTKernel_AVX512) return HasAVX2 && __builtin_cpu_supports("avx512f");
+#endif
+#endif
+    return false;
+}
+
+internal fft_kernel
+FFTBestKernel(void)
+{
+    for (i32 Kernel = FFTKernel_Count - 1; Kernel > FFTKernel_Scalar; Kernel--)
+    {
+        if (FFTKernelSupported((fft_kernel)Kernel)) return (fft_kernel)Kernel;
+    }
+    return FFTKernel_Scalar;
+}
+
+// Falls back to the scalar kernel if Kernel isn't supported here.
+internal void
+FFTSplitSetKernel(fft_split_plan *Plan, fft_kernel Kernel)
+{
+    if (!FFTKernelSupported(Kernel)) Kernel = FFTKernel_Scalar;
+    Plan->Kernel = Kernel;
+    Plan->RunStage = FFTSplitStageScalar;
+#if FFT_SIMD
+    if (Kernel == FFTKernel_AVX2) Plan->RunStage = FFTSplitStageAVX2;
+    if (Kernel == FFTKernel_AVX512) Plan->RunStage = FFTSplitStageAVX512;
+#endif
+}
+
+// Size must be a power of two, at least 2, and Batch at least 1. Returns a
+// plan with Size == 0 otherwise. Uses the best kernel this CPU supports.
+internal fft_split_plan
+FFTSplitCreateBatchPlan(u32 Size, u32 Batch)
+{
+    fft_split_plan Plan = {0};
+    if (!FFTIsPowerOfTwo(Size) || Size < 2 || Batch == 0) return Plan;
+
+    Plan.Size = Size;
+    Plan.Batch = Batch;
+    while ((1u << Plan.Log2Size) < Size) Plan.Log2Size++;
+
+    u32 TwiddleCount = 0;
+    for (u32 Points = Size; Points >= 4; Points /= 4) TwiddleCount += 3 * 2 * (Points / 4);
+    Plan.Twiddles = (f32 *)malloc((TwiddleCount + 1) * sizeof(f32));
+    Plan.WorkRe = (f32 *)malloc((usize)Size * Batch * sizeof(f32));
+    Plan.WorkIm = (f32 *)malloc((usize)Size * Batch * sizeof(f32));
+
+    f32 *NextTwiddle = Plan.Twiddles;
+    u32 Stride = Batch;
+    for (u32 Points = Size; Points > 1; )
+    {
+        fft_split_stage *Stage = &Plan.Stages[Plan.StageCount++];
+        Stage->Stride = Stride;
+        if (Points == 2)
+        {
+            Stage->Quarter = 0;
+            break;
+        }
+        Stage->Quarter = Points / 4;
+        for (u32 Power = 0; Power < 3; Power++)
+        {
+            Stage->WRe[Power] = NextTwiddle;
+            Stage->WIm[Power] = NextTwiddle + Stage->Quarter;
+            NextTwiddle += 2 * Stage->Quarter;
+            for (u32 P = 0; P < Stage->Quarter; P++)
+            {
+                f64 Theta = FFT_TAU * (f64)((Power + 1) * P) / (f64)Points;
+                Stage->WRe[Power][P] = (f32)cos(Theta);
+                Stage->WIm[Power][P] = (f32)-sin(Theta);
+            }
+        }
+        Points /= 4;
+        Stride *= 4;
+    }
+
+    FFTSplitSetKernel(&Plan, FFTBestKernel());
+    return Plan;
+}
+
+internal fft_split_plan
+FFTSplitCreatePlan(u32 Size)
+{
+    return FFTSplitCreateBatchPlan(Size, 1);
+}
+
+internal void
+FFTSplitDestroyPlan(fft_split_plan *Plan)
+{
+    free(Plan->Twiddles);
+    free(Plan->WorkRe);
+    free(Plan->WorkIm);
+    Plan->Twiddles = 0;
+    Plan->WorkRe = 0;
+    Plan->WorkIm = 0;
+    Plan->Size = 0;
+}
+
+// X[k] = sum(x[n] * e^(-2*pi*i*k*n/Size)), in place, for each of the
+// plan's Batch frames.
+internal void
+FFTSplitForward(fft_split_plan *Plan, f32 *Re, f32 *Im)
+{
+    f32 *XRe = Re, *XIm = Im;
+    f32 *YRe = Plan->WorkRe, *YIm = Plan->WorkIm;
+    for (u32 StageIndex = 0; StageIndex < Plan->StageCount; StageIndex++)
+    {
+        Plan->RunStage(&Plan->Stages[StageIndex], XRe, XIm, YRe, YIm);
+        f32 *SwapRe = XRe, *SwapIm = XIm;
+        XRe = YRe; XIm = YIm;
+        YRe = SwapRe; YIm = SwapIm;
+    }
+    if (XRe != Re)
+    {
+        memcpy(Re, XRe, (usize)Plan->Size * Plan->Batch * sizeof(f32));
+        memcpy(Im, XIm, (usize)Plan->Size * Plan->Batch * sizeof(f32));
+    }
+}
+
+// Undoes FFTSplitForward, including the 1/Size scale. Swapping the real and
+// imaginary parts on the way in and out turns the forward transform into the
+// inverse one, and with split arrays that's just swapping the pointers.
+internal void
+FFTSplitInverse(fft_split_plan *Plan, f32 *Re, f32 *Im)
+{
+    FFTSplitForward(Plan, Im, Re);
+    f32 Scale = 1.0f / (f32)Plan->Size;
+    for (u32 Index = 0; Index < Plan->Size * Plan->Batch; Index++)
+    {
+        Re[Index] *= Scale;
+        Im[Index] *= Scale;
+    }
+}
+
+#endif //FFT_SPLIT_H
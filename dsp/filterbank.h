@@ -0,0 +1,350 @@
+/* date = October 18th 2026 */
+
+#ifndef FILTERBANK_H
+#define FILTERBANK_H
+
+// Log-spaced spectra from one FFT frame: a constant-Q transform and
+// triangular semitone and mel filterbanks, for music, where notes are a
+// fixed ratio apart rather than a fixed number of Hz.
+//
+// Every band is a weighted sum over a short run of FFT bins, precomputed at
+// create time, so a frame costs one real FFT plus a sparse multiply of a few
+// bins per band, however many bands there are.
+//
+// Constant-Q (Brown and Puckette's method): band k is the correlation of the
+// frame with a Hann-windowed complex exponential at its frequency f_k, Q
+// cycles long with Q = 1/(2^(1/BandsPerOctave) - 1), so every band is as
+// selective as a semitone (at 12 per octave) and the low ones are long. By
+// Parseval that's sum(X[j] * conj(K_k[j])) / FFTSize over the kernel's
+// spectrum K_k, which is a narrow peak around f_k: the bins below Threshold
+// of its peak are dropped. The kernels end at the end of the frame, so the
+// newest samples count for every band and high notes show up at once.
+//
+// Semitone and mel: triangles on the Hann-windowed power spectrum, each one
+// rising from the band below's centre and falling to the band above's. Mel
+// bands are evenly spaced in mels between MinFreq and MaxFreq.
+//
+// Bands are amplitudes: a sine of amplitude A at a band's centre gives about
+// A there.
+//
+// Needs fft_planner.h.
+
+#define FILTERBANK_THRESHOLD 0.01f
+
+typedef enum filterbank_kind
+{
+    FilterbankKind_ConstantQ,
+    FilterbankKind_Semitone,
+    FilterbankKind_Mel,
+    FilterbankKind_Count,
+} filterbank_kind;
+
+internal const char *
+FilterbankKindName(filterbank_kind Value)
+{
+    local_static const char *Names[FilterbankKind_Count] = {"constant-q", "semitone", "mel"};
+    return ((u32)Value < FilterbankKind_Count) ? Names[Value] : "?";
+}
+
+typedef struct filterbank_config
+{
+    filterbank_kind Kind;
+    u32 FFTSize;         // even, at least 4; constant-Q needs its lowest kernel to fit.
+    f32 SampleRate;
+    f32 MinFreq;         // constant-Q and semitone: the first band's centre; mel: the lowest edge.
+    f32 MaxFreq;         // the highest centre (or mel edge), at most Nyquist; 0 means Nyquist.
+    u32 BandsPerOctave;  // constant-Q and semitone; 0 means 12.
+    u32 BandCount;       // mel.
+    f32 Threshold;       // constant-Q; 0 means FILTERBANK_THRESHOLD.
+} filterbank_config;
+
+typedef struct filterbank_band
+{
+    f32 Freq;            // centre.
+    u32 FirstBin;
+    u32 BinCount;
+    u32 FirstWeight;     // into Kernels or Weights.
+    u32 Length;          // constant-Q: samples in the kernel.
+} filterbank_band;
+
+typedef struct filterbank
+{
+    filterbank_config Config;
+    u32 BandCount;
+    filterbank_band *Bands;
+    u32 WeightCount;     // nonzero weights over all bands.
+    complex32 *Kernels;  // constant-Q: conj(K_k[j]) * 2 / FFTSize.
+    f32 *Weights;        // semitone and mel.
+    planned_fft *Forward;
+    f32 *Window;         // semitone and mel: Hann over the frame.
+    f32 *Frame;          // FFTSize entries.
+    complex32 *Spectrum; // FFTSize/2 + 1 entries.
+} filterbank;
+
+internal f32
+FilterbankMel(f32 Freq)
+{
+    return 2595.0f * log10f(1.0f + Freq / 700.0f);
+}
+
+internal f32
+FilterbankFreqFromMel(f32 Mel)
+{
+    return 700.0f * (powf(10.0f, Mel / 2595.0f) - 1.0f);
+}
+
+internal f32
+FilterbankQ(u32 BandsPerOctave)
+{
+    return 1.0f / (powf(2.0f, 1.0f / BandsPerOctave) - 1.0f);
+}
+
+// Fills in defaults and counts the bands. Returns false if they can't work.
+internal bool
+FilterbankConfigResolve(filterbank_config *Config, u32 *BandCount)
+{
+    f32 Nyquist = Config->SampleRate / 2;
+    if (Config->MaxFreq <= 0 || Config->MaxFreq > Nyquist) Config->MaxFreq = Nyquist;
+    if (Config->BandsPerOctave == 0) Config->BandsPerOctave = 12;
+    if (Config->Threshold <= 0) Config->Threshold = FILTERBANK_THRESHOLD;
+    if (!FFTPlanSizeValid(Config->FFTSize, FFTType_Real) || Config->Kind >= FilterbankKind_Count ||
+        Config->SampleRate <= 0 || Config->MinFreq <= 0 || Config->MinFreq >= Config->MaxFreq) return false;
+
+    if (Config->Kind == FilterbankKind_Mel)
+    {
+        *BandCount = Config->BandCount;
+        return (Config->BandCount > 0);
+    }
+    *BandCount = 1 + (u32)floorf(Config->BandsPerOctave * log2f(Config->MaxFreq / Config->MinFreq) + 1e-4f);
+    if (Config->Kind == FilterbankKind_ConstantQ)
+    {
+        f32 Longest = FilterbankQ(Config->BandsPerOctave) * Config->SampleRate / Config->MinFreq;
+        return (ceilf(Longest) <= Config->FFTSize);
+    }
+    return true;
+}
+
+// Constant-Q kernels: each band's exponential is transformed and its
+// spectrum trimmed to the run of bins around the peak above Threshold.
+internal void
+FilterbankCreateConstantQ(fft_planner *Planner, filterbank *Filterbank)
+{
+    filterbank_config *Config = &Filterbank->Config;
+    u32 Size = Config->FFTSize;
+    u32 BinCount = Size/2 + 1;
+    f32 Q = FilterbankQ(Config->BandsPerOctave);
+    planned_fft *Complex = FFTPlan(Planner, Size, FFTType_Complex, FFTDirection_Forward);
+    complex32 *Kernel = (complex32 *)malloc(Size * sizeof(complex32));
+
+    // The runs are kept as they're found, growing Kernels as it goes.
+    u32 Capacity = 0;
+    for (u32 Band = 0; Band < Filterbank->BandCount; Band++)
+    {
+        filterbank_band *Info = &Filterbank->Bands[Band];
+        Info->Freq = Config->MinFreq * powf(2.0f, (f32)Band / Config->BandsPerOctave);
+        Info->Length = (u32)ceilf(Q * Config->SampleRate / Info->Freq);
+        if (Info->Length > Size) Info->Length = Size;
+
+        memset(Kernel, 0, Size * sizeof(complex32));
+        u32 Start = Size - Info->Length;
+        f64 WindowSum = 0;
+        for (u32 N = 0; N < Info->Length; N++) WindowSum += 0.5 - 0.5*cos(FFT_TAU * (N + 0.5) / Info->Length);
+        for (u32 N = 0; N < Info->Length; N++)
+        {
+            f64 Window = (0.5 - 0.5*cos(FFT_TAU * (N + 0.5) / Info->Length)) / WindowSum;
+            f64 Phase = FFT_TAU * Info->Freq * (f64)(Start + N) / Config->SampleRate;
+            Kernel[Start + N].Re = (f32)(Window * cos(Phase));
+            Kernel[Start + N].Im = (f32)(Window * sin(Phase));
+        }
+        FFTExecuteComplex(Complex, Kernel);
+
+        f32 Peak = 0;
+        for (u32 Bin = 0; Bin < BinCount; Bin++) Peak = fmaxf(Peak, ComplexMagnitude(Kernel[Bin]));
+        u32 First = BinCount;
+        u32 Last = 0;
+        for (u32 Bin = 0; Bin < BinCount; Bin++)
+        {
+            if (ComplexMagnitude(Kernel[Bin]) < Config->Threshold * Peak) continue;
+            if (First == BinCount) First = Bin;
+            Last = Bin;
+        }
+        Info->FirstBin = First;
+        Info->BinCount = Last - First + 1;
+        Info->FirstWeight = Filterbank->WeightCount;
+        Filterbank->WeightCount += Info->BinCount;
+        if (Filterbank->WeightCount > Capacity)
+        {
+            Capacity = 2 * Filterbank->WeightCount;
+            Filterbank->Kernels = (complex32 *)realloc(Filterbank->Kernels, Capacity * sizeof(complex32));
+        }
+        for (u32 Bin = 0; Bin < Info->BinCount; Bin++)
+        {
+            complex32 Value = Kernel[First + Bin];
+            complex32 Weight = {Value.Re * 2.0f / Size, -Value.Im * 2.0f / Size};
+            Filterbank->Kernels[Info->FirstWeight + Bin] = Weight;
+        }
+    }
+    free(Kernel);
+}
+
+// Triangles from Lower up to Centre and down to Upper. The Hann window
+// spreads a sine's power over three bins, 1 + 1/4 + 1/4 of its peak bin's,
+// so the weights carry 2/3 to give back its amplitude at the centre. A band
+// narrower than a bin gets the nearest bin whole.
+internal void
+FilterbankAddTriangle(filterbank *Filterbank, filterbank_band *Band, f32 Lower, f32 Centre, f32 Upper, u32 *Capacity)
+{
+    filterbank_config *Config = &Filterbank->Config;
+    f32 BinWidth = Config->SampleRate / Config->FFTSize;
+    u32 MaxBin = Config->FFTSize / 2;
+    u32 First = (u32)ceilf(Lower / BinWidth);
+    u32 Last = (u32)floorf(Upper / BinWidth);
+    if (Last > MaxBin) Last = MaxBin;
+    if (First > Last || Last * BinWidth <= Lower || First * BinWidth >= Upper)
+    {
+        First = Last = (u32)(Centre / BinWidth + 0.5f);
+        if (First > MaxBin) First = Last = MaxBin;
+    }
+
+    Band->Freq = Centre;
+    Band->FirstBin = First;
+    Band->BinCount = Last - First + 1;
+    Band->FirstWeight = Filterbank->WeightCount;
+    Filterbank->WeightCount += Band->BinCount;
+    if (Filterbank->WeightCount > *Capacity)
+    {
+        *Capacity = 2 * Filterbank->WeightCount;
+        Filterbank->Weights = (f32 *)realloc(Filterbank->Weights, *Capacity * sizeof(f32));
+    }
+
+    f32 *Weights = Filterbank->Weights + Band->FirstWeight;
+    for (u32 Bin = First; Bin <= Last; Bin++)
+    {
+        f32 Freq = Bin * BinWidth;
+        f32 Weight = (Freq <= Centre) ? (Freq - Lower) / (Centre - Lower) : (Upper - Freq) / (Upper - Centre);
+        if (Band->BinCount == 1) Weight = 1.0f;
+        Weights[Bin - First] = fminf(fmaxf(Weight, 0.0f), 1.0f) * (2.0f / 3.0f);
+    }
+}
+
+// Returns a filterbank with BandCount == 0 if the config can't work.
+internal filterbank
+FilterbankCreate(fft_planner *Planner, filterbank_config Config)
+{
+    filterbank Filterbank = {0};
+    u32 BandCount = 0;
+    if (!FilterbankConfigResolve(&Config, &BandCount)) return Filterbank;
+
+    Filterbank.Config = Config;
+    Filterbank.BandCount = BandCount;
+    Filterbank.Bands = (filterbank_band *)calloc(BandCount, sizeof(filterbank_band));
+    Filterbank.Forward = FFTPlan(Planner, Config.FFTSize, FFTType_Real, FFTDirection_Forward);
+    Filterbank.Frame = (f32 *)malloc(Config.FFTSize * sizeof(f32));
+    Filterbank.Spectrum = (complex32 *)malloc((Config.FFTSize/2 + 1) * sizeof(complex32));
+
+    if (Config.Kind == FilterbankKind_ConstantQ)
+    {
+        FilterbankCreateConstantQ(Planner, &Filterbank);
+        return Filterbank;
+    }
+
+    // The triangle window is Hann over the whole frame, scaled by 2 so a
+    // sine's peak bin comes out near its amplitude.
+    Filterbank.Window = (f32 *)malloc(Config.FFTSize * sizeof(f32));
+    for (u32 N = 0; N < Config.FFTSize; N++)
+    {
+        Filterbank.Window[N] = (f32)(1.0 - cos(FFT_TAU * (f64)N / Config.FFTSize)) / Config.FFTSize * 2.0f;
+    }
+
+    u32 Capacity = 0;
+    for (u32 Band = 0; Band < BandCount; Band++)
+    {
+        f32 Lower, Centre, Upper;
+        if (Config.Kind == FilterbankKind_Mel)
+        {
+            f32 MinMel = FilterbankMel(Config.MinFreq);
+            f32 Step = (FilterbankMel(Config.MaxFreq) - MinMel) / (BandCount + 1);
+            Lower = FilterbankFreqFromMel(MinMel + Step * Band);
+            Centre = FilterbankFreqFromMel(MinMel + Step * (Band + 1));
+            Upper = FilterbankFreqFromMel(MinMel + Step * (Band + 2));
+        }
+        else
+        {
+            Centre = Config.MinFreq * powf(2.0f, (f32)Band / Config.BandsPerOctave);
+            Lower = Centre * powf(2.0f, -1.0f / Config.BandsPerOctave);
+            Upper = Centre * powf(2.0f, 1.0f / Config.BandsPerOctave);
+        }
+        FilterbankAddTriangle(&Filterbank, &Filterbank.Bands[Band], Lower, Centre, Upper, &Capacity);
+    }
+    return Filterbank;
+}
+
+internal void
+FilterbankDestroy(filterbank *Filterbank)
+{
+    free(Filterbank->Bands);
+    free(Filterbank->Kernels);
+    free(Filterbank->Weights);
+    free(Filterbank->Window);
+    free(Filterbank->Frame);
+    free(Filterbank->Spectrum);
+    Filterbank->Bands = 0;
+    Filterbank->Kernels = 0;
+    Filterbank->Weights = 0;
+    Filterbank->Window = 0;
+    Filterbank->Frame = 0;
+    Filterbank->Spectrum = 0;
+    Filterbank->BandCount = 0;
+}
+
+// The sparse multiply: BandCount amplitudes from a half-spectrum of the
+// frame, transformed unwindowed for constant-Q and Hann-windowed (as
+// FilterbankTransform does) for the triangles.
+internal void
+FilterbankApply(filterbank *Filterbank, complex32 *Spectrum, f32 *Bands)
+{
+    for (u32 Band = 0; Band < Filterbank->BandCount; Band++)
+    {
+        filterbank_band *Info = &Filterbank->Bands[Band];
+        complex32 *Bins = Spectrum + Info->FirstBin;
+        if (Filterbank->Kernels)
+        {
+            complex32 *Kernel = Filterbank->Kernels + Info->FirstWeight;
+            f32 SumRe = 0;
+            f32 SumIm = 0;
+            for (u32 Bin = 0; Bin < Info->BinCount; Bin++)
+            {
+                SumRe += Bins[Bin].Re*Kernel[Bin].Re - Bins[Bin].Im*Kernel[Bin].Im;
+                SumIm += Bins[Bin].Re*Kernel[Bin].Im + Bins[Bin].Im*Kernel[Bin].Re;
+            }
+            Bands[Band] = sqrtf(SumRe*SumRe + SumIm*SumIm);
+        }
+        else
+        {
+            f32 *Weights = Filterbank->Weights + Info->FirstWeight;
+            f32 Power = 0;
+            for (u32 Bin = 0; Bin < Info->BinCount; Bin++)
+            {
+                Power += Weights[Bin] * (Bins[Bin].Re*Bins[Bin].Re + Bins[Bin].Im*Bins[Bin].Im);
+            }
+            Bands[Band] = sqrtf(Power);
+        }
+    }
+}
+
+// One frame of FFTSize samples, oldest first, into BandCount amplitudes.
+internal void
+FilterbankTransform(filterbank *Filterbank, f32 *Samples, f32 *Bands)
+{
+    u32 Size = Filterbank->Config.FFTSize;
+    f32 *Frame = Samples;
+    if (Filterbank->Window)
+    {
+        for (u32 N = 0; N < Size; N++) Filterbank->Frame[N] = Samples[N] * Filterbank->Window[N];
+        Frame = Filterbank->Frame;
+    }
+    FFTExecuteReal(Filterbank->Forward, Frame, Filterbank->Spectrum);
+    FilterbankApply(Filterbank, Filterbank->Spectrum, Bands);
+}
+
+#endif //FILTERBANK_H
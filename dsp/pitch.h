@@ -0,0 +1,252 @@
+/* date = October 18th 2026 */
+
+#ifndef PITCH_H
+#define PITCH_H
+
+// Monophonic pitch tracking with the McLeod pitch method.
+//
+// Every HopSize samples the last WindowSize are autocorrelated through one
+// real FFT pair: the frame is zero padded so the wrap-around doesn't reach
+// the lags used, the spectrum is replaced by its power and transformed back.
+// The normalized square difference
+//
+//   n(t) = 2 r(t) / m(t),   m(t) = sum over j < W - t of x[j]^2 + x[j+t]^2
+//
+// is the autocorrelation scaled so a perfectly periodic signal gives 1 at
+// its period; m follows from running sums, so a frame costs O(W log W).
+// (YIN's difference function is m(t) - 2 r(t), the same data.) The period is
+// the first "key maximum" (the highest point between two rising zero
+// crossings of n) that reaches Cutoff of the highest one, refined with a
+// parabola, which picks the fundamental over its octaves and fifths.
+//
+// Confidence is n at that peak: near 1 for a steady note, lower for noise,
+// chords without a common period, or a note changing under the window. A
+// frame quieter than SilenceRMS, or without a key maximum, reports 0 Hz at 0
+// confidence.
+//
+// Needs fft_planner.h.
+
+#define PITCH_WINDOW 2048
+#define PITCH_MIN_FREQ 50.0f
+#define PITCH_CUTOFF 0.93f
+#define PITCH_SILENCE_RMS 1e-4f
+#define PITCH_MAX_KEY_MAXIMA 64
+
+typedef struct pitch_config
+{
+    f32 SampleRate;
+    u32 WindowSize;  // 0 means PITCH_WINDOW; the longest period has to fit in half of it.
+    u32 HopSize;     // samples between detections; 0 means WindowSize/4.
+    f32 MinFreq;     // 0 means PITCH_MIN_FREQ.
+    f32 MaxFreq;     // 0 means a quarter of the sample rate.
+    f32 Cutoff;      // 0 means PITCH_CUTOFF.
+    f32 SilenceRMS;  // 0 means PITCH_SILENCE_RMS.
+} pitch_config;
+
+typedef struct pitch_estimate
+{
+    f32 Freq;        // Hz, 0 if nothing was found.
+    f32 Confidence;  // 0 to 1.
+} pitch_estimate;
+
+typedef struct pitch_tracker
+{
+    pitch_config Config;
+    u32 MinLag;
+    u32 MaxLag;
+    u32 FFTSize;
+    planned_fft *Forward;
+    planned_fft *Inverse;
+    f32 *Ring;            // WindowSize samples.
+    u32 WriteIndex;
+    u32 SinceDetect;
+    f32 *Window;          // the ring unrolled.
+    f32 *Frame;           // FFTSize entries; the autocorrelation after a detect.
+    complex32 *Spectrum;  // FFTSize/2 + 1 entries.
+    f32 *Nsdf;            // MaxLag + 2 entries.
+    pitch_estimate Estimate;
+    u64 DetectCount;
+} pitch_tracker;
+
+// Fills in defaults. Returns false if the lag range doesn't fit the window.
+internal bool
+PitchConfigResolve(pitch_config *Config, u32 *MinLag, u32 *MaxLag)
+{
+    if (Config->WindowSize == 0) Config->WindowSize = PITCH_WINDOW;
+    if (Config->HopSize == 0) Config->HopSize = Config->WindowSize / 4;
+    if (Config->MinFreq <= 0) Config->MinFreq = PITCH_MIN_FREQ;
+    if (Config->MaxFreq <= 0) Config->MaxFreq = Config->SampleRate / 4;
+    if (Config->Cutoff <= 0) Config->Cutoff = PITCH_CUTOFF;
+    if (Config->SilenceRMS <= 0) Config->SilenceRMS = PITCH_SILENCE_RMS;
+    if (Config->SampleRate <= 0 || Config->MinFreq >= Config->MaxFreq || Config->WindowSize < 16) return false;
+
+    *MinLag = (u32)floorf(Config->SampleRate / Config->MaxFreq);
+    *MaxLag = (u32)ceilf(Config->SampleRate / Config->MinFreq);
+    return (*MinLag >= 2 && *MaxLag + 1 <= Config->WindowSize / 2);
+}
+
+// Returns a tracker with no buffers if the config can't work.
+internal pitch_tracker
+PitchTrackerCreate(fft_planner *Planner, pitch_config Config)
+{
+    pitch_tracker Tracker = {0};
+    u32 MinLag, MaxLag;
+    if (!PitchConfigResolve(&Config, &MinLag, &MaxLag)) return Tracker;
+
+    Tracker.Config = Config;
+    Tracker.MinLag = MinLag;
+    Tracker.MaxLag = MaxLag;
+    Tracker.FFTSize = 16;
+    while (Tracker.FFTSize < Config.WindowSize + MaxLag + 2) Tracker.FFTSize *= 2;
+    Tracker.Forward = FFTPlan(Planner, Tracker.FFTSize, FFTType_Real, FFTDirection_Forward);
+    Tracker.Inverse = FFTPlan(Planner, Tracker.FFTSize, FFTType_Real, FFTDirection_Inverse);
+    Tracker.Ring = (f32 *)calloc(Config.WindowSize, sizeof(f32));
+    Tracker.Window = (f32 *)calloc(Config.WindowSize, sizeof(f32));
+    Tracker.Frame = (f32 *)calloc(Tracker.FFTSize, sizeof(f32));
+    Tracker.Spectrum = (complex32 *)calloc(Tracker.FFTSize/2 + 1, sizeof(complex32));
+    Tracker.Nsdf = (f32 *)calloc(MaxLag + 2, sizeof(f32));
+    return Tracker;
+}
+
+internal void
+PitchTrackerDestroy(pitch_tracker *Tracker)
+{
+    free(Tracker->Ring);
+    free(Tracker->Window);
+    free(Tracker->Frame);
+    free(Tracker->Spectrum);
+    free(Tracker->Nsdf);
+    Tracker->Ring = 0;
+    Tracker->Window = 0;
+    Tracker->Frame = 0;
+    Tracker->Spectrum = 0;
+    Tracker->Nsdf = 0;
+}
+
+// Forgets the stream so far, as if it had been silent.
+internal void
+PitchTrackerReset(pitch_tracker *Tracker)
+{
+    if (!Tracker->Ring) return;
+    memset(Tracker->Ring, 0, Tracker->Config.WindowSize * sizeof(f32));
+    Tracker->WriteIndex = 0;
+    Tracker->SinceDetect = 0;
+    pitch_estimate Silent = {0};
+    Tracker->Estimate = Silent;
+}
+
+// Pitch of WindowSize samples, independent of the stream.
+internal pitch_estimate
+PitchDetect(pitch_tracker *Tracker, f32 *Samples)
+{
+    pitch_estimate Estimate = {0};
+    pitch_config *Config = &Tracker->Config;
+    u32 WindowSize = Config->WindowSize;
+    u32 MaxLag = Tracker->MaxLag;
+    f32 *Nsdf = Tracker->Nsdf;
+    Tracker->DetectCount++;
+
+    f32 Energy = 0;
+    for (u32 N = 0; N < WindowSize; N++) Energy += Samples[N] * Samples[N];
+    if (Energy < Config->SilenceRMS * Config->SilenceRMS * WindowSize) return Estimate;
+
+    // Autocorrelation: r = IFFT(|FFT(x)|^2) with the padding past the window.
+    memcpy(Tracker->Frame, Samples, WindowSize * sizeof(f32));
+    memset(Tracker->Frame + WindowSize, 0, (Tracker->FFTSize - WindowSize) * sizeof(f32));
+    FFTExecuteReal(Tracker->Forward, Tracker->Frame, Tracker->Spectrum);
+    for (u32 Bin = 0; Bin <= Tracker->FFTSize/2; Bin++)
+    {
+        complex32 Value = Tracker->Spectrum[Bin];
+        Tracker->Spectrum[Bin].Re = Value.Re*Value.Re + Value.Im*Value.Im;
+        Tracker->Spectrum[Bin].Im = 0;
+    }
+    FFTExecuteReal(Tracker->Inverse, Tracker->Frame, Tracker->Spectrum);
+
+    f32 *Correlation = Tracker->Frame;
+    f32 Sum = 2*Energy;
+    Nsdf[0] = 1;
+    for (u32 Lag = 1; Lag <= MaxLag + 1; Lag++)
+    {
+        Sum -= Samples[Lag - 1]*Samples[Lag - 1] + Samples[WindowSize - Lag]*Samples[WindowSize - Lag];
+        Nsdf[Lag] = (Sum > 0) ? 2*Correlation[Lag] / Sum : 0;
+    }
+
+    // Key maxima: the highest point of each positive lobe after the first
+    // zero crossing. A lobe still rising at MaxLag doesn't count.
+    u32 KeyLags[PITCH_MAX_KEY_MAXIMA];
+    u32 KeyCount = 0;
+    f32 Highest = 0;
+    u32 Lag = 1;
+    while (Lag <= MaxLag && Nsdf[Lag] > 0) Lag++;
+    u32 LobeMax = 0;
+    for (; Lag <= MaxLag && KeyCount < PITCH_MAX_KEY_MAXIMA; Lag++)
+    {
+        if (Nsdf[Lag] > 0)
+        {
+            if (LobeMax == 0 || Nsdf[Lag] > Nsdf[LobeMax]) LobeMax = Lag;
+        }
+        else if (LobeMax)
+        {
+            KeyLags[KeyCount++] = LobeMax;
+            Highest = (Nsdf[LobeMax] > Highest) ? Nsdf[LobeMax] : Highest;
+            LobeMax = 0;
+        }
+    }
+    if (LobeMax && LobeMax < MaxLag && KeyCount < PITCH_MAX_KEY_MAXIMA)
+    {
+        KeyLags[KeyCount++] = LobeMax;
+        Highest = (Nsdf[LobeMax] > Highest) ? Nsdf[LobeMax] : Highest;
+    }
+
+    for (u32 Key = 0; Key < KeyCount; Key++)
+    {
+        u32 Peak = KeyLags[Key];
+        if (Peak < Tracker->MinLag || Nsdf[Peak] < Config->Cutoff * Highest) continue;
+
+        f32 Left = Nsdf[Peak - 1];
+        f32 Centre = Nsdf[Peak];
+        f32 Right = Nsdf[Peak + 1];
+        f32 Curve = Left - 2*Centre + Right;
+        f32 Offset = (Curve < 0) ? 0.5f * (Left - Right) / Curve : 0;
+        f32 Value = Centre - 0.25f * (Left - Right) * Offset;
+        Estimate.Freq = Config->SampleRate / ((f32)Peak + Offset);
+        Estimate.Confidence = (Value > 1) ? 1 : (Value < 0) ? 0 : Value;
+        break;
+    }
+    return Estimate;
+}
+
+// Feeds a block of any size. Returns true if a new estimate was made; the
+// latest is in Tracker->Estimate.
+internal bool
+PitchTrackerPush(pitch_tracker *Tracker, f32 *Samples, u32 Count)
+{
+    if (!Tracker->Ring) return false;
+    u32 WindowSize = Tracker->Config.WindowSize;
+    bool Updated = false;
+    while (Count > 0)
+    {
+        u32 Step = Tracker->Config.HopSize - Tracker->SinceDetect;
+        Step = (Step < Count) ? Step : Count;
+        for (u32 N = 0; N < Step; N++)
+        {
+            Tracker->Ring[Tracker->WriteIndex] = Samples[N];
+            Tracker->WriteIndex = (Tracker->WriteIndex + 1 == WindowSize) ? 0 : Tracker->WriteIndex + 1;
+        }
+        Samples += Step;
+        Count -= Step;
+        Tracker->SinceDetect += Step;
+        if (Tracker->SinceDetect == Tracker->Config.HopSize)
+        {
+            u32 OlderCount = WindowSize - Tracker->WriteIndex;
+            memcpy(Tracker->Window, Tracker->Ring + Tracker->WriteIndex, OlderCount * sizeof(f32));
+            memcpy(Tracker->Window + OlderCount, Tracker->Ring, Tracker->WriteIndex * sizeof(f32));
+            Tracker->Estimate = PitchDetect(Tracker, Tracker->Window);
+            Tracker->SinceDetect = 0;
+            Updated = true;
+        }
+    }
+    return Updated;
+}
+
+#endif //PITCH_H
@@ -0,0 +1,168 @@
+/* date = October 18th 2026 */
+
+#ifndef REAL_FFT_H
+#define REAL_FFT_H
+
+// Real-input FFT, done as a complex FFT of half the size.
+//
+// The Size real samples are packed as Size/2 complex ones, z[n] = x[2n] +
+// i*x[2n+1], and transformed. The even and odd samples' spectra are then
+// pulled apart again and combined with one more radix-2 step (the "post-twiddle"
+// pass):
+//
+//   E[k] = (Z[k] + conj(Z[M-k])) / 2
+//   O[k] = (Z[k] - conj(Z[M-k])) / 2i
+//   X[k] = E[k] + e^(-2*pi*i*k/Size) * O[k],   M = Size/2
+//
+// The spectrum of a real signal is Hermitian, X[Size-k] = conj(X[k]), so only
+// the half-spectrum X[0] .. X[Size/2] is stored: Size/2 + 1 bins, with X[0]
+// and X[Size/2] purely real. Bin k is k cycles per Size samples, so it can be
+// drawn as is, and multiplying two half-spectra bin by bin is a circular
+// convolution once it's inverted.
+//
+// Needs fft.h.
+
+typedef struct real_fft_plan
+{
+    u32 Size;
+    fft_plan Half;        // Size/2 points.
+    complex32 *Twiddles;  // Size/4 + 1 entries: e^(-2*pi*i*k/Size).
+} real_fft_plan;
+
+// Size must be even, at least 4. Returns a plan with Size == 0 otherwise.
+// Half, the radix-2 transform RealFFTForward and RealFFTInverse run, is only
+// made for powers of two; other sizes just get the twiddle passes, and the
+// planner runs their half-size transform with fft_mixed.h.
+internal real_fft_plan
+RealFFTCreatePlan(u32 Size)
+{
+    real_fft_plan Plan = {0};
+    if ((Size & 1) || Size < 4) return Plan;
+
+    Plan.Size = Size;
+    if (FFTIsPowerOfTwo(Size)) Plan.Half = FFTCreatePlan(Size / 2);
+    Plan.Twiddles = (complex32 *)malloc((Size/4 + 1) * sizeof(complex32));
+    for (u32 K = 0; K < Size/4 + 1; K++)
+    {
+        f64 Theta = FFT_TAU * (f64)K / (f64)Size;
+        Plan.Twiddles[K].Re = (f32)cos(Theta);
+        Plan.Twiddles[K].Im = (f32)-sin(Theta);
+    }
+    return Plan;
+}
+
+internal void
+RealFFTDestroyPlan(real_fft_plan *Plan)
+{
+    FFTDestroyPlan(&Plan->Half);
+    free(Plan->Twiddles);
+    Plan->Twiddles = 0;
+    Plan->Size = 0;
+}
+
+// Half-spectrum bins for a plan's size.
+internal u32
+RealFFTBinCount(real_fft_plan *Plan)
+{
+    return Plan->Size/2 + 1;
+}
+
+// Spectrum[0 .. Size/2) holds the half-size transform of the packed samples;
+// turns it into the Size/2 + 1 bin half-spectrum, in place.
+internal void
+RealFFTPostTwiddle(real_fft_plan *Plan, complex32 *Spectrum)
+{
+    u32 HalfSize = Plan->Size / 2;
+
+    // Z[0] holds the sums of the even and odd samples.
+    complex32 Z0 = Spectrum[0];
+    Spectrum[0].Re = Z0.Re + Z0.Im;
+    Spectrum[0].Im = 0.0f;
+    Spectrum[HalfSize].Re = Z0.Re - Z0.Im;
+    Spectrum[HalfSize].Im = 0.0f;
+
+    // Bins k and M-k share their inputs, so they're done together in place.
+    // With W = e^(-2*pi*i*k/Size), X[M-k] = conj(E[k] - W*O[k]).
+    for (u32 K = 1; K <= HalfSize/2; K++)
+    {
+        complex32 A = Spectrum[K];
+        complex32 B = Spectrum[HalfSize - K];
+        complex32 Even, Odd;
+        Even.Re = 0.5f * (A.Re + B.Re);
+        Even.Im = 0.5f * (A.Im - B.Im);
+        Odd.Re = 0.5f * (A.Im + B.Im);
+        Odd.Im = -0.5f * (A.Re - B.Re);
+        complex32 T = ComplexMul(Plan->Twiddles[K], Odd);
+        Spectrum[K].Re = Even.Re + T.Re;
+        Spectrum[K].Im = Even.Im + T.Im;
+        Spectrum[HalfSize - K].Re = Even.Re - T.Re;
+        Spectrum[HalfSize - K].Im = -(Even.Im - T.Im);
+    }
+}
+
+// Undoes RealFFTPostTwiddle: Spectrum[0 .. Size/2) ends up holding the
+// half-size transform the inverse has to undo. The imaginary parts of the DC
+// and Size/2 bins are ignored.
+internal void
+RealFFTPreTwiddle(real_fft_plan *Plan, complex32 *Spectrum)
+{
+    u32 HalfSize = Plan->Size / 2;
+
+    // The same split run backwards: E[k] = (X[k] + conj(X[M-k])) / 2,
+    // O[k] = (X[k] - conj(X[M-k])) * conj(W) / 2, Z[k] = E[k] + i*O[k].
+    f32 First = Spectrum[0].Re;
+    f32 Last = Spectrum[HalfSize].Re;
+    Spectrum[0].Re = 0.5f * (First + Last);
+    Spectrum[0].Im = 0.5f * (First - Last);
+    for (u32 K = 1; K <= HalfSize/2; K++)
+    {
+        complex32 A = Spectrum[K];
+        complex32 B = Spectrum[HalfSize - K];
+        complex32 Even, Diff;
+        Even.Re = 0.5f * (A.Re + B.Re);
+        Even.Im = 0.5f * (A.Im - B.Im);
+        Diff.Re = 0.5f * (A.Re - B.Re);
+        Diff.Im = 0.5f * (A.Im + B.Im);
+        complex32 W = Plan->Twiddles[K];
+        W.Im = -W.Im;
+        complex32 Odd = ComplexMul(Diff, W);
+        // Z[k] = E + i*O, and Z[M-k] = conj(E) + i*conj(O) with the roles of A
+        // and B swapped, which works out to conj(E - i*O).
+        Spectrum[K].Re = Even.Re - Odd.Im;
+        Spectrum[K].Im = Even.Im + Odd.Re;
+        Spectrum[HalfSize - K].Re = Even.Re + Odd.Im;
+        Spectrum[HalfSize - K].Im = -(Even.Im - Odd.Re);
+    }
+}
+
+// Spectrum gets Size/2 + 1 bins of sum(x[n] * e^(-2*pi*i*k*n/Size)). Count
+// samples are read and the rest of the window is zero-padded.
+internal void
+RealFFTForward(real_fft_plan *Plan, f32 *Samples, u32 Count, complex32 *Spectrum)
+{
+    u32 HalfSize = Plan->Size / 2;
+    for (u32 Index = 0; Index < HalfSize; Index++)
+    {
+        Spectrum[Index].Re = (2*Index < Count) ? Samples[2*Index] : 0.0f;
+        Spectrum[Index].Im = (2*Index + 1 < Count) ? Samples[2*Index + 1] : 0.0f;
+    }
+    FFTForward(&Plan->Half, Spectrum);
+    RealFFTPostTwiddle(Plan, Spectrum);
+}
+
+// Undoes RealFFTForward, including the 1/Size scale. Spectrum holds Size/2 + 1
+// bins and is used as scratch; Samples gets Size samples.
+internal void
+RealFFTInverse(real_fft_plan *Plan, complex32 *Spectrum, f32 *Samples)
+{
+    u32 HalfSize = Plan->Size / 2;
+    RealFFTPreTwiddle(Plan, Spectrum);
+    FFTInverse(&Plan->Half, Spectrum);
+    for (u32 Index = 0; Index < HalfSize; Index++)
+    {
+        Samples[2*Index] = Spectrum[Index].Re;
+        Samples[2*Index + 1] = Spectrum[Index].Im;
+    }
+}
+
+#endif //REAL_FFT_H
@@ -0,0 +1,185 @@
+/* date = October 18th 2026 */
+
+#ifndef SINGLE_BIN_H
+#define SINGLE_BIN_H
+
+// Single-frequency DFT probes, for when only one bin is wanted.
+//
+//   Goertzel:    X(f) for a block in O(N), one multiply-add per sample.
+//   Phasor:      a recursive oscillator e^(i*2*pi*f*n); PhasorWind uses it to
+//                produce every point of the winding e^(i*2*pi*f*n) * x[n]
+//                along with their sum, so a view can draw the points and the
+//                centroid from one pass.
+//   Sliding DFT: X(f) over the last N samples of a stream, updated in O(1)
+//                per new sample.
+//
+// Frequencies are in cycles per sample. Each one costs a single sin/cos when
+// it's set up; the per-sample work has no transcendental calls.
+//
+// Needs fft.h (for complex32).
+
+// Recursive phasors drift off the unit circle by about an ulp per step;
+// pulling them back this often is plenty.
+#define PHASOR_RENORMALIZE_INTERVAL 256
+// A sliding DFT recomputes its value from scratch once per window length, so
+// rounding error never builds up past one window's worth.
+#define SLIDING_DFT_REFRESH_WINDOWS 1
+
+typedef struct phasor
+{
+    complex32 Value;
+    complex32 Step;
+    u32 StepsSinceRenormalize;
+} phasor;
+
+typedef struct sliding_dft
+{
+    u32 Size;
+    f32 CyclesPerSample;
+    f32 *History;         // the last Size samples, a ring starting at Head.
+    u32 Head;
+    u32 SamplesSinceRefresh;
+    complex32 Step;       // e^(i*2*pi*f)
+    complex32 WrapTwist;  // e^(-i*2*pi*f*Size)
+    complex32 Value;      // X(f), with the oldest sample at n = 0.
+} sliding_dft;
+
+internal complex32
+ComplexFromTurns(f64 Turns)
+{
+    f64 Theta = FFT_TAU * fmod(Turns, 1.0);
+    complex32 Result;
+    Result.Re = (f32)cos(Theta);
+    Result.Im = (f32)sin(Theta);
+    return Result;
+}
+
+// X(f) = sum(x[n] * e^(-i*2*pi*f*n)) for n in [0, Count).
+// The recurrence runs in double: near 0Hz its coefficient approaches 2 and in
+// float the two states cancel badly.
+internal complex32
+GoertzelBin(f32 *Samples, u32 Count, f32 CyclesPerSample)
+{
+    f64 Theta = FFT_TAU * CyclesPerSample;
+    f64 Cos = cos(Theta);
+    f64 Coefficient = 2.0 * Cos;
+    f64 S1 = 0;
+    f64 S2 = 0;
+    for (u32 N = 0; N < Count; N++)
+    {
+        f64 S0 = Samples[N] + Coefficient*S1 - S2;
+        S2 = S1;
+        S1 = S0;
+    }
+
+    // S1 - e^(-i*w)*S2 is the sum referenced to the last sample; rotate it
+    // back to n = 0.
+    complex32 Tail;
+    Tail.Re = (f32)(S1 - Cos*S2);
+    Tail.Im = (f32)(sin(Theta)*S2);
+    complex32 Back = ComplexFromTurns(-(f64)CyclesPerSample * (f64)(Count - 1));
+    return (Count > 0) ? ComplexMul(Tail, Back) : (complex32){0};
+}
+
+// Starts at e^(i*2*pi*StartTurns) and advances by CyclesPerSample per step.
+internal phasor
+PhasorCreate(f32 CyclesPerSample, f64 StartTurns)
+{
+    phasor Phasor = {0};
+    Phasor.Value = ComplexFromTurns(StartTurns);
+    Phasor.Step = ComplexFromTurns(CyclesPerSample);
+    return Phasor;
+}
+
+internal void
+PhasorAdvance(phasor *Phasor)
+{
+    Phasor->Value = ComplexMul(Phasor->Value, Phasor->Step);
+    if (++Phasor->StepsSinceRenormalize == PHASOR_RENORMALIZE_INTERVAL)
+    {
+        // One Newton step towards |z| = 1; no square root needed this close.
+        f32 Scale = 0.5f * (3.0f - (Phasor->Value.Re*Phasor->Value.Re + Phasor->Value.Im*Phasor->Value.Im));
+        Phasor->Value.Re *= Scale;
+        Phasor->Value.Im *= Scale;
+        Phasor->StepsSinceRenormalize = 0;
+    }
+}
+
+// Writes Wound[n] = x[n] * e^(i*2*pi*f*n) (if Wound isn't 0) and returns
+// their sum, i.e. the conjugate of X(f) for real samples.
+internal complex32
+PhasorWind(f32 *Samples, u32 Count, f32 CyclesPerSample, complex32 *Wound)
+{
+    phasor Phasor = PhasorCreate(CyclesPerSample, 0.0);
+    complex32 Sum = {0};
+    for (u32 N = 0; N < Count; N++)
+    {
+        complex32 Point;
+        Point.Re = Phasor.Value.Re * Samples[N];
+        Point.Im = Phasor.Value.Im * Samples[N];
+        if (Wound) Wound[N] = Point;
+        Sum.Re += Point.Re;
+        Sum.Im += Point.Im;
+        PhasorAdvance(&Phasor);
+    }
+    return Sum;
+}
+
+// History starts as silence.
+internal sliding_dft
+SlidingDFTCreate(u32 Size, f32 CyclesPerSample)
+{
+    sliding_dft DFT = {0};
+    DFT.Size = Size;
+    DFT.CyclesPerSample = CyclesPerSample;
+    DFT.History = (f32 *)calloc(Size, sizeof(f32));
+    DFT.Step = ComplexFromTurns(CyclesPerSample);
+    DFT.WrapTwist = ComplexFromTurns(-(f64)CyclesPerSample * Size);
+    return DFT;
+}
+
+internal void
+SlidingDFTDestroy(sliding_dft *DFT)
+{
+    free(DFT->History);
+    DFT->History = 0;
+}
+
+// Recomputes Value from the history, oldest sample first.
+internal void
+SlidingDFTRefresh(sliding_dft *DFT)
+{
+    phasor Phasor = PhasorCreate(-DFT->CyclesPerSample, 0.0);
+    complex32 Sum = {0};
+    for (u32 N = 0; N < DFT->Size; N++)
+    {
+        f32 Sample = DFT->History[(DFT->Head + N) % DFT->Size];
+        Sum.Re += Phasor.Value.Re * Sample;
+        Sum.Im += Phasor.Value.Im * Sample;
+        PhasorAdvance(&Phasor);
+    }
+    DFT->Value = Sum;
+    DFT->SamplesSinceRefresh = 0;
+}
+
+// Slides the window on by one sample:
+// X' = e^(i*w) * (X - x_oldest + x_new * e^(-i*w*Size)).
+internal void
+SlidingDFTPush(sliding_dft *DFT, f32 Sample)
+{
+    f32 Oldest = DFT->History[DFT->Head];
+    DFT->History[DFT->Head] = Sample;
+    DFT->Head = (DFT->Head + 1 == DFT->Size) ? 0 : DFT->Head + 1;
+
+    complex32 Inner;
+    Inner.Re = DFT->Value.Re - Oldest + Sample*DFT->WrapTwist.Re;
+    Inner.Im = DFT->Value.Im + Sample*DFT->WrapTwist.Im;
+    DFT->Value = ComplexMul(Inner, DFT->Step);
+
+    if (++DFT->SamplesSinceRefresh == DFT->Size * SLIDING_DFT_REFRESH_WINDOWS)
+    {
+        SlidingDFTRefresh(DFT);
+    }
+}
+
+#endif //SINGLE_BIN_H
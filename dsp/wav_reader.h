@@ -0,0 +1,542 @@
+/* date = October 18th 2026 */
+
+#ifndef WAV_READER_H
+#define WAV_READER_H
+
+// Reads WAV and RF64 files by memory-mapping them, so nothing is copied or
+// loaded up front and files of any size open instantly. Takes 16/24/32-bit
+// PCM and 32-bit float, plain or WAVE_FORMAT_EXTENSIBLE.
+//
+// Samples can be used three ways:
+//
+//   WavViewI16 / WavViewF32  the file's own samples in place, when they're
+//                            already that type (and suitably aligned).
+//   WavConvert               any Count frames from any frame on, converted
+//                            to mono f32 (channels averaged) into a buffer.
+//   wav_iterator             walks a range block by block, converting each
+//                            block only when it's reached.
+//
+// WavRead reads sequentially on top of WavConvert. As it goes it madvises the
+// OS to prefetch WAV_PREFETCH_BYTES ahead and to drop what has been passed,
+// so memory stays flat through a multi-gigabyte capture.
+//
+// A pipe can't be mapped. WavOpenStream reads a WAV file from one and
+// WavOpenRaw a headerless stream of mono f32 samples, both through stdio and
+// sequentially only: WavRead and iterators from the current position work,
+// views and WavConvert don't.
+//
+// Used by the fourier_transforms tools and synth_render. Needs string.h and
+// stdlib.h; mapping needs a 64-bit process for files past 2GB.
+
+#ifdef _WIN32
+#include "minimal_windows.h"
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define WAV_READ_BLOCK 4096  // frames per block for WavRead and raw streams.
+#define WAV_MAX_CHANNELS 8
+#define WAV_PREFETCH_BYTES (4u << 20)
+
+typedef enum wav_sample_type
+{
+    WavSample_Int16,
+    WavSample_Int24,
+    WavSample_Int32,
+    WavSample_Float32,
+    WavSample_Count,
+} wav_sample_type;
+
+internal const char *
+WavSampleTypeName(wav_sample_type Value)
+{
+    local_static const char *Names[WavSample_Count] = {"int16", "int24", "int32", "float32"};
+    return ((u32)Value < WavSample_Count) ? Names[Value] : "?";
+}
+
+typedef struct wav_reader
+{
+    // Mapped files.
+    u8 *Map;
+    u64 MapSize;
+#ifdef _WIN32
+    HANDLE FileHandle;
+    HANDLE Mapping;
+#endif
+    u8 *Data;         // the first sample frame, inside Map.
+    u64 Advised;      // bytes of Data asked to be prefetched so far,
+    u64 Released;     // and let go of again.
+
+    // Raw streams.
+    FILE *Stream;
+    u8 *Bytes;        // one block of stream data.
+    bool Raw;
+
+    bool RF64;
+    wav_sample_type Type;
+    u32 Channels;
+    u32 BytesPerSample;
+    u32 FrameBytes;
+    u32 SampleRate;
+    u64 FrameCount;   // sample frames in the file; ~0 for raw streams.
+    u64 Position;     // next frame WavRead reads.
+    const char *Error;
+} wav_reader;
+
+internal u32
+WavReadU32(u8 *Bytes)
+{
+    return (u32)Bytes[0] | ((u32)Bytes[1] << 8) | ((u32)Bytes[2] << 16) | ((u32)Bytes[3] << 24);
+}
+
+internal u16
+WavReadU16(u8 *Bytes)
+{
+    return (u16)(Bytes[0] | (Bytes[1] << 8));
+}
+
+internal u64
+WavReadU64(u8 *Bytes)
+{
+    return (u64)WavReadU32(Bytes) | ((u64)WavReadU32(Bytes + 4) << 32);
+}
+
+internal bool
+WavMap(wav_reader *Reader, const char *Path)
+{
+#ifdef _WIN32
+    Reader->FileHandle = CreateFileA(Path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING,
+                                     FILE_FLAG_SEQUENTIAL_SCAN, 0);
+    if (Reader->FileHandle == INVALID_HANDLE_VALUE)
+    {
+        Reader->FileHandle = 0;
+        return false;
+    }
+    LARGE_INTEGER Size;
+    if (!GetFileSizeEx(Reader->FileHandle, &Size) || Size.QuadPart == 0) return false;
+    Reader->Mapping = CreateFileMappingA(Reader->FileHandle, 0, PAGE_READONLY, 0, 0, 0);
+    if (!Reader->Mapping) return false;
+    Reader->Map = (u8 *)MapViewOfFile(Reader->Mapping, FILE_MAP_READ, 0, 0, 0);
+    Reader->MapSize = (u64)Size.QuadPart;
+    return Reader->Map != 0;
+#else
+    i32 Descriptor = open(Path, O_RDONLY);
+    if (Descriptor < 0) return false;
+    struct stat Status;
+    void *Map = MAP_FAILED;
+    if (fstat(Descriptor, &Status) == 0 && Status.st_size > 0)
+    {
+        Map = mmap(0, (usize)Status.st_size, PROT_READ, MAP_PRIVATE, Descriptor, 0);
+    }
+    close(Descriptor); // the mapping keeps the file open.
+    if (Map == MAP_FAILED) return false;
+    Reader->Map = (u8 *)Map;
+    Reader->MapSize = (u64)Status.st_size;
+    madvise(Map, (usize)Status.st_size, MADV_SEQUENTIAL);
+    return true;
+#endif
+}
+
+internal void
+WavClose(wav_reader *Reader)
+{
+#ifdef _WIN32
+    if (Reader->Map) UnmapViewOfFile(Reader->Map);
+    if (Reader->Mapping) CloseHandle(Reader->Mapping);
+    if (Reader->FileHandle) CloseHandle(Reader->FileHandle);
+    Reader->Mapping = 0;
+    Reader->FileHandle = 0;
+#else
+    if (Reader->Map) munmap(Reader->Map, (usize)Reader->MapSize);
+#endif
+    if (Reader->Stream && Reader->Stream != stdin) fclose(Reader->Stream);
+    free(Reader->Bytes);
+    Reader->Map = 0;
+    Reader->Data = 0;
+    Reader->Stream = 0;
+    Reader->Bytes = 0;
+}
+
+// Reads a "fmt " chunk body of Size bytes.
+internal bool
+WavParseFormat(wav_reader *Reader, u8 *Body, u64 Size)
+{
+    if (Size < 16)
+    {
+        Reader->Error = "bad fmt chunk";
+        return false;
+    }
+    u16 Tag = WavReadU16(Body);
+    if (Tag == 0xFFFE && Size >= 26) Tag = WavReadU16(Body + 24); // the sub-format GUID starts with it.
+    Reader->Channels = WavReadU16(Body + 2);
+    Reader->SampleRate = WavReadU32(Body + 4);
+    Reader->BytesPerSample = WavReadU16(Body + 14) / 8;
+    Reader->Type = WavSample_Count;
+    if (Tag == 1 && Reader->BytesPerSample == 2) Reader->Type = WavSample_Int16;
+    if (Tag == 1 && Reader->BytesPerSample == 3) Reader->Type = WavSample_Int24;
+    if (Tag == 1 && Reader->BytesPerSample == 4) Reader->Type = WavSample_Int32;
+    if (Tag == 3 && Reader->BytesPerSample == 4) Reader->Type = WavSample_Float32;
+    if (Reader->Type == WavSample_Count || Reader->Channels == 0 ||
+        Reader->Channels > WAV_MAX_CHANNELS || Reader->SampleRate == 0)
+    {
+        Reader->Error = "unsupported sample format";
+        return false;
+    }
+    Reader->FrameBytes = Reader->Channels * Reader->BytesPerSample;
+    return true;
+}
+
+// Walks the RIFF (or RF64) chunks up to "data". An RF64 file's real sizes
+// are in its ds64 chunk, and its RIFF and data sizes are ~0.
+internal bool
+WavParseHeader(wav_reader *Reader)
+{
+    u8 *Map = Reader->Map;
+    u64 Size = Reader->MapSize;
+    if (Size < 12 || memcmp(Map + 8, "WAVE", 4) != 0 ||
+        (memcmp(Map, "RIFF", 4) != 0 && memcmp(Map, "RF64", 4) != 0))
+    {
+        Reader->Error = "not a WAV file";
+        return false;
+    }
+    Reader->RF64 = (memcmp(Map, "RF64", 4) == 0);
+
+    bool HaveFormat = false;
+    u64 DataSize64 = 0;
+    u64 At = 12;
+    while (At + 8 <= Size)
+    {
+        u8 *Chunk = Map + At;
+        u64 ChunkSize = WavReadU32(Chunk + 4);
+        u8 *Body = Chunk + 8;
+        u64 BodySize = Size - (At + 8);
+        if (memcmp(Chunk, "ds64", 4) == 0 && ChunkSize >= 24 && BodySize >= 24)
+        {
+            DataSize64 = WavReadU64(Body + 8);
+        }
+        else if (memcmp(Chunk, "fmt ", 4) == 0)
+        {
+            if (!WavParseFormat(Reader, Body, (ChunkSize < BodySize) ? ChunkSize : BodySize)) return false;
+            HaveFormat = true;
+        }
+        else if (memcmp(Chunk, "data", 4) == 0)
+        {
+            if (!HaveFormat)
+            {
+                Reader->Error = "data before fmt";
+                return false;
+            }
+            // Writers that stream often leave the size at 0 or ~0, so trust the
+            // file's length over it.
+            if (Reader->RF64 && ChunkSize == 0xFFFFFFFF) ChunkSize = DataSize64;
+            if (ChunkSize == 0 || ChunkSize > BodySize) ChunkSize = BodySize;
+            Reader->Data = Body;
+            Reader->FrameCount = ChunkSize / Reader->FrameBytes;
+            return true;
+        }
+        At += 8 + ChunkSize + (ChunkSize & 1);
+    }
+    Reader->Error = "no data chunk";
+    return false;
+}
+
+// Returns false, with Reader->Error set, if the file can't be read.
+internal bool
+WavOpen(wav_reader *Reader, const char *Path)
+{
+    memset(Reader, 0, sizeof(*Reader));
+    if (!WavMap(Reader, Path))
+    {
+        Reader->Error = "can't map (missing or empty?)";
+        WavClose(Reader);
+        return false;
+    }
+    if (!WavParseHeader(Reader))
+    {
+        WavClose(Reader);
+        return false;
+    }
+    return true;
+}
+
+// Reads mono f32 samples from Stream until it ends. Stream has to be in
+// binary mode.
+internal void
+WavOpenRaw(wav_reader *Reader, FILE *Stream, u32 SampleRate)
+{
+    memset(Reader, 0, sizeof(*Reader));
+    Reader->Stream = Stream;
+    Reader->Raw = true;
+    Reader->Type = WavSample_Float32;
+    Reader->Channels = 1;
+    Reader->BytesPerSample = 4;
+    Reader->FrameBytes = 4;
+    Reader->SampleRate = SampleRate;
+    Reader->FrameCount = ~(u64)0;
+    Reader->Bytes = (u8 *)malloc(WAV_READ_BLOCK * 4);
+}
+
+// Reads a WAV file from Stream (stdin, say) front to back, for input that
+// can't be mapped. The header is parsed as it arrives and the samples are
+// then read like a raw stream: WavRead and iterators work, views and
+// WavConvert don't. A data size of 0 or ~0, which streaming writers leave,
+// reads until the stream ends. Stream has to be in binary mode. Returns
+// false, with Reader->Error set, if it isn't a WAV file this can read.
+internal bool
+WavOpenStream(wav_reader *Reader, FILE *Stream)
+{
+    memset(Reader, 0, sizeof(*Reader));
+    Reader->Stream = Stream;
+    Reader->Raw = true;
+    u8 Header[12];
+    if (fread(Header, 1, sizeof(Header), Stream) != sizeof(Header) || memcmp(Header + 8, "WAVE", 4) != 0 ||
+        (memcmp(Header, "RIFF", 4) != 0 && memcmp(Header, "RF64", 4) != 0))
+    {
+        Reader->Error = "not a WAV file";
+        return false;
+    }
+    Reader->RF64 = (memcmp(Header, "RF64", 4) == 0);
+
+    bool HaveFormat = false;
+    u64 DataSize64 = 0;
+    u8 Chunk[8];
+    u8 Body[64]; // fmt and ds64 are shorter; anything past this is skipped.
+    while (fread(Chunk, 1, sizeof(Chunk), Stream) == sizeof(Chunk))
+    {
+        u64 ChunkSize = WavReadU32(Chunk + 4);
+        if (memcmp(Chunk, "data", 4) == 0)
+        {
+            if (!HaveFormat)
+            {
+                Reader->Error = "data before fmt";
+                return false;
+            }
+            if (Reader->RF64 && ChunkSize == 0xFFFFFFFF) ChunkSize = DataSize64;
+            bool Unsized = (ChunkSize == 0 || ChunkSize == 0xFFFFFFFF);
+            Reader->FrameCount = Unsized ? ~(u64)0 : ChunkSize / Reader->FrameBytes;
+            Reader->Bytes = (u8 *)malloc(WAV_READ_BLOCK * Reader->FrameBytes);
+            return true;
+        }
+
+        u64 Skip = ChunkSize + (ChunkSize & 1);
+        if (memcmp(Chunk, "fmt ", 4) == 0 || memcmp(Chunk, "ds64", 4) == 0)
+        {
+            u64 Keep = (ChunkSize < sizeof(Body)) ? ChunkSize : sizeof(Body);
+            if (fread(Body, 1, (usize)Keep, Stream) != Keep) break;
+            Skip -= Keep;
+            if (Chunk[0] == 'd')
+            {
+                if (Keep >= 24) DataSize64 = WavReadU64(Body + 8);
+            }
+            else
+            {
+                if (!WavParseFormat(Reader, Body, Keep)) return false;
+                HaveFormat = true;
+            }
+        }
+        while (Skip > 0)
+        {
+            u8 Discard[256];
+            usize Step = (Skip < sizeof(Discard)) ? (usize)Skip : sizeof(Discard);
+            if (fread(Discard, 1, Step, Stream) != Step) break;
+            Skip -= Step;
+        }
+    }
+    Reader->Error = "no data chunk";
+    return false;
+}
+
+// The file's bytes for frame Frame on, in place. 0 for raw streams.
+internal void *
+WavFrames(wav_reader *Reader, u64 Frame)
+{
+    return Reader->Data ? Reader->Data + Frame * Reader->FrameBytes : 0;
+}
+
+// The samples as they are in the file, interleaved, FrameCount * Channels of
+// them, if they're 16-bit and 2-byte aligned. Otherwise 0.
+internal i16 *
+WavViewI16(wav_reader *Reader)
+{
+    bool Usable = (Reader->Data && Reader->Type == WavSample_Int16 && ((usize)Reader->Data & 1) == 0);
+    return Usable ? (i16 *)Reader->Data : 0;
+}
+
+// Same for 32-bit float, 4-byte aligned.
+internal f32 *
+WavViewF32(wav_reader *Reader)
+{
+    bool Usable = (Reader->Data && Reader->Type == WavSample_Float32 && ((usize)Reader->Data & 3) == 0);
+    return Usable ? (f32 *)Reader->Data : 0;
+}
+
+// Converts Count frames of packed samples at Bytes to mono f32.
+internal void
+WavConvertBytes(wav_reader *Reader, u8 *Bytes, u32 Count, f32 *Samples)
+{
+    u32 Channels = Reader->Channels;
+    f32 Scale = 1.0f / Channels;
+    for (u32 Index = 0; Index < Count; Index++)
+    {
+        f32 Sum = 0;
+        for (u32 Channel = 0; Channel < Channels; Channel++, Bytes += Reader->BytesPerSample)
+        {
+            switch (Reader->Type)
+            {
+                case WavSample_Int16:
+                {
+                    Sum += (i16)WavReadU16(Bytes) * (1.0f / 32768.0f);
+                } break;
+                case WavSample_Int24:
+                {
+                    i32 Value = (i32)(((u32)Bytes[0] << 8) | ((u32)Bytes[1] << 16) | ((u32)Bytes[2] << 24)) >> 8;
+                    Sum += Value * (1.0f / 8388608.0f);
+                } break;
+                case WavSample_Int32:
+                {
+                    Sum += (f32)((i32)WavReadU32(Bytes) * (1.0 / 2147483648.0));
+                } break;
+                default:
+                {
+                    f32 Value;
+                    memcpy(&Value, Bytes, 4);
+                    Sum += Value;
+                } break;
+            }
+        }
+        Samples[Index] = Sum * Scale;
+    }
+}
+
+// Frames [Frame, Frame + Count) as mono f32, clipped to the file. Returns
+// how many were converted; 0 for raw streams.
+internal u32
+WavConvert(wav_reader *Reader, u64 Frame, u32 Count, f32 *Samples)
+{
+    if (!Reader->Data || Frame >= Reader->FrameCount) return 0;
+    if (Count > Reader->FrameCount - Frame) Count = (u32)(Reader->FrameCount - Frame);
+    WavConvertBytes(Reader, Reader->Data + Frame * Reader->FrameBytes, Count, Samples);
+    return Count;
+}
+
+// Reading in order: once Frame gets within half a prefetch of what's been
+// asked for, ask for the next stretch and let go of what's a prefetch behind.
+internal void
+WavAdvise(wav_reader *Reader, u64 Frame)
+{
+#ifndef _WIN32
+    u64 Offset = Frame * Reader->FrameBytes;
+    u64 DataSize = Reader->FrameCount * Reader->FrameBytes;
+    if (Offset + WAV_PREFETCH_BYTES / 2 < Reader->Advised || Reader->Advised >= DataSize) return;
+
+    u64 PageMask = (u64)sysconf(_SC_PAGESIZE) - 1;
+    u64 Base = (u64)(Reader->Data - Reader->Map);
+    u64 Start = (Base + Reader->Advised) & ~PageMask;
+    u64 End = Base + ((Offset + WAV_PREFETCH_BYTES < DataSize) ? Offset + WAV_PREFETCH_BYTES : DataSize);
+    if (End > Start) madvise(Reader->Map + Start, (usize)(End - Start), MADV_WILLNEED);
+    Reader->Advised = End - Base;
+
+    if (Offset > WAV_PREFETCH_BYTES)
+    {
+        u64 ReleaseStart = (Base + Reader->Released) & ~PageMask;
+        u64 ReleaseEnd = (Base + Offset - WAV_PREFETCH_BYTES) & ~PageMask;
+        if (ReleaseEnd > ReleaseStart)
+        {
+            madvise(Reader->Map + ReleaseStart, (usize)(ReleaseEnd - ReleaseStart), MADV_DONTNEED);
+        }
+        Reader->Released = Offset - WAV_PREFETCH_BYTES;
+    }
+#else
+    // FILE_FLAG_SEQUENTIAL_SCAN already has Windows read ahead.
+    (void)Reader;
+    (void)Frame;
+#endif
+}
+
+// Moves WavRead to frame Frame. Raw streams can't seek.
+internal bool
+WavSeek(wav_reader *Reader, u64 Frame)
+{
+    if (Reader->Raw || Frame > Reader->FrameCount) return false;
+    Reader->Position = Frame;
+    Reader->Advised = Frame * Reader->FrameBytes;
+    Reader->Released = Reader->Advised;
+    return true;
+}
+
+// Reads up to Count frames from the current position, mixed down to mono.
+// Returns how many; 0 at the end.
+internal u32
+WavRead(wav_reader *Reader, f32 *Samples, u32 Count)
+{
+    if (!Reader->Raw)
+    {
+        WavAdvise(Reader, Reader->Position + Count);
+        u32 Done = WavConvert(Reader, Reader->Position, Count, Samples);
+        Reader->Position += Done;
+        return Done;
+    }
+
+    if (Count > Reader->FrameCount - Reader->Position) Count = (u32)(Reader->FrameCount - Reader->Position);
+    u32 Done = 0;
+    while (Done < Count)
+    {
+        u32 Want = (Count - Done < WAV_READ_BLOCK) ? Count - Done : WAV_READ_BLOCK;
+        u32 Got = (u32)fread(Reader->Bytes, Reader->FrameBytes, Want, Reader->Stream);
+        if (Got == 0) break;
+        WavConvertBytes(Reader, Reader->Bytes, Got, Samples + Done);
+        Done += Got;
+    }
+    Reader->Position += Done;
+    return Done;
+}
+
+//
+// Iterator.
+//
+
+typedef struct wav_iterator
+{
+    wav_reader *Reader;
+    u64 End;
+    f32 *Samples;   // the current block, mono.
+    u32 Capacity;
+    u32 Count;      // frames in the current block.
+    u64 Start;      // frame the current block starts at.
+} wav_iterator;
+
+// Walks frames [First, End) of a mapped file (End clipped to the file) in
+// blocks of up to Capacity frames, converted into Buffer. A raw stream is
+// walked from where it is, to its end.
+internal wav_iterator
+WavIterate(wav_reader *Reader, u64 First, u64 End, f32 *Buffer, u32 Capacity)
+{
+    wav_iterator Iterator = {0};
+    Iterator.Reader = Reader;
+    Iterator.End = (End < Reader->FrameCount) ? End : Reader->FrameCount;
+    Iterator.Samples = Buffer;
+    Iterator.Capacity = Capacity;
+    Iterator.Start = Reader->Raw ? Reader->Position : First;
+    if (!Reader->Raw) WavSeek(Reader, First);
+    return Iterator;
+}
+
+// Converts the next block. Returns false once the range is done.
+//
+//   wav_iterator Blocks = WavIterate(&Reader, 0, ~(u64)0, Buffer, 4096);
+//   while (WavNext(&Blocks)) Use(Blocks.Samples, Blocks.Count);
+internal bool
+WavNext(wav_iterator *Iterator)
+{
+    wav_reader *Reader = Iterator->Reader;
+    Iterator->Start = Reader->Position;
+    u64 Left = (Iterator->End > Reader->Position) ? Iterator->End - Reader->Position : 0;
+    u32 Want = (Left < Iterator->Capacity) ? (u32)Left : Iterator->Capacity;
+    Iterator->Count = (Want > 0) ? WavRead(Reader, Iterator->Samples, Want) : 0;
+    return Iterator->Count > 0;
+}
+
+#endif //WAV_READER_H
@@ -0,0 +1,149 @@
+/* date = October 18th 2026 */
+
+#ifndef WORK_QUEUE_H
+#define WORK_QUEUE_H
+
+// Runs a numbered list of jobs on a pool of threads for the headless tools.
+// Each thread claims the next job number with an atomic add until none are
+// left, so uneven jobs balance out on their own. The calling thread works too
+// and returns once every job is done. Win32 threads or pthreads.
+
+#ifdef _WIN32
+#include "minimal_windows.h"
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#define MAX_WORK_THREADS 64
+
+// Sequentially consistent; used for job numbers and hand-offs between jobs.
+#ifdef _WIN32
+#define mx_AtomicLoadU32(Pointer) ((u32)InterlockedCompareExchange((volatile LONG *)(Pointer), 0, 0))
+#define mx_AtomicStoreU32(Pointer, Value) InterlockedExchange((volatile LONG *)(Pointer), (LONG)(Value))
+#define mx_AtomicAddU32(Pointer, Value) ((u32)InterlockedExchangeAdd((volatile LONG *)(Pointer), (LONG)(Value)) + (Value))
+#else
+#define mx_AtomicLoadU32(Pointer) __atomic_load_n((Pointer), __ATOMIC_SEQ_CST)
+#define mx_AtomicStoreU32(Pointer, Value) __atomic_store_n((Pointer), (Value), __ATOMIC_SEQ_CST)
+#define mx_AtomicAddU32(Pointer, Value) __atomic_add_fetch((Pointer), (Value), __ATOMIC_SEQ_CST)
+#endif
+
+// Thread is 0 for the calling thread and 1 .. ThreadCount-1 for the others,
+// so per-thread state can live in an array.
+typedef void work_proc(void *Data, u32 Job, u32 Thread);
+
+typedef struct work_queue
+{
+    work_proc *Proc;
+    void *Data;
+    u32 JobCount;
+    u32 NextJob;
+} work_queue;
+
+typedef struct work_thread
+{
+#ifdef _WIN32
+    HANDLE Handle;
+#else
+    pthread_t Handle;
+#endif
+    work_queue *Queue;
+    u32 Index;
+} work_thread;
+
+internal u32
+WorkCpuCount(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO Info;
+    GetSystemInfo(&Info);
+    return (u32)Info.dwNumberOfProcessors;
+#else
+    long Count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (Count > 0) ? (u32)Count : 1;
+#endif
+}
+
+internal void
+WorkYield(void)
+{
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+internal void
+WorkQueueDrain(work_queue *Queue, u32 Thread)
+{
+    for (;;)
+    {
+        u32 Job = mx_AtomicAddU32(&Queue->NextJob, 1) - 1;
+        if (Job >= Queue->JobCount) break;
+        Queue->Proc(Queue->Data, Job, Thread);
+    }
+}
+
+#ifdef _WIN32
+internal DWORD WINAPI
+WorkThreadEntry(void *Parameter)
+{
+    work_thread *Thread = (work_thread *)Parameter;
+    WorkQueueDrain(Thread->Queue, Thread->Index);
+    return 0;
+}
+#else
+internal void *
+WorkThreadEntry(void *Parameter)
+{
+    work_thread *Thread = (work_thread *)Parameter;
+    WorkQueueDrain(Thread->Queue, Thread->Index);
+    return 0;
+}
+#endif
+
+// Runs Proc for jobs 0 .. JobCount-1 on up to ThreadCount threads, counting
+// the caller. Returns the number of threads that took part.
+internal u32
+WorkQueueRun(work_proc *Proc, void *Data, u32 JobCount, u32 ThreadCount)
+{
+    work_queue Queue = {0};
+    Queue.Proc = Proc;
+    Queue.Data = Data;
+    Queue.JobCount = JobCount;
+    if (ThreadCount > MAX_WORK_THREADS) ThreadCount = MAX_WORK_THREADS;
+    if (ThreadCount > JobCount) ThreadCount = JobCount;
+    if (ThreadCount == 0) ThreadCount = 1;
+
+    work_thread Threads[MAX_WORK_THREADS];
+    u32 Started = 1;
+    for (u32 Index = 1; Index < ThreadCount; Index++)
+    {
+        work_thread *Thread = &Threads[Started];
+        Thread->Queue = &Queue;
+        Thread->Index = Started;
+#ifdef _WIN32
+        Thread->Handle = CreateThread(0, 0, WorkThreadEntry, Thread, 0, 0);
+        if (!Thread->Handle) break;
+#else
+        if (pthread_create(&Thread->Handle, 0, WorkThreadEntry, Thread) != 0) break;
+#endif
+        Started++;
+    }
+
+    WorkQueueDrain(&Queue, 0);
+    for (u32 Index = 1; Index < Started; Index++)
+    {
+#ifdef _WIN32
+        WaitForSingleObject(Threads[Index].Handle, INFINITE);
+        CloseHandle(Threads[Index].Handle);
+#else
+        pthread_join(Threads[Index].Handle, 0);
+#endif
+    }
+    return Started;
+}
+
+#endif //WORK_QUEUE_H
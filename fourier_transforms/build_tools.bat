@@ -0,0 +1,11 @@
+pushd bin
+call tcc -o fft_bench.exe ../src/fft_bench.c -I../include -I../../dsp -lmsvcrt -lkernel32 -std=c99
+call tcc -o fft_split_bench.exe ../src/fft_split_bench.c -I../include -I../../dsp -lmsvcrt -lkernel32 -std=c99
+call tcc -o fft_wisdom.exe ../src/fft_wisdom.c -I../include -I../../dsp -lmsvcrt -lkernel32 -std=c99
+call tcc -o fft_mixed_bench.exe ../src/fft_mixed_bench.c -I../include -I../../dsp -lmsvcrt -lkernel32 -std=c99
+call tcc -o stft_stream.exe ../src/stft_stream.c -I../include -I../../dsp -lmsvcrt -lkernel32 -std=c99
+call tcc -o spectral_batch.exe ../src/spectral_batch.c -I../include -I../../dsp -lmsvcrt -lkernel32 -std=c99
+call tcc -o fft_batch_bench.exe ../src/fft_batch_bench.c -I../include -I../../dsp -lmsvcrt -lkernel32 -std=c99
+call tcc -o convolve_bench.exe ../src/convolve_bench.c -I../include -I../../dsp -lmsvcrt -lkernel32 -std=c99
+call tcc -o vocoder_bench.exe ../src/vocoder_bench.c -I../include -I../../dsp -lmsvcrt -lkernel32 -std=c99
+popd
@@ -0,0 +1,15 @@
+#!/bin/sh
+# Headless tools (benchmarks) for Linux. The explorer itself is built with build.bat.
+set -e
+cd "$(dirname "$0")"
+mkdir -p bin
+CommonFlags="-std=c99 -D_GNU_SOURCE -O2 -g -Wall -Wno-unused-function -Iinclude -I../dsp"
+cc $CommonFlags -o bin/fft_bench src/fft_bench.c -lm
+cc $CommonFlags -o bin/fft_split_bench src/fft_split_bench.c -lm
+cc $CommonFlags -o bin/fft_wisdom src/fft_wisdom.c -lm
+cc $CommonFlags -o bin/fft_mixed_bench src/fft_mixed_bench.c -lm
+cc $CommonFlags -o bin/stft_stream src/stft_stream.c -lm
+cc $CommonFlags -pthread -o bin/spectral_batch src/spectral_batch.c -lm
+cc $CommonFlags -pthread -o bin/fft_batch_bench src/fft_batch_bench.c -lm
+cc $CommonFlags -o bin/convolve_bench src/convolve_bench.c -lm
+cc $CommonFlags -o bin/vocoder_bench src/vocoder_bench.c -lm
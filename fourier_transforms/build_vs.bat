@@ -5,7 +5,7 @@ if not defined DevEnvDir (
 )
 
 pushd bin
-SET CommonFlags=-nologo -Od -Oi /I"..\include" /Zi /Gm- /Gd /TC
+SET CommonFlags=-nologo -Od -Oi /I"..\include" /I"..\..\dsp" /Zi /Gm- /Gd /TC
 SET CommonLinkerFlags=/LIBPATH:"..\lib\vs2019" raylib.lib -opt:ref kernel32.lib user32.lib gdi32.lib shell32.lib winmm.lib
 call cl.exe %CommonFlags% "..\src\main.c" /link /OUT:"main.exe"  %CommonLinkerFlags%
 popd
\ No newline at end of file
@@ -0,0 +1,115 @@
+// Times convolve.h's direct and overlap-save filters for a range of kernel
+// sizes and shows where they cross over and what Auto picks. Throughput is in
+// millions of samples filtered per second, streaming in blocks of 512.
+// dsp_check checks that both are right.
+//
+// Usage: convolve_bench [--samples N] [TAPS...]
+//   --samples  length of the timed signal (default 1M).
+//   Kernel sizes default to a spread from 4 to 16384 taps.
+
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#include "fft.h"
+#include "real_fft.h"
+#include "fft_split.h"
+#include "fft_mixed.h"
+#include "bench_timer.h"
+#include "fft_planner.h"
+#include "convolve.h"
+
+#define STREAM_BLOCK 512
+#define MAX_BENCH_SIZES 32
+
+global u32 DefaultSizes[] = {4, 8, 16, 32, 64, 96, 128, 192, 256, 512, 1024, 2048, 4096, 8192, 16384};
+
+// Seconds to stream Count samples through Convolver.
+internal f64
+TimeStream(convolver *Convolver, f32 *Signal, f32 *Output, u32 Count)
+{
+    f64 Seconds;
+    mx_TimeCalls(0.2, Seconds, for (u32 Start = 0; Start < Count; Start += STREAM_BLOCK)
+                               {
+                                   ConvolverProcess(Convolver, Signal + Start, Output + Start, STREAM_BLOCK);
+                               });
+    return Seconds;
+}
+
+i32
+main(i32 argc, char **argv)
+{
+    u32 SampleCount = 1 << 20;
+    u32 Sizes[MAX_BENCH_SIZES];
+    u32 SizeCount = 0;
+    for (i32 ArgIndex = 1; ArgIndex < argc; ArgIndex++)
+    {
+        if (strcmp(argv[ArgIndex], "--samples") == 0 && ArgIndex + 1 < argc)
+        {
+            SampleCount = (u32)atoi(argv[++ArgIndex]);
+        }
+        else if (atoi(argv[ArgIndex]) >= 1 && SizeCount < MAX_BENCH_SIZES)
+        {
+            Sizes[SizeCount++] = (u32)atoi(argv[ArgIndex]);
+        }
+        else
+        {
+            printf("Usage: convolve_bench [--samples N] [TAPS...]\n");
+            return 2;
+        }
+    }
+    if (SizeCount == 0)
+    {
+        SizeCount = mx_ArrayCount(DefaultSizes);
+        memcpy(Sizes, DefaultSizes, sizeof(DefaultSizes));
+    }
+    SampleCount = (SampleCount + STREAM_BLOCK - 1) / STREAM_BLOCK * STREAM_BLOCK;
+    if (SampleCount == 0) SampleCount = STREAM_BLOCK;
+
+    u32 MaxKernel = 0;
+    for (u32 Index = 0; Index < SizeCount; Index++) MaxKernel = (Sizes[Index] > MaxKernel) ? Sizes[Index] : MaxKernel;
+    f32 *Signal = (f32 *)malloc(SampleCount * sizeof(f32));
+    f32 *Output = (f32 *)malloc(SampleCount * sizeof(f32));
+    f32 *Kernel = (f32 *)malloc(MaxKernel * sizeof(f32));
+    for (u32 N = 0; N < SampleCount; N++) Signal[N] = RandomF32(N) - 0.5f;
+    for (u32 K = 0; K < MaxKernel; K++) Kernel[K] = (RandomF32(K + SampleCount) - 0.5f) / sqrtf((f32)(K + 1));
+
+    fft_planner Planner = FFTPlannerCreate(FFTPlanner_Measure, 0);
+    printf("Best kernel here is %s.\n", FFTKernelName(FFTBestKernel()));
+
+    printf("\n%u samples in blocks of %u, Msamples/s:\n", SampleCount, STREAM_BLOCK);
+    printf("%8s %10s %10s %8s %8s %8s %8s\n", "taps", "direct", "fft", "fft size", "latency", "faster", "auto");
+    u32 Crossover = 0;
+    for (u32 Index = 0; Index < SizeCount; Index++)
+    {
+        u32 KernelSize = Sizes[Index];
+        convolve_config DirectConfig = {ConvolveMethod_Direct, 0, false};
+        convolve_config FFTConfig = {ConvolveMethod_FFT, 0, false};
+        convolve_config AutoConfig = {ConvolveMethod_Auto, 0, false};
+        convolver Direct = ConvolverCreate(&Planner, Kernel, KernelSize, DirectConfig);
+        convolver FFT = ConvolverCreate(&Planner, Kernel, KernelSize, FFTConfig);
+        convolver Auto = ConvolverCreate(&Planner, Kernel, KernelSize, AutoConfig);
+
+        // Direct gets slow for long kernels; a slice of the signal will do.
+        u32 DirectCount = SampleCount;
+        while (DirectCount > STREAM_BLOCK && (u64)DirectCount * KernelSize > (1ull << 28)) DirectCount /= 2;
+        DirectCount = DirectCount / STREAM_BLOCK * STREAM_BLOCK;
+        f64 DirectRate = DirectCount / TimeStream(&Direct, Signal, Output, DirectCount) / 1e6;
+        f64 FFTRate = SampleCount / TimeStream(&FFT, Signal, Output, SampleCount) / 1e6;
+        if (Crossover == 0 && FFTRate > DirectRate) Crossover = KernelSize;
+
+        printf("%8u %10.1f %10.1f %8u %8u %8s %8s\n", KernelSize, DirectRate, FFTRate, FFT.FFTSize,
+               FFT.Latency, ConvolveMethodName((FFTRate > DirectRate) ? ConvolveMethod_FFT : ConvolveMethod_Direct),
+               ConvolveMethodName(Auto.Config.Method));
+        ConvolverDestroy(&Auto);
+        ConvolverDestroy(&FFT);
+        ConvolverDestroy(&Direct);
+    }
+    if (Crossover) printf("\nOverlap-save overtakes direct at %u taps here; Auto switches after %u.\n", Crossover,
+                          FFTKernelSupported(FFTKernel_AVX2) ? CONVOLVE_DIRECT_MAX_TAPS : CONVOLVE_DIRECT_MAX_TAPS_SCALAR);
+
+    FFTPlannerDestroy(&Planner);
+    free(Kernel);
+    free(Output);
+    free(Signal);
+    return 0;
+}
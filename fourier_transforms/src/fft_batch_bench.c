@@ -0,0 +1,177 @@
+// Times the batched FFTs in fft_batch.h: a loop of single-frame calls on one
+// thread, then the batch in frames and interleaved mode on 1, 2, 4 .. threads.
+// The "x loop" column is the speedup over the single-frame loop and "scaling"
+// the speedup over the same mode on one thread. dsp_check checks that the
+// batches match the single-frame transforms.
+//
+// Usage: fft_batch_bench [--threads N] [--points N] [SIZE...]
+//   --threads  most threads to time (default the CPU count).
+//   --points   complex points (or real samples) per timed batch, split into
+//              frames of each size (default 4M).
+//   Sizes default to 64, 256, 1024 and 4096.
+
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#include "fft.h"
+#include "real_fft.h"
+#include "fft_split.h"
+#include "fft_mixed.h"
+#include "bench_timer.h"
+#include "fft_planner.h"
+#include "work_queue.h"
+#include "fft_batch.h"
+
+#define MAX_BENCH_SIZES 16
+
+global u32 DefaultSizes[] = {64, 256, 1024, 4096};
+
+// Seconds per forward and inverse batch of FrameCount frames, packed end to
+// end. Running them in pairs keeps the data from growing without bound.
+internal f64
+TimeBatch(fft_batch *Forward, fft_batch *Inverse, complex32 *Frames, f32 *Samples, u32 FrameCount)
+{
+    u32 Size = Forward->Size;
+    f64 Seconds;
+    if (Forward->Type == FFTType_Complex)
+    {
+        mx_TimeCalls(0.2, Seconds, (FFTBatchExecuteComplex(Forward, Frames, Size, FrameCount),
+                                    FFTBatchExecuteComplex(Inverse, Frames, Size, FrameCount)));
+    }
+    else
+    {
+        mx_TimeCalls(0.2, Seconds, (FFTBatchExecuteReal(Forward, Samples, Size, Frames, Size/2 + 1, FrameCount),
+                                    FFTBatchExecuteReal(Inverse, Samples, Size, Frames, Size/2 + 1, FrameCount)));
+    }
+    return Seconds;
+}
+
+internal void
+ExecuteLoop(planned_fft *Plan, complex32 *Frames, f32 *Samples, u32 FrameCount)
+{
+    u32 Size = Plan->Size;
+    for (u32 Frame = 0; Frame < FrameCount; Frame++)
+    {
+        if (Plan->Type == FFTType_Complex) FFTExecuteComplex(Plan, Frames + (usize)Frame*Size);
+        else FFTExecuteReal(Plan, Samples + (usize)Frame*Size, Frames + (usize)Frame*(Size/2 + 1));
+    }
+}
+
+// The same frames through single-frame calls on one thread.
+internal f64
+TimeLoop(planned_fft *Forward, planned_fft *Inverse, complex32 *Frames, f32 *Samples, u32 FrameCount)
+{
+    f64 Seconds;
+    mx_TimeCalls(0.2, Seconds, (ExecuteLoop(Forward, Frames, Samples, FrameCount),
+                                ExecuteLoop(Inverse, Frames, Samples, FrameCount)));
+    return Seconds;
+}
+
+// 1, 2, 4 .. and MaxThreads itself.
+internal u32
+NextThreadCount(u32 ThreadCount, u32 MaxThreads)
+{
+    if (ThreadCount < MaxThreads && ThreadCount * 2 > MaxThreads) return MaxThreads;
+    return ThreadCount * 2;
+}
+
+i32
+main(i32 argc, char **argv)
+{
+    u32 MaxThreads = WorkCpuCount();
+    u32 Points = 1 << 22;
+    u32 Sizes[MAX_BENCH_SIZES];
+    u32 SizeCount = 0;
+    for (i32 ArgIndex = 1; ArgIndex < argc; ArgIndex++)
+    {
+        if (strcmp(argv[ArgIndex], "--threads") == 0 && ArgIndex + 1 < argc)
+        {
+            MaxThreads = (u32)atoi(argv[++ArgIndex]);
+        }
+        else if (strcmp(argv[ArgIndex], "--points") == 0 && ArgIndex + 1 < argc)
+        {
+            Points = (u32)atoi(argv[++ArgIndex]);
+        }
+        else if (atoi(argv[ArgIndex]) >= 4 && SizeCount < MAX_BENCH_SIZES)
+        {
+            Sizes[SizeCount++] = (u32)atoi(argv[ArgIndex]);
+        }
+        else
+        {
+            printf("Usage: fft_batch_bench [--threads N] [--points N] [SIZE...]\n");
+            return 2;
+        }
+    }
+    if (SizeCount == 0)
+    {
+        SizeCount = mx_ArrayCount(DefaultSizes);
+        memcpy(Sizes, DefaultSizes, sizeof(DefaultSizes));
+    }
+    if (MaxThreads == 0 || MaxThreads > MAX_WORK_THREADS) MaxThreads = MAX_WORK_THREADS;
+
+    fft_planner Planner = FFTPlannerCreate(FFTPlanner_Measure, 0);
+    printf("Best kernel here is %s; %u CPUs, timing up to %u threads, %u points per batch, forward and inverse.\n",
+           FFTKernelName(FFTBestKernel()), WorkCpuCount(), MaxThreads, Points);
+
+    for (u32 Index = 0; Index < SizeCount; Index++)
+    {
+        u32 Size = Sizes[Index];
+        for (u32 Type = 0; Type < FFTType_Count; Type++)
+        {
+            if (!FFTPlanSizeValid(Size, (fft_type)Type))
+            {
+                printf("\n%u points can't be planned as %s.\n", Size, FFTTypeNames[Type]);
+                continue;
+            }
+
+            u32 FrameCount = Points / Size;
+            if (FrameCount < 1) FrameCount = 1;
+            complex32 *Frames = (complex32 *)malloc((usize)FrameCount * Size * sizeof(complex32));
+            f32 *Samples = (f32 *)malloc((usize)FrameCount * Size * sizeof(f32));
+            for (usize N = 0; N < (usize)FrameCount * Size; N++)
+            {
+                Frames[N].Re = RandomF32((u32)N) - 0.5f;
+                Frames[N].Im = RandomF32((u32)N + 1) - 0.5f;
+                Samples[N] = Frames[N].Re;
+            }
+
+            planned_fft *Plan = FFTPlan(&Planner, Size, (fft_type)Type, FFTDirection_Forward);
+            planned_fft *InversePlan = FFTPlan(&Planner, Size, (fft_type)Type, FFTDirection_Inverse);
+            f64 LoopSeconds = TimeLoop(Plan, InversePlan, Frames, Samples, FrameCount);
+            printf("\n%u-point %s (%s) x %u frames: single-frame loop %.2f ms, %.1f ns per frame\n",
+                   Size, FFTTypeNames[Type], FFTAlgorithmNames[Plan->Algorithm], FrameCount,
+                   LoopSeconds * 1e3, LoopSeconds * 1e9 / FrameCount);
+            printf("%12s %8s %10s %12s %8s %8s\n", "mode", "threads", "ms", "ns/frame", "x loop", "scaling");
+
+            for (u32 Mode = FFTBatch_Frames; Mode < FFTBatch_Count; Mode++)
+            {
+                f64 OneThreadSeconds = 0;
+                for (u32 ThreadCount = 1; ThreadCount <= MaxThreads; ThreadCount = NextThreadCount(ThreadCount, MaxThreads))
+                {
+                    fft_batch Batch = FFTBatchCreate(&Planner, Size, (fft_type)Type, FFTDirection_Forward,
+                                                     (fft_batch_mode)Mode, ThreadCount);
+                    fft_batch Inverse = FFTBatchCreate(&Planner, Size, (fft_type)Type, FFTDirection_Inverse,
+                                                       (fft_batch_mode)Mode, ThreadCount);
+                    if (Batch.Size == 0 || Inverse.Size == 0)
+                    {
+                        printf("%12s  not for this size\n", FFTBatchModeName((fft_batch_mode)Mode));
+                        FFTBatchDestroy(&Inverse);
+                        FFTBatchDestroy(&Batch);
+                        break;
+                    }
+                    f64 Seconds = TimeBatch(&Batch, &Inverse, Frames, Samples, FrameCount);
+                    if (ThreadCount == 1) OneThreadSeconds = Seconds;
+                    printf("%12s %8u %10.2f %12.1f %8.2f %8.2f\n", FFTBatchModeName((fft_batch_mode)Mode), ThreadCount,
+                           Seconds * 1e3, Seconds * 1e9 / FrameCount, LoopSeconds / Seconds, OneThreadSeconds / Seconds);
+                    FFTBatchDestroy(&Inverse);
+                    FFTBatchDestroy(&Batch);
+                }
+            }
+            free(Samples);
+            free(Frames);
+        }
+    }
+
+    FFTPlannerDestroy(&Planner);
+    return 0;
+}
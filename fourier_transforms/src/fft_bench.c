@@ -0,0 +1,278 @@
+// Times the FFT (fft.h) against the direct DFT it replaced, from 256 to 65536
+// points, the real-input FFT (real_fft.h) against the complex one both ways,
+// the explorer's 0-10Hz view built three ways (the direct sum, a zero-padded
+// FFT and the chirp-Z zoom transform, czt.h) and its hovered frequency's
+// probes (single_bin.h). dsp_check checks that they're right.
+//
+// Usage: fft_bench [--max-naive N]
+//   Direct DFTs above --max-naive points (default 8192) are not run; their
+//   time is extrapolated from the largest measured size as O(N^2).
+
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#include "fft.h"
+#include "real_fft.h"
+#include "czt.h"
+#include "single_bin.h"
+#include "dsp_test.h"
+#include "bench_timer.h"
+
+#define VIEW_SAMPLES 1024
+#define VIEW_ZOOM 128
+#define VIEW_MAX_FREQ 10.0f
+#define PROBE_FREQ 7.25f
+
+// The transform as it was done before: sinf/cosf for every (k, n) pair.
+internal void
+NaiveDFT(f32 *TimeDomain, complex32 *FreqDomain, u32 Size)
+{
+    for (u32 K = 0; K < Size; K++)
+    {
+        f32 SumRe = 0;
+        f32 SumIm = 0;
+        for (u32 N = 0; N < Size; N++)
+        {
+            f32 Theta = (f32)FFT_TAU * (f32)K * ((f32)N / Size);
+            SumRe += TimeDomain[N] * cosf(Theta);
+            SumIm -= TimeDomain[N] * sinf(Theta);
+        }
+        FreqDomain[K].Re = SumRe;
+        FreqDomain[K].Im = SumIm;
+    }
+}
+
+// The explorer's view as SlowFourierTransform computed it.
+internal void
+NaiveView(f32 *TimeDomain, f32 *FreqDomain, i32 Size)
+{
+    for (i32 Ki = 0; Ki < Size; Ki++)
+    {
+        f32 K = ((f32)Ki/Size) * VIEW_MAX_FREQ;
+        f32 SumX = 0;
+        for (i32 N = 0; N < Size; N++)
+        {
+            f32 Theta = (f32)FFT_TAU*K*((f32)N/Size);
+            SumX += sinf(Theta) * TimeDomain[N];
+        }
+        FreqDomain[Ki] = SumX;
+    }
+}
+
+// The view from a zero-padded FFT, interpolating between the nearest bins.
+internal void
+FFTView(fft_plan *Plan, complex32 *Spectrum, f32 *TimeDomain, f32 *FreqDomain, i32 Size)
+{
+    FFTLoadReal(Plan, Spectrum, TimeDomain, Size);
+    FFTForward(Plan, Spectrum);
+    f32 BinsPerCycle = (f32)Plan->Size / Size;
+    for (i32 Ki = 0; Ki < Size; Ki++)
+    {
+        f32 Bin = ((f32)Ki/Size) * VIEW_MAX_FREQ * BinsPerCycle;
+        u32 BinIndex = (u32)Bin;
+        FreqDomain[Ki] = -ComplexLerp(Spectrum[BinIndex], Spectrum[BinIndex + 1], Bin - (f32)BinIndex).Im;
+    }
+}
+
+// The view as FrequencyView in main.c computes it.
+internal void
+CZTView(czt_plan *Plan, complex32 *Output, f32 *TimeDomain, f32 *FreqDomain, i32 Size)
+{
+    CZTTransformReal(Plan, TimeDomain, Output);
+    for (i32 Ki = 0; Ki < Size; Ki++)
+    {
+        FreqDomain[Ki] = -Output[Ki].Im;
+    }
+}
+
+// The winding the way Draw computed it before.
+internal complex32
+TrigWind(f32 *Samples, u32 Count, f32 CyclesPerSample, complex32 *Wound)
+{
+    complex32 Sum = {0};
+    for (u32 N = 0; N < Count; N++)
+    {
+        f32 Theta = (f32)FFT_TAU * CyclesPerSample * N;
+        Wound[N].Re = cosf(Theta) * Samples[N];
+        Wound[N].Im = sinf(Theta) * Samples[N];
+        Sum.Re += Wound[N].Re;
+        Sum.Im += Wound[N].Im;
+    }
+    return Sum;
+}
+
+internal f32
+MaxViewError(f32 *Reference, f32 *Values, u32 Count)
+{
+    f32 MaxError = 0;
+    f32 Peak = 0;
+    for (u32 Index = 0; Index < Count; Index++)
+    {
+        f32 Error = fabsf(Reference[Index] - Values[Index]);
+        if (Error > MaxError) MaxError = Error;
+        if (fabsf(Reference[Index]) > Peak) Peak = fabsf(Reference[Index]);
+    }
+    return MaxError / Peak;
+}
+
+i32
+main(i32 argc, char **argv)
+{
+    u32 MaxNaiveSize = 8192;
+    for (i32 ArgIndex = 1; ArgIndex < argc; ArgIndex++)
+    {
+        if (strcmp(argv[ArgIndex], "--max-naive") == 0 && ArgIndex + 1 < argc)
+        {
+            MaxNaiveSize = (u32)atoi(argv[++ArgIndex]);
+        }
+        else
+        {
+            printf("Usage: fft_bench [--max-naive N]\n");
+            return 2;
+        }
+    }
+
+    printf("%8s %14s %14s %10s %12s %14s\n",
+           "points", "direct (ms)", "fft (ms)", "speedup", "fft MFLOPS", "fft per sec");
+
+    f64 LastNaiveSeconds = 0;
+    u32 LastNaiveSize = 0;
+    for (u32 Size = 256; Size <= 65536; Size *= 2)
+    {
+        f32 *Signal = (f32 *)malloc(Size * sizeof(f32));
+        complex32 *Spectrum = (complex32 *)malloc(Size * sizeof(complex32));
+        DSPTestSignal(Signal, 0, Size, Size);
+        fft_plan Plan = FFTCreatePlan(Size);
+
+        f64 FFTSeconds;
+        mx_TimeCalls(0.2, FFTSeconds, (FFTLoadReal(&Plan, Spectrum, Signal, Size), FFTForward(&Plan, Spectrum)));
+
+        f64 NaiveSeconds;
+        bool Estimated = (Size > MaxNaiveSize);
+        if (!Estimated)
+        {
+            mx_TimeCalls(0.2, NaiveSeconds, NaiveDFT(Signal, Spectrum, Size));
+            LastNaiveSeconds = NaiveSeconds;
+            LastNaiveSize = Size;
+        }
+        else
+        {
+            f64 Ratio = (f64)Size / LastNaiveSize;
+            NaiveSeconds = LastNaiveSeconds * Ratio * Ratio;
+        }
+
+        // The usual 5 N log2(N) flop count for a complex radix-2 FFT.
+        f64 MFlops = 5.0 * Size * Plan.Log2Size / FFTSeconds * 1e-6;
+        printf("%8u %13.3f%s %14.4f %9.0fx %12.0f %14.0f\n",
+               Size, NaiveSeconds * 1e3, Estimated ? "*" : " ", FFTSeconds * 1e3,
+               NaiveSeconds / FFTSeconds, MFlops, 1.0 / FFTSeconds);
+
+        FFTDestroyPlan(&Plan);
+        free(Spectrum);
+        free(Signal);
+    }
+    printf("* extrapolated as O(N^2) from %u points.\n\n", LastNaiveSize);
+
+    // Real input. The complex path has to widen the samples to complex first;
+    // that's part of its cost. Both inverses work in place, so each call gets
+    // a fresh copy of its spectrum.
+    printf("%8s %12s %12s %8s %12s %12s %8s\n",
+           "points", "cfft fwd us", "real fwd us", "speedup", "cfft inv us", "real inv us", "speedup");
+    for (u32 Size = 256; Size <= 65536; Size *= 2)
+    {
+        f32 *Signal = (f32 *)malloc(Size * sizeof(f32));
+        f32 *RoundTrip = (f32 *)malloc(Size * sizeof(f32));
+        complex32 *Spectrum = (complex32 *)malloc(Size * sizeof(complex32));
+        complex32 *SavedSpectrum = (complex32 *)malloc(Size * sizeof(complex32));
+        complex32 *HalfSpectrum = (complex32 *)malloc((Size/2 + 1) * sizeof(complex32));
+        complex32 *SavedHalfSpectrum = (complex32 *)malloc((Size/2 + 1) * sizeof(complex32));
+        DSPTestSignal(Signal, 0, Size, Size);
+        fft_plan Plan = FFTCreatePlan(Size);
+        real_fft_plan RealPlan = RealFFTCreatePlan(Size);
+        FFTLoadReal(&Plan, SavedSpectrum, Signal, Size);
+        FFTForward(&Plan, SavedSpectrum);
+        RealFFTForward(&RealPlan, Signal, Size, SavedHalfSpectrum);
+
+        f64 ComplexForwardSeconds, RealForwardSeconds, ComplexInverseSeconds, RealInverseSeconds;
+        mx_TimeCalls(0.05, ComplexForwardSeconds,
+                     (FFTLoadReal(&Plan, Spectrum, Signal, Size), FFTForward(&Plan, Spectrum)));
+        mx_TimeCalls(0.05, RealForwardSeconds, RealFFTForward(&RealPlan, Signal, Size, HalfSpectrum));
+        mx_TimeCalls(0.05, ComplexInverseSeconds,
+                     (memcpy(Spectrum, SavedSpectrum, Size * sizeof(complex32)),
+                      FFTInverse(&Plan, Spectrum)));
+        mx_TimeCalls(0.05, RealInverseSeconds,
+                     (memcpy(HalfSpectrum, SavedHalfSpectrum, (Size/2 + 1) * sizeof(complex32)),
+                      RealFFTInverse(&RealPlan, HalfSpectrum, RoundTrip)));
+        printf("%8u %12.2f %12.2f %7.2fx %12.2f %12.2f %7.2fx\n", Size,
+               ComplexForwardSeconds * 1e6, RealForwardSeconds * 1e6, ComplexForwardSeconds / RealForwardSeconds,
+               ComplexInverseSeconds * 1e6, RealInverseSeconds * 1e6, ComplexInverseSeconds / RealInverseSeconds);
+
+        RealFFTDestroyPlan(&RealPlan);
+        FFTDestroyPlan(&Plan);
+        free(SavedHalfSpectrum);
+        free(HalfSpectrum);
+        free(SavedSpectrum);
+        free(Spectrum);
+        free(RoundTrip);
+        free(Signal);
+    }
+    printf("Spectrum memory per transform: %u bytes real vs %u bytes complex at 65536 points.\n\n",
+           (u32)((65536/2 + 1) * sizeof(complex32)), (u32)(65536 * sizeof(complex32)));
+
+    // The explorer's per-frame 0-10Hz view.
+    {
+        f32 Signal[VIEW_SAMPLES];
+        f32 NaiveOut[VIEW_SAMPLES];
+        f32 FFTOut[VIEW_SAMPLES];
+        f32 CZTOut[VIEW_SAMPLES];
+        complex32 CZTBins[VIEW_SAMPLES];
+        DSPTestSignal(Signal, 0, VIEW_SAMPLES, VIEW_SAMPLES);
+        fft_plan Plan = FFTCreatePlan(VIEW_SAMPLES * VIEW_ZOOM);
+        complex32 *Spectrum = (complex32 *)malloc(Plan.Size * sizeof(complex32));
+        czt_plan ZoomPlan = CZTCreatePlan(VIEW_SAMPLES, VIEW_SAMPLES, 0.0,
+                                          VIEW_MAX_FREQ / ((f64)VIEW_SAMPLES * VIEW_SAMPLES));
+
+        f64 NaiveSeconds, FFTSeconds, CZTSeconds;
+        mx_TimeCalls(0.5, NaiveSeconds, NaiveView(Signal, NaiveOut, VIEW_SAMPLES));
+        mx_TimeCalls(0.5, FFTSeconds, FFTView(&Plan, Spectrum, Signal, FFTOut, VIEW_SAMPLES));
+        mx_TimeCalls(0.5, CZTSeconds, CZTView(&ZoomPlan, CZTBins, Signal, CZTOut, VIEW_SAMPLES));
+
+        printf("0-10Hz view, %u points:\n", VIEW_SAMPLES);
+        printf("  direct sum          %8.3f ms/frame\n", NaiveSeconds * 1e3);
+        printf("  %6u-point FFT     %8.3f ms/frame (%6.1fx), max error %.2e of peak\n",
+               Plan.Size, FFTSeconds * 1e3, NaiveSeconds / FFTSeconds, MaxViewError(NaiveOut, FFTOut, VIEW_SAMPLES));
+        printf("  chirp-z (%u FFTs) %8.3f ms/frame (%6.1fx), max error %.2e of peak\n",
+               ZoomPlan.FFT.Size, CZTSeconds * 1e3, NaiveSeconds / CZTSeconds, MaxViewError(NaiveOut, CZTOut, VIEW_SAMPLES));
+
+        CZTDestroyPlan(&ZoomPlan);
+        FFTDestroyPlan(&Plan);
+        free(Spectrum);
+    }
+
+    // The explorer's hovered frequency, one bin of the same view.
+    {
+        f32 Signal[VIEW_SAMPLES];
+        complex32 Wound[VIEW_SAMPLES];
+        DSPTestSignal(Signal, 0, VIEW_SAMPLES, VIEW_SAMPLES);
+        f32 CyclesPerSample = PROBE_FREQ / VIEW_SAMPLES;
+        f64 TrigSeconds, PhasorSeconds, GoertzelSeconds, RecomputeSeconds, SlideSeconds;
+        volatile f32 Sink = 0;
+        mx_TimeCalls(0.3, TrigSeconds, Sink += TrigWind(Signal, VIEW_SAMPLES, CyclesPerSample, Wound).Re);
+        mx_TimeCalls(0.3, PhasorSeconds, Sink += PhasorWind(Signal, VIEW_SAMPLES, CyclesPerSample, Wound).Re);
+        mx_TimeCalls(0.3, GoertzelSeconds, Sink += GoertzelBin(Signal, VIEW_SAMPLES, CyclesPerSample).Re);
+
+        sliding_dft Sliding = SlidingDFTCreate(VIEW_SAMPLES, CyclesPerSample);
+        u32 Next = 0;
+        mx_TimeCalls(0.3, RecomputeSeconds, SlidingDFTRefresh(&Sliding));
+        mx_TimeCalls(0.3, SlideSeconds, (SlidingDFTPush(&Sliding, Signal[Next]), Next = (Next + 1) % VIEW_SAMPLES));
+        SlidingDFTDestroy(&Sliding);
+
+        printf("\nHovered frequency, %u points:\n", VIEW_SAMPLES);
+        printf("  sinf/cosf winding   %8.2f us\n", TrigSeconds * 1e6);
+        printf("  phasor winding      %8.2f us (%.1fx)\n", PhasorSeconds * 1e6, TrigSeconds / PhasorSeconds);
+        printf("  goertzel centroid   %8.2f us (%.1fx)\n", GoertzelSeconds * 1e6, TrigSeconds / GoertzelSeconds);
+        printf("  sliding: one new sample %.3f us vs %.2f us to recompute the window\n",
+               SlideSeconds * 1e6, RecomputeSeconds * 1e6);
+    }
+    return 0;
+}
@@ -0,0 +1,138 @@
+// Times the planner's non-power-of-two FFTs (fft_mixed.h) next to the
+// power-of-two sizes either side, as planned for this machine. The "per N log N" column is the time per
+// N*log2(N) relative to the power of two below, so 1.0 means as efficient as
+// the neighbouring radix-4 sizes; the "vs pad" column is the time relative to
+// zero-padding up to the next power of two. dsp_check checks that they're
+// right.
+//
+// Usage: fft_mixed_bench [--estimate] [SIZE...]
+//   --estimate plan by rule of thumb instead of measuring.
+//   Sizes default to a list of audio-sized windows and awkward primes.
+
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#include "fft.h"
+#include "real_fft.h"
+#include "fft_split.h"
+#include "fft_mixed.h"
+#include "bench_timer.h"
+#include "fft_planner.h"
+#include "dsp_test.h"
+
+#define MAX_BENCH_SIZES 32 // their plans have to fit in one plan cache.
+
+global u32 DefaultSizes[] =
+{
+    6, 12, 60, 100, 210, 360, 441, 480, 1000, 1536, 2401, 3000, 4410, 4800,
+    10000, 22050, 44100, 48000, 96000, 97, 1009, 2003, 10007, 44101, 65537,
+};
+
+// Seconds per complex forward transform of Size points.
+internal f64
+TimeForward(fft_planner *Planner, u32 Size, complex32 *Input, complex32 *Data)
+{
+    planned_fft *Plan = FFTPlan(Planner, Size, FFTType_Complex, FFTDirection_Forward);
+    f64 Seconds;
+    mx_TimeCalls(0.05, Seconds, (memcpy(Data, Input, Size * sizeof(complex32)), FFTExecuteComplex(Plan, Data)));
+    return Seconds;
+}
+
+internal f64
+Log2(u32 Size)
+{
+    return log((f64)Size) / log(2.0);
+}
+
+i32
+main(i32 argc, char **argv)
+{
+    fft_planner_mode Mode = FFTPlanner_Measure;
+    u32 Sizes[MAX_BENCH_SIZES];
+    u32 SizeCount = 0;
+    for (i32 ArgIndex = 1; ArgIndex < argc; ArgIndex++)
+    {
+        if (strcmp(argv[ArgIndex], "--estimate") == 0)
+        {
+            Mode = FFTPlanner_Estimate;
+        }
+        else if (atoi(argv[ArgIndex]) >= 2 && SizeCount < MAX_BENCH_SIZES)
+        {
+            Sizes[SizeCount++] = (u32)atoi(argv[ArgIndex]);
+        }
+        else
+        {
+            printf("Usage: fft_mixed_bench [--estimate] [SIZE...]\n");
+            return 2;
+        }
+    }
+    if (SizeCount == 0)
+    {
+        SizeCount = mx_ArrayCount(DefaultSizes);
+        memcpy(Sizes, DefaultSizes, sizeof(DefaultSizes));
+    }
+
+    u32 MaxSize = 0;
+    for (u32 Index = 0; Index < SizeCount; Index++)
+    {
+        u32 Padded = 1;
+        while (Padded < Sizes[Index]) Padded *= 2;
+        if (Padded > MaxSize) MaxSize = Padded;
+    }
+    complex32 *Input = (complex32 *)malloc(MaxSize * sizeof(complex32));
+    complex32 *Data = (complex32 *)malloc(MaxSize * sizeof(complex32));
+    DSPTestSignal(0, Input, MaxSize, 1024);
+
+    // One planner for the sizes under test, another for their neighbours,
+    // so the plan cache doesn't fill up.
+    fft_planner Planner = FFTPlannerCreate(Mode, 0);
+    fft_planner Neighbours = FFTPlannerCreate(Mode, 0);
+    printf("Best kernel here is %s; planning by %s. Times are complex forward transforms.\n\n",
+           FFTKernelName(FFTBestKernel()), (Mode == FFTPlanner_Measure) ? "measuring" : "estimate");
+    printf("%8s %12s %10s %10s %10s %12s %8s\n", "points", "algorithm", "us", "below us",
+           "above us", "per N log N", "vs pad");
+
+    f64 WorstMixed = 0;
+    f64 WorstBluestein = 0;
+    for (u32 Index = 0; Index < SizeCount; Index++)
+    {
+        u32 Size = Sizes[Index];
+        planned_fft *Forward = FFTPlan(&Planner, Size, FFTType_Complex, FFTDirection_Forward);
+        if (!Forward)
+        {
+            printf("%8u  can't be planned\n", Size);
+            continue;
+        }
+
+        u32 Below = 1;
+        while (Below * 2 <= Size) Below *= 2;
+        u32 Above = (Below == Size) ? Size : Below * 2;
+        if (Below < 2) Below = 2;
+        f64 Seconds = TimeForward(&Planner, Size, Input, Data);
+        f64 BelowSeconds = TimeForward(&Neighbours, Below, Input, Data);
+        f64 AboveSeconds = TimeForward(&Neighbours, Above, Input, Data);
+        f64 Efficiency = (Seconds / (Size * Log2(Size))) / (BelowSeconds / (Below * Log2(Below)));
+        if (Forward->Algorithm == FFTAlgorithm_Bluestein) WorstBluestein = fmax(WorstBluestein, Efficiency);
+        else if (Size != Below) WorstMixed = fmax(WorstMixed, Efficiency);
+
+        printf("%8u %12s %10.2f %10.2f %10.2f %12.2f %8.2f\n", Size,
+               FFTAlgorithmNames[Forward->Algorithm], Seconds * 1e6, BelowSeconds * 1e6, AboveSeconds * 1e6,
+               Efficiency, Seconds / AboveSeconds);
+
+        if (Neighbours.PlanCount > FFT_PLANNER_MAX_PLANS - 4)
+        {
+            FFTPlannerDestroy(&Neighbours);
+            Neighbours = FFTPlannerCreate(Mode, 0);
+        }
+    }
+
+    printf("\nPer N log N, mixed radix is at worst %.2fx the power of two below it", WorstMixed);
+    if (WorstBluestein > 0) printf(", Bluestein %.2fx", WorstBluestein);
+    printf(".\n");
+
+    FFTPlannerDestroy(&Neighbours);
+    FFTPlannerDestroy(&Planner);
+    free(Data);
+    free(Input);
+    return 0;
+}
@@ -0,0 +1,86 @@
+// Reports GFLOPS per size for each split-array FFT kernel (fft_split.h) this
+// CPU supports, next to the radix-2 FFT in fft.h. dsp_check checks that the
+// kernels are right.
+//
+// Usage: fft_split_bench
+
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#include "fft.h"
+#include "fft_split.h"
+#include "bench_timer.h"
+
+#define MIN_BENCH_SIZE 16
+#define MAX_BENCH_SIZE 65536
+
+// The usual 5 N log2(N) flop count for a complex FFT, whatever the radix.
+internal f64
+FFTGigaFlops(u32 Size, u32 Log2Size, f64 Seconds)
+{
+    return 5.0 * Size * Log2Size / Seconds * 1e-9;
+}
+
+i32
+main(i32 argc, char **argv)
+{
+    complex32 *Input = (complex32 *)malloc(MAX_BENCH_SIZE * sizeof(complex32));
+    complex32 *Work = (complex32 *)malloc(MAX_BENCH_SIZE * sizeof(complex32));
+    f32 *Re = (f32 *)malloc(MAX_BENCH_SIZE * sizeof(f32));
+    f32 *Im = (f32 *)malloc(MAX_BENCH_SIZE * sizeof(f32));
+    for (u32 N = 0; N < MAX_BENCH_SIZE; N++)
+    {
+        Input[N].Re = RandomF32(N) - 0.5f;
+        Input[N].Im = RandomF32(N + MAX_BENCH_SIZE) - 0.5f;
+    }
+
+    bool Supported[FFTKernel_Count];
+    printf("Kernels:");
+    for (u32 Kernel = 0; Kernel < FFTKernel_Count; Kernel++)
+    {
+        Supported[Kernel] = FFTKernelSupported((fft_kernel)Kernel);
+        printf(" %s%s", FFTKernelName(Kernel), Supported[Kernel] ? "" : " (unsupported)");
+    }
+    printf(", best is %s. Columns are GFLOPS.\n\n", FFTKernelName(FFTBestKernel()));
+
+    printf("%8s %10s", "points", "radix-2");
+    for (u32 Kernel = 0; Kernel < FFTKernel_Count; Kernel++)
+    {
+        if (Supported[Kernel]) printf(" %10s", FFTKernelName(Kernel));
+    }
+    printf("\n");
+
+    for (u32 Size = MIN_BENCH_SIZE; Size <= MAX_BENCH_SIZE; Size *= 2)
+    {
+        fft_plan Plan = FFTCreatePlan(Size);
+        f64 Radix2Seconds;
+        mx_TimeCalls(0.05, Radix2Seconds, (memcpy(Work, Input, Size * sizeof(complex32)), FFTForward(&Plan, Work)));
+        printf("%8u %10.2f", Size, FFTGigaFlops(Size, Plan.Log2Size, Radix2Seconds));
+
+        fft_split_plan SplitPlan = FFTSplitCreatePlan(Size);
+        for (u32 Kernel = 0; Kernel < FFTKernel_Count; Kernel++)
+        {
+            if (!Supported[Kernel]) continue;
+            FFTSplitSetKernel(&SplitPlan, (fft_kernel)Kernel);
+            for (u32 N = 0; N < Size; N++)
+            {
+                Re[N] = Input[N].Re;
+                Im[N] = Input[N].Im;
+            }
+
+            f64 Seconds;
+            mx_TimeCalls(0.05, Seconds, FFTSplitForward(&SplitPlan, Re, Im));
+            printf(" %10.2f", FFTGigaFlops(Size, SplitPlan.Log2Size, Seconds));
+        }
+        printf("\n");
+
+        FFTSplitDestroyPlan(&SplitPlan);
+        FFTDestroyPlan(&Plan);
+    }
+
+    free(Im);
+    free(Re);
+    free(Work);
+    free(Input);
+    return 0;
+}
@@ -0,0 +1,211 @@
+// Tunes the FFT planner (fft_planner.h) for this machine and saves the
+// wisdom file, then checks what a second launch gets from it: the same
+// algorithms, from the cache, with no measuring. Every plan is also checked
+// against the radix-2 FFT. Exits 1 if anything doesn't match.
+//
+// Usage: fft_wisdom [--wisdom FILE] [--estimate] [--min N] [--max N]
+//   --wisdom   wisdom file to read and update (default fft.wisdom).
+//   --estimate plan by rule of thumb instead of measuring.
+//   --min/max  range of power-of-two sizes to plan (default 16 to 65536).
+
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#include "fft.h"
+#include "real_fft.h"
+#include "fft_split.h"
+#include "fft_mixed.h"
+#include "bench_timer.h"
+#include "fft_planner.h"
+
+#define PLAN_TOLERANCE 1e-5 // relative to the largest bin (or sample).
+
+// Runs every plan for Size on noise: the forward ones against the radix-2
+// FFT, the inverse ones against the input. Returns the largest relative error.
+internal f64
+CheckPlans(fft_planner *Planner, u32 Size)
+{
+    complex32 *Input = (complex32 *)malloc(Size * sizeof(complex32));
+    complex32 *Reference = (complex32 *)malloc(Size * sizeof(complex32));
+    complex32 *Data = (complex32 *)malloc(Size * sizeof(complex32));
+    f32 *Samples = (f32 *)malloc(Size * sizeof(f32));
+    for (u32 Index = 0; Index < Size; Index++)
+    {
+        Input[Index].Re = RandomF32(Index) - 0.5f;
+        Input[Index].Im = RandomF32(Index + Size) - 0.5f;
+    }
+    fft_plan Radix2 = FFTCreatePlan(Size);
+    f64 MaxError = 0;
+
+    // Complex, both ways.
+    memcpy(Reference, Input, Size * sizeof(complex32));
+    FFTForward(&Radix2, Reference);
+    memcpy(Data, Input, Size * sizeof(complex32));
+    FFTExecuteComplex(FFTPlan(Planner, Size, FFTType_Complex, FFTDirection_Forward), Data);
+    f64 Error = 0, Peak = 0;
+    for (u32 K = 0; K < Size; K++)
+    {
+        Error = fmax(Error, hypot(Data[K].Re - Reference[K].Re, Data[K].Im - Reference[K].Im));
+        Peak = fmax(Peak, ComplexMagnitude(Reference[K]));
+    }
+    MaxError = fmax(MaxError, Error / Peak);
+
+    FFTExecuteComplex(FFTPlan(Planner, Size, FFTType_Complex, FFTDirection_Inverse), Data);
+    Error = 0;
+    for (u32 N = 0; N < Size; N++)
+    {
+        Error = fmax(Error, hypot(Data[N].Re - Input[N].Re, Data[N].Im - Input[N].Im));
+    }
+    MaxError = fmax(MaxError, Error);
+
+    // Real, both ways.
+    for (u32 N = 0; N < Size; N++)
+    {
+        Samples[N] = Input[N].Re;
+        Reference[N].Re = Input[N].Re;
+        Reference[N].Im = 0;
+    }
+    FFTForward(&Radix2, Reference);
+    FFTExecuteReal(FFTPlan(Planner, Size, FFTType_Real, FFTDirection_Forward), Samples, Data);
+    Error = 0;
+    Peak = 0;
+    for (u32 K = 0; K < Size/2 + 1; K++)
+    {
+        Error = fmax(Error, hypot(Data[K].Re - Reference[K].Re, Data[K].Im - Reference[K].Im));
+        Peak = fmax(Peak, ComplexMagnitude(Reference[K]));
+    }
+    MaxError = fmax(MaxError, Error / Peak);
+
+    FFTExecuteReal(FFTPlan(Planner, Size, FFTType_Real, FFTDirection_Inverse), Samples, Data);
+    Error = 0;
+    for (u32 N = 0; N < Size; N++)
+    {
+        Error = fmax(Error, fabs(Samples[N] - Input[N].Re));
+    }
+    MaxError = fmax(MaxError, Error);
+
+    FFTDestroyPlan(&Radix2);
+    free(Samples);
+    free(Data);
+    free(Reference);
+    free(Input);
+    return MaxError;
+}
+
+// Plans every key in the range; returns the seconds it took.
+internal f64
+PlanAll(fft_planner *Planner, u32 MinSize, u32 MaxSize)
+{
+    f64 Start = BenchSeconds();
+    for (u32 Size = MinSize; Size <= MaxSize; Size *= 2)
+    {
+        for (i32 Type = 0; Type < FFTType_Count; Type++)
+        {
+            for (i32 Direction = 0; Direction < FFTDirection_Count; Direction++)
+            {
+                FFTPlan(Planner, Size, (fft_type)Type, (fft_direction)Direction);
+            }
+        }
+    }
+    return BenchSeconds() - Start;
+}
+
+i32
+main(i32 argc, char **argv)
+{
+    const char *WisdomPath = "fft.wisdom";
+    fft_planner_mode Mode = FFTPlanner_Measure;
+    u32 MinSize = 16;
+    u32 MaxSize = 65536;
+    for (i32 ArgIndex = 1; ArgIndex < argc; ArgIndex++)
+    {
+        if (strcmp(argv[ArgIndex], "--wisdom") == 0 && ArgIndex + 1 < argc)
+        {
+            WisdomPath = argv[++ArgIndex];
+        }
+        else if (strcmp(argv[ArgIndex], "--estimate") == 0)
+        {
+            Mode = FFTPlanner_Estimate;
+        }
+        else if (strcmp(argv[ArgIndex], "--min") == 0 && ArgIndex + 1 < argc)
+        {
+            MinSize = (u32)atoi(argv[++ArgIndex]);
+        }
+        else if (strcmp(argv[ArgIndex], "--max") == 0 && ArgIndex + 1 < argc)
+        {
+            MaxSize = (u32)atoi(argv[++ArgIndex]);
+        }
+        else
+        {
+            printf("Usage: fft_wisdom [--wisdom FILE] [--estimate] [--min N] [--max N]\n");
+            return 2;
+        }
+    }
+    if (!FFTIsPowerOfTwo(MinSize) || MinSize < 4 || MaxSize < MinSize)
+    {
+        printf("--min must be a power of two >= 4 and no more than --max.\n");
+        return 2;
+    }
+
+    u32 FailCount = 0;
+    fft_planner Planner = FFTPlannerCreate(Mode, WisdomPath);
+    printf("Best kernel here is %s; %u wisdom entries loaded from %s.\n",
+           FFTKernelName(FFTBestKernel()), Planner.WisdomCount, WisdomPath);
+    f64 FirstSeconds = PlanAll(&Planner, MinSize, MaxSize);
+    printf("Planned in %.1f ms, %u keys measured (%.1f ms of that).\n\n",
+           FirstSeconds * 1e3, Planner.MeasuredCount, Planner.MeasureSeconds * 1e3);
+
+    printf("%8s %14s %14s %14s %14s %10s\n", "points", "complex fwd", "complex inv", "real fwd", "real inv", "error");
+    for (u32 Size = MinSize; Size <= MaxSize; Size *= 2)
+    {
+        printf("%8u", Size);
+        for (i32 Type = 0; Type < FFTType_Count; Type++)
+        {
+            for (i32 Direction = 0; Direction < FFTDirection_Count; Direction++)
+            {
+                planned_fft *Plan = FFTPlan(&Planner, Size, (fft_type)Type, (fft_direction)Direction);
+                printf(" %14s", FFTAlgorithmNames[Plan->Algorithm]);
+            }
+        }
+        f64 Error = CheckPlans(&Planner, Size);
+        bool Passed = (Error <= PLAN_TOLERANCE);
+        FailCount += Passed ? 0 : 1;
+        printf(" %10.1e  %s\n", Error, Passed ? "ok" : "FAILED");
+    }
+
+    // Asking again has to hit the cache.
+    u32 PlanCount = Planner.PlanCount;
+    PlanAll(&Planner, MinSize, MaxSize);
+    if (Planner.PlanCount != PlanCount)
+    {
+        printf("Replanning made %u new plans instead of using the cache.\n", Planner.PlanCount - PlanCount);
+        FailCount++;
+    }
+
+    // Keep the choices to compare against the next launch.
+    fft_algorithm Chosen[FFT_PLANNER_MAX_PLANS];
+    for (u32 Index = 0; Index < Planner.PlanCount; Index++)
+    {
+        Chosen[Index] = Planner.Plans[Index]->Algorithm;
+    }
+    bool Measured = (Planner.MeasuredCount > 0);
+    FFTPlannerDestroy(&Planner);
+
+    if (Mode == FFTPlanner_Measure)
+    {
+        fft_planner Relaunch = FFTPlannerCreate(FFTPlanner_Measure, WisdomPath);
+        f64 RelaunchSeconds = PlanAll(&Relaunch, MinSize, MaxSize);
+        u32 Mismatches = 0;
+        for (u32 Index = 0; Index < Relaunch.PlanCount; Index++)
+        {
+            Mismatches += (Relaunch.Plans[Index]->Algorithm != Chosen[Index]) ? 1 : 0;
+        }
+        printf("\n%s %s. Next launch: %u entries, planned in %.1f ms, %u keys measured, %u choices differ.\n",
+               Measured ? "Saved" : "Nothing new to save to", WisdomPath,
+               Relaunch.WisdomCount, RelaunchSeconds * 1e3, Relaunch.MeasuredCount, Mismatches);
+        if (Relaunch.MeasuredCount != 0 || Mismatches != 0) FailCount++;
+        FFTPlannerDestroy(&Relaunch);
+    }
+
+    return (FailCount == 0) ? 0 : 1;
+}
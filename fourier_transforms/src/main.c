@@ -3,38 +3,179 @@
 #define RAYGUI_SUPPORT_ICONS
 #define RAYGUI_IMPLEMENTATION
 #include "raygui.h"
+#include "fft.h"
+#include "czt.h"
+#include "single_bin.h"
+#include "plot.h"
 
-#define NUM_SAMPLES 1024
+#define SCREEN_WIDTH 1024
+#define VIEW_POINTS SCREEN_WIDTH
+#define DEFAULT_NUM_SAMPLES 1024
+#define MIN_NUM_SAMPLES 16
+#define MAX_NUM_SAMPLES (1 << 20)
+#define MAX_VIEW_FREQ 10.0f
+#define SIGNAL_TONES 3
+// Each tone's phasor restarts from an exact sin/cos this often, so its phase
+// can't drift however long the signal is.
+#define SIGNAL_RESYNC_INTERVAL 4096
+// The winding only needs enough points to show its shape.
+#define MAX_WINDING_POINTS 8192
 
+#define SIGNAL_BASELINE_Y 150
+#define SIGNAL_HEIGHT 50
+#define WINDING_ORIGIN_X 512
+#define WINDING_ORIGIN_Y 400
+#define WINDING_SCALE 200
+#define SPECTRUM_BASELINE_Y 650
+#define WATERFALL_X 744
+#define WATERFALL_Y 210
+#define WATERFALL_WIDTH 256
+#define WATERFALL_HEIGHT 256
+#define WATERFALL_FLOOR_DB -60.0f
+
+typedef struct signal_params
+{
+    i32 Freq[SIGNAL_TONES];
+    f32 Amp[SIGNAL_TONES];
+} signal_params;
+
+typedef enum draw_mode
+{
+    DrawMode_Layers,     // plots rasterized into plot.h layers.
+    DrawMode_Immediate,  // one draw call per point, to compare against.
+    DrawMode_Count,
+} draw_mode;
+
+global const char *DrawModeNames[DrawMode_Count] = {"layers", "per point"};
+
+typedef struct draw_stats
+{
+    i32 DrawCalls;
+    f64 FrameSeconds;  // averaged over recent frames.
+} draw_stats;
+
+// Everything past Signal is derived from it and cached until its inputs
+// change, so a frame where nothing moves only draws.
 typedef struct state
 {
-    f32 Signal[NUM_SAMPLES];
-    f32 FourierTransform[NUM_SAMPLES];
+    i32 SignalSize;
+    f32 *Signal;
+    signal_params Params;
+    bool SignalDirty;
+    
+    // 0Hz - 10Hz view of Signal.
+    bool ViewDirty;
+    czt_plan ViewPlan;
+    complex32 View[VIEW_POINTS];
+    f32 FourierTransform[VIEW_POINTS];
+    
+    // Cuts and winding of Signal at CutFreq.
+    bool CutsDirty;
+    f32 CutFreq;
+    i32 CutStride;
+    f32 *Summation;
+    complex32 *Winding;
+    complex32 WindingSum;
+    
+    // Plots of the above, redrawn into their layers when it changes. Tab
+    // switches DrawMode.
+    draw_mode DrawMode;
+    bool SignalPlotDirty;
+    bool SpectrumPlotDirty;
+    plot_layer SignalLayer;
+    plot_layer WindingLayer;
+    plot_layer SpectrumLayer;
+    waterfall Waterfall;
+    f32 Magnitudes[VIEW_POINTS];
+    draw_stats Stats[DrawMode_Count];
 } state;
 
+// The view is VIEW_POINTS points from 0Hz up to (not including) MAX_VIEW_FREQ
+// cycles per window of Size samples.
+internal czt_plan
+CreateViewPlan(i32 Size)
+{
+    return CZTCreatePlan(Size, VIEW_POINTS, 0.0, (f64)MAX_VIEW_FREQ / ((f64)VIEW_POINTS * Size));
+}
+
+// 0Hz - 10Hz. Each point is sum(x[n] * sin(2*pi*K*n/Size)), i.e. minus the
+// imaginary part of the zoom transform at K cycles per window.
 internal void 
-SlowFourierTransform(f32 *TimeDomain, f32 *FreqDomain, i32 Size)
+FrequencyView(state *State, f32 *TimeDomain, f32 *FreqDomain)
 {
-    // TODO: Make a optimized fast fourier transform.
-    // 0Hz - 10Hz.
-    for (i32 Ki = 0; Ki < Size; Ki++)
-    {
-        f32 K = ((f32)Ki/Size) * 10.0f;
-        f32 SumX = 0;
-        f32 SumY = 0;
-        for (i32 N = 0; N < Size; N++)
+    CZTTransformReal(&State->ViewPlan, TimeDomain, State->View);
+    for (i32 Ki = 0; Ki < VIEW_POINTS; Ki++)
+    {
+        FreqDomain[Ki] = -State->View[Ki].Im;
+    }
+}
+
+internal bool
+SignalParamsEqual(signal_params *A, signal_params *B)
+{
+    for (i32 Tone = 0; Tone < SIGNAL_TONES; Tone++)
+    {
+        if (A->Freq[Tone] != B->Freq[Tone] || A->Amp[Tone] != B->Amp[Tone]) return false;
+    }
+    return true;
+}
+
+// Sum of the tones, each one a phasor stepping Freq cycles per window, so
+// there's one sin/cos per SIGNAL_RESYNC_INTERVAL samples instead of one per
+// sample. The tones advance side by side; their phasors don't depend on each
+// other, so their multiplies overlap.
+internal void
+GenerateSignal(f32 *Signal, i32 Size, signal_params *Params)
+{
+    f64 CyclesPerSample[SIGNAL_TONES];
+    f32 Amp[SIGNAL_TONES];
+    for (i32 Tone = 0; Tone < SIGNAL_TONES; Tone++)
+    {
+        CyclesPerSample[Tone] = (f64)Params->Freq[Tone] / Size;
+        Amp[Tone] = Params->Amp[Tone] / SIGNAL_TONES;
+    }
+    
+    for (i32 Start = 0; Start < Size; Start += SIGNAL_RESYNC_INTERVAL)
+    {
+        phasor Phasors[SIGNAL_TONES];
+        for (i32 Tone = 0; Tone < SIGNAL_TONES; Tone++)
+        {
+            Phasors[Tone] = PhasorCreate((f32)CyclesPerSample[Tone], CyclesPerSample[Tone] * Start);
+        }
+        i32 End = (Size - Start > SIGNAL_RESYNC_INTERVAL) ? Start + SIGNAL_RESYNC_INTERVAL : Size;
+        for (i32 N = Start; N < End; N++)
+        {
+            f32 Sample = 0;
+            for (i32 Tone = 0; Tone < SIGNAL_TONES; Tone++)
+            {
+                Sample += Amp[Tone] * Phasors[Tone].Value.Im;
+                PhasorAdvance(&Phasors[Tone]);
+            }
+            Signal[N] = Sample;
+        }
+    }
+}
+
+// Folds the signal every CutStride samples into Summation and winds it at
+// CutFreq. One phasor pass gives both the wound points and their sum (the
+// centroid).
+internal void
+UpdateCuts(state *State)
+{
+    i32 Size = State->SignalSize;
+    i32 FoldSize = (State->CutStride < Size) ? State->CutStride : Size;
+    for (i32 N = 0; N < FoldSize; N++)
+    {
+        State->Summation[N] = 0;
+    }
+    for (i32 CutX = 0; State->CutStride > 0 && CutX < Size; CutX += State->CutStride)
+    {
+        for (i32 N = 0; (N < State->CutStride) && (N+CutX < Size); N++)
         {
-            f32 Sample = TimeDomain[N];
-            f32 Ns = (f32)N/Size;
-            f32 Theta = 2*PI*K*Ns;
-            f32 Magnitude = Sample;
-            f32 X = sinf(Theta) * Magnitude;
-            f32 Y = cosf(Theta) * Magnitude;
-            SumX += X;
-            SumY += Y;
+            State->Summation[N] += State->Signal[N + CutX];
         }
-        FreqDomain[Ki] = SumX;
     }
+    State->WindingSum = PhasorWind(State->Signal, Size, State->CutFreq / Size, State->Winding);
 }
 
 internal void 
@@ -59,149 +200,301 @@ Update(state *State)
     if (GuiSpinner((Rectangle){ 800, 15, 80, 30 }, NULL, &Freq3, 0, 10, Freq3_Edit)) 
         Freq3_Edit = !Freq3_Edit;
     
-    for (i32 N = 0; N < NUM_SAMPLES; N++)
+    signal_params Params = {{Freq1, Freq2, Freq3}, {Amp1, Amp2, Amp3}};
+    if (State->SignalDirty || !SignalParamsEqual(&Params, &State->Params))
+    {
+        State->Params = Params;
+        GenerateSignal(State->Signal, State->SignalSize, &State->Params);
+        State->SignalDirty = false;
+        State->ViewDirty = true;
+        State->CutsDirty = true;
+    }
+    
+    // Cut Frequency
+    f32 MaxCutFreq = MAX_VIEW_FREQ;
+    f32 CutFreq = ((f32)GetMouseX()/SCREEN_WIDTH) * MaxCutFreq;
+    if (CutFreq != State->CutFreq)
+    {
+        State->CutFreq = CutFreq;
+        State->CutStride = (CutFreq > 0) ? (i32)fmaxf(State->SignalSize/CutFreq, 1) : 0;
+        State->CutsDirty = true;
+    }
+    
+    if (State->CutsDirty)
+    {
+        UpdateCuts(State);
+        State->CutsDirty = false;
+        State->SignalPlotDirty = true;
+    }
+    if (State->ViewDirty)
+    {
+        FrequencyView(State, State->Signal, State->FourierTransform);
+        for (i32 Ki = 0; Ki < VIEW_POINTS; Ki++)
+        {
+            State->Magnitudes[Ki] = ComplexMagnitude(State->View[Ki]);
+        }
+        State->ViewDirty = false;
+        State->SpectrumPlotDirty = true;
+    }
+    
+    if (IsKeyPressed(KEY_TAB))
     {
-        State->Signal[N] = 0;
-        State->Signal[N] += Amp1 * sinf(2 * PI * Freq1 * ((f32)N / NUM_SAMPLES));
-        State->Signal[N] += Amp2 * sinf(2 * PI * Freq2 * ((f32)N / NUM_SAMPLES));
-        State->Signal[N] += Amp3 * sinf(2 * PI * Freq3 * ((f32)N / NUM_SAMPLES));
-        State->Signal[N] /= 3;
+        State->DrawMode = (State->DrawMode + 1) % DrawMode_Count;
     }
 }
 
-internal void
-Draw(state *State)
+// The plots as they were first written: a DrawPixel per sample, winding point
+// and bin. Returns the draw calls it made.
+internal i32
+DrawPlotsImmediate(state *State)
 {
     Color SignalCol = ColorAlpha(RED, 0.7f);
-    Color BaselineCol = ColorAlpha(GRAY, 0.7f);
     Color CutCol = ColorAlpha(GREEN, 0.9f);
     Color Sum2DCol = ColorAlpha(YELLOW, 0.9f);
-    f32 MouseX = (f32)GetMouseX();
+    i32 Size = State->SignalSize;
+    i32 DrawCalls = 0;
+    
+    // Long signals are drawn one sample per pixel column.
+    f32 PixelsPerSample = (f32)SCREEN_WIDTH / Size;
+    i32 SampleStep = (Size > SCREEN_WIDTH) ? Size / SCREEN_WIDTH : 1;
     
     // Draw the signal
-    i32 SignalBaselineY = 150;
-    i32 SignalHeight = 50;
-    DrawLine(0, SignalBaselineY, NUM_SAMPLES, SignalBaselineY, BaselineCol);
-    for (i32 N = 0; N < NUM_SAMPLES; N++)
+    for (i32 N = 0; N < Size; N += SampleStep)
     {
         f32 Sample = State->Signal[N];
-        DrawPixel(N, SignalBaselineY + Sample*SignalHeight, SignalCol);
+        DrawPixel(N*PixelsPerSample, SIGNAL_BASELINE_Y + Sample*SIGNAL_HEIGHT, SignalCol);
+        DrawCalls++;
     }
     
-    // Cut Frequency
-    f32 MaxCutFreq = 10.0f;
-    f32 CutFreq = (MouseX/NUM_SAMPLES) * MaxCutFreq;
-    
     // Draw Cuts
-    i32 CutX = 0;
-    i32 CutStride = max((NUM_SAMPLES/CutFreq), 1);
-    f32 Summation[NUM_SAMPLES] = {0};
-    while (CutStride > 0 && CutX < NUM_SAMPLES)
-    {
-        DrawLine(CutX, 
-                 SignalBaselineY - SignalHeight, 
-                 CutX, 
-                 SignalBaselineY + SignalHeight, 
+    i32 CutStride = State->CutStride;
+    for (i32 CutX = 0; CutStride > 0 && CutX < Size; CutX += CutStride)
+    {
+        DrawLine(CutX*PixelsPerSample, 
+                 SIGNAL_BASELINE_Y - SIGNAL_HEIGHT, 
+                 CutX*PixelsPerSample, 
+                 SIGNAL_BASELINE_Y + SIGNAL_HEIGHT, 
                  CutCol);
+        DrawCalls++;
         // Draw overlap.
-        for (i32 N = 0; (N < CutStride) && (N+CutX < NUM_SAMPLES); N++)
+        for (i32 N = 0; (N < CutStride) && (N+CutX < Size); N += SampleStep)
         {
             f32 Sample = State->Signal[N + CutX];
-            DrawPixel(CutStride + N,
-                      SignalBaselineY + Sample*SignalHeight,
+            DrawPixel((CutStride + N)*PixelsPerSample,
+                      SIGNAL_BASELINE_Y + Sample*SIGNAL_HEIGHT,
                       SignalCol);
-            Summation[N] += Sample;
+            DrawCalls++;
         }
-        CutX += CutStride;
     }
     
     // Draw Summation.
-    for (i32 N = 0; N < min(CutStride, NUM_SAMPLES); N++)
+    for (i32 N = 0; N < CutStride && N < Size; N += SampleStep)
     {
-        f32 Sample = Summation[N];
-        DrawPixel(CutStride + N,
-                  SignalBaselineY + Sample*SignalHeight,
+        f32 Sample = State->Summation[N];
+        DrawPixel((CutStride + N)*PixelsPerSample,
+                  SIGNAL_BASELINE_Y + Sample*SIGNAL_HEIGHT,
                   CutCol);
+        DrawCalls++;
     }
     
     // Draw circular wrap.
-    i32 CircleOriginX = 512;
-    i32 CircleOriginY = 400;
-    f32 SumX = 0;
-    f32 SumY = 0;
-    for (i32 N = 0; N < NUM_SAMPLES; N++)
+    i32 WindingStep = (Size > MAX_WINDING_POINTS) ? Size / MAX_WINDING_POINTS : 1;
+    for (i32 N = 0; N < Size; N += WindingStep)
     {
-        f32 Sample = State->Signal[N];
-        f32 Ns = (f32)N/NUM_SAMPLES;
-        f32 Theta = 2*PI*CutFreq*Ns;
-        f32 Magnitude = 200 * Sample;
-        f32 X = sinf(Theta) * Magnitude;
-        f32 Y = cosf(Theta) * Magnitude;
+        f32 X = State->Winding[N].Im * WINDING_SCALE;
+        f32 Y = State->Winding[N].Re * WINDING_SCALE;
+        DrawPixel(X + WINDING_ORIGIN_X, Y + WINDING_ORIGIN_Y, CutCol);
+        DrawCalls++;
+    }
+    
+    // Draw the frequency domain, scaled back to 1024 samples like the centroid.
+    f32 ViewScale = (f32)DEFAULT_NUM_SAMPLES / Size;
+    for (i32 N = 0; N < VIEW_POINTS; N++)
+    {
+        f32 F = State->FourierTransform[N] * ViewScale;
+        DrawPixel(N,
+                  SPECTRUM_BASELINE_Y - (F * 1),
+                  Sum2DCol);
+        DrawCalls++;
+    }
+    return DrawCalls;
+}
+
+// The same plots traced into layers, min/max per pixel column, so nothing
+// is skipped however long the signal is. The layers are only redrawn and
+// uploaded when the signal, cuts or view change. Returns the draw calls it
+// made.
+internal i32
+DrawPlotsLayers(state *State)
+{
+    Color SignalCol = ColorAlpha(RED, 0.7f);
+    Color CutCol = ColorAlpha(GREEN, 0.9f);
+    Color Sum2DCol = ColorAlpha(YELLOW, 0.9f);
+    i32 Size = State->SignalSize;
+    f32 PixelsPerSample = (f32)SCREEN_WIDTH / Size;
+    
+    if (State->SignalPlotDirty)
+    {
+        plot_layer *Layer = &State->SignalLayer;
+        PlotLayerClear(Layer);
+        PlotTrace(Layer, State->Signal, Size, 0, PixelsPerSample, SIGNAL_BASELINE_Y, SIGNAL_HEIGHT, SignalCol);
         
-        SumX += X;
-        SumY += Y;
+        // Each cut, folded over the first, then their sum.
+        i32 CutStride = State->CutStride;
+        for (i32 CutX = 0; CutStride > 0 && CutX < Size; CutX += CutStride)
+        {
+            PlotSpan(Layer, (i32)(CutX*PixelsPerSample), SIGNAL_BASELINE_Y - SIGNAL_HEIGHT,
+                     SIGNAL_BASELINE_Y + SIGNAL_HEIGHT, CutCol);
+            i32 Count = (Size - CutX < CutStride) ? Size - CutX : CutStride;
+            PlotTrace(Layer, State->Signal + CutX, Count, CutStride*PixelsPerSample, PixelsPerSample,
+                      SIGNAL_BASELINE_Y, SIGNAL_HEIGHT, SignalCol);
+        }
+        i32 FoldSize = (CutStride < Size) ? CutStride : Size;
+        PlotTrace(Layer, State->Summation, FoldSize, CutStride*PixelsPerSample, PixelsPerSample,
+                  SIGNAL_BASELINE_Y, SIGNAL_HEIGHT, CutCol);
+        PlotLayerUpload(Layer);
         
-        DrawPixel(X + CircleOriginX, Y + CircleOriginY, CutCol);
+        Layer = &State->WindingLayer;
+        PlotLayerClear(Layer);
+        i32 WindingStep = (Size > MAX_WINDING_POINTS) ? Size / MAX_WINDING_POINTS : 1;
+        for (i32 N = 0; N < Size; N += WindingStep)
+        {
+            PlotPoint(Layer,
+                      (i32)(State->Winding[N].Im * WINDING_SCALE) + WINDING_ORIGIN_X,
+                      (i32)(State->Winding[N].Re * WINDING_SCALE) + WINDING_ORIGIN_Y,
+                      CutCol);
+        }
+        PlotLayerUpload(Layer);
+        State->SignalPlotDirty = false;
+    }
+    
+    if (State->SpectrumPlotDirty)
+    {
+        plot_layer *Layer = &State->SpectrumLayer;
+        PlotLayerClear(Layer);
+        f32 ViewScale = (f32)DEFAULT_NUM_SAMPLES / Size;
+        PlotTrace(Layer, State->FourierTransform, VIEW_POINTS, 0, (f32)SCREEN_WIDTH / VIEW_POINTS,
+                  SPECTRUM_BASELINE_Y, -ViewScale, Sum2DCol);
+        PlotLayerUpload(Layer);
+        State->SpectrumPlotDirty = false;
     }
     
+    return (PlotLayerDraw(&State->SignalLayer) +
+            PlotLayerDraw(&State->WindingLayer) +
+            PlotLayerDraw(&State->SpectrumLayer));
+}
+
+internal void
+Draw(state *State)
+{
+    Color BaselineCol = ColorAlpha(GRAY, 0.7f);
+    Color Sum2DCol = ColorAlpha(YELLOW, 0.9f);
+    i32 Size = State->SignalSize;
+    i32 DrawCalls = 0;
+    
+    DrawLine(0, SIGNAL_BASELINE_Y, SCREEN_WIDTH, SIGNAL_BASELINE_Y, BaselineCol);
+    DrawCalls++;
+    DrawCalls += (State->DrawMode == DrawMode_Immediate) ? DrawPlotsImmediate(State) : DrawPlotsLayers(State);
+    
+    // The spectrum's history, one column per frame, in either mode.
+    WaterfallPush(&State->Waterfall, State->Magnitudes, VIEW_POINTS, 0.5f * Size);
+    DrawCalls += WaterfallDraw(&State->Waterfall);
+    
+    // The centroid grows with the window, so scale it back to 1024 samples.
+    f32 CentroidScale = WINDING_SCALE * (f32)DEFAULT_NUM_SAMPLES / Size;
+    f32 SumX = State->WindingSum.Im * CentroidScale;
+    f32 SumY = State->WindingSum.Re * CentroidScale;
+    
     // Draw 2D summation.
     f32 Sum2DScale = 0.01f;
-    i32 SumXFinal = (i32)(SumX*Sum2DScale) + CircleOriginX;
-    i32 SumYFinal = (i32)(SumY*Sum2DScale) + CircleOriginY;
+    i32 SumXFinal = (i32)(SumX*Sum2DScale) + WINDING_ORIGIN_X;
+    i32 SumYFinal = (i32)(SumY*Sum2DScale) + WINDING_ORIGIN_Y;
     DrawCircle(SumXFinal, 
                SumYFinal, 
                5, 
                Sum2DCol);
-    DrawLine(CircleOriginX,
-             CircleOriginY,
+    DrawLine(WINDING_ORIGIN_X,
+             WINDING_ORIGIN_Y,
              SumXFinal,
              SumYFinal,
              Sum2DCol);
+    DrawCalls += 2;
     
-    SlowFourierTransform(&State->Signal[0], &State->FourierTransform[0], NUM_SAMPLES);
-    
-    // Draw the frequency domain
-    for (i32 N = 0; N < NUM_SAMPLES; N++)
-    {
-        f32 F = State->FourierTransform[N];
-        DrawPixel(N,
-                  650 - (F * 1),
-                  Sum2DCol);
-    }
-    
-    DrawText(TextFormat("Cut Freq: %.2fHz", CutFreq),
+    DrawText(TextFormat("Cut Freq: %.2fHz", State->CutFreq),
              15,
              15,
              20,
              RAYWHITE);
+    DrawText(TextFormat("%d samples, drawing %s (Tab switches)", Size, DrawModeNames[State->DrawMode]),
+             15,
+             40,
+             20,
+             GRAY);
+    DrawCalls += 2 + DrawMode_Count;
+    State->Stats[State->DrawMode].DrawCalls = DrawCalls;
+    for (i32 Mode = 0; Mode < DrawMode_Count; Mode++)
+    {
+        DrawText(TextFormat("%-9s %5d draw calls, %.3fms per frame", DrawModeNames[Mode],
+                            State->Stats[Mode].DrawCalls, State->Stats[Mode].FrameSeconds * 1000.0),
+                 15,
+                 65 + 20*Mode,
+                 16,
+                 (Mode == State->DrawMode) ? RAYWHITE : GRAY);
+    }
 }
 
 i32 
 main(i32 argc, char **argv)
 {
-    const i32 screen_width = NUM_SAMPLES;
+    // Usage: main [samples]
+    i32 SignalSize = (argc > 1) ? atoi(argv[1]) : DEFAULT_NUM_SAMPLES;
+    if (SignalSize < MIN_NUM_SAMPLES) SignalSize = MIN_NUM_SAMPLES;
+    if (SignalSize > MAX_NUM_SAMPLES) SignalSize = MAX_NUM_SAMPLES;
+    
+    const i32 screen_width = SCREEN_WIDTH;
     const i32 screen_height = 768;
     InitWindow(screen_width, screen_height, "Raylib");
     SetTargetFPS(60);
     InitAudioDevice();
     
-    state *State = malloc(sizeof(state));
-    for (i32 N = 0; N < NUM_SAMPLES; N++)
-    {
-        State->FourierTransform[N] = 0;
-    }
+    state *State = calloc(1, sizeof(state));
+    State->SignalSize = SignalSize;
+    State->Signal = calloc(SignalSize, sizeof(f32));
+    State->Summation = calloc(SignalSize, sizeof(f32));
+    State->Winding = calloc(SignalSize, sizeof(complex32));
+    State->SignalDirty = true;
+    State->CutFreq = -1;
+    State->ViewPlan = CreateViewPlan(SignalSize);
+    State->SignalLayer = PlotLayerCreate(0, 0, SCREEN_WIDTH, 2*SIGNAL_BASELINE_Y + 1);
+    State->WindingLayer = PlotLayerCreate(WINDING_ORIGIN_X - WINDING_SCALE, WINDING_ORIGIN_Y - WINDING_SCALE,
+                                          2*WINDING_SCALE + 1, 2*WINDING_SCALE + 1);
+    State->SpectrumLayer = PlotLayerCreate(0, WINDING_ORIGIN_Y, SCREEN_WIDTH, screen_height - WINDING_ORIGIN_Y);
+    State->Waterfall = WaterfallCreate(WATERFALL_X, WATERFALL_Y, WATERFALL_WIDTH, WATERFALL_HEIGHT,
+                                       WATERFALL_FLOOR_DB);
     
     while(!WindowShouldClose())
     {
+        f64 FrameStart = GetTime();
         Update(State);
         
         BeginDrawing();
         ClearBackground(BLACK);
         Draw(State);
+        draw_stats *Stats = &State->Stats[State->DrawMode];
+        Stats->FrameSeconds += 0.1 * ((GetTime() - FrameStart) - Stats->FrameSeconds);
         EndDrawing();
     }
     
+    WaterfallDestroy(&State->Waterfall);
+    PlotLayerDestroy(&State->SpectrumLayer);
+    PlotLayerDestroy(&State->WindingLayer);
+    PlotLayerDestroy(&State->SignalLayer);
+    CZTDestroyPlan(&State->ViewPlan);
+    free(State->Signal);
+    free(State->Summation);
+    free(State->Winding);
+    free(State);
     CloseAudioDevice();
     CloseWindow();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,220 @@
+/* date = October 18th 2026 */
+
+#ifndef PLOT_H
+#define PLOT_H
+
+// CPU-side plotting for the explorer.
+//
+// A plot_layer is an Image the size of a screen region. Points and spans are
+// written straight into its pixels, and the whole layer goes up to the GPU
+// in one texture upload, after which it costs one draw call however many
+// points it holds. Layers are only redrawn and uploaded when what they show
+// changes.
+//
+// A waterfall is an Image used as a ring of columns, one per frame. Pushing a
+// spectrum writes the newest column and uploads just that column. Drawing
+// takes two draw calls, because the ring is unrolled oldest column first.
+//
+// Needs raylib.h.
+
+typedef struct plot_layer
+{
+    i32 X;
+    i32 Y;
+    Image Image;        // R8G8B8A8, transparent where nothing is plotted.
+    Texture2D Texture;
+} plot_layer;
+
+internal plot_layer
+PlotLayerCreate(i32 X, i32 Y, i32 Width, i32 Height)
+{
+    plot_layer Layer = {0};
+    Layer.X = X;
+    Layer.Y = Y;
+    Layer.Image = GenImageColor(Width, Height, BLANK);
+    Layer.Texture = LoadTextureFromImage(Layer.Image);
+    return Layer;
+}
+
+internal void
+PlotLayerDestroy(plot_layer *Layer)
+{
+    UnloadTexture(Layer->Texture);
+    UnloadImage(Layer->Image);
+}
+
+internal void
+PlotLayerClear(plot_layer *Layer)
+{
+    memset(Layer->Image.data, 0, (usize)Layer->Image.width * Layer->Image.height * sizeof(Color));
+}
+
+// Fills screen column X from Y0 to Y1 (either way round), clipped to the layer.
+internal void
+PlotSpan(plot_layer *Layer, i32 X, i32 Y0, i32 Y1, Color Col)
+{
+    X -= Layer->X;
+    if (X < 0 || X >= Layer->Image.width) return;
+    i32 Top = ((Y0 < Y1) ? Y0 : Y1) - Layer->Y;
+    i32 Bottom = ((Y0 < Y1) ? Y1 : Y0) - Layer->Y;
+    if (Top < 0) Top = 0;
+    if (Bottom >= Layer->Image.height) Bottom = Layer->Image.height - 1;
+    Color *Pixels = (Color *)Layer->Image.data;
+    for (i32 Row = Top; Row <= Bottom; Row++)
+    {
+        Pixels[Row*Layer->Image.width + X] = Col;
+    }
+}
+
+internal void
+PlotPoint(plot_layer *Layer, i32 X, i32 Y, Color Col)
+{
+    PlotSpan(Layer, X, Y, Y, Col);
+}
+
+// Plots Count values as a trace: value N at screen x = X0 + N*PixelsPerValue,
+// y = BaselineY + Value*Scale. Every pixel column gets one span from the
+// smallest to the largest value landing in it, so peaks survive any amount of
+// decimation. Each span also reaches back to the value before the column,
+// so steep stretches stay joined up.
+internal void
+PlotTrace(plot_layer *Layer, f32 *Values, i32 Count, f32 X0, f32 PixelsPerValue,
+          f32 BaselineY, f32 Scale, Color Col)
+{
+    if (Count <= 0) return;
+    i32 Column = (i32)X0;
+    f32 Min = Values[0];
+    f32 Max = Values[0];
+    for (i32 N = 1; N < Count; N++)
+    {
+        f32 Value = Values[N];
+        i32 ValueColumn = (i32)(X0 + N*PixelsPerValue);
+        if (ValueColumn != Column)
+        {
+            PlotSpan(Layer, Column, (i32)(BaselineY + Min*Scale), (i32)(BaselineY + Max*Scale), Col);
+            Column = ValueColumn;
+            f32 Last = Values[N - 1];
+            Min = (Value < Last) ? Value : Last;
+            Max = (Value < Last) ? Last : Value;
+        }
+        else
+        {
+            Min = fminf(Min, Value);
+            Max = fmaxf(Max, Value);
+        }
+    }
+    PlotSpan(Layer, Column, (i32)(BaselineY + Min*Scale), (i32)(BaselineY + Max*Scale), Col);
+}
+
+// Uploads the layer's pixels. One call per change.
+internal void
+PlotLayerUpload(plot_layer *Layer)
+{
+    UpdateTexture(Layer->Texture, Layer->Image.data);
+}
+
+// Returns the draw calls it made.
+internal i32
+PlotLayerDraw(plot_layer *Layer)
+{
+    DrawTexture(Layer->Texture, Layer->X, Layer->Y, WHITE);
+    return 1;
+}
+
+//
+// Waterfall.
+//
+
+typedef struct waterfall
+{
+    i32 X;
+    i32 Y;
+    Image Image;        // Width columns of Height rows; column Head is the newest.
+    Texture2D Texture;
+    Color *Column;      // Height pixels, staged for the column upload.
+    i32 Head;
+    f32 FloorDecibels;  // the bottom of the colour ramp; 0dB is the top.
+} waterfall;
+
+internal waterfall
+WaterfallCreate(i32 X, i32 Y, i32 Width, i32 Height, f32 FloorDecibels)
+{
+    waterfall Waterfall = {0};
+    Waterfall.X = X;
+    Waterfall.Y = Y;
+    Waterfall.Image = GenImageColor(Width, Height, BLACK);
+    Waterfall.Texture = LoadTextureFromImage(Waterfall.Image);
+    Waterfall.Column = (Color *)calloc(Height, sizeof(Color));
+    Waterfall.Head = Width - 1;
+    Waterfall.FloorDecibels = FloorDecibels;
+    return Waterfall;
+}
+
+internal void
+WaterfallDestroy(waterfall *Waterfall)
+{
+    UnloadTexture(Waterfall->Texture);
+    UnloadImage(Waterfall->Image);
+    free(Waterfall->Column);
+}
+
+// Black through blue and red to yellow as T goes from 0 to 1.
+internal Color
+WaterfallColor(f32 T)
+{
+    T = fminf(fmaxf(T, 0.0f), 1.0f);
+    Color Col;
+    Col.r = (u8)(255.0f * fminf(2.0f*T, 1.0f));
+    Col.g = (u8)(255.0f * fmaxf(2.0f*T - 1.0f, 0.0f));
+    Col.b = (u8)(255.0f * ((T < 0.5f) ? 2.0f*T : 2.0f - 2.0f*T) * 0.8f);
+    Col.a = 255;
+    return Col;
+}
+
+// Adds a column for Count magnitudes, lowest frequency at the bottom, each
+// row showing the largest of the bins it covers in dB relative to FullScale.
+internal void
+WaterfallPush(waterfall *Waterfall, f32 *Magnitudes, i32 Count, f32 FullScale)
+{
+    i32 Width = Waterfall->Image.width;
+    i32 Height = Waterfall->Image.height;
+    Waterfall->Head = (Waterfall->Head + 1) % Width;
+    Color *Pixels = (Color *)Waterfall->Image.data;
+    for (i32 Row = 0; Row < Height; Row++)
+    {
+        i32 FirstBin = (i32)((i64)(Height - 1 - Row) * Count / Height);
+        i32 EndBin = (i32)((i64)(Height - Row) * Count / Height);
+        if (EndBin <= FirstBin) EndBin = FirstBin + 1;
+        f32 Peak = 0;
+        for (i32 Bin = FirstBin; Bin < EndBin; Bin++)
+        {
+            Peak = fmaxf(Peak, Magnitudes[Bin]);
+        }
+        f32 Decibels = 20.0f * log10f(Peak / FullScale + 1e-9f);
+        Color Col = WaterfallColor(1.0f - Decibels / Waterfall->FloorDecibels);
+        Waterfall->Column[Row] = Col;
+        Pixels[Row*Width + Waterfall->Head] = Col;
+    }
+    UpdateTextureRec(Waterfall->Texture, (Rectangle){ (f32)Waterfall->Head, 0, 1, (f32)Height }, Waterfall->Column);
+}
+
+// Oldest column on the left. Returns the draw calls it made.
+internal i32
+WaterfallDraw(waterfall *Waterfall)
+{
+    i32 Width = Waterfall->Image.width;
+    f32 Height = (f32)Waterfall->Image.height;
+    i32 Oldest = Waterfall->Head + 1;
+    i32 DrawCalls = 0;
+    if (Oldest < Width)
+    {
+        DrawTextureRec(Waterfall->Texture, (Rectangle){ (f32)Oldest, 0, (f32)(Width - Oldest), Height },
+                       (Vector2){ (f32)Waterfall->X, (f32)Waterfall->Y }, WHITE);
+        DrawCalls++;
+    }
+    DrawTextureRec(Waterfall->Texture, (Rectangle){ 0, 0, (f32)Oldest, Height },
+                   (Vector2){ (f32)(Waterfall->X + Width - Oldest), (f32)Waterfall->Y }, WHITE);
+    return DrawCalls + 1;
+}
+
+#endif //PLOT_H
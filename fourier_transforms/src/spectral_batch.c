@@ -0,0 +1,668 @@
+// Analyses WAV files offline: each one is run through the STFT in stft.h,
+// and every frame gets its spectral centroid, its spectral flux and its
+// strongest peaks, and optionally the whole magnitude spectrum. The results
+// go to a CSV file or a compact binary file next to each input (or into
+// --out).
+//
+// Files are cut into chunks of CHUNK_FRAMES frames, and all the chunks of all
+// the files go on one work queue, so a single long file is spread over every
+// core as well as a folder of short ones. Chunks are analysed in any order
+// but written in order. Each thread reads only the chunk it's working on, so
+// memory use doesn't depend on how long the files are.
+//
+// Usage: spectral_batch [--fft N] [--window-size N] [--hop N] [--window NAME]
+//                       [--peaks N] [--spectra] [--format csv|bin]
+//                       [--threads N] [--out DIR] FILE|FOLDER...
+//   --fft          FFT size, any even size from 4 (default 2048).
+//   --window-size  samples per frame (default the FFT size).
+//   --hop          samples between frames (default a quarter window).
+//   --window       rectangular, hann, hamming or blackman (default hann).
+//   --peaks        peaks listed per frame, up to 32 (default 5).
+//   --spectra      also write every bin's level in dB.
+//   --format       csv (default) or bin; see spectral_file_header.
+//   --threads      threads to use (default one per core).
+//   --out          folder to write into instead of next to each input.
+// Folders are searched (not recursively) for .wav files.
+//
+// Levels are in dB relative to a full-scale sine. Flux is the length of the
+// rise in each bin's amplitude since the previous frame, so it picks out
+// onsets. Peaks are local maxima, refined by fitting a parabola to their
+// level in dB.
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include "platform.h"
+#include "fft.h"
+#include "real_fft.h"
+#include "fft_split.h"
+#include "fft_mixed.h"
+#include "bench_timer.h"
+#include "fft_planner.h"
+#include "dsp_math.h"
+#include "dsp_window.h"
+#include "stft.h"
+#include "wav_reader.h"
+#include "work_queue.h"
+
+#ifndef _WIN32
+#include <dirent.h>
+#endif
+
+#define CHUNK_FRAMES 256
+#define MAX_PEAKS 32
+#define MAX_PATH_LENGTH 512
+#define LEVEL_FLOOR_DB -240.0f
+#define PEAK_FLOOR_DB -100.0f
+
+typedef enum output_format
+{
+    OutputFormat_CSV,
+    OutputFormat_Binary,
+} output_format;
+
+// The binary format, little-endian: this header, then FrameCount records of
+//   f32 Time (seconds, the middle of the window), Centroid (Hz), Flux,
+//   PeakCount x {f32 Frequency (Hz), Level (dB)}, strongest first, unused
+//   ones 0Hz at LEVEL_FLOOR_DB,
+//   BinCount x f32 Level (dB), if the spectra were asked for.
+typedef struct spectral_file_header
+{
+    char Magic[4];  // "SPEC"
+    u32 Version;    // 1
+    u32 SampleRate;
+    u32 FFTSize;
+    u32 WindowSize;
+    u32 HopSize;
+    u32 Window;     // dsp_window
+    u32 PeakCount;
+    u32 BinCount;   // 0 without spectra.
+    u32 FrameCount;
+} spectral_file_header;
+
+typedef struct analysis_config
+{
+    stft_config STFT;
+    u32 PeakCount;
+    bool Spectra;
+    output_format Format;
+    const char *OutDir;
+} analysis_config;
+
+typedef struct input_file
+{
+    char Path[MAX_PATH_LENGTH];
+    char OutPath[MAX_PATH_LENGTH];
+    wav_sample_type Type;
+    u32 Channels;
+    u32 SampleRate;
+    u64 SampleCount;
+    u64 FrameCount;
+    u32 ChunkCount;
+    u32 FirstJob;
+    // Chunks written so far. Chunk n waits for this to reach n, then writes
+    // and bumps it, which also hands Out and Failed on to chunk n+1.
+    u32 WrittenChunks;
+    FILE *Out;
+    bool Failed;
+} input_file;
+
+typedef struct peak
+{
+    f32 Frequency;
+    f32 Level;
+} peak;
+
+// Everything one thread needs, allocated before any job runs.
+typedef struct worker
+{
+    fft_planner Planner;
+    stft STFT;
+    wav_reader Reader;
+    input_file *ReaderFile;  // the file Reader has open, to reuse for its next chunk.
+    f32 *Block;
+    f32 *Amplitudes;
+    f32 *Previous;
+    char *Output;            // the chunk's results, until it's its turn to write.
+    usize OutputSize;
+    usize OutputCapacity;
+    u64 FrameCount;
+    f64 BusySeconds;
+} worker;
+
+typedef struct batch
+{
+    analysis_config Config;
+    u32 BinCount;
+    f32 AmplitudeScale;      // bin magnitude to sine amplitude.
+    input_file *Files;
+    u32 FileCount;
+    u32 JobCount;
+    worker Workers[MAX_WORK_THREADS];
+} batch;
+
+internal void
+Append(worker *Worker, const char *Format, ...)
+{
+    va_list Args;
+    va_start(Args, Format);
+    usize Space = Worker->OutputCapacity - Worker->OutputSize;
+    i32 Written = vsnprintf(Worker->Output + Worker->OutputSize, Space, Format, Args);
+    va_end(Args);
+    if (Written > 0) Worker->OutputSize += ((usize)Written < Space) ? (usize)Written : Space - 1;
+}
+
+internal void
+AppendBytes(worker *Worker, void *Bytes, usize Size)
+{
+    if (Size > Worker->OutputCapacity - Worker->OutputSize) return;
+    memcpy(Worker->Output + Worker->OutputSize, Bytes, Size);
+    Worker->OutputSize += Size;
+}
+
+internal f32
+LevelDecibels(f32 Amplitude)
+{
+    f32 Level = 20.0f * log10f(Amplitude + 1e-12f);
+    return fminf(fmaxf(Level, LEVEL_FLOOR_DB), -LEVEL_FLOOR_DB);
+}
+
+// Keeps the Count strongest local maxima in Peaks, strongest first. Returns
+// how many there were, up to Count.
+internal u32
+FindPeaks(f32 *Amplitudes, u32 BinCount, f32 BinHz, peak *Peaks, u32 Count)
+{
+    u32 Found = 0;
+    for (u32 Bin = 1; Count > 0 && Bin + 1 < BinCount; Bin++)
+    {
+        f32 Amplitude = Amplitudes[Bin];
+        if (Amplitude <= Amplitudes[Bin - 1] || Amplitude < Amplitudes[Bin + 1]) continue;
+        f32 B = LevelDecibels(Amplitude);
+        if (B < PEAK_FLOOR_DB) continue;
+        if (Found == Count && B <= Peaks[Count - 1].Level) continue;
+
+        f32 A = LevelDecibels(Amplitudes[Bin - 1]);
+        f32 C = LevelDecibels(Amplitudes[Bin + 1]);
+        f32 Curve = A - 2*B + C;
+        f32 Offset = (Curve < 0) ? 0.5f * (A - C) / Curve : 0.0f;
+        peak Peak;
+        Peak.Frequency = ((f32)Bin + Offset) * BinHz;
+        Peak.Level = B - 0.25f * (A - C) * Offset;
+
+        u32 Slot = (Found < Count) ? Found++ : Count - 1;
+        while (Slot > 0 && Peaks[Slot - 1].Level < Peak.Level)
+        {
+            Peaks[Slot] = Peaks[Slot - 1];
+            Slot--;
+        }
+        Peaks[Slot] = Peak;
+    }
+    return Found;
+}
+
+internal void
+AppendHeader(batch *Batch, worker *Worker, input_file *File)
+{
+    analysis_config *Config = &Batch->Config;
+    u32 BinCount = Config->Spectra ? Batch->BinCount : 0;
+    if (Config->Format == OutputFormat_Binary)
+    {
+        spectral_file_header Header = {{'S', 'P', 'E', 'C'}, 1};
+        Header.SampleRate = File->SampleRate;
+        Header.FFTSize = Config->STFT.FFTSize;
+        Header.WindowSize = Config->STFT.WindowSize;
+        Header.HopSize = Config->STFT.HopSize;
+        Header.Window = Config->STFT.Window;
+        Header.PeakCount = Config->PeakCount;
+        Header.BinCount = BinCount;
+        Header.FrameCount = (u32)File->FrameCount;
+        AppendBytes(Worker, &Header, sizeof(Header));
+        return;
+    }
+
+    Append(Worker, "frame,time,centroid_hz,flux");
+    for (u32 Index = 0; Index < Config->PeakCount; Index++)
+    {
+        Append(Worker, ",peak%u_hz,peak%u_db", Index + 1, Index + 1);
+    }
+    f32 BinHz = (f32)File->SampleRate / Config->STFT.FFTSize;
+    for (u32 Bin = 0; Bin < BinCount; Bin++)
+    {
+        Append(Worker, ",%.1fhz", Bin * BinHz);
+    }
+    Append(Worker, "\n");
+}
+
+internal void
+AppendFrame(batch *Batch, worker *Worker, input_file *File, u64 Frame, bool HavePrevious)
+{
+    analysis_config *Config = &Batch->Config;
+    u32 BinCount = Batch->BinCount;
+    f32 *Amplitudes = Worker->Amplitudes;
+    f32 BinHz = (f32)File->SampleRate / Config->STFT.FFTSize;
+
+    f32 Weighted = 0;
+    f32 Total = 0;
+    f32 Flux = 0;
+    for (u32 Bin = 0; Bin < BinCount; Bin++)
+    {
+        Weighted += Bin * BinHz * Amplitudes[Bin];
+        Total += Amplitudes[Bin];
+        f32 Rise = HavePrevious ? Amplitudes[Bin] - Worker->Previous[Bin] : 0.0f;
+        if (Rise > 0) Flux += Rise * Rise;
+    }
+    f32 Time = (f32)((f64)(Frame * Config->STFT.HopSize + Config->STFT.WindowSize / 2) / File->SampleRate);
+    f32 Centroid = (Total > 0) ? Weighted / Total : 0.0f;
+    Flux = sqrtf(Flux);
+
+    peak Peaks[MAX_PEAKS];
+    u32 PeakCount = FindPeaks(Amplitudes, BinCount, BinHz, Peaks, Config->PeakCount);
+    for (u32 Index = PeakCount; Index < Config->PeakCount; Index++)
+    {
+        Peaks[Index].Frequency = 0;
+        Peaks[Index].Level = LEVEL_FLOOR_DB;
+    }
+
+    if (Config->Format == OutputFormat_Binary)
+    {
+        f32 Features[3] = {Time, Centroid, Flux};
+        AppendBytes(Worker, Features, sizeof(Features));
+        AppendBytes(Worker, Peaks, Config->PeakCount * sizeof(peak));
+        for (u32 Bin = 0; Config->Spectra && Bin < BinCount; Bin++)
+        {
+            f32 Level = LevelDecibels(Amplitudes[Bin]);
+            AppendBytes(Worker, &Level, sizeof(Level));
+        }
+        return;
+    }
+
+    Append(Worker, "%llu,%.6f,%.2f,%.6g", (unsigned long long)Frame, Time, Centroid, Flux);
+    for (u32 Index = 0; Index < Config->PeakCount; Index++)
+    {
+        if (Index < PeakCount) Append(Worker, ",%.2f,%.2f", Peaks[Index].Frequency, Peaks[Index].Level);
+        else Append(Worker, ",,");
+    }
+    for (u32 Bin = 0; Config->Spectra && Bin < BinCount; Bin++)
+    {
+        Append(Worker, ",%.2f", LevelDecibels(Amplitudes[Bin]));
+    }
+    Append(Worker, "\n");
+}
+
+// Upper bound on a chunk's output, header included.
+internal usize
+ChunkOutputCapacity(analysis_config *Config, u32 BinCount)
+{
+    usize Bins = Config->Spectra ? BinCount : 0;
+    usize Frame = 64 + Config->PeakCount * 24 + Bins * 12;
+    usize Header = 64 + Config->PeakCount * 32 + Bins * 16 + sizeof(spectral_file_header);
+    return Header + CHUNK_FRAMES * Frame;
+}
+
+internal void
+AnalyseChunk(void *Data, u32 Job, u32 Thread)
+{
+    batch *Batch = (batch *)Data;
+    worker *Worker = &Batch->Workers[Thread];
+    stft_config *Config = &Batch->Config.STFT;
+    f64 Start = BenchSeconds();
+
+    // The last file starting at or before Job.
+    u32 Low = 0;
+    u32 High = Batch->FileCount - 1;
+    while (Low < High)
+    {
+        u32 Middle = (Low + High + 1) / 2;
+        if (Batch->Files[Middle].FirstJob <= Job) Low = Middle;
+        else High = Middle - 1;
+    }
+    input_file *File = &Batch->Files[Low];
+    u32 Chunk = Job - File->FirstJob;
+    u64 FirstFrame = (u64)Chunk * CHUNK_FRAMES;
+    u64 EndFrame = FirstFrame + CHUNK_FRAMES;
+    if (EndFrame > File->FrameCount) EndFrame = File->FrameCount;
+
+    Worker->OutputSize = 0;
+    if (Chunk == 0) AppendHeader(Batch, Worker, File);
+
+    bool ReadFailed = false;
+    if (FirstFrame < EndFrame)
+    {
+        if (Worker->ReaderFile != File)
+        {
+            if (Worker->ReaderFile) WavClose(&Worker->Reader);
+            Worker->ReaderFile = WavOpen(&Worker->Reader, File->Path) ? File : 0;
+        }
+
+        // Start a frame early, when there is one, so the first frame's flux
+        // has something to compare against.
+        u64 PrimeFrame = (FirstFrame > 0) ? FirstFrame - 1 : 0;
+        u64 FirstSample = PrimeFrame * Config->HopSize;
+        u64 EndSample = (EndFrame - 1) * Config->HopSize + Config->WindowSize;
+        bool HavePrevious = false;
+        STFTReset(&Worker->STFT);
+        ReadFailed = !Worker->ReaderFile;
+        wav_iterator Blocks = {0};
+        if (!ReadFailed) Blocks = WavIterate(&Worker->Reader, FirstSample, EndSample, Worker->Block, WAV_READ_BLOCK);
+        while (!ReadFailed && WavNext(&Blocks))
+        {
+            u32 Produced = STFTPush(&Worker->STFT, Blocks.Samples, Blocks.Count);
+            for (u64 Local = Worker->STFT.FrameCount - Produced; Local < Worker->STFT.FrameCount; Local++)
+            {
+                complex32 *Bins = STFTFrame(&Worker->STFT, Local);
+                for (u32 Bin = 0; Bin < Batch->BinCount; Bin++)
+                {
+                    Worker->Amplitudes[Bin] = ComplexMagnitude(Bins[Bin]) * Batch->AmplitudeScale;
+                }
+                u64 Frame = PrimeFrame + Local;
+                if (Frame >= FirstFrame)
+                {
+                    AppendFrame(Batch, Worker, File, Frame, HavePrevious);
+                    Worker->FrameCount++;
+                }
+                f32 *Swap = Worker->Previous;
+                Worker->Previous = Worker->Amplitudes;
+                Worker->Amplitudes = Swap;
+                HavePrevious = true;
+            }
+        }
+    }
+    Worker->BusySeconds += BenchSeconds() - Start;
+
+    // Wait for the chunk before this one to be written.
+    while (mx_AtomicLoadU32(&File->WrittenChunks) != Chunk)
+    {
+        WorkYield();
+    }
+    if (Chunk == 0)
+    {
+        File->Out = fopen(File->OutPath, (Batch->Config.Format == OutputFormat_Binary) ? "wb" : "w");
+        File->Failed = !File->Out;
+    }
+    if (ReadFailed) File->Failed = true;
+    if (File->Out)
+    {
+        if (fwrite(Worker->Output, 1, Worker->OutputSize, File->Out) != Worker->OutputSize) File->Failed = true;
+        if (Chunk + 1 == File->ChunkCount)
+        {
+            if (fclose(File->Out) != 0) File->Failed = true;
+            File->Out = 0;
+        }
+    }
+    mx_AtomicStoreU32(&File->WrittenChunks, Chunk + 1);
+}
+
+internal bool
+HasWavExtension(const char *Name)
+{
+    usize Length = strlen(Name);
+    if (Length < 4) return false;
+    const char *Extension = Name + Length - 4;
+    return (Extension[0] == '.' &&
+            (Extension[1] | 0x20) == 'w' && (Extension[2] | 0x20) == 'a' && (Extension[3] | 0x20) == 'v');
+}
+
+internal void
+AddFile(batch *Batch, const char *Path, u32 *Capacity)
+{
+    if (strlen(Path) >= MAX_PATH_LENGTH)
+    {
+        printf("%s: path too long, skipped.\n", Path);
+        return;
+    }
+    if (Batch->FileCount == *Capacity)
+    {
+        *Capacity = *Capacity ? 2 * *Capacity : 64;
+        Batch->Files = (input_file *)realloc(Batch->Files, *Capacity * sizeof(input_file));
+    }
+    input_file *File = &Batch->Files[Batch->FileCount++];
+    memset(File, 0, sizeof(*File));
+    strcpy(File->Path, Path);
+}
+
+// Adds Path if it's a file, or the .wav files in it if it's a folder.
+internal void
+AddPath(batch *Batch, const char *Path, u32 *Capacity)
+{
+    char Child[MAX_PATH_LENGTH];
+#ifdef _WIN32
+    DWORD Attributes = GetFileAttributesA(Path);
+    if (Attributes == INVALID_FILE_ATTRIBUTES || !(Attributes & FILE_ATTRIBUTE_DIRECTORY))
+    {
+        AddFile(Batch, Path, Capacity);
+        return;
+    }
+    snprintf(Child, sizeof(Child), "%s\\*.wav", Path);
+    WIN32_FIND_DATAA Found;
+    HANDLE Find = FindFirstFileA(Child, &Found);
+    if (Find == INVALID_HANDLE_VALUE) return;
+    do
+    {
+        if (Found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) continue;
+        snprintf(Child, sizeof(Child), "%s\\%s", Path, Found.cFileName);
+        AddFile(Batch, Child, Capacity);
+    } while (FindNextFileA(Find, &Found));
+    FindClose(Find);
+#else
+    DIR *Folder = opendir(Path);
+    if (!Folder)
+    {
+        AddFile(Batch, Path, Capacity);
+        return;
+    }
+    struct dirent *Entry;
+    while ((Entry = readdir(Folder)) != 0)
+    {
+        if (!HasWavExtension(Entry->d_name)) continue;
+        snprintf(Child, sizeof(Child), "%s/%s", Path, Entry->d_name);
+        AddFile(Batch, Child, Capacity);
+    }
+    closedir(Folder);
+#endif
+}
+
+internal i32
+CompareFiles(const void *A, const void *B)
+{
+    return strcmp(((input_file *)A)->Path, ((input_file *)B)->Path);
+}
+
+i32
+main(i32 argc, char **argv)
+{
+    static batch Batch;
+    analysis_config *Config = &Batch.Config;
+    Config->STFT.FFTSize = 2048;
+    Config->STFT.Window = DSPWindow_Hann;
+    Config->PeakCount = 5;
+    u32 ThreadCount = WorkCpuCount();
+    u32 FileCapacity = 0;
+    bool Usage = false;
+    for (i32 ArgIndex = 1; ArgIndex < argc; ArgIndex++)
+    {
+        char *Arg = argv[ArgIndex];
+        bool HasValue = (ArgIndex + 1 < argc);
+        if (strcmp(Arg, "--fft") == 0 && HasValue)
+        {
+            Config->STFT.FFTSize = (u32)atoi(argv[++ArgIndex]);
+        }
+        else if (strcmp(Arg, "--window-size") == 0 && HasValue)
+        {
+            Config->STFT.WindowSize = (u32)atoi(argv[++ArgIndex]);
+        }
+        else if (strcmp(Arg, "--hop") == 0 && HasValue)
+        {
+            Config->STFT.HopSize = (u32)atoi(argv[++ArgIndex]);
+        }
+        else if (strcmp(Arg, "--window") == 0 && HasValue)
+        {
+            const char *Name = argv[++ArgIndex];
+            Config->STFT.Window = DSPWindow_Count;
+            for (i32 Kind = 0; Kind < DSPWindow_Count; Kind++)
+            {
+                if (strcmp(Name, DSPWindowName(Kind)) == 0) Config->STFT.Window = (dsp_window)Kind;
+            }
+        }
+        else if (strcmp(Arg, "--peaks") == 0 && HasValue)
+        {
+            Config->PeakCount = (u32)atoi(argv[++ArgIndex]);
+            if (Config->PeakCount > MAX_PEAKS) Config->PeakCount = MAX_PEAKS;
+        }
+        else if (strcmp(Arg, "--spectra") == 0)
+        {
+            Config->Spectra = true;
+        }
+        else if (strcmp(Arg, "--format") == 0 && HasValue)
+        {
+            const char *Name = argv[++ArgIndex];
+            if (strcmp(Name, "csv") == 0) Config->Format = OutputFormat_CSV;
+            else if (strcmp(Name, "bin") == 0) Config->Format = OutputFormat_Binary;
+            else Usage = true;
+        }
+        else if (strcmp(Arg, "--threads") == 0 && HasValue)
+        {
+            ThreadCount = (u32)atoi(argv[++ArgIndex]);
+        }
+        else if (strcmp(Arg, "--out") == 0 && HasValue)
+        {
+            Config->OutDir = argv[++ArgIndex];
+        }
+        else if (Arg[0] != '-')
+        {
+            AddPath(&Batch, Arg, &FileCapacity);
+        }
+        else
+        {
+            Usage = true;
+        }
+    }
+    if (Config->STFT.HopSize == 0)
+    {
+        Config->STFT.HopSize = ((Config->STFT.WindowSize ? Config->STFT.WindowSize : Config->STFT.FFTSize) + 3) / 4;
+    }
+    Config->STFT.FrameCapacity = WAV_READ_BLOCK / (Config->STFT.HopSize ? Config->STFT.HopSize : 1) + 2;
+    if (Usage || Batch.FileCount == 0)
+    {
+        printf("Usage: spectral_batch [--fft N] [--window-size N] [--hop N] [--window NAME] [--peaks N]\n"
+               "                      [--spectra] [--format csv|bin] [--threads N] [--out DIR] FILE|FOLDER...\n");
+        return 2;
+    }
+    if (!STFTConfigResolve(&Config->STFT))
+    {
+        printf("The FFT size has to be even and >= 4, the window no bigger and the hop no bigger than the window.\n");
+        return 2;
+    }
+    if (ThreadCount == 0) ThreadCount = 1;
+    if (ThreadCount > MAX_WORK_THREADS) ThreadCount = MAX_WORK_THREADS;
+    qsort(Batch.Files, Batch.FileCount, sizeof(input_file), CompareFiles);
+
+    // Read the headers to find how many chunks each file makes. Files that
+    // can't be read are dropped.
+    u32 Kept = 0;
+    u64 TotalSamples = 0;
+    f64 AudioSeconds = 0;
+    for (u32 Index = 0; Index < Batch.FileCount; Index++)
+    {
+        input_file File = Batch.Files[Index];
+        wav_reader Reader;
+        if (!WavOpen(&Reader, File.Path))
+        {
+            printf("%s: %s, skipped.\n", File.Path, Reader.Error);
+            continue;
+        }
+        File.Type = Reader.Type;
+        File.Channels = Reader.Channels;
+        File.SampleRate = Reader.SampleRate;
+        File.SampleCount = Reader.FrameCount;
+        WavClose(&Reader);
+
+        const char *Extension = (Config->Format == OutputFormat_Binary) ? ".spec" : ".csv";
+        const char *Name = File.Path;
+        for (const char *At = File.Path; *At && Config->OutDir; At++)
+        {
+            if (*At == '/' || *At == '\\') Name = At + 1;
+        }
+        i32 Length = Config->OutDir ?
+            snprintf(File.OutPath, sizeof(File.OutPath), "%s/%s%s", Config->OutDir, Name, Extension) :
+            snprintf(File.OutPath, sizeof(File.OutPath), "%s%s", File.Path, Extension);
+        if (Length < 0 || Length >= (i32)sizeof(File.OutPath))
+        {
+            printf("%s: output path too long, skipped.\n", File.Path);
+            continue;
+        }
+
+        u32 WindowSize = Config->STFT.WindowSize;
+        File.FrameCount = (File.SampleCount >= WindowSize) ? (File.SampleCount - WindowSize) / Config->STFT.HopSize + 1 : 0;
+        File.ChunkCount = (u32)((File.FrameCount + CHUNK_FRAMES - 1) / CHUNK_FRAMES);
+        if (File.ChunkCount == 0) File.ChunkCount = 1; // still writes the header.
+        File.FirstJob = Batch.JobCount;
+        Batch.JobCount += File.ChunkCount;
+        TotalSamples += File.SampleCount;
+        AudioSeconds += (f64)File.SampleCount / File.SampleRate;
+        Batch.Files[Kept++] = File;
+    }
+    Batch.FileCount = Kept;
+    if (Batch.FileCount == 0) return 1;
+
+    // Amplitude of a sine centred on a bin: |X| = A * sum(window) / 2.
+    f32 *Window = (f32 *)malloc(Config->STFT.WindowSize * sizeof(f32));
+    DSPFillWindow(Window, Config->STFT.WindowSize, Config->STFT.Window);
+    f64 WindowSum = 0;
+    for (u32 N = 0; N < Config->STFT.WindowSize; N++) WindowSum += Window[N];
+    free(Window);
+    Batch.AmplitudeScale = (f32)(2.0 / WindowSum);
+    Batch.BinCount = Config->STFT.FFTSize/2 + 1;
+
+    // Plans carry scratch memory, so every thread gets its own.
+    if (ThreadCount > Batch.JobCount) ThreadCount = Batch.JobCount;
+    usize OutputCapacity = ChunkOutputCapacity(Config, Batch.BinCount);
+    for (u32 Thread = 0; Thread < ThreadCount; Thread++)
+    {
+        worker *Worker = &Batch.Workers[Thread];
+        Worker->Planner = FFTPlannerCreate(FFTPlanner_Estimate, 0);
+        Worker->STFT = STFTCreate(&Worker->Planner, Config->STFT);
+        Worker->Block = (f32 *)malloc(WAV_READ_BLOCK * sizeof(f32));
+        Worker->Amplitudes = (f32 *)malloc(Batch.BinCount * sizeof(f32));
+        Worker->Previous = (f32 *)malloc(Batch.BinCount * sizeof(f32));
+        Worker->Output = (char *)malloc(OutputCapacity);
+        Worker->OutputCapacity = OutputCapacity;
+    }
+
+    printf("%u files, %.1fs of audio, FFT %u (%s kernels), window %u (%s), hop %u, %u chunks on %u threads.\n",
+           Batch.FileCount, AudioSeconds, Config->STFT.FFTSize, FFTKernelName(FFTBestKernel()), Config->STFT.WindowSize,
+           DSPWindowName(Config->STFT.Window), Config->STFT.HopSize, Batch.JobCount, ThreadCount);
+    f64 Start = BenchSeconds();
+    WorkQueueRun(AnalyseChunk, &Batch, Batch.JobCount, ThreadCount);
+    f64 WallSeconds = BenchSeconds() - Start;
+
+    u32 FailCount = 0;
+    for (u32 Index = 0; Index < Batch.FileCount; Index++)
+    {
+        input_file *File = &Batch.Files[Index];
+        printf("%s (%s x %u, %u Hz): %llu frames -> %s%s\n", File->Path, WavSampleTypeName(File->Type),
+               File->Channels, File->SampleRate, (unsigned long long)File->FrameCount, File->OutPath,
+               File->Failed ? " FAILED" : "");
+        FailCount += File->Failed ? 1 : 0;
+    }
+    u64 FrameCount = 0;
+    f64 BusySeconds = 0;
+    for (u32 Thread = 0; Thread < ThreadCount; Thread++)
+    {
+        worker *Worker = &Batch.Workers[Thread];
+        FrameCount += Worker->FrameCount;
+        BusySeconds += Worker->BusySeconds;
+        if (Worker->ReaderFile) WavClose(&Worker->Reader);
+        STFTDestroy(&Worker->STFT);
+        FFTPlannerDestroy(&Worker->Planner);
+        free(Worker->Block);
+        free(Worker->Amplitudes);
+        free(Worker->Previous);
+        free(Worker->Output);
+    }
+    printf("%llu frames from %llu samples in %.3fs: %.0fx real time, %.0f frames/s, threads %.0f%% busy.\n",
+           (unsigned long long)FrameCount, (unsigned long long)TotalSamples, WallSeconds,
+           AudioSeconds / WallSeconds, FrameCount / WallSeconds,
+           100.0 * BusySeconds / (WallSeconds * ThreadCount));
+    free(Batch.Files);
+    return (FailCount == 0) ? 0 : 1;
+}
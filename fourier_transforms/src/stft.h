@@ -0,0 +1,250 @@
+/* date = October 18th 2026 */
+
+#ifndef STFT_H
+#define STFT_H
+
+// Streaming short-time Fourier transform and its overlap-add inverse.
+//
+// STFTPush takes samples in blocks of any size, as they arrive. Every
+// HopSize samples, once a full window has come in, the last WindowSize
+// samples are windowed, zero-padded to FFTSize and transformed into a
+// real_fft.h half-spectrum (FFTSize/2 + 1 bins). The spectrum goes into a
+// ring holding the last FrameCapacity frames. Frame i covers samples
+// [i*HopSize, i*HopSize + WindowSize).
+//
+// ISTFTPushFrame inverts one frame at a time. It windows each frame again and
+// overlap-adds it, dividing by the summed squared window, which gives back
+// the input exactly for any window and hop where the frames overlap. Each frame
+// finishes HopSize samples.
+//
+// All memory is allocated at create time; pushing samples and frames
+// allocates nothing.
+//
+// Needs fft_planner.h and dsp_window.h.
+
+typedef struct stft_config
+{
+    u32 FFTSize;        // even, at least 4.
+    u32 WindowSize;     // at most FFTSize; 0 means FFTSize.
+    u32 HopSize;        // at most WindowSize.
+    dsp_window Window;
+    u32 FrameCapacity;  // frames kept in the ring.
+} stft_config;
+
+typedef struct stft
+{
+    stft_config Config;
+    u32 BinCount;
+    planned_fft *Forward;
+    f32 *Window;         // WindowSize entries.
+    f32 *History;        // the last WindowSize samples, oldest first.
+    u32 HistoryCount;
+    f32 *Frame;          // FFTSize entries; the tail past WindowSize stays 0.
+    complex32 *Spectra;  // FrameCapacity * BinCount, a ring of frames.
+    u64 FrameCount;      // frames produced so far.
+    u64 SampleCount;     // samples pushed so far.
+} stft;
+
+typedef struct istft
+{
+    stft_config Config;
+    u32 BinCount;
+    planned_fft *Inverse;
+    f32 *Window;
+    complex32 *Bins;     // BinCount entries; the inverse uses them as scratch.
+    f32 *Frame;          // FFTSize entries.
+    f32 *Sum;            // WindowSize entries of overlap-added frames,
+    f32 *WindowSum;      // and of the squared windows they were weighted by.
+    u64 FrameCount;
+} istft;
+
+// Fills in defaults and checks the sizes. Returns false if they can't work.
+internal bool
+STFTConfigResolve(stft_config *Config)
+{
+    if (Config->WindowSize == 0) Config->WindowSize = Config->FFTSize;
+    if (Config->FrameCapacity == 0) Config->FrameCapacity = 1;
+    return (FFTPlanSizeValid(Config->FFTSize, FFTType_Real) &&
+            Config->WindowSize <= Config->FFTSize &&
+            Config->HopSize > 0 && Config->HopSize <= Config->WindowSize &&
+            Config->Window < DSPWindow_Count);
+}
+
+// Returns an stft with BinCount == 0 if the config can't work.
+internal stft
+STFTCreate(fft_planner *Planner, stft_config Config)
+{
+    stft STFT = {0};
+    if (!STFTConfigResolve(&Config)) return STFT;
+
+    STFT.Config = Config;
+    STFT.BinCount = Config.FFTSize/2 + 1;
+    STFT.Forward = FFTPlan(Planner, Config.FFTSize, FFTType_Real, FFTDirection_Forward);
+    STFT.Window = (f32 *)malloc(Config.WindowSize * sizeof(f32));
+    STFT.History = (f32 *)calloc(Config.WindowSize, sizeof(f32));
+    STFT.Frame = (f32 *)calloc(Config.FFTSize, sizeof(f32));
+    STFT.Spectra = (complex32 *)calloc((usize)Config.FrameCapacity * STFT.BinCount, sizeof(complex32));
+    DSPFillWindow(STFT.Window, Config.WindowSize, Config.Window);
+    return STFT;
+}
+
+internal void
+STFTDestroy(stft *STFT)
+{
+    free(STFT->Window);
+    free(STFT->History);
+    free(STFT->Frame);
+    free(STFT->Spectra);
+    STFT->Window = 0;
+    STFT->History = 0;
+    STFT->Frame = 0;
+    STFT->Spectra = 0;
+    STFT->BinCount = 0;
+}
+
+// Forgets the stream so far; the ring is kept but no frame in it is valid.
+internal void
+STFTReset(stft *STFT)
+{
+    STFT->HistoryCount = 0;
+    STFT->FrameCount = 0;
+    STFT->SampleCount = 0;
+}
+
+// Frame Index's bins, or 0 if it hasn't been produced yet or has been
+// overwritten in the ring.
+internal complex32 *
+STFTFrame(stft *STFT, u64 Index)
+{
+    if (Index >= STFT->FrameCount || Index + STFT->Config.FrameCapacity < STFT->FrameCount) return 0;
+    return STFT->Spectra + (usize)(Index % STFT->Config.FrameCapacity) * STFT->BinCount;
+}
+
+// The newest frame, or 0 before the first one.
+internal complex32 *
+STFTLatestFrame(stft *STFT)
+{
+    return (STFT->FrameCount > 0) ? STFTFrame(STFT, STFT->FrameCount - 1) : 0;
+}
+
+// First sample frame Index covers.
+internal u64
+STFTFrameStart(stft *STFT, u64 Index)
+{
+    return Index * STFT->Config.HopSize;
+}
+
+internal void
+STFTProduceFrame(stft *STFT)
+{
+    u32 WindowSize = STFT->Config.WindowSize;
+    for (u32 N = 0; N < WindowSize; N++)
+    {
+        STFT->Frame[N] = STFT->History[N] * STFT->Window[N];
+    }
+    complex32 *Bins = STFT->Spectra + (usize)(STFT->FrameCount % STFT->Config.FrameCapacity) * STFT->BinCount;
+    FFTExecuteReal(STFT->Forward, STFT->Frame, Bins);
+    STFT->FrameCount++;
+
+    // Keep the part of the window the next frame shares.
+    u32 HopSize = STFT->Config.HopSize;
+    memmove(STFT->History, STFT->History + HopSize, (WindowSize - HopSize) * sizeof(f32));
+    STFT->HistoryCount = WindowSize - HopSize;
+}
+
+// Consumes Count samples. Returns how many frames they completed; those are
+// the newest ones in the ring.
+internal u32
+STFTPush(stft *STFT, f32 *Samples, u32 Count)
+{
+    u32 WindowSize = STFT->Config.WindowSize;
+    u32 Produced = 0;
+    while (Count > 0)
+    {
+        u32 Take = WindowSize - STFT->HistoryCount;
+        if (Take > Count) Take = Count;
+        memcpy(STFT->History + STFT->HistoryCount, Samples, Take * sizeof(f32));
+        STFT->HistoryCount += Take;
+        STFT->SampleCount += Take;
+        Samples += Take;
+        Count -= Take;
+        if (STFT->HistoryCount == WindowSize)
+        {
+            STFTProduceFrame(STFT);
+            Produced++;
+        }
+    }
+    return Produced;
+}
+
+//
+// Inverse.
+//
+
+// Config has to match the stft whose frames it will be given.
+internal istft
+ISTFTCreate(fft_planner *Planner, stft_config Config)
+{
+    istft ISTFT = {0};
+    if (!STFTConfigResolve(&Config)) return ISTFT;
+
+    ISTFT.Config = Config;
+    ISTFT.BinCount = Config.FFTSize/2 + 1;
+    ISTFT.Inverse = FFTPlan(Planner, Config.FFTSize, FFTType_Real, FFTDirection_Inverse);
+    ISTFT.Window = (f32 *)malloc(Config.WindowSize * sizeof(f32));
+    ISTFT.Bins = (complex32 *)malloc(ISTFT.BinCount * sizeof(complex32));
+    ISTFT.Frame = (f32 *)malloc(Config.FFTSize * sizeof(f32));
+    ISTFT.Sum = (f32 *)calloc(Config.WindowSize, sizeof(f32));
+    ISTFT.WindowSum = (f32 *)calloc(Config.WindowSize, sizeof(f32));
+    DSPFillWindow(ISTFT.Window, Config.WindowSize, Config.Window);
+    return ISTFT;
+}
+
+internal void
+ISTFTDestroy(istft *ISTFT)
+{
+    free(ISTFT->Window);
+    free(ISTFT->Bins);
+    free(ISTFT->Frame);
+    free(ISTFT->Sum);
+    free(ISTFT->WindowSum);
+    ISTFT->Window = 0;
+    ISTFT->Bins = 0;
+    ISTFT->Frame = 0;
+    ISTFT->Sum = 0;
+    ISTFT->WindowSum = 0;
+    ISTFT->BinCount = 0;
+}
+
+// Overlap-adds the next frame (Bins isn't modified) and writes the HopSize
+// samples it finishes to Output: samples [i*HopSize, (i+1)*HopSize) for the
+// i-th frame pushed.
+internal void
+ISTFTPushFrame(istft *ISTFT, complex32 *Bins, f32 *Output)
+{
+    u32 WindowSize = ISTFT->Config.WindowSize;
+    u32 HopSize = ISTFT->Config.HopSize;
+    memcpy(ISTFT->Bins, Bins, ISTFT->BinCount * sizeof(complex32));
+    FFTExecuteReal(ISTFT->Inverse, ISTFT->Frame, ISTFT->Bins);
+    for (u32 N = 0; N < WindowSize; N++)
+    {
+        f32 Weight = ISTFT->Window[N];
+        ISTFT->Sum[N] += ISTFT->Frame[N] * Weight;
+        ISTFT->WindowSum[N] += Weight * Weight;
+    }
+
+    // Nothing later overlaps the first hop any more. Where the windows summed
+    // to (nearly) nothing there's nothing to recover.
+    for (u32 N = 0; N < HopSize; N++)
+    {
+        Output[N] = (ISTFT->WindowSum[N] > 1e-6f) ? ISTFT->Sum[N] / ISTFT->WindowSum[N] : 0.0f;
+    }
+    u32 Keep = WindowSize - HopSize;
+    memmove(ISTFT->Sum, ISTFT->Sum + HopSize, Keep * sizeof(f32));
+    memmove(ISTFT->WindowSum, ISTFT->WindowSum + HopSize, Keep * sizeof(f32));
+    memset(ISTFT->Sum + Keep, 0, HopSize * sizeof(f32));
+    memset(ISTFT->WindowSum + Keep, 0, HopSize * sizeof(f32));
+    ISTFT->FrameCount++;
+}
+
+#endif //STFT_H
@@ -0,0 +1,227 @@
+// Streams a WAV file, or raw 32-bit float samples, through the STFT in stft.h
+// and resynthesizes it with the overlap-add inverse. It prints the strongest
+// frequency about once a second of audio and the throughput at the end. The
+// input is read in fixed blocks, so it can be endless: pipe the synth's output
+// tap into it with
+//
+//   synth_render --freewheel --seconds 10 --tap - | stft_stream --raw -
+//
+// Every resynthesized sample is compared against the input. Exits 1 if the
+// two differ by more than the tolerance.
+//
+// Usage: stft_stream [--fft N] [--window-size N] [--hop N] [--window NAME]
+//                    [--rate HZ] [--raw] FILE|-
+//   --fft          FFT size, any even size from 4 (default 1024).
+//   --window-size  samples per frame, zero-padded up to the FFT size
+//                  (default the FFT size).
+//   --hop          samples between frames (default a quarter window).
+//   --window       rectangular, hann, hamming or blackman (default hann).
+//   --rate         sample rate of raw input (default 44100).
+//   --raw          the input is mono f32 samples rather than a WAV file.
+//   -              read the input, WAV or raw, from stdin.
+
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#include "fft.h"
+#include "real_fft.h"
+#include "fft_split.h"
+#include "fft_mixed.h"
+#include "bench_timer.h"
+#include "fft_planner.h"
+#include "dsp_math.h"
+#include "dsp_window.h"
+#include "stft.h"
+#include "wav_reader.h"
+
+#if _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+#define BLOCK_SAMPLES 4096
+#define RESYNTH_TOLERANCE 1e-4 // relative to the input's peak.
+
+i32
+main(i32 argc, char **argv)
+{
+    stft_config Config = {0};
+    Config.FFTSize = 1024;
+    Config.Window = DSPWindow_Hann;
+    Config.FrameCapacity = 64;
+    u32 SampleRate = 44100;
+    bool Raw = false;
+    const char *Path = 0;
+    bool Usage = false;
+    for (i32 ArgIndex = 1; ArgIndex < argc; ArgIndex++)
+    {
+        if (strcmp(argv[ArgIndex], "--fft") == 0 && ArgIndex + 1 < argc)
+        {
+            Config.FFTSize = (u32)atoi(argv[++ArgIndex]);
+        }
+        else if (strcmp(argv[ArgIndex], "--window-size") == 0 && ArgIndex + 1 < argc)
+        {
+            Config.WindowSize = (u32)atoi(argv[++ArgIndex]);
+        }
+        else if (strcmp(argv[ArgIndex], "--hop") == 0 && ArgIndex + 1 < argc)
+        {
+            Config.HopSize = (u32)atoi(argv[++ArgIndex]);
+        }
+        else if (strcmp(argv[ArgIndex], "--window") == 0 && ArgIndex + 1 < argc)
+        {
+            const char *Name = argv[++ArgIndex];
+            Config.Window = DSPWindow_Count;
+            for (i32 Kind = 0; Kind < DSPWindow_Count; Kind++)
+            {
+                if (strcmp(Name, DSPWindowName(Kind)) == 0) Config.Window = (dsp_window)Kind;
+            }
+        }
+        else if (strcmp(argv[ArgIndex], "--rate") == 0 && ArgIndex + 1 < argc)
+        {
+            SampleRate = (u32)atoi(argv[++ArgIndex]);
+        }
+        else if (strcmp(argv[ArgIndex], "--raw") == 0)
+        {
+            Raw = true;
+        }
+        else if (argv[ArgIndex][0] != '-' || strcmp(argv[ArgIndex], "-") == 0)
+        {
+            Path = argv[ArgIndex];
+        }
+        else
+        {
+            Usage = true;
+        }
+    }
+    if (Config.HopSize == 0) Config.HopSize = ((Config.WindowSize ? Config.WindowSize : Config.FFTSize) + 3) / 4;
+    if (Usage || !Path || SampleRate == 0)
+    {
+        printf("Usage: stft_stream [--fft N] [--window-size N] [--hop N] [--window NAME] [--rate HZ] [--raw] FILE|-\n");
+        return 2;
+    }
+
+    fft_planner Planner = FFTPlannerCreate(FFTPlanner_Estimate, 0);
+    stft STFT = STFTCreate(&Planner, Config);
+    istft ISTFT = ISTFTCreate(&Planner, Config);
+    if (STFT.BinCount == 0 || ISTFT.BinCount == 0)
+    {
+        printf("The FFT size has to be even and >= 4, the window no bigger and the hop no bigger than the window.\n");
+        return 2;
+    }
+    Config = STFT.Config;
+
+    wav_reader Reader;
+    if (Raw)
+    {
+        FILE *File = stdin;
+        if (strcmp(Path, "-") == 0)
+        {
+#if _WIN32
+            _setmode(_fileno(stdin), _O_BINARY);
+#endif
+        }
+        else if (!(File = fopen(Path, "rb")))
+        {
+            printf("Can't open %s.\n", Path);
+            return 1;
+        }
+        WavOpenRaw(&Reader, File, SampleRate);
+    }
+    else if (strcmp(Path, "-") == 0)
+    {
+#if _WIN32
+        _setmode(_fileno(stdin), _O_BINARY);
+#endif
+        if (!WavOpenStream(&Reader, stdin))
+        {
+            printf("stdin: %s (use --raw for f32 samples).\n", Reader.Error);
+            return 1;
+        }
+    }
+    else if (!WavOpen(&Reader, Path))
+    {
+        printf("%s: %s.\n", Path, Reader.Error);
+        return 1;
+    }
+
+    // The resynthesis runs WindowSize - HopSize samples behind the input, so
+    // the input is kept in a ring that long (and a block more) to check it.
+    u32 RingSize = 1;
+    while (RingSize < Config.WindowSize + BLOCK_SAMPLES) RingSize *= 2;
+    f32 *Ring = (f32 *)calloc(RingSize, sizeof(f32));
+    f32 *Block = (f32 *)malloc(BLOCK_SAMPLES * sizeof(f32));
+    f32 *Resynth = (f32 *)malloc(Config.HopSize * sizeof(f32));
+
+    printf("%s x %u at %u Hz, FFT %u (%s, %s kernels here), window %u (%s), hop %u, %u bins of %.2f Hz.\n",
+           WavSampleTypeName(Reader.Type), Reader.Channels, Reader.SampleRate, Config.FFTSize,
+           FFTAlgorithmNames[STFT.Forward->Algorithm], FFTKernelName(FFTBestKernel()),
+           Config.WindowSize, DSPWindowName(Config.Window),
+           Config.HopSize, STFT.BinCount, (f64)Reader.SampleRate / Config.FFTSize);
+
+    u64 SampleCount = 0;
+    u64 ResynthCount = 0;
+    u64 NextReport = 0;
+    f64 InputPeak = 0;
+    f64 MaxError = 0;
+    f64 STFTSeconds = 0;
+    f64 Start = BenchSeconds();
+    for (;;)
+    {
+        u32 Count = WavRead(&Reader, Block, BLOCK_SAMPLES);
+        if (Count == 0) break;
+        for (u32 Index = 0; Index < Count; Index++)
+        {
+            Ring[(SampleCount + Index) & (RingSize - 1)] = Block[Index];
+            InputPeak = fmax(InputPeak, fabs(Block[Index]));
+        }
+        SampleCount += Count;
+
+        f64 BlockStart = BenchSeconds();
+        u32 Produced = STFTPush(&STFT, Block, Count);
+        for (u64 Frame = STFT.FrameCount - Produced; Frame < STFT.FrameCount; Frame++)
+        {
+            ISTFTPushFrame(&ISTFT, STFTFrame(&STFT, Frame), Resynth);
+            // The first window's samples are only covered by the tails of the
+            // windows, so they can't all be recovered.
+            for (u32 Index = 0; Index < Config.HopSize; Index++, ResynthCount++)
+            {
+                if (ResynthCount < Config.WindowSize) continue;
+                f64 Error = fabs(Resynth[Index] - Ring[ResynthCount & (RingSize - 1)]);
+                MaxError = fmax(MaxError, Error);
+            }
+        }
+        STFTSeconds += BenchSeconds() - BlockStart;
+
+        complex32 *Latest = STFTLatestFrame(&STFT);
+        if (Latest && SampleCount >= NextReport)
+        {
+            u32 PeakBin = 1;
+            for (u32 Bin = 1; Bin < STFT.BinCount; Bin++)
+            {
+                if (ComplexMagnitude(Latest[Bin]) > ComplexMagnitude(Latest[PeakBin])) PeakBin = Bin;
+            }
+            printf("%8.2fs  peak %8.1f Hz  %6.1f dB\n", (f64)SampleCount / Reader.SampleRate,
+                   (f64)PeakBin * Reader.SampleRate / Config.FFTSize,
+                   20.0 * log10(ComplexMagnitude(Latest[PeakBin]) + 1e-12));
+            NextReport += Reader.SampleRate;
+        }
+    }
+    f64 WallSeconds = BenchSeconds() - Start;
+
+    f64 AudioSeconds = (f64)SampleCount / Reader.SampleRate;
+    f64 RelativeError = (InputPeak > 0) ? MaxError / InputPeak : MaxError;
+    bool Passed = (RelativeError <= RESYNTH_TOLERANCE);
+    printf("%llu samples (%.2fs), %llu frames; STFT + inverse took %.1f ms, %.0fx real time (%.2fs wall with input).\n",
+           (unsigned long long)SampleCount, AudioSeconds, (unsigned long long)STFT.FrameCount,
+           STFTSeconds * 1e3, (STFTSeconds > 0) ? AudioSeconds / STFTSeconds : 0.0, WallSeconds);
+    printf("Resynthesis error %.1e of the input's peak: %s\n", RelativeError, Passed ? "ok" : "FAILED");
+
+    WavClose(&Reader);
+    free(Resynth);
+    free(Block);
+    free(Ring);
+    ISTFTDestroy(&ISTFT);
+    STFTDestroy(&STFT);
+    FFTPlannerDestroy(&Planner);
+    return Passed ? 0 : 1;
+}
@@ -0,0 +1,599 @@
+/* date = October 18th 2026 */
+
+#ifndef VOCODER_H
+#define VOCODER_H
+
+// Streaming phase vocoder: time-stretch and pitch-shift, independently and
+// changeable while it runs.
+//
+// Input is cut into Hann-windowed frames Ha samples apart and resynthesized
+// through an istft (stft.h) HopSize = WindowSize/4 samples apart, so the
+// output is Hs/Ha times as long. Each bin keeps its magnitude; its phase
+// advances by the bin's measured frequency times Hs, so partials stay
+// continuous across the new hop. To shift pitch by P the vocoder stretches
+// by Stretch*P and the result is resampled by P (cubic Hermite), with the
+// bins above Nyquist/P dropped first so the resampling doesn't alias.
+//
+// Phase locking (Laroche and Dolson's identity locking): only spectral
+// peaks get their phases advanced; every other bin keeps its analysed phase
+// offset from the peak whose region it's in, so the few bins a sinusoid
+// spreads over stay coherent and the result is much less phasey than with
+// every bin advanced on its own (VocoderPhase_Plain).
+//
+// Transients: a frame where most of the magnitude is in bins that rose more
+// than 3 dB since the last frame (TransientFraction) has an onset entering
+// its last hop. Its phases are reset to the analysed ones, and the frames
+// after it step Hs through the input until the onset has left the window,
+// so they pass the attack through as it was: stretched, each overlapping
+// frame would place it somewhere else. The time this takes from the stretch
+// is made up over the frames after. The onset stays rising while the window
+// slides over it, so another isn't taken until a frame stops rising.
+//
+// Streaming: VocoderPush takes input as it comes (as much as fits) and
+// VocoderPull gives back output as far as the input allows. At Stretch and
+// Pitch 1 the output lags the input by Latency = WindowSize - HopSize
+// samples; otherwise frame middles map to frame middles, so away from onsets
+// output sample n comes from around input (n - W/2)/Stretch + W/2 - Latency
+// for a window of W. Nothing is allocated after create.
+//
+// The per-bin loops (magnitude and phase, phase advance, locking and
+// resynthesis) run on 8 bins at a time with AVX2, with a polynomial atan2
+// good to about 1e-6 radians and dsp_simd_math's accurate sin and cos.
+//
+// Needs fft_planner.h, stft.h and dsp_simd_math.h.
+
+#define VOCODER_WINDOW 2048
+#define VOCODER_OVERLAP 4
+#define VOCODER_MIN_RATIO 0.25f
+#define VOCODER_MAX_RATIO 4.0f
+#define VOCODER_TRANSIENT_FRACTION 0.5f
+#define VOCODER_TRANSIENT_RISE 1.41253754f // 3 dB.
+
+typedef enum vocoder_phase
+{
+    VocoderPhase_Locked,
+    VocoderPhase_Plain,
+    VocoderPhase_Count,
+} vocoder_phase;
+
+global const char *VocoderPhaseNames[VocoderPhase_Count] = {"locked", "plain"};
+
+typedef struct vocoder_config
+{
+    u32 WindowSize;          // a power of two, at least 64; 0 means VOCODER_WINDOW.
+    f32 Stretch;             // output length over input length; 0 means 1.
+    f32 Pitch;               // frequency ratio; 0 means 1.
+    vocoder_phase Phase;
+    f32 TransientFraction;   // 0 means VOCODER_TRANSIENT_FRACTION; above 1 turns detection off.
+} vocoder_config;
+
+typedef struct vocoder
+{
+    vocoder_config Config;
+    u32 WindowSize;
+    u32 HopSize;             // synthesis hop.
+    u32 BinCount;
+    u32 PaddedBinCount;      // BinCount rounded up to 8; the padding stays 0.
+    u32 Latency;
+    bool Vector;
+    planned_fft *Forward;
+    istft Synthesis;
+    f32 *Window;
+    f32 *Frame;              // WindowSize entries.
+    complex32 *Spectrum;     // PaddedBinCount entries.
+
+    // Input, from absolute sample InputStart on. Samples before the next
+    // frame are dropped as soon as it's known where that is.
+    f32 *Input;
+    u32 InputCapacity;
+    u32 InputCount;
+    u64 InputStart;
+    u64 InputEnd;            // samples pushed so far, the latency padding included.
+    f64 FramePosition;       // where the next frame starts, unrounded.
+    u64 FrameStart;          // and rounded.
+    u64 LastFrameStart;
+    u64 FrameCount;
+    u64 TransientCount;
+    bool OnsetArmed;         // the last frame wasn't rising.
+    u64 OnsetAt;             // input position of the last onset.
+    f64 Ahead;               // input samples taken past the stretch by onsets.
+
+    // Per bin, PaddedBinCount entries each.
+    f32 *Magnitude;
+    f32 *Phase;
+    f32 *LastMagnitude;
+    f32 *LastPhase;
+    f32 *SynthPhase;
+    f32 *Advanced;
+    i32 *PeakOf;
+
+    // Resynthesized samples waiting to be resampled. ReadPosition is in them,
+    // and one sample before it is kept for the interpolation.
+    f32 *Resynth;
+    u32 ResynthCapacity;
+    u32 ResynthCount;
+    f64 ReadPosition;
+} vocoder;
+
+internal f32
+VocoderClampRatio(f32 Ratio)
+{
+    if (Ratio <= 0) return 1.0f;
+    return (Ratio < VOCODER_MIN_RATIO) ? VOCODER_MIN_RATIO : (Ratio > VOCODER_MAX_RATIO) ? VOCODER_MAX_RATIO : Ratio;
+}
+
+internal f32
+VocoderWrap(f32 Phase)
+{
+    return Phase - (f32)FFT_TAU * nearbyintf(Phase * (f32)(1.0 / FFT_TAU));
+}
+
+// Forgets the stream so far, keeping the ratios.
+internal void
+VocoderReset(vocoder *Vocoder)
+{
+    // The latency padding: the first real sample lands where the windows
+    // already overlap fully.
+    Vocoder->InputCount = Vocoder->Latency;
+    memset(Vocoder->Input, 0, Vocoder->InputCount * sizeof(f32));
+    Vocoder->InputStart = 0;
+    Vocoder->InputEnd = Vocoder->Latency;
+    Vocoder->FramePosition = 0;
+    Vocoder->FrameStart = 0;
+    Vocoder->LastFrameStart = 0;
+    Vocoder->FrameCount = 0;
+    Vocoder->TransientCount = 0;
+    Vocoder->OnsetArmed = true;
+    Vocoder->OnsetAt = 0;
+    Vocoder->Ahead = 0;
+    memset(Vocoder->SynthPhase, 0, Vocoder->PaddedBinCount * sizeof(f32));
+    Vocoder->Resynth[0] = 0;
+    Vocoder->ResynthCount = 1;
+    Vocoder->ReadPosition = 1;
+
+    istft *Synthesis = &Vocoder->Synthesis;
+    memset(Synthesis->Sum, 0, Synthesis->Config.WindowSize * sizeof(f32));
+    memset(Synthesis->WindowSum, 0, Synthesis->Config.WindowSize * sizeof(f32));
+    Synthesis->FrameCount = 0;
+}
+
+// Returns a vocoder with BinCount == 0 if the window size can't work.
+internal vocoder
+VocoderCreate(fft_planner *Planner, vocoder_config Config)
+{
+    vocoder Vocoder = {0};
+    if (Config.WindowSize == 0) Config.WindowSize = VOCODER_WINDOW;
+    if (Config.WindowSize < 64 || !FFTIsPowerOfTwo(Config.WindowSize) || Config.Phase >= VocoderPhase_Count)
+    {
+        return Vocoder;
+    }
+    Config.Stretch = VocoderClampRatio(Config.Stretch);
+    Config.Pitch = VocoderClampRatio(Config.Pitch);
+    if (Config.TransientFraction <= 0) Config.TransientFraction = VOCODER_TRANSIENT_FRACTION;
+
+    u32 WindowSize = Config.WindowSize;
+    Vocoder.Config = Config;
+    Vocoder.WindowSize = WindowSize;
+    Vocoder.HopSize = WindowSize / VOCODER_OVERLAP;
+    Vocoder.BinCount = WindowSize/2 + 1;
+    Vocoder.PaddedBinCount = (Vocoder.BinCount + 7) & ~7u;
+    Vocoder.Latency = WindowSize - Vocoder.HopSize;
+#if FFT_SIMD
+    Vocoder.Vector = FFTKernelSupported(FFTKernel_AVX2);
+#endif
+
+    stft_config Synthesis = {WindowSize, WindowSize, Vocoder.HopSize, DSPWindow_Hann, 1};
+    Vocoder.Synthesis = ISTFTCreate(Planner, Synthesis);
+    Vocoder.Forward = FFTPlan(Planner, WindowSize, FFTType_Real, FFTDirection_Forward);
+    Vocoder.Window = (f32 *)malloc(WindowSize * sizeof(f32));
+    DSPFillWindow(Vocoder.Window, WindowSize, DSPWindow_Hann);
+    Vocoder.Frame = (f32 *)malloc(WindowSize * sizeof(f32));
+    Vocoder.Spectrum = (complex32 *)calloc(Vocoder.PaddedBinCount, sizeof(complex32));
+
+    // A frame can start up to WindowSize * VOCODER_MAX_RATIO^2 / VOCODER_OVERLAP
+    // past the last one; anything in between is skipped rather than kept.
+    Vocoder.InputCapacity = 2 * WindowSize;
+    Vocoder.Input = (f32 *)malloc(Vocoder.InputCapacity * sizeof(f32));
+
+    u32 Padded = Vocoder.PaddedBinCount;
+    Vocoder.Magnitude = (f32 *)calloc(Padded, sizeof(f32));
+    Vocoder.Phase = (f32 *)calloc(Padded, sizeof(f32));
+    Vocoder.LastMagnitude = (f32 *)calloc(Padded, sizeof(f32));
+    Vocoder.LastPhase = (f32 *)calloc(Padded, sizeof(f32));
+    Vocoder.SynthPhase = (f32 *)calloc(Padded, sizeof(f32));
+    Vocoder.Advanced = (f32 *)calloc(Padded, sizeof(f32));
+    Vocoder.PeakOf = (i32 *)calloc(Padded, sizeof(i32));
+
+    // Room for a hop on top of what one pulled sample can need at most.
+    Vocoder.ResynthCapacity = Vocoder.HopSize + (u32)VOCODER_MAX_RATIO + 4;
+    Vocoder.Resynth = (f32 *)malloc(Vocoder.ResynthCapacity * sizeof(f32));
+    VocoderReset(&Vocoder);
+    return Vocoder;
+}
+
+internal void
+VocoderDestroy(vocoder *Vocoder)
+{
+    ISTFTDestroy(&Vocoder->Synthesis);
+    free(Vocoder->Window);
+    free(Vocoder->Frame);
+    free(Vocoder->Spectrum);
+    free(Vocoder->Input);
+    free(Vocoder->Magnitude);
+    free(Vocoder->Phase);
+    free(Vocoder->LastMagnitude);
+    free(Vocoder->LastPhase);
+    free(Vocoder->SynthPhase);
+    free(Vocoder->Advanced);
+    free(Vocoder->PeakOf);
+    free(Vocoder->Resynth);
+    memset(Vocoder, 0, sizeof(*Vocoder));
+}
+
+// Takes effect from the next frame (stretch) and the next sample (pitch).
+internal void
+VocoderSetRatios(vocoder *Vocoder, f32 Stretch, f32 Pitch)
+{
+    Vocoder->Config.Stretch = VocoderClampRatio(Stretch);
+    Vocoder->Config.Pitch = VocoderClampRatio(Pitch);
+}
+
+//
+// Per-bin loops. Bins are in split arrays; the scalar versions are the
+// reference for the AVX2 ones.
+//
+
+// Magnitude and phase of every bin.
+internal void
+VocoderAnalyseScalar(vocoder *Vocoder)
+{
+    for (u32 Bin = 0; Bin < Vocoder->PaddedBinCount; Bin++)
+    {
+        complex32 Value = Vocoder->Spectrum[Bin];
+        Vocoder->Magnitude[Bin] = sqrtf(Value.Re*Value.Re + Value.Im*Value.Im);
+        Vocoder->Phase[Bin] = atan2f(Value.Im, Value.Re);
+    }
+}
+
+// Each bin's phase advanced by its measured frequency over the synthesis
+// hop. The bin's own advance, Bin * Hop * TAU / WindowSize, is taken modulo
+// TAU in integers so it stays exact for any hop.
+internal void
+VocoderAdvanceScalar(vocoder *Vocoder, u32 AnalysisHop)
+{
+    u32 Mask = Vocoder->WindowSize - 1;
+    f32 BinPhase = (f32)(FFT_TAU / Vocoder->WindowSize);
+    f32 HopRatio = (f32)Vocoder->HopSize / (f32)AnalysisHop;
+    for (u32 Bin = 0; Bin < Vocoder->PaddedBinCount; Bin++)
+    {
+        f32 Expected = BinPhase * (f32)((Bin * AnalysisHop) & Mask);
+        f32 Deviation = VocoderWrap(Vocoder->Phase[Bin] - Vocoder->LastPhase[Bin] - Expected);
+        f32 Advance = BinPhase * (f32)((Bin * Vocoder->HopSize) & Mask) + Deviation * HopRatio;
+        Vocoder->Advanced[Bin] = VocoderWrap(Vocoder->SynthPhase[Bin] + Advance);
+    }
+}
+
+// Synthesis phases (locked to their peaks' advanced phases, or the advanced
+// ones as they are) and the spectrum rebuilt from them.
+internal void
+VocoderResynthesiseScalar(vocoder *Vocoder, bool Locked)
+{
+    for (u32 Bin = 0; Bin < Vocoder->PaddedBinCount; Bin++)
+    {
+        f32 Phase = Vocoder->Advanced[Bin];
+        if (Locked)
+        {
+            i32 Peak = Vocoder->PeakOf[Bin];
+            Phase = VocoderWrap(Vocoder->Advanced[Peak] + Vocoder->Phase[Bin] - Vocoder->Phase[Peak]);
+        }
+        Vocoder->SynthPhase[Bin] = Phase;
+        Vocoder->Spectrum[Bin].Re = Vocoder->Magnitude[Bin] * DSPCos(Phase, DSPMathTier_Accurate);
+        Vocoder->Spectrum[Bin].Im = Vocoder->Magnitude[Bin] * DSPSin(Phase, DSPMathTier_Accurate);
+    }
+}
+
+#if FFT_SIMD
+FFT_TARGET_AVX2 internal __m256
+VocoderWrapAVX2(__m256 Phase)
+{
+    __m256 Turns = _mm256_round_ps(_mm256_mul_ps(Phase, _mm256_set1_ps((f32)(1.0 / FFT_TAU))),
+                                   _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    return _mm256_fnmadd_ps(Turns, _mm256_set1_ps((f32)FFT_TAU), Phase);
+}
+
+// atan2 for the phases. The ratio of the smaller to the larger coordinate is
+// folded below tan(pi/8) with atan(a) = pi/4 + atan((a - 1)/(a + 1)), where
+// eight terms of the series are enough.
+FFT_TARGET_AVX2 internal __m256
+VocoderAtan2AVX2(__m256 Y, __m256 X)
+{
+    __m256 SignMask = _mm256_set1_ps(-0.0f);
+    __m256 AbsX = _mm256_andnot_ps(SignMask, X);
+    __m256 AbsY = _mm256_andnot_ps(SignMask, Y);
+    __m256 Low = _mm256_min_ps(AbsX, AbsY);
+    __m256 High = _mm256_max_ps(AbsX, AbsY);
+    __m256 Zero = _mm256_setzero_ps();
+    __m256 Ratio = _mm256_div_ps(Low, _mm256_blendv_ps(High, _mm256_set1_ps(1.0f), _mm256_cmp_ps(High, Zero, _CMP_EQ_OQ)));
+
+    __m256 Fold = _mm256_cmp_ps(Ratio, _mm256_set1_ps(0.414213562f), _CMP_GT_OQ);
+    __m256 One = _mm256_set1_ps(1.0f);
+    __m256 Folded = _mm256_div_ps(_mm256_sub_ps(Ratio, One), _mm256_add_ps(Ratio, One));
+    __m256 T = _mm256_blendv_ps(Ratio, Folded, Fold);
+    __m256 T2 = _mm256_mul_ps(T, T);
+    __m256 Series = _mm256_set1_ps(-1.0f/15);
+    Series = _mm256_fmadd_ps(Series, T2, _mm256_set1_ps(1.0f/13));
+    Series = _mm256_fmadd_ps(Series, T2, _mm256_set1_ps(-1.0f/11));
+    Series = _mm256_fmadd_ps(Series, T2, _mm256_set1_ps(1.0f/9));
+    Series = _mm256_fmadd_ps(Series, T2, _mm256_set1_ps(-1.0f/7));
+    Series = _mm256_fmadd_ps(Series, T2, _mm256_set1_ps(1.0f/5));
+    Series = _mm256_fmadd_ps(Series, T2, _mm256_set1_ps(-1.0f/3));
+    Series = _mm256_fmadd_ps(Series, T2, One);
+    __m256 Angle = _mm256_fmadd_ps(Series, T, _mm256_and_ps(Fold, _mm256_set1_ps((f32)(FFT_TAU / 8))));
+
+    Angle = _mm256_blendv_ps(Angle, _mm256_sub_ps(_mm256_set1_ps((f32)(FFT_TAU / 4)), Angle), _mm256_cmp_ps(AbsY, AbsX, _CMP_GT_OQ));
+    Angle = _mm256_blendv_ps(Angle, _mm256_sub_ps(_mm256_set1_ps((f32)(FFT_TAU / 2)), Angle), _mm256_cmp_ps(X, Zero, _CMP_LT_OQ));
+    return _mm256_or_ps(Angle, _mm256_and_ps(Y, SignMask));
+}
+
+FFT_TARGET_AVX2 internal void
+VocoderAnalyseAVX2(vocoder *Vocoder)
+{
+    f32 *Interleaved = (f32 *)Vocoder->Spectrum;
+    for (u32 Bin = 0; Bin < Vocoder->PaddedBinCount; Bin += 8)
+    {
+        __m256 A = _mm256_loadu_ps(Interleaved + 2*Bin);
+        __m256 B = _mm256_loadu_ps(Interleaved + 2*Bin + 8);
+        __m256 Re = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(A, B, _MM_SHUFFLE(2, 0, 2, 0))), _MM_SHUFFLE(3, 1, 2, 0)));
+        __m256 Im = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(A, B, _MM_SHUFFLE(3, 1, 3, 1))), _MM_SHUFFLE(3, 1, 2, 0)));
+        _mm256_storeu_ps(Vocoder->Magnitude + Bin, _mm256_sqrt_ps(_mm256_fmadd_ps(Re, Re, _mm256_mul_ps(Im, Im))));
+        _mm256_storeu_ps(Vocoder->Phase + Bin, VocoderAtan2AVX2(Im, Re));
+    }
+}
+
+FFT_TARGET_AVX2 internal void
+VocoderAdvanceAVX2(vocoder *Vocoder, u32 AnalysisHop)
+{
+    __m256i Mask = _mm256_set1_epi32((i32)(Vocoder->WindowSize - 1));
+    __m256 BinPhase = _mm256_set1_ps((f32)(FFT_TAU / Vocoder->WindowSize));
+    __m256 HopRatio = _mm256_set1_ps((f32)Vocoder->HopSize / (f32)AnalysisHop);
+    __m256i Bins = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i AnalysisStep = _mm256_set1_epi32((i32)AnalysisHop);
+    __m256i SynthesisStep = _mm256_set1_epi32((i32)Vocoder->HopSize);
+    for (u32 Bin = 0; Bin < Vocoder->PaddedBinCount; Bin += 8)
+    {
+        __m256 Expected = _mm256_mul_ps(BinPhase, _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_mullo_epi32(Bins, AnalysisStep), Mask)));
+        __m256 Own = _mm256_mul_ps(BinPhase, _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_mullo_epi32(Bins, SynthesisStep), Mask)));
+        __m256 Deviation = _mm256_sub_ps(_mm256_sub_ps(_mm256_loadu_ps(Vocoder->Phase + Bin), _mm256_loadu_ps(Vocoder->LastPhase + Bin)), Expected);
+        __m256 Advance = _mm256_fmadd_ps(VocoderWrapAVX2(Deviation), HopRatio, Own);
+        _mm256_storeu_ps(Vocoder->Advanced + Bin, VocoderWrapAVX2(_mm256_add_ps(_mm256_loadu_ps(Vocoder->SynthPhase + Bin), Advance)));
+        Bins = _mm256_add_epi32(Bins, _mm256_set1_epi32(8));
+    }
+}
+
+FFT_TARGET_AVX2 internal void
+VocoderResynthesiseAVX2(vocoder *Vocoder, bool Locked)
+{
+    f32 *Interleaved = (f32 *)Vocoder->Spectrum;
+    for (u32 Bin = 0; Bin < Vocoder->PaddedBinCount; Bin += 8)
+    {
+        __m256 Phase = _mm256_loadu_ps(Vocoder->Advanced + Bin);
+        if (Locked)
+        {
+            __m256i Peak = _mm256_loadu_si256((__m256i *)(Vocoder->PeakOf + Bin));
+            __m256 Offset = _mm256_sub_ps(_mm256_loadu_ps(Vocoder->Phase + Bin), _mm256_i32gather_ps(Vocoder->Phase, Peak, 4));
+            Phase = VocoderWrapAVX2(_mm256_add_ps(_mm256_i32gather_ps(Vocoder->Advanced, Peak, 4), Offset));
+        }
+        _mm256_storeu_ps(Vocoder->SynthPhase + Bin, Phase);
+        __m256 Sin, Cos;
+        DSPSinCosAVX2(Phase, DSPMathTier_Accurate, &Sin, &Cos);
+        __m256 Magnitude = _mm256_loadu_ps(Vocoder->Magnitude + Bin);
+        __m256 Re = _mm256_mul_ps(Magnitude, Cos);
+        __m256 Im = _mm256_mul_ps(Magnitude, Sin);
+        __m256 Low = _mm256_unpacklo_ps(Re, Im);
+        __m256 High = _mm256_unpackhi_ps(Re, Im);
+        _mm256_storeu_ps(Interleaved + 2*Bin, _mm256_permute2f128_ps(Low, High, 0x20));
+        _mm256_storeu_ps(Interleaved + 2*Bin + 8, _mm256_permute2f128_ps(Low, High, 0x31));
+    }
+}
+#endif // FFT_SIMD
+
+// Peaks are bins louder than the two on each side. Each bin belongs to the
+// nearest one; with no peaks every bin is its own.
+internal void
+VocoderFindPeaks(vocoder *Vocoder)
+{
+    f32 *Magnitude = Vocoder->Magnitude;
+    u32 BinCount = Vocoder->BinCount;
+    i32 LastPeak = -1;
+    for (u32 Bin = 0; Bin < BinCount; Bin++)
+    {
+        bool Peak = (Magnitude[Bin] > 0 &&
+                     (Bin < 1 || Magnitude[Bin] > Magnitude[Bin - 1]) &&
+                     (Bin < 2 || Magnitude[Bin] > Magnitude[Bin - 2]) &&
+                     (Bin + 1 >= BinCount || Magnitude[Bin] >= Magnitude[Bin + 1]) &&
+                     (Bin + 2 >= BinCount || Magnitude[Bin] >= Magnitude[Bin + 2]));
+        if (!Peak) continue;
+
+        // Bins since the last peak split between it and this one.
+        u32 Middle = (LastPeak < 0) ? 0 : ((u32)LastPeak + Bin + 1) / 2;
+        for (u32 Between = (LastPeak < 0) ? 0 : (u32)LastPeak + 1; Between < Bin; Between++)
+        {
+            Vocoder->PeakOf[Between] = (Between < Middle) ? LastPeak : (i32)Bin;
+        }
+        Vocoder->PeakOf[Bin] = (i32)Bin;
+        LastPeak = (i32)Bin;
+    }
+    for (u32 Bin = (LastPeak < 0) ? 0 : (u32)LastPeak + 1; Bin < Vocoder->PaddedBinCount; Bin++)
+    {
+        Vocoder->PeakOf[Bin] = (LastPeak < 0 || Bin >= BinCount) ? (i32)Bin : LastPeak;
+    }
+}
+
+// Fraction of the magnitude in bins that rose by VOCODER_TRANSIENT_RISE.
+internal f32
+VocoderRisingFraction(vocoder *Vocoder)
+{
+    f32 Total = 0;
+    f32 Rising = 0;
+    for (u32 Bin = 0; Bin < Vocoder->BinCount; Bin++)
+    {
+        f32 Magnitude = Vocoder->Magnitude[Bin];
+        Total += Magnitude;
+        Rising += (Magnitude > VOCODER_TRANSIENT_RISE * Vocoder->LastMagnitude[Bin]) ? Magnitude : 0;
+    }
+    return (Total > 1e-9f) ? Rising / Total : 0;
+}
+
+// One frame from FrameStart: analysed, its phases advanced, HopSize samples
+// resynthesized onto the end of Resynth.
+internal void
+VocoderRunFrame(vocoder *Vocoder)
+{
+    u32 WindowSize = Vocoder->WindowSize;
+    f32 *Samples = Vocoder->Input + (Vocoder->FrameStart - Vocoder->InputStart);
+    for (u32 N = 0; N < WindowSize; N++) Vocoder->Frame[N] = Samples[N] * Vocoder->Window[N];
+    FFTExecuteReal(Vocoder->Forward, Vocoder->Frame, Vocoder->Spectrum);
+#if FFT_SIMD
+    if (Vocoder->Vector) VocoderAnalyseAVX2(Vocoder);
+    else VocoderAnalyseScalar(Vocoder);
+#else
+    VocoderAnalyseScalar(Vocoder);
+#endif
+
+    // An onset is somewhere in the hop this frame added at its end; take the
+    // middle of it.
+    bool Transient = (Vocoder->FrameCount == 0);
+    if (!Transient && Vocoder->Config.TransientFraction <= 1)
+    {
+        bool Rising = (VocoderRisingFraction(Vocoder) >= Vocoder->Config.TransientFraction);
+        if (Rising && Vocoder->OnsetArmed)
+        {
+            Transient = true;
+            Vocoder->TransientCount++;
+            Vocoder->OnsetAt = Vocoder->FrameStart + WindowSize - (Vocoder->FrameStart - Vocoder->LastFrameStart) / 2;
+        }
+        Vocoder->OnsetArmed = !Rising;
+    }
+
+    bool Locked = (Vocoder->Config.Phase == VocoderPhase_Locked);
+    if (Transient)
+    {
+        memcpy(Vocoder->Advanced, Vocoder->Phase, Vocoder->PaddedBinCount * sizeof(f32));
+        Locked = false;
+    }
+    else
+    {
+        u32 AnalysisHop = (u32)(Vocoder->FrameStart - Vocoder->LastFrameStart);
+#if FFT_SIMD
+        if (Vocoder->Vector) VocoderAdvanceAVX2(Vocoder, AnalysisHop);
+        else VocoderAdvanceScalar(Vocoder, AnalysisHop);
+#else
+        VocoderAdvanceScalar(Vocoder, AnalysisHop);
+#endif
+        if (Locked) VocoderFindPeaks(Vocoder);
+    }
+
+    // The current frame becomes the last one before the cut above Nyquist/P.
+    memcpy(Vocoder->LastMagnitude, Vocoder->Magnitude, Vocoder->PaddedBinCount * sizeof(f32));
+    memcpy(Vocoder->LastPhase, Vocoder->Phase, Vocoder->PaddedBinCount * sizeof(f32));
+    if (Vocoder->Config.Pitch > 1)
+    {
+        u32 Cut = (u32)((f32)(Vocoder->BinCount - 1) / Vocoder->Config.Pitch) + 1;
+        memset(Vocoder->Magnitude + Cut, 0, (Vocoder->PaddedBinCount - Cut) * sizeof(f32));
+    }
+#if FFT_SIMD
+    if (Vocoder->Vector) VocoderResynthesiseAVX2(Vocoder, Locked);
+    else VocoderResynthesiseScalar(Vocoder, Locked);
+#else
+    VocoderResynthesiseScalar(Vocoder, Locked);
+#endif
+
+    ISTFTPushFrame(&Vocoder->Synthesis, Vocoder->Spectrum, Vocoder->Resynth + Vocoder->ResynthCount);
+    Vocoder->ResynthCount += Vocoder->HopSize;
+    Vocoder->FrameCount++;
+
+    // The next frame, Ha = Hs / (Stretch * Pitch) on, and what it no longer
+    // needs. Past an onset, up to half of each hop goes to making up for it.
+    f64 Hop = Vocoder->HopSize / ((f64)Vocoder->Config.Stretch * Vocoder->Config.Pitch);
+    if (Vocoder->FrameStart < Vocoder->OnsetAt)
+    {
+        Vocoder->Ahead += Vocoder->HopSize - Hop;
+        Hop = Vocoder->HopSize;
+    }
+    else if (Vocoder->Ahead != 0)
+    {
+        f64 Catch = (Vocoder->Ahead > Hop/2) ? Hop/2 : (Vocoder->Ahead < -Hop/2) ? -Hop/2 : Vocoder->Ahead;
+        Vocoder->Ahead -= Catch;
+        Hop -= Catch;
+    }
+    Vocoder->LastFrameStart = Vocoder->FrameStart;
+    Vocoder->FramePosition += Hop;
+    Vocoder->FrameStart = (u64)Vocoder->FramePosition;
+    if (Vocoder->FrameStart == Vocoder->LastFrameStart) Vocoder->FrameStart++;
+    u64 Drop = Vocoder->FrameStart - Vocoder->InputStart;
+    if (Drop >= Vocoder->InputCount)
+    {
+        Vocoder->InputCount = 0;
+    }
+    else
+    {
+        Vocoder->InputCount -= (u32)Drop;
+        memmove(Vocoder->Input, Vocoder->Input + Drop, Vocoder->InputCount * sizeof(f32));
+    }
+    Vocoder->InputStart = Vocoder->FrameStart;
+}
+
+// Takes up to Count samples; returns how many fit. Pull to make room.
+internal u32
+VocoderPush(vocoder *Vocoder, f32 *Samples, u32 Count)
+{
+    u32 Taken = 0;
+    // Samples between two far-apart frames aren't needed.
+    if (Vocoder->InputEnd < Vocoder->InputStart)
+    {
+        u64 Skip = Vocoder->InputStart - Vocoder->InputEnd;
+        Taken = (Skip < Count) ? (u32)Skip : Count;
+        Vocoder->InputEnd += Taken;
+    }
+    u32 Room = Vocoder->InputCapacity - Vocoder->InputCount;
+    u32 Copy = (Count - Taken < Room) ? Count - Taken : Room;
+    memcpy(Vocoder->Input + Vocoder->InputCount, Samples + Taken, Copy * sizeof(f32));
+    Vocoder->InputCount += Copy;
+    Vocoder->InputEnd += Copy;
+    return Taken + Copy;
+}
+
+// Writes up to Count output samples; returns how many the input so far
+// allowed.
+internal u32
+VocoderPull(vocoder *Vocoder, f32 *Output, u32 Count)
+{
+    u32 Written = 0;
+    while (Written < Count)
+    {
+        u32 Index = (u32)Vocoder->ReadPosition;
+        if (Index + 2 < Vocoder->ResynthCount)
+        {
+            // Cubic Hermite through the samples around ReadPosition.
+            f32 *At = Vocoder->Resynth + Index;
+            f32 T = (f32)(Vocoder->ReadPosition - Index);
+            f32 C1 = 0.5f * (At[1] - At[-1]);
+            f32 C2 = At[-1] - 2.5f*At[0] + 2.0f*At[1] - 0.5f*At[2];
+            f32 C3 = 0.5f * (At[2] - At[-1]) + 1.5f * (At[0] - At[1]);
+            Output[Written++] = ((C3*T + C2)*T + C1)*T + At[0];
+            Vocoder->ReadPosition += Vocoder->Config.Pitch;
+            continue;
+        }
+
+        // Out of resynthesized samples: drop the used ones and make a hop more.
+        if (Vocoder->InputCount < Vocoder->WindowSize) break;
+        u32 Used = (Index - 1 < Vocoder->ResynthCount) ? Index - 1 : Vocoder->ResynthCount;
+        Vocoder->ResynthCount -= Used;
+        memmove(Vocoder->Resynth, Vocoder->Resynth + Used, Vocoder->ResynthCount * sizeof(f32));
+        Vocoder->ReadPosition -= Used;
+        VocoderRunFrame(Vocoder);
+    }
+    return Written;
+}
+
+#endif //VOCODER_H
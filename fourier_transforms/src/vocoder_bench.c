@@ -0,0 +1,371 @@
+// Checks the phase vocoder in vocoder.h and times it.
+//
+// Checks: at Stretch and Pitch 1 the output is the input, Latency samples
+// late; the output doesn't depend on the block sizes it's pushed and pulled
+// in; a sine stretched keeps its frequency and level, and shifted moves by
+// exactly the ratio; clicks stretched are each caught as one transient, and
+// spread no wider in time than without the phase reset.
+//
+// Then real-time factors (seconds of input processed per second of CPU) at
+// 44.1 and 48kHz over a few stretch and pitch settings, scalar against AVX2.
+// With --wav, a recording is processed too, and with --out the result is
+// written as raw mono f32 (synth/recordings holds MP3s; convert one first).
+// Exits 1 if any check fails.
+//
+// Usage: vocoder_bench [--window N] [--stretch S] [--pitch P] [--phase locked|plain]
+//                      [--wav FILE] [--out FILE]
+
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#include "fft.h"
+#include "real_fft.h"
+#include "fft_split.h"
+#include "fft_mixed.h"
+#include "bench_timer.h"
+#include "fft_planner.h"
+#include "dsp_math.h"
+#include "dsp_simd_math.h"
+#include "dsp_window.h"
+#include "stft.h"
+#include "vocoder.h"
+#include "wav_reader.h"
+
+#define CHECK_RATE 44100
+#define CHECK_SECONDS 2
+#define IDENTITY_TOLERANCE 1e-4f  // relative to the input's peak.
+#define FREQ_TOLERANCE 0.002      // relative.
+#define LEVEL_TOLERANCE_DB 1.0
+#define CLICK_COUNT 8
+#define BENCH_SECONDS 10
+
+typedef struct vocoder_setting
+{
+    f32 Stretch;
+    f32 Pitch;
+} vocoder_setting;
+
+global vocoder_setting BenchSettings[] = {{1.0f, 1.0f}, {1.5f, 1.0f}, {0.75f, 1.0f}, {1.0f, 1.4983f}, {1.25f, 0.8409f}};
+
+// Runs all of Input through and returns how many samples came out, flushing
+// with silence. Blocks alternate between the two sizes given.
+internal u32
+RunVocoder(vocoder *Vocoder, f32 *Input, u32 InputCount, f32 *Output, u32 OutputCapacity, u32 PushBlock, u32 PullBlock)
+{
+    f32 Silence[256] = {0};
+    u32 Pushed = 0;
+    u32 Flushed = 0;
+    u32 FlushCount = Vocoder->WindowSize * 2;
+    u32 Written = 0;
+    u32 Step = 0;
+    while (Written < OutputCapacity)
+    {
+        u32 Pull = (PullBlock < OutputCapacity - Written) ? PullBlock : OutputCapacity - Written;
+        u32 Got = VocoderPull(Vocoder, Output + Written, Pull);
+        Written += Got;
+        if (Got == Pull) continue;
+
+        if (Pushed < InputCount)
+        {
+            u32 Push = PushBlock + (Step++ % 7);
+            Push = (Push < InputCount - Pushed) ? Push : InputCount - Pushed;
+            Pushed += VocoderPush(Vocoder, Input + Pushed, Push);
+        }
+        else if (Flushed < FlushCount)
+        {
+            Flushed += VocoderPush(Vocoder, Silence, mx_ArrayCount(Silence));
+        }
+        else break;
+    }
+    return Written;
+}
+
+// Frequency from the rising zero crossings in [First, End).
+internal f64
+MeasureFreq(f32 *Samples, u32 First, u32 End, f64 SampleRate)
+{
+    f64 FirstCrossing = -1;
+    f64 LastCrossing = 0;
+    u32 Crossings = 0;
+    for (u32 N = First + 1; N < End; N++)
+    {
+        if (Samples[N - 1] < 0 && Samples[N] >= 0)
+        {
+            f64 At = N - 1 + Samples[N - 1] / (Samples[N - 1] - Samples[N]);
+            if (FirstCrossing < 0) FirstCrossing = At;
+            LastCrossing = At;
+            Crossings++;
+        }
+    }
+    return (Crossings > 1) ? (Crossings - 1) * SampleRate / (LastCrossing - FirstCrossing) : 0;
+}
+
+internal f64
+MeasureRMS(f32 *Samples, u32 First, u32 End)
+{
+    f64 Sum = 0;
+    for (u32 N = First; N < End; N++) Sum += (f64)Samples[N] * Samples[N];
+    return sqrt(Sum / (End - First));
+}
+
+internal bool
+Report(u32 *FailCount, bool Passed)
+{
+    *FailCount += Passed ? 0 : 1;
+    return Passed;
+}
+
+// Attack spread: how far each stretched click's energy reaches, as the RMS
+// distance in ms from its centre over the 100ms around it, with the tone's
+// peak power taken off; averaged. Frame middles map to frame middles.
+internal f64
+AttackSpread(f32 *Output, u32 OutputCount, u32 *Clicks, u32 ClickCount, f32 Stretch, u32 Latency, u32 WindowSize,
+             f32 ToneLevel)
+{
+    i32 Span = CHECK_RATE / 20;
+    f64 Background = (f64)ToneLevel * ToneLevel;
+    f64 Sum = 0;
+    u32 Counted = 0;
+    for (u32 Click = 0; Click < ClickCount; Click++)
+    {
+        i32 At = (i32)((Clicks[Click] + Latency - WindowSize/2) * Stretch) + (i32)WindowSize/2;
+        if (At < Span || At + Span > (i32)OutputCount) continue;
+        f64 Weight = 0, Moment = 0, Square = 0;
+        for (i32 N = -Span; N < Span; N++)
+        {
+            f64 Energy = fmax((f64)Output[At + N] * Output[At + N] - Background, 0);
+            Weight += Energy;
+            Moment += Energy * N;
+            Square += Energy * N * N;
+        }
+        if (Weight <= 0) continue;
+        f64 Centre = Moment / Weight;
+        Sum += 1000.0 * sqrt(fmax(Square / Weight - Centre * Centre, 0)) / CHECK_RATE;
+        Counted++;
+    }
+    return Counted ? Sum / Counted : 0;
+}
+
+internal f64
+TimeVocoder(fft_planner *Planner, vocoder_config Config, bool Vector, f32 *Input, u32 InputCount, f32 *Output,
+            u32 OutputCapacity)
+{
+    vocoder Vocoder = VocoderCreate(Planner, Config);
+    Vocoder.Vector = Vocoder.Vector && Vector;
+    f64 Start = BenchSeconds();
+    RunVocoder(&Vocoder, Input, InputCount, Output, OutputCapacity, 512, 512);
+    f64 Seconds = BenchSeconds() - Start;
+    VocoderDestroy(&Vocoder);
+    return Seconds;
+}
+
+i32
+main(i32 argc, char **argv)
+{
+    vocoder_config Base = {0};
+    const char *WavPath = 0;
+    const char *OutPath = 0;
+    for (i32 ArgIndex = 1; ArgIndex < argc; ArgIndex++)
+    {
+        const char *Arg = argv[ArgIndex];
+        const char *Value = (ArgIndex + 1 < argc) ? argv[ArgIndex + 1] : "";
+        if (strcmp(Arg, "--window") == 0) { Base.WindowSize = (u32)atoi(Value); ArgIndex++; }
+        else if (strcmp(Arg, "--stretch") == 0) { Base.Stretch = (f32)atof(Value); ArgIndex++; }
+        else if (strcmp(Arg, "--pitch") == 0) { Base.Pitch = (f32)atof(Value); ArgIndex++; }
+        else if (strcmp(Arg, "--phase") == 0) { Base.Phase = (strcmp(Value, "plain") == 0) ? VocoderPhase_Plain : VocoderPhase_Locked; ArgIndex++; }
+        else if (strcmp(Arg, "--wav") == 0) { WavPath = Value; ArgIndex++; }
+        else if (strcmp(Arg, "--out") == 0) { OutPath = Value; ArgIndex++; }
+        else
+        {
+            printf("Usage: vocoder_bench [--window N] [--stretch S] [--pitch P] [--phase locked|plain] [--wav FILE] [--out FILE]\n");
+            return 2;
+        }
+    }
+
+    fft_planner Planner = FFTPlannerCreate(FFTPlanner_Measure, 0);
+    vocoder Probe = VocoderCreate(&Planner, Base);
+    if (Probe.BinCount == 0)
+    {
+        printf("The window has to be a power of two, at least 64.\n");
+        return 2;
+    }
+    printf("window %u, hop %u, latency %u, %s phases, best kernel %s\n\n", Probe.WindowSize, Probe.HopSize,
+           Probe.Latency, VocoderPhaseNames[Probe.Config.Phase], Probe.Vector ? "avx2" : "scalar");
+    u32 Latency = Probe.Latency;
+    VocoderDestroy(&Probe);
+
+    u32 InputCount = CHECK_RATE * CHECK_SECONDS;
+    u32 OutputCapacity = (u32)(InputCount * VOCODER_MAX_RATIO) + 8 * VOCODER_WINDOW * 4;
+    f32 *Input = (f32 *)malloc(InputCount * sizeof(f32));
+    f32 *Output = (f32 *)malloc(OutputCapacity * sizeof(f32));
+    f32 *Other = (f32 *)malloc(OutputCapacity * sizeof(f32));
+    u32 FailCount = 0;
+
+    // Identity, on a chord with some noise.
+    for (u32 N = 0; N < InputCount; N++)
+    {
+        Input[N] = 0.3f * (f32)sin(FFT_TAU * 220.0 * N / CHECK_RATE) + 0.2f * (f32)sin(FFT_TAU * 277.18 * N / CHECK_RATE) +
+                   0.05f * (RandomF32(N) - 0.5f);
+    }
+    for (u32 Vector = 0; Vector < 2; Vector++)
+    {
+        vocoder_config Config = Base;
+        Config.Stretch = 1;
+        Config.Pitch = 1;
+        vocoder Vocoder = VocoderCreate(&Planner, Config);
+        if (Vector && !Vocoder.Vector) { VocoderDestroy(&Vocoder); continue; }
+        Vocoder.Vector = (Vector == 1);
+        u32 Count = RunVocoder(&Vocoder, Input, InputCount, Output, InputCount + Latency, 300, 1000);
+        f32 Error = 0;
+        for (u32 N = 0; N + Latency < Count; N++) Error = fmaxf(Error, fabsf(Output[N + Latency] - Input[N]));
+        bool Passed = Report(&FailCount, Count == InputCount + Latency && Error / 0.55f <= IDENTITY_TOLERANCE);
+        printf("identity (%s): %u samples out, error %.1e  %s\n", Vector ? "avx2" : "scalar", Count, Error / 0.55f, Passed ? "ok" : "FAILED");
+        VocoderDestroy(&Vocoder);
+    }
+
+    // The same stream in different blocks.
+    {
+        vocoder_config Config = Base;
+        Config.Stretch = 1.37f;
+        Config.Pitch = 1.12f;
+        vocoder A = VocoderCreate(&Planner, Config);
+        vocoder B = VocoderCreate(&Planner, Config);
+        u32 CountA = RunVocoder(&A, Input, InputCount, Output, OutputCapacity, 4096, 4096);
+        u32 CountB = RunVocoder(&B, Input, InputCount, Other, OutputCapacity, 1, 37);
+        bool Same = (CountA == CountB && memcmp(Output, Other, CountA * sizeof(f32)) == 0);
+        printf("blocks of 4096 and of 1-7 in, 37 out: %u and %u samples  %s\n", CountA, CountB, Report(&FailCount, Same) ? "same" : "DIFFERENT");
+        VocoderDestroy(&A);
+        VocoderDestroy(&B);
+    }
+
+    // A sine, stretched and shifted; measured over the steady middle.
+    printf("\n%8s %8s %10s %10s %8s\n", "stretch", "pitch", "Hz", "expected", "level");
+    f64 SineFreq = 440.0;
+    for (u32 N = 0; N < InputCount; N++) Input[N] = 0.5f * (f32)sin(FFT_TAU * SineFreq * N / CHECK_RATE);
+    vocoder_setting SineSettings[] = {{0.5f, 1}, {1.5f, 1}, {2.0f, 1}, {1, 0.7491535f}, {1, 1.4983071f}, {1, 2.0f}, {1.3f, 0.8f}};
+    for (u32 Index = 0; Index < mx_ArrayCount(SineSettings); Index++)
+    {
+        vocoder_config Config = Base;
+        Config.Stretch = SineSettings[Index].Stretch;
+        Config.Pitch = SineSettings[Index].Pitch;
+        vocoder Vocoder = VocoderCreate(&Planner, Config);
+        u32 Count = RunVocoder(&Vocoder, Input, InputCount, Output, OutputCapacity, 512, 512);
+        u32 First = (u32)((Latency + CHECK_RATE / 4) * Config.Stretch);
+        u32 End = (u32)((Latency + InputCount - CHECK_RATE / 4) * Config.Stretch);
+        End = (End < Count) ? End : Count;
+        f64 Freq = MeasureFreq(Output, First, End, CHECK_RATE);
+        f64 Expected = SineFreq * Config.Pitch;
+        f64 LevelDB = 20.0 * log10(MeasureRMS(Output, First, End) / (0.5 / sqrt(2.0)));
+        bool Passed = Report(&FailCount, fabs(Freq / Expected - 1) <= FREQ_TOLERANCE && fabs(LevelDB) <= LEVEL_TOLERANCE_DB);
+        printf("%8.3f %8.3f %10.2f %10.2f %+7.2fdB  %s\n", Config.Stretch, Config.Pitch, Freq, Expected, LevelDB, Passed ? "ok" : "FAILED");
+        VocoderDestroy(&Vocoder);
+    }
+
+    // Clicks on a quiet tone, stretched. The tone starting is an onset too;
+    // it fades out over 50ms so its end isn't one.
+    u32 Clicks[CLICK_COUNT];
+    u32 Fade = CHECK_RATE / 20;
+    for (u32 N = 0; N < InputCount; N++)
+    {
+        f32 Gain = (InputCount - N < Fade) ? (f32)(InputCount - N) / Fade : 1.0f;
+        Input[N] = Gain * 0.02f * (f32)sin(FFT_TAU * 330.0 * N / CHECK_RATE);
+    }
+    for (u32 Click = 0; Click < CLICK_COUNT; Click++)
+    {
+        Clicks[Click] = (Click + 1) * InputCount / (CLICK_COUNT + 1);
+        for (u32 N = 0; N < 400; N++) Input[Clicks[Click] + N] += 0.8f * expf(-(f32)N / 60.0f) * (RandomF32(N + Click * 400) - 0.5f) * 2;
+    }
+    printf("\n%u clicks stretched 2x:\n", CLICK_COUNT);
+    f64 PlainSpread = 0;
+    for (u32 Detect = 0; Detect < 2; Detect++)
+    {
+        vocoder_config Config = Base;
+        Config.Stretch = 2.0f;
+        Config.Pitch = 1.0f;
+        Config.TransientFraction = Detect ? 0 : 2;
+        vocoder Vocoder = VocoderCreate(&Planner, Config);
+        u32 Count = RunVocoder(&Vocoder, Input, InputCount, Output, OutputCapacity, 512, 512);
+        f64 Spread = AttackSpread(Output, Count, Clicks, CLICK_COUNT, Config.Stretch, Latency, Vocoder.WindowSize, 0.02f);
+        if (Detect)
+        {
+            bool Passed = Report(&FailCount, Vocoder.TransientCount == CLICK_COUNT + 1 && Spread <= PlainSpread);
+            printf("  transients on:  %llu onsets, attack spread %.2fms  %s\n", (unsigned long long)Vocoder.TransientCount, Spread, Passed ? "ok" : "FAILED");
+        }
+        else
+        {
+            PlainSpread = Spread;
+            printf("  transients off: attack spread %.2fms\n", Spread);
+        }
+        VocoderDestroy(&Vocoder);
+    }
+
+    // Real-time factors.
+    u32 BenchCount = 48000 * BENCH_SECONDS;
+    f32 *BenchInput = (f32 *)malloc(BenchCount * sizeof(f32));
+    u32 BenchCapacity = (u32)(BenchCount * VOCODER_MAX_RATIO) + 8 * VOCODER_WINDOW * 4;
+    f32 *BenchOutput = (f32 *)malloc(BenchCapacity * sizeof(f32));
+    u32 Rates[] = {44100, 48000};
+    printf("\nreal-time factor, %u s of input:\n%8s %8s %8s %10s %10s\n", BENCH_SECONDS, "rate", "stretch", "pitch", "scalar", "avx2");
+    for (u32 RateIndex = 0; RateIndex < mx_ArrayCount(Rates); RateIndex++)
+    {
+        u32 Rate = Rates[RateIndex];
+        u32 Count = Rate * BENCH_SECONDS;
+        for (u32 N = 0; N < Count; N++)
+        {
+            f64 Time = (f64)N / Rate;
+            BenchInput[N] = 0.2f * (f32)sin(FFT_TAU * 110.0 * Time) + 0.1f * (f32)sin(FFT_TAU * 164.8 * Time * (1 + 0.002 * sin(Time))) +
+                            0.05f * (RandomF32(N) - 0.5f);
+        }
+        for (u32 Index = 0; Index < mx_ArrayCount(BenchSettings); Index++)
+        {
+            vocoder_config Config = Base;
+            Config.Stretch = BenchSettings[Index].Stretch;
+            Config.Pitch = BenchSettings[Index].Pitch;
+            f64 Scalar = TimeVocoder(&Planner, Config, false, BenchInput, Count, BenchOutput, BenchCapacity);
+            f64 Vector = TimeVocoder(&Planner, Config, true, BenchInput, Count, BenchOutput, BenchCapacity);
+            printf("%8u %8.3f %8.3f %9.1fx %9.1fx\n", Rate, Config.Stretch, Config.Pitch, BENCH_SECONDS / Scalar, BENCH_SECONDS / Vector);
+        }
+    }
+
+    if (WavPath)
+    {
+        wav_reader Reader;
+        if (!WavOpen(&Reader, WavPath))
+        {
+            printf("%s: %s\n", WavPath, Reader.Error);
+            return 1;
+        }
+        u32 Count = (u32)Reader.FrameCount;
+        f32 *Recording = (f32 *)malloc(Count * sizeof(f32));
+        WavConvert(&Reader, 0, Count, Recording);
+        vocoder_config Config = Base;
+        vocoder Vocoder = VocoderCreate(&Planner, Config);
+        u32 Capacity = (u32)(Count * Vocoder.Config.Stretch) + 8 * Vocoder.WindowSize;
+        f32 *Result = (f32 *)malloc(Capacity * sizeof(f32));
+        f64 Start = BenchSeconds();
+        u32 Written = RunVocoder(&Vocoder, Recording, Count, Result, Capacity, 512, 512);
+        f64 Seconds = BenchSeconds() - Start;
+        printf("\n%s: %.2fs at %u Hz, stretch %.3f, pitch %.3f: %.1fx real time, %u transients\n", WavPath,
+               (f64)Count / Reader.SampleRate, Reader.SampleRate, Vocoder.Config.Stretch, Vocoder.Config.Pitch,
+               (f64)Count / Reader.SampleRate / Seconds, (u32)Vocoder.TransientCount);
+        if (OutPath)
+        {
+            FILE *File = fopen(OutPath, "wb");
+            if (!File) { printf("Can't open %s\n", OutPath); return 1; }
+            fwrite(Result, sizeof(f32), Written, File);
+            fclose(File);
+        }
+        VocoderDestroy(&Vocoder);
+        free(Result);
+        free(Recording);
+        WavClose(&Reader);
+    }
+
+    FFTPlannerDestroy(&Planner);
+    free(BenchOutput);
+    free(BenchInput);
+    free(Other);
+    free(Output);
+    free(Input);
+    return (FailCount == 0) ? 0 : 1;
+}
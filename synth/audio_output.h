@@ -0,0 +1,404 @@
+/* date = October 18th 2026 */
+
+#ifndef AUDIO_OUTPUT_H
+#define AUDIO_OUTPUT_H
+
+// Pull-style audio output.
+//
+// AudioOutputStart spins up an audio thread that asks the render callback for
+// one period at a time and hands it to a backend:
+//
+//   alsa: Linux ALSA playback, with a configurable period size and count.
+//         PipeWire and PulseAudio systems are reached through their ALSA
+//         plugins ("default", "pipewire", "pulse"). libasound is loaded at
+//         runtime so nothing extra is needed to build.
+//   null: throws the audio away.
+//   file: writes it to a .wav through audio_sink.h.
+//
+// null and file run the exact same thread and callback as alsa. They either
+// pace themselves to the sample clock like a device would, or freewheel as
+// fast as the callback allows (for benchmarks and CI). The audio thread can
+// be raised to real-time priority (SCHED_FIFO) and pinned to a CPU.
+//
+// The render callback runs on the audio thread and must be real-time safe.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "synth_platform.h"
+#include "synth_thread.h"
+#include "audio_sink.h"
+#include "rt_check.h"
+
+#ifdef __linux__
+#include <dlfcn.h>
+#endif
+
+typedef void AudioRenderFn(void *user_data, f32 *samples, u32 sample_count);
+
+#define AUDIO_BACKEND_OPTIONS "null;file;alsa"
+typedef enum AudioBackend {
+    AudioBackend_NULL = 0,
+    AudioBackend_FILE = 1,
+    AudioBackend_ALSA = 2,
+    AudioBackend_COUNT
+} AudioBackend;
+
+typedef struct AudioOutputConfig {
+    AudioBackend backend;
+    u32 sample_rate;
+    u32 period_size;       // samples per render callback.
+    u32 period_count;      // periods in the device buffer (alsa).
+    bool realtime;         // SCHED_FIFO / time critical audio thread.
+    i32 realtime_priority; // 1-99 for SCHED_FIFO.
+    i32 cpu;               // pin the audio thread to this cpu, -1 to leave it.
+    bool freewheel;        // null/file: render as fast as possible.
+    u64 max_periods;       // stop by itself after this many periods, 0 = never.
+    const char *device_name; // alsa pcm name.
+    const char *file_path;   // file backend output.
+} AudioOutputConfig;
+
+// @alsa
+// The handful of libasound entry points we use, resolved with dlopen.
+typedef struct AlsaApi {
+    void *library;
+    i32 (*pcm_open)(void **pcm, const char *name, i32 stream, i32 mode);
+    i32 (*pcm_close)(void *pcm);
+    i32 (*pcm_hw_params_malloc)(void **params);
+    void (*pcm_hw_params_free)(void *params);
+    i32 (*pcm_hw_params_any)(void *pcm, void *params);
+    i32 (*pcm_hw_params_set_access)(void *pcm, void *params, i32 access);
+    i32 (*pcm_hw_params_set_format)(void *pcm, void *params, i32 format);
+    i32 (*pcm_hw_params_set_channels)(void *pcm, void *params, u32 channels);
+    i32 (*pcm_hw_params_set_rate_near)(void *pcm, void *params, u32 *rate, i32 *dir);
+    i32 (*pcm_hw_params_set_period_size_near)(void *pcm, void *params, unsigned long *frames, i32 *dir);
+    i32 (*pcm_hw_params_set_periods_near)(void *pcm, void *params, u32 *periods, i32 *dir);
+    i32 (*pcm_hw_params)(void *pcm, void *params);
+    i32 (*pcm_prepare)(void *pcm);
+    long (*pcm_writei)(void *pcm, const void *buffer, unsigned long frames);
+    i32 (*pcm_recover)(void *pcm, i32 err, i32 silent);
+    i32 (*pcm_drain)(void *pcm);
+    const char *(*strerror)(i32 err);
+} AlsaApi;
+
+// Values from alsa/pcm.h.
+#define ALSA_PCM_STREAM_PLAYBACK 0
+#define ALSA_PCM_ACCESS_RW_INTERLEAVED 3
+#define ALSA_PCM_FORMAT_FLOAT_LE 14
+
+typedef struct AudioOutput {
+    AudioOutputConfig config;
+    AudioRenderFn *render;
+    void *user_data;
+
+    SynthThread thread;
+    u32 is_running;
+    f32 *period_buffer;
+    AudioSink sink;
+    AlsaApi alsa;
+    void *alsa_pcm;
+
+    // Written by the audio thread, read by anyone.
+    u32 periods_rendered;
+    u32 xruns;
+    bool got_realtime;
+    bool got_cpu;
+    f64 render_seconds_last;
+    f64 render_seconds_total;
+    f64 render_seconds_max;
+} AudioOutput;
+
+internal AudioOutputConfig
+AudioOutputDefaultConfig(void)
+{
+    AudioOutputConfig config = {0};
+    config.backend = AudioBackend_NULL;
+    config.sample_rate = 44100;
+    config.period_size = 256;
+    config.period_count = 2;
+    config.realtime = false;
+    config.realtime_priority = 70;
+    config.cpu = -1;
+    config.device_name = "default";
+    config.file_path = "output.wav";
+    return config;
+}
+
+// @alsa
+internal bool
+AlsaLoad(AlsaApi *alsa)
+{
+#ifdef __linux__
+    alsa->library = dlopen("libasound.so.2", RTLD_NOW);
+    if (!alsa->library)
+    {
+        printf("Could not load libasound.so.2.\n");
+        return false;
+    }
+#define AlsaBind(field, symbol) *(void **)(&alsa->field) = dlsym(alsa->library, symbol); if (!alsa->field) return false;
+    AlsaBind(pcm_open, "snd_pcm_open");
+    AlsaBind(pcm_close, "snd_pcm_close");
+    AlsaBind(pcm_hw_params_malloc, "snd_pcm_hw_params_malloc");
+    AlsaBind(pcm_hw_params_free, "snd_pcm_hw_params_free");
+    AlsaBind(pcm_hw_params_any, "snd_pcm_hw_params_any");
+    AlsaBind(pcm_hw_params_set_access, "snd_pcm_hw_params_set_access");
+    AlsaBind(pcm_hw_params_set_format, "snd_pcm_hw_params_set_format");
+    AlsaBind(pcm_hw_params_set_channels, "snd_pcm_hw_params_set_channels");
+    AlsaBind(pcm_hw_params_set_rate_near, "snd_pcm_hw_params_set_rate_near");
+    AlsaBind(pcm_hw_params_set_period_size_near, "snd_pcm_hw_params_set_period_size_near");
+    AlsaBind(pcm_hw_params_set_periods_near, "snd_pcm_hw_params_set_periods_near");
+    AlsaBind(pcm_hw_params, "snd_pcm_hw_params");
+    AlsaBind(pcm_prepare, "snd_pcm_prepare");
+    AlsaBind(pcm_writei, "snd_pcm_writei");
+    AlsaBind(pcm_recover, "snd_pcm_recover");
+    AlsaBind(pcm_drain, "snd_pcm_drain");
+    AlsaBind(strerror, "snd_strerror");
+#undef AlsaBind
+    return true;
+#else
+    printf("The alsa backend is only available on Linux.\n");
+    return false;
+#endif
+}
+
+// @alsa
+internal void
+AlsaUnload(AlsaApi *alsa)
+{
+#ifdef __linux__
+    if (alsa->library) dlclose(alsa->library);
+#endif
+    memset(alsa, 0, sizeof(AlsaApi));
+}
+
+// @alsa
+// Opens the device and negotiates the period size/count; the config is updated
+// with what the device actually gave us.
+internal bool
+AlsaOpen(AudioOutput *output)
+{
+    AlsaApi *alsa = &output->alsa;
+    AudioOutputConfig *config = &output->config;
+    if (!AlsaLoad(alsa))
+    {
+        AlsaUnload(alsa);
+        return false;
+    }
+
+    i32 err = alsa->pcm_open(&output->alsa_pcm, config->device_name, ALSA_PCM_STREAM_PLAYBACK, 0);
+    if (err < 0)
+    {
+        printf("Could not open ALSA device %s: %s\n", config->device_name, alsa->strerror(err));
+        output->alsa_pcm = 0;
+        AlsaUnload(alsa);
+        return false;
+    }
+
+    void *params = 0;
+    err = alsa->pcm_hw_params_malloc(&params);
+    if (err < 0 || !params)
+    {
+        printf("Could not allocate ALSA hardware parameters: %s\n", alsa->strerror(err));
+        alsa->pcm_close(output->alsa_pcm);
+        output->alsa_pcm = 0;
+        AlsaUnload(alsa);
+        return false;
+    }
+    alsa->pcm_hw_params_any(output->alsa_pcm, params);
+    u32 rate = config->sample_rate;
+    unsigned long period_size = config->period_size;
+    u32 period_count = config->period_count;
+    i32 dir = 0;
+    err = alsa->pcm_hw_params_set_access(output->alsa_pcm, params, ALSA_PCM_ACCESS_RW_INTERLEAVED);
+    if (err >= 0) err = alsa->pcm_hw_params_set_format(output->alsa_pcm, params, ALSA_PCM_FORMAT_FLOAT_LE);
+    if (err >= 0) err = alsa->pcm_hw_params_set_channels(output->alsa_pcm, params, 1);
+    if (err >= 0) err = alsa->pcm_hw_params_set_rate_near(output->alsa_pcm, params, &rate, &dir);
+    if (err >= 0) err = alsa->pcm_hw_params_set_period_size_near(output->alsa_pcm, params, &period_size, &dir);
+    if (err >= 0) err = alsa->pcm_hw_params_set_periods_near(output->alsa_pcm, params, &period_count, &dir);
+    if (err >= 0) err = alsa->pcm_hw_params(output->alsa_pcm, params);
+    alsa->pcm_hw_params_free(params);
+    if (err < 0)
+    {
+        printf("Could not configure ALSA device %s: %s\n", config->device_name, alsa->strerror(err));
+        alsa->pcm_close(output->alsa_pcm);
+        output->alsa_pcm = 0;
+        AlsaUnload(alsa);
+        return false;
+    }
+
+    if (rate != config->sample_rate)
+    {
+        printf("ALSA device %s runs at %u Hz, not %u Hz.\n", config->device_name, rate, config->sample_rate);
+    }
+    config->sample_rate = rate;
+    config->period_size = (u32)period_size;
+    config->period_count = period_count;
+    alsa->pcm_prepare(output->alsa_pcm);
+    return true;
+}
+
+// @audiothread
+internal void
+AudioOutputThread(void *user_data)
+{
+    AudioOutput *output = (AudioOutput *)user_data;
+    AudioOutputConfig *config = &output->config;
+
+    if (config->realtime)
+    {
+        output->got_realtime = SynthThreadSetRealtime(config->realtime_priority);
+    }
+    if (config->cpu >= 0)
+    {
+        output->got_cpu = SynthThreadPinToCpu(config->cpu);
+    }
+
+    const f64 period_seconds = (f64)config->period_size / config->sample_rate;
+    f64 next_deadline = SynthTimeSeconds();
+    while (AtomicLoadU32(&output->is_running))
+    {
+        // Everything up to handing the period to the backend must be
+        // real-time safe; the backend itself is what blocks.
+        RtScopeBegin();
+        const f64 render_start = SynthTimeSeconds();
+        output->render(output->user_data, output->period_buffer, config->period_size);
+        const f64 render_seconds = SynthTimeSeconds() - render_start;
+        output->render_seconds_last = render_seconds;
+        output->render_seconds_total += render_seconds;
+        if (render_seconds > output->render_seconds_max) output->render_seconds_max = render_seconds;
+        RtScopeEnd();
+
+        switch (config->backend)
+        {
+            case AudioBackend_ALSA: {
+                // Blocks until there's room for the period, which is what
+                // paces this loop. A write can come back short (a signal, or
+                // the device only had room for part of it), so keep going from
+                // where it stopped; if recovering from an error fails the rest
+                // of the period is dropped.
+                f32 *frames = output->period_buffer;
+                unsigned long frames_left = config->period_size;
+                while (frames_left > 0)
+                {
+                    long written = output->alsa.pcm_writei(output->alsa_pcm, frames, frames_left);
+                    if (written < 0)
+                    {
+                        AtomicAddU32(&output->xruns, 1);
+                        if (output->alsa.pcm_recover(output->alsa_pcm, (i32)written, 1) < 0) break;
+                        continue;
+                    }
+                    frames += written;
+                    frames_left -= (unsigned long)written;
+                }
+                break;
+            }
+            case AudioBackend_FILE: {
+                AudioSinkWrite(&output->sink, output->period_buffer, config->period_size);
+            } // fallthrough
+            case AudioBackend_NULL: {
+                if (!config->freewheel)
+                {
+                    next_deadline += period_seconds;
+                    if (SynthTimeSeconds() > next_deadline)
+                    {
+                        // Rendering ran past the time a device would have
+                        // needed this period.
+                        AtomicAddU32(&output->xruns, 1);
+                        next_deadline = SynthTimeSeconds();
+                    }
+                    SynthSleepUntil(next_deadline);
+                }
+                break;
+            }
+            default: break;
+        }
+
+        u32 periods = AtomicAddU32(&output->periods_rendered, 1);
+        if (config->max_periods && periods >= config->max_periods)
+        {
+            AtomicStoreU32(&output->is_running, 0);
+        }
+    }
+}
+
+// Closes whatever AudioOutputStart opened. The audio thread must not be
+// running.
+internal void
+AudioOutputRelease(AudioOutput *output)
+{
+    if (output->alsa_pcm)
+    {
+        output->alsa.pcm_close(output->alsa_pcm);
+        output->alsa_pcm = 0;
+    }
+    AlsaUnload(&output->alsa);
+    AudioSinkClose(&output->sink);
+    free(output->period_buffer);
+    output->period_buffer = 0;
+}
+
+internal bool
+AudioOutputStart(AudioOutput *output, AudioOutputConfig *config, AudioRenderFn *render, void *user_data)
+{
+    memset(output, 0, sizeof(AudioOutput));
+    output->config = *config;
+    output->render = render;
+    output->user_data = user_data;
+
+    switch (config->backend)
+    {
+        case AudioBackend_NULL: {
+            AudioSinkOpenNull(&output->sink, config->sample_rate);
+            break;
+        }
+        case AudioBackend_FILE: {
+            if (!AudioSinkOpenWav(&output->sink, config->file_path, config->sample_rate)) return false;
+            break;
+        }
+        case AudioBackend_ALSA: {
+            if (!AlsaOpen(output)) return false;
+            break;
+        }
+        default: return false;
+    }
+
+    // Allocated after the device has settled on a period size.
+    output->period_buffer = (f32 *)calloc(output->config.period_size, sizeof(f32));
+    if (!output->period_buffer)
+    {
+        printf("Could not allocate the period buffer.\n");
+        AudioOutputRelease(output);
+        return false;
+    }
+    AtomicStoreU32(&output->is_running, 1);
+    if (!SynthThreadStart(&output->thread, AudioOutputThread, output))
+    {
+        printf("Could not start the audio thread.\n");
+        AtomicStoreU32(&output->is_running, 0);
+        AudioOutputRelease(output);
+        return false;
+    }
+    return true;
+}
+
+// Waits for a max_periods run to finish by itself.
+internal void
+AudioOutputWait(AudioOutput *output)
+{
+    while (AtomicLoadU32(&output->is_running))
+    {
+        SynthSleepUntil(SynthTimeSeconds() + 0.005);
+    }
+}
+
+internal void
+AudioOutputStop(AudioOutput *output)
+{
+    AtomicStoreU32(&output->is_running, 0);
+    SynthThreadJoin(&output->thread);
+
+    if (output->alsa_pcm) output->alsa.pcm_drain(output->alsa_pcm);
+    AudioOutputRelease(output);
+}
+
+#endif //AUDIO_OUTPUT_H
@@ -0,0 +1,116 @@
+/* date = October 18th 2026 */
+
+#ifndef AUDIO_SINK_H
+#define AUDIO_SINK_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "synth_platform.h"
+
+// Somewhere to put rendered audio when there is no sound card: the null sink
+// just counts samples, the wav sink writes mono 32-bit float .wav files.
+typedef enum AudioSinkKind {
+    AudioSinkKind_NULL = 0,
+    AudioSinkKind_WAV = 1,
+} AudioSinkKind;
+
+typedef struct AudioSink {
+    AudioSinkKind kind;
+    FILE *file;
+    u32 sample_rate;
+    u64 samples_written;
+} AudioSink;
+
+internal void
+AudioSinkWriteU32(FILE *file, u32 value)
+{
+    u8 bytes[4] = {value & 0xff, (value >> 8) & 0xff, (value >> 16) & 0xff, (value >> 24) & 0xff};
+    fwrite(bytes, 1, sizeof(bytes), file);
+}
+
+internal void
+AudioSinkWriteU16(FILE *file, u16 value)
+{
+    u8 bytes[2] = {value & 0xff, (value >> 8) & 0xff};
+    fwrite(bytes, 1, sizeof(bytes), file);
+}
+
+internal void
+AudioSinkWriteWavHeader(AudioSink *sink)
+{
+    const u32 data_size = (u32)(sink->samples_written * sizeof(f32));
+    fwrite("RIFF", 1, 4, sink->file);
+    AudioSinkWriteU32(sink->file, 36 + data_size);
+    fwrite("WAVE", 1, 4, sink->file);
+    fwrite("fmt ", 1, 4, sink->file);
+    AudioSinkWriteU32(sink->file, 16);
+    AudioSinkWriteU16(sink->file, 3); // WAVE_FORMAT_IEEE_FLOAT
+    AudioSinkWriteU16(sink->file, 1); // mono
+    AudioSinkWriteU32(sink->file, sink->sample_rate);
+    AudioSinkWriteU32(sink->file, sink->sample_rate * sizeof(f32));
+    AudioSinkWriteU16(sink->file, sizeof(f32));
+    AudioSinkWriteU16(sink->file, 32);
+    fwrite("data", 1, 4, sink->file);
+    AudioSinkWriteU32(sink->file, data_size);
+}
+
+internal void
+AudioSinkOpenNull(AudioSink *sink, u32 sample_rate)
+{
+    sink->kind = AudioSinkKind_NULL;
+    sink->file = 0;
+    sink->sample_rate = sample_rate;
+    sink->samples_written = 0;
+}
+
+internal bool
+AudioSinkOpenWav(AudioSink *sink, const char *path, u32 sample_rate)
+{
+    AudioSinkOpenNull(sink, sample_rate);
+    sink->file = fopen(path, "wb");
+    if (!sink->file)
+    {
+        printf("Could not open %s for writing.\n", path);
+        return false;
+    }
+    sink->kind = AudioSinkKind_WAV;
+    // Sizes are patched in by AudioSinkClose.
+    AudioSinkWriteWavHeader(sink);
+    return true;
+}
+
+internal void
+AudioSinkWrite(AudioSink *sink, const f32 *samples, usize sample_count)
+{
+    if (sink->kind == AudioSinkKind_WAV)
+    {
+        fwrite(samples, sizeof(f32), sample_count, sink->file);
+    }
+    sink->samples_written += sample_count;
+}
+
+internal void
+AudioSinkWriteSilence(AudioSink *sink, usize sample_count)
+{
+    const f32 zeros[256] = {0};
+    while (sample_count > 0)
+    {
+        usize chunk = (sample_count < ArrayCount(zeros)) ? sample_count : ArrayCount(zeros);
+        AudioSinkWrite(sink, zeros, chunk);
+        sample_count -= chunk;
+    }
+}
+
+internal void
+AudioSinkClose(AudioSink *sink)
+{
+    if (sink->kind == AudioSinkKind_WAV && sink->file)
+    {
+        fseek(sink->file, 0, SEEK_SET);
+        AudioSinkWriteWavHeader(sink);
+        fclose(sink->file);
+        sink->file = 0;
+    }
+}
+
+#endif //AUDIO_SINK_H
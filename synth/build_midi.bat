@@ -1 +1 @@
-tcc -o midi.exe midi.c -Iinclude -lmsvcrt -lgdi32 -lkernel32 -lshell32 -luser32 -lwinmm -Wl -std=c99 -g
\ No newline at end of file
+tcc -o midi.exe midi.c -Iinclude -I../dsp -lmsvcrt -lgdi32 -lkernel32 -lshell32 -luser32 -lwinmm -Wl -std=c99 -g
\ No newline at end of file
@@ -1 +1 @@
-tcc -o synth.exe synth.c -Iinclude -lraylib -lmsvcrt -lopengl32 -lgdi32 -lkernel32 -lshell32 -luser32 -lwinmm -Wl,-subsystem=gui -std=c99 -run
\ No newline at end of file
+tcc -o synth.exe synth.c -Iinclude -I../dsp -lraylib -lmsvcrt -lopengl32 -lgdi32 -lkernel32 -lshell32 -luser32 -lwinmm -Wl,-subsystem=gui -std=c99 -run
\ No newline at end of file
@@ -0,0 +1,2 @@
+tcc -o latency_harness.exe latency_harness.c -Iinclude -I../dsp -lmsvcrt -lkernel32 -lwinmm -std=c99
+tcc -o pitch_bench.exe pitch_bench.c -Iinclude -I../dsp -lmsvcrt -lkernel32 -std=c99
\ No newline at end of file
@@ -0,0 +1,11 @@
+#!/bin/sh
+# Headless tools: no window, no raylib library, so they build and run in CI.
+# DSP_FIXED=15 or 31 in the environment builds them with fixed-point wave
+# shapes (dsp/dsp_fixed.h).
+set -e
+cd "$(dirname "$0")"
+CommonFlags="-std=c99 -D_GNU_SOURCE -O2 -g -Wall -Wno-unused-function -Iinclude -I../dsp ${DSP_FIXED:+-DDSP_FIXED=$DSP_FIXED}"
+cc $CommonFlags -o latency_harness latency_harness.c -lm
+cc $CommonFlags -rdynamic -o rt_check rt_check.c -lm -ldl -lpthread
+cc $CommonFlags -o synth_render synth_render.c -lm -ldl -lpthread
+cc $CommonFlags -o pitch_bench pitch_bench.c -lm
@@ -0,0 +1,241 @@
+/* date = October 18th 2026 */
+
+#ifndef SYNTH_THREAD_H
+#define SYNTH_THREAD_H
+
+// Minimal cross-platform threads, atomics and timing for the audio and worker
+// threads. Win32 and pthreads only.
+
+#include "synth_platform.h"
+#include <stdbool.h>
+
+#ifdef _WIN32
+#include "minimal_windows.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+typedef void SynthThreadProc(void *user_data);
+
+typedef struct SynthSemaphore {
+#ifdef _WIN32
+    HANDLE handle;
+#else
+    sem_t handle;
+#endif
+} SynthSemaphore;
+
+typedef struct SynthThread {
+#ifdef _WIN32
+    HANDLE handle;
+#else
+    pthread_t handle;
+#endif
+    SynthThreadProc *proc;
+    void *user_data;
+} SynthThread;
+
+#ifdef _WIN32
+internal DWORD WINAPI
+SynthThreadEntry(void *param)
+{
+    SynthThread *thread = (SynthThread *)param;
+    thread->proc(thread->user_data);
+    return 0;
+}
+#else
+internal void *
+SynthThreadEntry(void *param)
+{
+    SynthThread *thread = (SynthThread *)param;
+    thread->proc(thread->user_data);
+    return 0;
+}
+#endif
+
+// thread must stay alive until SynthThreadJoin returns.
+internal bool
+SynthThreadStart(SynthThread *thread, SynthThreadProc *proc, void *user_data)
+{
+    thread->proc = proc;
+    thread->user_data = user_data;
+#ifdef _WIN32
+    thread->handle = CreateThread(0, 0, SynthThreadEntry, thread, 0, 0);
+    return thread->handle != 0;
+#else
+    return pthread_create(&thread->handle, 0, SynthThreadEntry, thread) == 0;
+#endif
+}
+
+internal void
+SynthThreadJoin(SynthThread *thread)
+{
+#ifdef _WIN32
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+#else
+    pthread_join(thread->handle, 0);
+#endif
+}
+
+internal void
+SynthThreadYield(void)
+{
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+// A spin-wait hint to the CPU. Unlike SynthThreadYield it never enters the
+// kernel, so the audio thread can use it while waiting on workers.
+internal void
+SynthThreadPause(void)
+{
+#if defined(_MSC_VER)
+    _mm_pause();
+#elif defined(__i386__) || defined(__x86_64__)
+    __asm__ __volatile__("pause");
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+internal void
+SynthSemaphoreInit(SynthSemaphore *semaphore)
+{
+#ifdef _WIN32
+    semaphore->handle = CreateSemaphoreA(0, 0, 0x7fffffff, 0);
+#else
+    sem_init(&semaphore->handle, 0, 0);
+#endif
+}
+
+internal void
+SynthSemaphoreDestroy(SynthSemaphore *semaphore)
+{
+#ifdef _WIN32
+    CloseHandle(semaphore->handle);
+#else
+    sem_destroy(&semaphore->handle);
+#endif
+}
+
+// Never blocks, so it's fine to call from the audio thread.
+internal void
+SynthSemaphorePost(SynthSemaphore *semaphore, u32 count)
+{
+#ifdef _WIN32
+    ReleaseSemaphore(semaphore->handle, (LONG)count, 0);
+#else
+    for (u32 i = 0; i < count; i++) sem_post(&semaphore->handle);
+#endif
+}
+
+internal void
+SynthSemaphoreWait(SynthSemaphore *semaphore)
+{
+#ifdef _WIN32
+    WaitForSingleObject(semaphore->handle, INFINITE);
+#else
+    while (sem_wait(&semaphore->handle) != 0) {} // retry on EINTR.
+#endif
+}
+
+// Raises the calling thread to real-time priority (SCHED_FIFO on Linux, which
+// needs CAP_SYS_NICE or an rtprio limit). Returns false if the OS refused.
+internal bool
+SynthThreadSetRealtime(i32 priority)
+{
+#ifdef _WIN32
+    return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) != 0;
+#else
+    struct sched_param param = {0};
+    param.sched_priority = priority;
+    return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+#endif
+}
+
+// Pins the calling thread to one CPU. Returns false if unsupported or refused.
+internal bool
+SynthThreadPinToCpu(i32 cpu)
+{
+#if defined(_WIN32)
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) != 0;
+#elif defined(__linux__) && defined(_GNU_SOURCE)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+internal u32
+SynthCpuCount(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (u32)info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0) ? (u32)count : 1;
+#endif
+}
+
+// Monotonic wall clock in seconds.
+internal f64
+SynthTimeSeconds(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (f64)counter.QuadPart / (f64)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (f64)now.tv_sec + (f64)now.tv_nsec * 1e-9;
+#endif
+}
+
+internal void
+SynthSleepUntil(f64 time)
+{
+    f64 remaining = time - SynthTimeSeconds();
+    if (remaining <= 0.0) return;
+#ifdef _WIN32
+    Sleep((DWORD)(remaining * 1000.0));
+#else
+    struct timespec deadline;
+    deadline.tv_sec = (time_t)time;
+    deadline.tv_nsec = (long)((time - (f64)deadline.tv_sec) * 1e9);
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, 0);
+#endif
+}
+
+// @atomics
+// Sequentially consistent; only used for flags, counters and indices.
+#ifdef _WIN32
+#define AtomicLoadU32(ptr) ((u32)InterlockedCompareExchange((volatile LONG *)(ptr), 0, 0))
+#define AtomicStoreU32(ptr, value) InterlockedExchange((volatile LONG *)(ptr), (LONG)(value))
+#define AtomicExchangeU32(ptr, value) ((u32)InterlockedExchange((volatile LONG *)(ptr), (LONG)(value)))
+#define AtomicAddU32(ptr, value) ((u32)InterlockedExchangeAdd((volatile LONG *)(ptr), (LONG)(value)) + (value))
+#else
+#define AtomicLoadU32(ptr) __atomic_load_n((ptr), __ATOMIC_SEQ_CST)
+#define AtomicStoreU32(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_SEQ_CST)
+#define AtomicExchangeU32(ptr, value) __atomic_exchange_n((ptr), (value), __ATOMIC_SEQ_CST)
+#define AtomicAddU32(ptr, value) __atomic_add_fetch((ptr), (value), __ATOMIC_SEQ_CST)
+#endif
+
+#endif //SYNTH_THREAD_H
@@ -0,0 +1,414 @@
+// Headless MIDI-in to audio-out latency harness.
+//
+// Note events are pushed through a virtual MIDI port with timestamps, the real
+// engine (midi handler, ApplyUiState, SynthRenderBlock) renders them, and the
+// stream the device would have played is captured into an audio sink. Each
+// note's onset is then found in the captured audio and compared with the time
+// the event was sent.
+//
+// Time is simulated rather than read from a clock, so results are repeatable
+// and the harness runs anywhere, CI included. Two threading modes are modelled:
+//
+//   ui:       what synth.c does today. Once per UI frame the stream is polled,
+//             one block is rendered if the device has room, then ApplyUiState
+//             picks up the MIDI keys for the *next* block.
+//   callback: the device pulls a block every period and the render call applies
+//             the MIDI keys right before rendering, as an audio thread would.
+//
+// Usage: latency_harness [--blocks 128,256,512,1024] [--modes ui,callback]
+//                        [--periods 2] [--fps 60] [--notes 200] [--seed 1]
+//                        [--wav DIR] [--csv FILE]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "midi.h"
+#include "synth_engine.h"
+#include "audio_sink.h"
+
+#define MAX_CONFIG_VALUES 16
+#define MAX_NOTES 4096
+#define NOTE_SPACING_SECONDS 0.25
+#define NOTE_HOLD_SECONDS 0.1
+#define ONSET_THRESHOLD 0.1f
+#define ONSET_REARM_SECONDS 0.05 // silence needed before another onset counts.
+
+typedef enum ThreadMode {
+    ThreadMode_UI = 0,
+    ThreadMode_CALLBACK = 1,
+    ThreadMode_COUNT
+} ThreadMode;
+
+global const char *thread_mode_names[ThreadMode_COUNT] = {"ui", "callback"};
+
+typedef struct HarnessConfig {
+    ThreadMode mode;
+    u32 block_size;
+    u32 periods;
+    f64 ui_fps;
+    u32 note_count;
+    u32 seed;
+} HarnessConfig;
+
+// Follows the captured stream and records where notes start.
+typedef struct OnsetDetector {
+    u64 silent_run;
+    u64 rearm_samples;
+    u64 onsets[MAX_NOTES];
+    u32 onset_count;
+} OnsetDetector;
+
+typedef struct LatencyStats {
+    u32 detected;
+    u32 missed;
+    u32 underruns;
+    f64 min, mean, p50, p95, p99, max, jitter;
+} LatencyStats;
+
+// Simulated output device. written is the stream position the next block will
+// land at; the device plays one sample every 1/SAMPLE_RATE seconds whether or
+// not anything was written in time.
+typedef struct SimDevice {
+    u64 written;
+    u32 block_size;
+    u32 periods;
+    u32 underruns;
+    AudioSink *sink;
+    OnsetDetector *detector;
+} SimDevice;
+
+internal void
+OnsetDetectorFeed(OnsetDetector *detector, const f32 *samples, usize count, u64 stream_pos)
+{
+    for (usize t = 0; t < count; t++)
+    {
+        if (fabsf(samples[t]) > ONSET_THRESHOLD)
+        {
+            if (detector->silent_run >= detector->rearm_samples &&
+                detector->onset_count < MAX_NOTES)
+            {
+                detector->onsets[detector->onset_count++] = stream_pos + t;
+            }
+            detector->silent_run = 0;
+        }
+        else
+        {
+            detector->silent_run += 1;
+        }
+    }
+}
+
+internal u64
+SimDevicePlayed(f64 time)
+{
+    // Nudged so a tick that lands exactly on a period boundary isn't rounded
+    // down a sample by floating point error.
+    return (u64)(time * SAMPLE_RATE + 1e-6);
+}
+
+internal bool
+SimDeviceHasRoom(SimDevice *device, f64 time)
+{
+    u64 played = SimDevicePlayed(time);
+    if (device->written <= played) return true;
+    return (device->written - played) <= (u64)(device->periods - 1) * device->block_size;
+}
+
+internal void
+SimDeviceSubmit(SimDevice *device, f64 time, const f32 *samples)
+{
+    u64 played = SimDevicePlayed(time);
+    if (device->written < played)
+    {
+        // The device ran dry and played silence until this block arrived.
+        if (device->written > 0) device->underruns += 1;
+        AudioSinkWriteSilence(device->sink, played - device->written);
+        device->detector->silent_run += played - device->written;
+        device->written = played;
+    }
+    AudioSinkWrite(device->sink, samples, device->block_size);
+    OnsetDetectorFeed(device->detector, samples, device->block_size, device->written);
+    device->written += device->block_size;
+}
+
+internal int
+CompareF64(const void *a, const void *b)
+{
+    f64 x = *(const f64 *)a;
+    f64 y = *(const f64 *)b;
+    return (x > y) - (x < y);
+}
+
+internal f64
+Percentile(f64 *sorted, u32 count, f64 p)
+{
+    u32 index = (u32)(p * (count - 1) + 0.5);
+    return sorted[index];
+}
+
+internal LatencyStats
+RunConfig(HarnessConfig *config, AudioSink *sink, FILE *csv)
+{
+    LatencyStats stats = {0};
+
+    f32 *signal = (f32 *)calloc(STREAM_BUFFER_SIZE, sizeof(f32));
+    Synth *synth = (Synth *)malloc(sizeof(Synth));
+    SynthInit(synth, signal, config->block_size);
+    synth->ui_oscillator_count = 1;
+    UiOscillator *ui_osc = &synth->ui_oscillator[0];
+    // A square wave is at full level from its first sample, so the onset can be
+    // found to the sample whatever phase the oscillator slot was left at.
+    ui_osc->shape = WaveShape_SQUARE;
+    ui_osc->freq = BASE_NOTE_FREQ;
+    ui_osc->amplitude_ratio = 0.5f;
+    ui_osc->shape_parameter_0 = 0.5f;
+
+    MidiChannelKeys keys;
+    SynthMidiChannelKeysInit(&keys);
+    MidiVirtualPort port;
+    SynthMidiVirtualOpen(&port, &keys);
+
+    OnsetDetector *detector = (OnsetDetector *)calloc(1, sizeof(OnsetDetector));
+    detector->rearm_samples = (u64)(ONSET_REARM_SECONDS * SAMPLE_RATE);
+    detector->silent_run = detector->rearm_samples;
+
+    SimDevice device = {0};
+    device.block_size = config->block_size;
+    device.periods = config->periods;
+    device.sink = sink;
+    device.detector = detector;
+
+    // Note-ons land at a random offset inside each slot so they are spread
+    // evenly over block and frame boundaries. Each note is released well
+    // before the next slot, so the events are already in time order.
+    f64 note_on_times[MAX_NOTES];
+    MidiVirtualEvent events[MAX_NOTES * 2];
+    u32 note_count = (config->note_count < MAX_NOTES) ? config->note_count : MAX_NOTES;
+    srand(config->seed);
+    for (u32 note_i = 0; note_i < note_count; note_i++)
+    {
+        f64 slot_start = 0.1 + note_i * NOTE_SPACING_SECONDS;
+        f64 offset = ((f64)rand() / RAND_MAX) * (NOTE_SPACING_SECONDS - NOTE_HOLD_SECONDS) * 0.5;
+        note_on_times[note_i] = slot_start + offset;
+        events[note_i*2 + 0].message = SynthMidiPackMessage(KEY_ON, BASE_MIDI_NOTE, 100);
+        events[note_i*2 + 0].timestamp = note_on_times[note_i];
+        events[note_i*2 + 1].message = SynthMidiPackMessage(KEY_OFF, BASE_MIDI_NOTE, 0);
+        events[note_i*2 + 1].timestamp = note_on_times[note_i] + NOTE_HOLD_SECONDS;
+    }
+    const u32 event_count = note_count * 2;
+    const f64 end_time = 0.1 + (note_count + 1) * NOTE_SPACING_SECONDS;
+
+    const f64 tick_dt = (config->mode == ThreadMode_UI)
+        ? 1.0 / config->ui_fps
+        : (f64)config->block_size / SAMPLE_RATE;
+    u32 next_event = 0;
+    for (u64 tick = 0; tick * tick_dt < end_time; tick++)
+    {
+        const f64 now = tick * tick_dt;
+        // Feed the virtual port everything sent up to now, as the driver would.
+        while (next_event < event_count && events[next_event].timestamp <= now)
+        {
+            SynthMidiVirtualSend(&port, events[next_event].message, events[next_event].timestamp);
+            next_event += 1;
+        }
+        SynthMidiVirtualDeliver(&port, now);
+
+        if (config->mode == ThreadMode_UI)
+        {
+            // HandleAudioStream, then ApplyUiState, like the main loop.
+            if (SimDeviceHasRoom(&device, now))
+            {
+                SynthRenderBlock(synth, config->block_size);
+                SimDeviceSubmit(&device, now, synth->signal);
+            }
+            ApplyUiState(synth, &keys.channel[0]);
+        }
+        else
+        {
+            // Keep the device's periods full, applying state per block.
+            while (SimDeviceHasRoom(&device, now))
+            {
+                ApplyUiState(synth, &keys.channel[0]);
+                SynthRenderBlock(synth, config->block_size);
+                SimDeviceSubmit(&device, now, synth->signal);
+            }
+        }
+    }
+
+    f64 *latencies = (f64 *)malloc(sizeof(f64) * (note_count + 1));
+    u32 onset_i = 0;
+    for (u32 note_i = 0; note_i < note_count; note_i++)
+    {
+        // Take the first onset after this note-on that comes before the next
+        // slot; anything else means the note never made it out.
+        f64 note_time = note_on_times[note_i];
+        while (onset_i < detector->onset_count &&
+               (f64)detector->onsets[onset_i] / SAMPLE_RATE < note_time)
+        {
+            onset_i += 1;
+        }
+        f64 onset_time = (onset_i < detector->onset_count)
+            ? (f64)detector->onsets[onset_i] / SAMPLE_RATE : -1.0;
+        if (onset_time < 0.0 || onset_time - note_time >= NOTE_SPACING_SECONDS)
+        {
+            stats.missed += 1;
+            continue;
+        }
+        f64 latency_ms = (onset_time - note_time) * 1000.0;
+        latencies[stats.detected++] = latency_ms;
+        onset_i += 1;
+        if (csv)
+        {
+            fprintf(csv, "%s,%u,%u,%u,%.6f,%.6f,%.3f\n",
+                    thread_mode_names[config->mode], config->block_size, config->periods,
+                    note_i, note_time, onset_time, latency_ms);
+        }
+    }
+
+    stats.underruns = device.underruns;
+    if (stats.detected > 0)
+    {
+        f64 sum = 0.0;
+        for (u32 i = 0; i < stats.detected; i++) sum += latencies[i];
+        stats.mean = sum / stats.detected;
+        f64 variance = 0.0;
+        for (u32 i = 0; i < stats.detected; i++)
+        {
+            f64 d = latencies[i] - stats.mean;
+            variance += d * d;
+        }
+        stats.jitter = sqrt(variance / stats.detected);
+        qsort(latencies, stats.detected, sizeof(f64), CompareF64);
+        stats.min = latencies[0];
+        stats.max = latencies[stats.detected - 1];
+        stats.p50 = Percentile(latencies, stats.detected, 0.50);
+        stats.p95 = Percentile(latencies, stats.detected, 0.95);
+        stats.p99 = Percentile(latencies, stats.detected, 0.99);
+    }
+
+    free(latencies);
+    free(detector);
+    free(synth);
+    free(signal);
+    return stats;
+}
+
+internal u32
+ParseList(const char *text, u32 *values, u32 max_values)
+{
+    u32 count = 0;
+    while (*text && count < max_values)
+    {
+        values[count++] = (u32)strtoul(text, (char **)&text, 10);
+        if (*text == ',') text++;
+        else break;
+    }
+    return count;
+}
+
+i32
+main(i32 argc, char **argv)
+{
+    u32 block_sizes[MAX_CONFIG_VALUES] = {128, 256, 512, 1024};
+    u32 block_size_count = 4;
+    bool modes[ThreadMode_COUNT] = {true, true};
+    HarnessConfig base = {0};
+    base.periods = 2;
+    base.ui_fps = 60.0;
+    base.note_count = 200;
+    base.seed = 1;
+    const char *wav_dir = 0;
+    const char *csv_path = 0;
+
+    for (i32 arg_i = 1; arg_i < argc; arg_i++)
+    {
+        const char *arg = argv[arg_i];
+        const char *value = (arg_i + 1 < argc) ? argv[arg_i + 1] : "";
+        if (strcmp(arg, "--blocks") == 0)
+        {
+            block_size_count = ParseList(value, block_sizes, MAX_CONFIG_VALUES);
+            arg_i++;
+        }
+        else if (strcmp(arg, "--modes") == 0)
+        {
+            modes[ThreadMode_UI] = strstr(value, "ui") != 0;
+            modes[ThreadMode_CALLBACK] = strstr(value, "callback") != 0;
+            arg_i++;
+        }
+        else if (strcmp(arg, "--periods") == 0) { base.periods = (u32)atoi(value); arg_i++; }
+        else if (strcmp(arg, "--fps") == 0) { base.ui_fps = atof(value); arg_i++; }
+        else if (strcmp(arg, "--notes") == 0) { base.note_count = (u32)atoi(value); arg_i++; }
+        else if (strcmp(arg, "--seed") == 0) { base.seed = (u32)atoi(value); arg_i++; }
+        else if (strcmp(arg, "--wav") == 0) { wav_dir = value; arg_i++; }
+        else if (strcmp(arg, "--csv") == 0) { csv_path = value; arg_i++; }
+        else
+        {
+            printf("Unknown argument: %s\n", arg);
+            return 2;
+        }
+    }
+
+    for (u32 i = 0; i < block_size_count; i++)
+    {
+        if (block_sizes[i] == 0 || block_sizes[i] > STREAM_BUFFER_SIZE)
+        {
+            printf("Block size %u must be between 1 and %d.\n", block_sizes[i], STREAM_BUFFER_SIZE);
+            return 2;
+        }
+    }
+    if (base.periods < 1) base.periods = 1;
+
+    FILE *csv = 0;
+    if (csv_path)
+    {
+        csv = fopen(csv_path, "w");
+        if (!csv)
+        {
+            printf("Could not open %s for writing.\n", csv_path);
+            return 2;
+        }
+        fprintf(csv, "mode,block,periods,note,sent_s,onset_s,latency_ms\n");
+    }
+
+    printf("%-9s %6s %7s %6s %6s %9s %9s %9s %9s %9s %9s %9s %9s\n",
+           "mode", "block", "periods", "notes", "missed", "underrun",
+           "min_ms", "mean_ms", "p50_ms", "p95_ms", "p99_ms", "max_ms", "jitter_ms");
+
+    i32 exit_code = 0;
+    for (u32 mode = 0; mode < ThreadMode_COUNT; mode++)
+    {
+        if (!modes[mode]) continue;
+        for (u32 block_i = 0; block_i < block_size_count; block_i++)
+        {
+            HarnessConfig config = base;
+            config.mode = (ThreadMode)mode;
+            config.block_size = block_sizes[block_i];
+
+            AudioSink sink;
+            if (wav_dir)
+            {
+                char path[1024];
+                snprintf(path, sizeof(path), "%s/latency_%s_%u.wav",
+                         wav_dir, thread_mode_names[mode], config.block_size);
+                if (!AudioSinkOpenWav(&sink, path, SAMPLE_RATE)) return 2;
+            }
+            else
+            {
+                AudioSinkOpenNull(&sink, SAMPLE_RATE);
+            }
+
+            LatencyStats stats = RunConfig(&config, &sink, csv);
+            AudioSinkClose(&sink);
+
+            printf("%-9s %6u %7u %6u %6u %9u %9.2f %9.2f %9.2f %9.2f %9.2f %9.2f %9.2f\n",
+                   thread_mode_names[mode], config.block_size, config.periods,
+                   stats.detected, stats.missed, stats.underruns,
+                   stats.min, stats.mean, stats.p50, stats.p95, stats.p99, stats.max, stats.jitter);
+            if (stats.missed > 0) exit_code = 1;
+        }
+    }
+
+    if (csv) fclose(csv);
+    return exit_code;
+}
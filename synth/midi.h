@@ -1,15 +1,23 @@
+#ifndef MIDI_H
+#define MIDI_H
+
 #include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#ifdef _WIN32
 #include "minimal_windows.h"
+#endif
 #include "synth_platform.h"
 
-typedef MIDIINCAPS MidiDeviceInfo;
-typedef HMIDIIN MidiHandle;
-
-#define KEY_ON 144
+#define KEY_ON 144 // status bytes carry the channel in their low nibble.
 #define KEY_OFF 128
+#define MIDI_STATUS_MASK 0xF0
+#define MIDI_CHANNEL_MASK 0x0F
+#define MIDI_CHANNEL_COUNT 16
 #define BASE_MIDI_NOTE 69 // A4
 #define MAX_MIDI_VELOCITY 127.f
 #define POLYPHONIC_COUNT 16
+#define MIDI_VIRTUAL_QUEUE_SIZE 256
 
 // @midi
 typedef union MidiMessage
@@ -34,56 +42,179 @@ typedef struct MidiKeyArray
 } MidiKeyArray;
 
 // @midi
-internal void CALLBACK 
-SynthMidiHandler(MidiHandle midi, u32 msg_type, u32 *user_data, u32 param1, u32 param2)
+// One voice pool per MIDI channel, so each part of the synth plays only the
+// notes sent on its channel.
+typedef struct MidiChannelKeys
 {
-    switch(msg_type)
+    MidiKeyArray channel[MIDI_CHANNEL_COUNT];
+} MidiChannelKeys;
+
+// @midi
+// A timestamped short message waiting in a virtual port.
+typedef struct MidiVirtualEvent
+{
+    u32 message;
+    f64 timestamp;
+} MidiVirtualEvent;
+
+// @midi
+// Stand-in for a MIDI driver. Events are queued with the time they "arrive"
+// and delivered through the same message handler as a real device, so tools
+// can drive the synth without any hardware.
+typedef struct MidiVirtualPort
+{
+    MidiVirtualEvent events[MIDI_VIRTUAL_QUEUE_SIZE];
+    u32 read_index;
+    u32 write_index;
+    MidiChannelKeys *keys;
+} MidiVirtualPort;
+
+#ifdef _WIN32
+typedef MIDIINCAPS MidiDeviceInfo;
+typedef HMIDIIN MidiHandle;
+#else
+typedef MidiVirtualPort *MidiHandle;
+#endif
+
+// @midi
+internal u32
+SynthMidiPackMessage(u8 status, u8 data1, u8 data2)
+{
+    MidiMessage msg = {0};
+    msg.data[0] = status;
+    msg.data[1] = data1;
+    msg.data[2] = data2;
+    return msg.message;
+}
+
+// @midi
+internal void
+SynthMidiChannelKeysInit(MidiChannelKeys *keys)
+{
+    memset(keys, 0, sizeof(MidiChannelKeys));
+    for (u32 channel = 0; channel < MIDI_CHANNEL_COUNT; channel++)
     {
-        case MIM_DATA: {
-            MidiKeyArray *keys = (MidiKeyArray*)user_data;
-            MidiMessage msg = {param1};
-            u8 midi_event = msg.data[0];
-            u8 midi_note = msg.data[1];
-            u8 midi_velocity = msg.data[2];
-            u32 midi_timestamp = param2;
-            
-            if (midi_event == KEY_ON)
+        keys->channel[channel].count = ArrayCount(keys->channel[channel].data);
+    }
+}
+
+// @midi
+// Applies a note on/off to one voice pool, whatever channel it was sent on.
+// A note on with zero velocity is a note off.
+internal void
+SynthMidiHandleMessage(MidiKeyArray *keys, u32 message)
+{
+    MidiMessage msg = {message};
+    u8 midi_event = msg.data[0] & MIDI_STATUS_MASK;
+    u8 midi_note = msg.data[1];
+    u8 midi_velocity = msg.data[2];
+    if (midi_event == KEY_ON && midi_velocity == 0)
+    {
+        midi_event = KEY_OFF;
+    }
+
+    if (midi_event == KEY_ON)
+    {
+        MidiKey *key = 0;
+        for (u32 i = 0; i < keys->count; i++)
+        {
+            if (keys->data[i].is_on == 0)
             {
-                MidiKey *key = 0;
-                for (u32 i = 0; i < keys->count; i++)
-                {
-                    if (keys->data[i].is_on == 0)
-                    {
-                        key = keys->data + i;
-                        break;
-                    }
-                }
-                if (key)
-                {
-                    key->is_on = 1;
-                    key->note = midi_note;
-                    key->velocity_ratio = (f32)midi_velocity / MAX_MIDI_VELOCITY;
-                }
+                key = keys->data + i;
+                break;
             }
-            else if (midi_event == KEY_OFF)
+        }
+        if (key)
+        {
+            key->is_on = 1;
+            key->note = midi_note;
+            key->velocity_ratio = (f32)midi_velocity / MAX_MIDI_VELOCITY;
+        }
+    }
+    else if (midi_event == KEY_OFF)
+    {
+        for (u32 i = 0; i < keys->count; i++)
+        {
+            if (keys->data[i].is_on && keys->data[i].note == midi_note)
             {
-                MidiKey *key = 0;
-                for (u32 i = 0; i < keys->count; i++)
-                {
-                    if (keys->data[i].is_on && keys->data[i].note == midi_note)
-                    {
-                        keys->data[i].is_on = false;
-                        break;
-                    }
-                }
+                keys->data[i].is_on = false;
+                break;
             }
+        }
+    }
+}
+
+// @midi
+// Hands a message to the voice pool of the channel it was sent on. System
+// messages (0xF0 and up) have no channel and are ignored.
+internal void
+SynthMidiRouteMessage(MidiChannelKeys *keys, u32 message)
+{
+    MidiMessage msg = {message};
+    if (msg.data[0] >= 0xF0) return;
+    SynthMidiHandleMessage(&keys->channel[msg.data[0] & MIDI_CHANNEL_MASK], message);
+}
+
+// @midi
+internal void
+SynthMidiVirtualOpen(MidiVirtualPort *port, MidiChannelKeys *keys)
+{
+    port->read_index = 0;
+    port->write_index = 0;
+    port->keys = keys;
+}
+
+// @midi
+// Returns false when the queue is full and the event was dropped.
+internal bool
+SynthMidiVirtualSend(MidiVirtualPort *port, u32 message, f64 timestamp)
+{
+    if (port->write_index - port->read_index >= MIDI_VIRTUAL_QUEUE_SIZE)
+    {
+        return false;
+    }
+    MidiVirtualEvent *event = &port->events[port->write_index % MIDI_VIRTUAL_QUEUE_SIZE];
+    event->message = message;
+    event->timestamp = timestamp;
+    port->write_index += 1;
+    return true;
+}
+
+// @midi
+// Hands every queued event whose timestamp is <= now to the message handler,
+// in the order they were sent. Returns the number of events delivered.
+internal u32
+SynthMidiVirtualDeliver(MidiVirtualPort *port, f64 now)
+{
+    u32 delivered = 0;
+    while (port->read_index != port->write_index)
+    {
+        MidiVirtualEvent *event = &port->events[port->read_index % MIDI_VIRTUAL_QUEUE_SIZE];
+        if (event->timestamp > now) break;
+        SynthMidiRouteMessage(port->keys, event->message);
+        port->read_index += 1;
+        delivered += 1;
+    }
+    return delivered;
+}
+
+#ifdef _WIN32
+// @midi
+internal void CALLBACK 
+SynthMidiHandler(MidiHandle midi, u32 msg_type, u32 *user_data, u32 param1, u32 param2)
+{
+    switch(msg_type)
+    {
+        case MIM_DATA: {
+            MidiChannelKeys *keys = (MidiChannelKeys*)user_data;
+            SynthMidiRouteMessage(keys, param1);
             break;
         }
     }
 }
 
 MidiHandle
-SynthMidiInit(u32 selected_device_id, MidiKeyArray *keys)
+SynthMidiInit(u32 selected_device_id, MidiChannelKeys *keys)
 {
     u32 num_midi_devices = midiInGetNumDevs();
     for(u32 device_id = 0; device_id < num_midi_devices; device_id++)
@@ -139,3 +270,24 @@ SynthMidiStop(MidiHandle midi)
         return;
     }
 }
+#else
+// No native MIDI input outside of Windows yet, so the synth listens on a
+// virtual port that tools can push events into.
+global MidiVirtualPort midi_virtual_port;
+
+MidiHandle
+SynthMidiInit(u32 selected_device_id, MidiChannelKeys *keys)
+{
+    SynthMidiVirtualOpen(&midi_virtual_port, keys);
+    printf("MIDI device: virtual port %d\n", selected_device_id);
+    return &midi_virtual_port;
+}
+
+void
+SynthMidiStop(MidiHandle midi)
+{
+    midi->read_index = midi->write_index;
+}
+#endif
+
+#endif //MIDI_H
@@ -0,0 +1,259 @@
+/* date = October 18th 2026 */
+
+#ifndef NOTE_CACHE_H
+#define NOTE_CACHE_H
+
+// Note render cache for static oscillators.
+//
+// An oscillator nothing modulates has a fixed frequency and shape for the whole
+// block, so its output is one cycle repeated. Instead of running the shape
+// function per sample, the cache renders that cycle once into a table and
+// later blocks read it back with linear interpolation. The table is the shape
+// function sampled with the note's own phase_dt, so the PolyBLEP corrections
+// at its edges are as wide as when rendered live; it isn't band-limited any
+// further than that. Playback steps osc->phase_ratio exactly like UpdatePhase, so
+// an oscillator can move between cached and live rendering without a phase
+// jump.
+//
+// A table costs NOTE_CACHE_TABLE_SIZE shape evaluations, several blocks' worth
+// of one live oscillator, and a chord onset misses on every voice at once. So
+// each block renders at most NOTE_CACHE_FILLS_PER_BLOCK tables; the other
+// misses are rendered live that block and tried again on the next, and the
+// onset block costs no more than live rendering plus that many tables.
+//
+// Entries are keyed by (ui oscillator, shape, note in cents, shape parameter)
+// and live in fixed-size slots carved out of one allocation made up front, so
+// a miss in the audio path never allocates. When the slots run out the least
+// recently used entry is evicted. NoteCacheSyncUi drops every entry of a ui
+// oscillator whose shape, pitch or shape parameter changed; amplitude is applied
+// on playback and doesn't invalidate anything.
+//
+// Included by synth_engine.h after the oscillator types.
+
+#define NOTE_CACHE_TABLE_SIZE 2048 // power of two; one cycle per table.
+#define NOTE_CACHE_MAX_ENTRIES 1024
+#define NOTE_CACHE_DEFAULT_BUDGET Megabytes(2)
+#define NOTE_CACHE_FILLS_PER_BLOCK 1
+
+typedef struct NoteCacheKey {
+    u16 ui_id;
+    u16 shape;
+    i32 cents;
+    i32 shape_param_milli;
+} NoteCacheKey;
+
+typedef struct NoteCacheEntry {
+    NoteCacheKey key;
+    bool is_used;
+    u64 last_used;
+    f32 *table;
+} NoteCacheEntry;
+
+// What each ui oscillator looked like when its entries were rendered.
+typedef struct NoteCacheUiSnapshot {
+    bool is_valid;
+    u16 shape;
+    i32 cents;
+    i32 shape_param_milli;
+} NoteCacheUiSnapshot;
+
+typedef struct NoteCache {
+    NoteCacheEntry entries[NOTE_CACHE_MAX_ENTRIES];
+    u32 entry_count;
+    f32 *tables;
+    u64 tick;
+    u32 fills_left; // in the current block.
+    NoteCacheUiSnapshot ui[MAX_UI_OSCILLATORS];
+
+    u32 hits;
+    u32 misses;
+    u32 deferrals;  // misses rendered live because the block's fills ran out.
+    u32 evictions;
+    u32 invalidations;
+} NoteCache;
+
+// Returns 0 if the budget can't hold a single table.
+internal NoteCache *
+NoteCacheCreate(usize budget_bytes)
+{
+    usize table_bytes = NOTE_CACHE_TABLE_SIZE * sizeof(f32);
+    usize entry_count = budget_bytes / table_bytes;
+    if (entry_count > NOTE_CACHE_MAX_ENTRIES) entry_count = NOTE_CACHE_MAX_ENTRIES;
+    if (entry_count == 0) return 0;
+
+    NoteCache *cache = (NoteCache *)calloc(1, sizeof(NoteCache));
+    cache->tables = (f32 *)malloc(entry_count * table_bytes);
+    cache->entry_count = (u32)entry_count;
+    for (u32 i = 0; i < cache->entry_count; i++)
+    {
+        cache->entries[i].table = cache->tables + (i * NOTE_CACHE_TABLE_SIZE);
+    }
+    return cache;
+}
+
+internal void
+NoteCacheDestroy(NoteCache *cache)
+{
+    if (!cache) return;
+    free(cache->tables);
+    free(cache);
+}
+
+internal i32
+NoteCacheCents(f32 freq)
+{
+    return (i32)floorf(SemitoneFromFrequency(freq) * 100.f + 0.5f);
+}
+
+internal i32
+NoteCacheShapeParamMilli(f32 shape_param)
+{
+    return (i32)floorf(shape_param * 1000.f + 0.5f);
+}
+
+internal void
+NoteCacheInvalidateUi(NoteCache *cache, u16 ui_id)
+{
+    for (u32 i = 0; i < cache->entry_count; i++)
+    {
+        NoteCacheEntry *entry = &cache->entries[i];
+        if (entry->is_used && entry->key.ui_id == ui_id)
+        {
+            entry->is_used = false;
+            cache->invalidations += 1;
+        }
+    }
+}
+
+// Call whenever the ui oscillators may have changed (ApplyUiState does).
+internal void
+NoteCacheSyncUi(NoteCache *cache, UiOscillator *ui_oscillators, usize ui_oscillator_count)
+{
+    for (usize ui_id = 0; ui_id < MAX_UI_OSCILLATORS; ui_id++)
+    {
+        NoteCacheUiSnapshot *snapshot = &cache->ui[ui_id];
+        NoteCacheUiSnapshot current = {0};
+        if (ui_id < ui_oscillator_count)
+        {
+            UiOscillator *ui_osc = &ui_oscillators[ui_id];
+            current.is_valid = true;
+            current.shape = (u16)ui_osc->shape;
+            current.cents = NoteCacheCents(ui_osc->freq);
+            current.shape_param_milli = NoteCacheShapeParamMilli(ui_osc->shape_parameter_0);
+        }
+
+        if (snapshot->is_valid != current.is_valid ||
+            snapshot->shape != current.shape ||
+            snapshot->cents != current.cents ||
+            snapshot->shape_param_milli != current.shape_param_milli)
+        {
+            if (snapshot->is_valid) NoteCacheInvalidateUi(cache, (u16)ui_id);
+            *snapshot = current;
+        }
+    }
+}
+
+internal bool
+NoteCacheKeyEquals(NoteCacheKey a, NoteCacheKey b)
+{
+    return (a.ui_id == b.ui_id &&
+            a.shape == b.shape &&
+            a.cents == b.cents &&
+            a.shape_param_milli == b.shape_param_milli);
+}
+
+internal void
+NoteCacheFill(NoteCacheEntry *entry, WaveShapeFn wave_shape_fn, f32 freq, f32 shape_param)
+{
+    const f32 phase_dt = freq * SAMPLE_DURATION;
+    for (u32 i = 0; i < NOTE_CACHE_TABLE_SIZE; i++)
+    {
+        f32 phase_ratio = (f32)i / NOTE_CACHE_TABLE_SIZE;
+        entry->table[i] = wave_shape_fn(phase_ratio, phase_dt, shape_param);
+    }
+}
+
+// Call at the start of every block (SynthRenderBlock does).
+internal void
+NoteCacheBeginBlock(NoteCache *cache)
+{
+    cache->fills_left = NOTE_CACHE_FILLS_PER_BLOCK;
+}
+
+// Finds the table for this oscillator, rendering it into a free or least
+// recently used slot on a miss. Returns 0 on a miss once the block has no
+// fills left.
+internal NoteCacheEntry *
+NoteCacheAcquire(NoteCache *cache, Oscillator *osc, WaveShape shape, WaveShapeFn wave_shape_fn)
+{
+    NoteCacheKey key;
+    key.ui_id = osc->ui_id;
+    key.shape = (u16)shape;
+    key.cents = NoteCacheCents(osc->freq);
+    key.shape_param_milli = NoteCacheShapeParamMilli(osc->shape_parameter_0);
+
+    cache->tick += 1;
+    NoteCacheEntry *victim = 0;
+    for (u32 i = 0; i < cache->entry_count; i++)
+    {
+        NoteCacheEntry *entry = &cache->entries[i];
+        if (!entry->is_used)
+        {
+            if (!victim || victim->is_used) victim = entry;
+            continue;
+        }
+        if (NoteCacheKeyEquals(entry->key, key))
+        {
+            entry->last_used = cache->tick;
+            cache->hits += 1;
+            return entry;
+        }
+        if (!victim || (victim->is_used && entry->last_used < victim->last_used))
+        {
+            victim = entry;
+        }
+    }
+
+    if (cache->fills_left == 0)
+    {
+        cache->deferrals += 1;
+        return 0;
+    }
+    cache->fills_left -= 1;
+    if (victim->is_used) cache->evictions += 1;
+    cache->misses += 1;
+    victim->key = key;
+    victim->is_used = true;
+    victim->last_used = cache->tick;
+    NoteCacheFill(victim, wave_shape_fn, osc->freq, osc->shape_parameter_0);
+    return victim;
+}
+
+// Returns false, having rendered nothing, if the oscillator has to be rendered
+// live this block.
+internal bool
+NoteCacheRenderOsc(NoteCache *cache, Oscillator *osc, WaveShape shape, WaveShapeFn wave_shape_fn,
+                   usize sample_count)
+{
+    NoteCacheEntry *entry = NoteCacheAcquire(cache, osc, shape, wave_shape_fn);
+    if (!entry) return false;
+    const f32 *table = entry->table;
+    for (usize t = 0; t < sample_count; t++)
+    {
+        UpdatePhase(&osc->phase_ratio,
+                    &osc->phase_dt,
+                    osc->freq,
+                    0.0f);
+
+        f32 position = osc->phase_ratio * NOTE_CACHE_TABLE_SIZE;
+        u32 index = (u32)position;
+        f32 frac = position - (f32)index;
+        index &= (NOTE_CACHE_TABLE_SIZE - 1);
+        u32 next_index = (index + 1) & (NOTE_CACHE_TABLE_SIZE - 1);
+        f32 sample = table[index] + (table[next_index] - table[index]) * frac;
+        osc->buffer[t] = sample * osc->amplitude_ratio;
+    }
+    return true;
+}
+
+#endif //NOTE_CACHE_H
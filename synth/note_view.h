@@ -0,0 +1,119 @@
+/* date = October 18th 2026 */
+
+#ifndef NOTE_VIEW_H
+#define NOTE_VIEW_H
+
+// Live note-bin display: a constant-Q transform of the output, one band per
+// semitone from C2 to C8, using the sparse kernels in
+// dsp/filterbank.h.
+//
+// The audio side pushes every rendered block into a ring; once per ui frame
+// NoteViewUpdate unrolls the newest NOTE_VIEW_FFT_SIZE samples and runs the
+// transform (one real FFT plus a sparse multiply, well under a millisecond).
+// The kernels end at the newest sample, so a note shows as soon as its
+// shortest kernel has seen it; the lowest notes need about a quarter of a
+// second. Levels are in dB and fall off at NOTE_VIEW_DECAY_DB per update so
+// the bars don't flicker.
+//
+// Push and update run on the same thread; with SYNTH_NATIVE_AUDIO the ui
+// pushes the scope copy instead, which can miss blocks.
+
+#include "dsp.h"
+#include "filterbank.h"
+
+#define NOTE_VIEW_FFT_SIZE 16384 // the C2 kernel is about 11300 samples at 44.1kHz.
+#define NOTE_VIEW_LOWEST_SEMITONE -33 // C2, relative to BASE_NOTE_FREQ.
+#define NOTE_VIEW_HIGHEST_SEMITONE 39 // C8.
+#define NOTE_VIEW_FLOOR_DB -80.0f
+#define NOTE_VIEW_DECAY_DB 1.5f
+
+global const char *note_view_names[12] = {"A", "A#", "B", "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#"};
+
+typedef struct NoteView {
+    f32 ring[NOTE_VIEW_FFT_SIZE];
+    u32 write_index;
+    f32 frame[NOTE_VIEW_FFT_SIZE];
+    filterbank filterbank;
+    u32 band_count;
+    f32 *bands;
+    f32 *levels_db;
+    u32 loudest_band;
+} NoteView;
+
+internal bool
+NoteViewInit(NoteView *view, fft_planner *planner, f32 sample_rate)
+{
+    memset(view, 0, sizeof(*view));
+    filterbank_config config = {0};
+    config.Kind = FilterbankKind_ConstantQ;
+    config.FFTSize = NOTE_VIEW_FFT_SIZE;
+    config.SampleRate = sample_rate;
+    config.MinFreq = FrequencyFromSemitone(NOTE_VIEW_LOWEST_SEMITONE);
+    config.MaxFreq = FrequencyFromSemitone(NOTE_VIEW_HIGHEST_SEMITONE + 0.5f);
+    view->filterbank = FilterbankCreate(planner, config);
+    view->band_count = view->filterbank.BandCount;
+    if (view->band_count == 0) return false;
+
+    view->bands = (f32 *)malloc(view->band_count * sizeof(f32));
+    view->levels_db = (f32 *)malloc(view->band_count * sizeof(f32));
+    for (u32 band_i = 0; band_i < view->band_count; band_i++) view->levels_db[band_i] = NOTE_VIEW_FLOOR_DB;
+    return true;
+}
+
+internal void
+NoteViewDestroy(NoteView *view)
+{
+    free(view->levels_db);
+    free(view->bands);
+    FilterbankDestroy(&view->filterbank);
+}
+
+internal void
+NoteViewPush(NoteView *view, f32 *samples, usize sample_count)
+{
+    for (usize i = 0; i < sample_count; i++)
+    {
+        view->ring[view->write_index] = samples[i];
+        view->write_index = (view->write_index + 1) % NOTE_VIEW_FFT_SIZE;
+    }
+}
+
+internal void
+NoteViewUpdate(NoteView *view)
+{
+    if (view->band_count == 0) return;
+
+    u32 older_count = NOTE_VIEW_FFT_SIZE - view->write_index;
+    memcpy(view->frame, view->ring + view->write_index, older_count * sizeof(f32));
+    memcpy(view->frame + older_count, view->ring, view->write_index * sizeof(f32));
+    FilterbankTransform(&view->filterbank, view->frame, view->bands);
+
+    view->loudest_band = 0;
+    for (u32 band_i = 0; band_i < view->band_count; band_i++)
+    {
+        f32 db = (view->bands[band_i] > 0.0f) ? DSPDecibelsFromAmplitude(view->bands[band_i]) : NOTE_VIEW_FLOOR_DB;
+        if (db < NOTE_VIEW_FLOOR_DB) db = NOTE_VIEW_FLOOR_DB;
+        f32 decayed = view->levels_db[band_i] - NOTE_VIEW_DECAY_DB;
+        view->levels_db[band_i] = (db > decayed) ? db : decayed;
+        if (view->bands[band_i] > view->bands[view->loudest_band]) view->loudest_band = band_i;
+    }
+}
+
+// Note name of a semitone relative to BASE_NOTE_FREQ, e.g. "C#4".
+internal const char *
+NoteName(i32 semitone, char *buffer, usize buffer_size)
+{
+    i32 name_i = ((semitone % 12) + 12) % 12;
+    // Octave numbers change at C, three semitones above A.
+    i32 octave = 4 + (i32)floorf((semitone + 9) / 12.0f);
+    snprintf(buffer, buffer_size, "%s%d", note_view_names[name_i], octave);
+    return buffer;
+}
+
+internal const char *
+NoteViewBandName(NoteView *view, u32 band_i, char *buffer, usize buffer_size)
+{
+    return NoteName(NOTE_VIEW_LOWEST_SEMITONE + (i32)band_i, buffer, buffer_size);
+}
+
+#endif //NOTE_VIEW_H
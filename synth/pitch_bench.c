@@ -0,0 +1,194 @@
+// Accuracy and CPU benchmark for the pitch tracker behind the synth's pitch
+// readout (dsp/pitch.h).
+//
+// Every wave shape plays single notes across the range through the real
+// engine (ApplyUiState, SynthRenderBlock), block by block, and each block
+// goes through the tracker exactly as the output tap feeds it. Once the
+// window is full of the note, every estimate is scored against the note's
+// frequency in cents: a note passes if the median is within
+// CENTS_TOLERANCE, none is off by more than GROSS_ERROR_CENTS (an octave or
+// fifth error) and all are confident. Chords are run too, for information:
+// a triad's "pitch" is its common fundamental, if it has one.
+//
+// CPU is the tracker's time per audio block against the block's duration.
+// Exits 1 if any note fails.
+//
+// Usage: pitch_bench [--window 2048] [--hop 512] [--seconds 0.5]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "midi.h"
+#include "synth_engine.h"
+#include "note_view.h"
+#include "pitch.h"
+
+#define LOWEST_NOTE 33 // A1, 55Hz.
+#define HIGHEST_NOTE 96 // C7, 2093Hz.
+#define NOTE_STEP 5
+#define CENTS_TOLERANCE 3.0f
+#define GROSS_ERROR_CENTS 50.0f
+#define MIN_CONFIDENCE 0.9f
+#define MAX_ESTIMATES 4096
+
+typedef struct ToneResult {
+    f32 median_cents;
+    f32 worst_cents;
+    f32 min_confidence;
+    f32 median_freq;
+    u32 estimate_count;
+} ToneResult;
+
+internal int
+CompareF32(const void *a, const void *b)
+{
+    f32 x = *(const f32 *)a;
+    f32 y = *(const f32 *)b;
+    return (x > y) - (x < y);
+}
+
+// Plays the notes on one shape for the given time and scores the estimates
+// made once the window has only seen the notes against expected_freq.
+internal ToneResult
+RunTone(Synth *synth, MidiKeyArray *keys, pitch_tracker *tracker, WaveShape shape,
+        u8 *notes, u32 note_count, f32 expected_freq, f64 seconds, f64 *tracker_seconds, u64 *block_count)
+{
+    synth->ui_oscillator[0].shape = shape;
+    for (u32 i = 0; i < note_count; i++) SynthMidiHandleMessage(keys, SynthMidiPackMessage(KEY_ON, notes[i], 100));
+    ApplyUiState(synth, keys);
+    PitchTrackerReset(tracker);
+
+    local_static f32 cents[MAX_ESTIMATES];
+    local_static f32 freqs[MAX_ESTIMATES];
+    ToneResult result = {0};
+    result.min_confidence = 1.0f;
+    u64 rendered = 0;
+    u64 total = (u64)(seconds * SAMPLE_RATE);
+    while (rendered < total)
+    {
+        SynthRenderBlock(synth, STREAM_BUFFER_SIZE);
+        f64 start = BenchSeconds();
+        bool updated = PitchTrackerPush(tracker, synth->signal, STREAM_BUFFER_SIZE);
+        *tracker_seconds += BenchSeconds() - start;
+        *block_count += 1;
+        rendered += STREAM_BUFFER_SIZE;
+        if (!updated || rendered < tracker->Config.WindowSize || result.estimate_count == MAX_ESTIMATES) continue;
+
+        pitch_estimate estimate = tracker->Estimate;
+        f32 error = (estimate.Freq > 0) ? 1200.0f * Log2f(estimate.Freq / expected_freq) : 1200.0f;
+        cents[result.estimate_count] = error;
+        freqs[result.estimate_count] = estimate.Freq;
+        result.estimate_count++;
+        if (fabsf(error) > fabsf(result.worst_cents)) result.worst_cents = error;
+        if (estimate.Confidence < result.min_confidence) result.min_confidence = estimate.Confidence;
+    }
+    if (result.estimate_count)
+    {
+        qsort(cents, result.estimate_count, sizeof(f32), CompareF32);
+        qsort(freqs, result.estimate_count, sizeof(f32), CompareF32);
+        result.median_cents = cents[result.estimate_count / 2];
+        result.median_freq = freqs[result.estimate_count / 2];
+    }
+
+    for (u32 i = 0; i < note_count; i++) SynthMidiHandleMessage(keys, SynthMidiPackMessage(KEY_OFF, notes[i], 0));
+    ApplyUiState(synth, keys);
+    return result;
+}
+
+i32
+main(i32 argc, char **argv)
+{
+    pitch_config config = {0};
+    config.SampleRate = SAMPLE_RATE;
+    f64 seconds = 0.5;
+    for (i32 arg_i = 1; arg_i < argc; arg_i++)
+    {
+        const char *arg = argv[arg_i];
+        const char *value = (arg_i + 1 < argc) ? argv[arg_i + 1] : "";
+        if (strcmp(arg, "--window") == 0) { config.WindowSize = (u32)atoi(value); arg_i++; }
+        else if (strcmp(arg, "--hop") == 0) { config.HopSize = (u32)atoi(value); arg_i++; }
+        else if (strcmp(arg, "--seconds") == 0) { seconds = atof(value); arg_i++; }
+        else
+        {
+            printf("Unknown argument: %s\n", arg);
+            return 2;
+        }
+    }
+
+    fft_planner planner = FFTPlannerCreate(FFTPlanner_Measure, 0);
+    pitch_tracker tracker = PitchTrackerCreate(&planner, config);
+    if (!tracker.Ring)
+    {
+        printf("The window has to hold two periods of the lowest note (%.0f Hz).\n", PITCH_MIN_FREQ);
+        return 2;
+    }
+    config = tracker.Config;
+    if (seconds * SAMPLE_RATE < 2 * config.WindowSize) seconds = 2.0 * config.WindowSize / SAMPLE_RATE;
+
+    f32 *signal = (f32 *)calloc(STREAM_BUFFER_SIZE, sizeof(f32));
+    Synth *synth = (Synth *)malloc(sizeof(Synth));
+    SynthInit(synth, signal, STREAM_BUFFER_SIZE);
+    synth->ui_oscillator_count = 1;
+    UiOscillator *ui_osc = &synth->ui_oscillator[0];
+    ui_osc->freq = BASE_NOTE_FREQ;
+    ui_osc->amplitude_ratio = 0.3f;
+    ui_osc->shape_parameter_0 = 0.5f;
+    MidiChannelKeys channel_keys;
+    SynthMidiChannelKeysInit(&channel_keys);
+    MidiKeyArray *keys = &channel_keys.channel[0];
+
+    printf("window %u, hop %u, FFT %u, %.0f-%.0f Hz, %u Hz\n\n", config.WindowSize, config.HopSize,
+           tracker.FFTSize, config.MinFreq, config.MaxFreq, SAMPLE_RATE);
+    printf("%-15s %5s %9s %8s %8s %6s\n", "shape", "note", "Hz", "median", "worst", "conf");
+    const char *shape_names[WaveShape_COUNT] = {"none", "sine", "sawtooth", "square", "triangle", "rounded square"};
+    f64 tracker_seconds = 0;
+    u64 block_count = 0;
+    u32 fail_count = 0;
+    u32 tone_count = 0;
+    char note_name[16];
+    for (u32 shape = WaveShape_SINE; shape < WaveShape_COUNT; shape++)
+    {
+        for (u32 note = LOWEST_NOTE; note <= HIGHEST_NOTE; note += NOTE_STEP)
+        {
+            u8 notes[1] = {(u8)note};
+            f32 freq = FrequencyFromSemitone((f32)note - BASE_MIDI_NOTE);
+            ToneResult result = RunTone(synth, keys, &tracker, (WaveShape)shape, notes, 1, freq, seconds,
+                                        &tracker_seconds, &block_count);
+            bool passed = (result.estimate_count > 0 && fabsf(result.median_cents) <= CENTS_TOLERANCE &&
+                           fabsf(result.worst_cents) <= GROSS_ERROR_CENTS && result.min_confidence >= MIN_CONFIDENCE);
+            fail_count += passed ? 0 : 1;
+            tone_count++;
+            printf("%-15s %5s %9.2f %+8.2f %+8.2f %6.3f  %s\n", shape_names[shape],
+                   NoteName((i32)note - BASE_MIDI_NOTE, note_name, sizeof(note_name)), freq,
+                   result.median_cents, result.worst_cents, result.min_confidence, passed ? "ok" : "FAILED");
+        }
+    }
+
+    // Chords: a major triad is 4:5:6, so its period is two octaves under the
+    // root; a minor triad (10:12:15) has nothing in range.
+    printf("\nchords, sawtooth (for information):\n");
+    u8 major[3] = {57, 61, 64};
+    u8 minor[3] = {57, 60, 64};
+    f32 root = FrequencyFromSemitone(57.0f - BASE_MIDI_NOTE);
+    ToneResult major_result = RunTone(synth, keys, &tracker, WaveShape_SAWTOOTH, major, 3, root / 4, seconds,
+                                      &tracker_seconds, &block_count);
+    ToneResult minor_result = RunTone(synth, keys, &tracker, WaveShape_SAWTOOTH, minor, 3, root, seconds,
+                                      &tracker_seconds, &block_count);
+    printf("  A3 major: median %.2f Hz (%+.1f cents from A1), confidence from %.3f\n",
+           major_result.median_freq, major_result.median_cents, major_result.min_confidence);
+    printf("  A3 minor: median %.2f Hz, confidence from %.3f\n", minor_result.median_freq, minor_result.min_confidence);
+
+    const f64 block_seconds = (f64)STREAM_BUFFER_SIZE / SAMPLE_RATE;
+    const f64 per_block = tracker_seconds / block_count;
+    printf("\n%u of %u notes ok\n", tone_count - fail_count, tone_count);
+    printf("tracker per %u-sample block: %.1fus (%.3f%% of the block), %.1fus per detection\n",
+           STREAM_BUFFER_SIZE, per_block * 1e6, 100.0 * per_block / block_seconds,
+           tracker_seconds / tracker.DetectCount * 1e6);
+
+    PitchTrackerDestroy(&tracker);
+    FFTPlannerDestroy(&planner);
+    free(synth);
+    free(signal);
+    return (fail_count == 0) ? 0 : 1;
+}
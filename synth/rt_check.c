@@ -0,0 +1,286 @@
+// Renders every wave shape and modulation combination with the real-time
+// safety checker active and fails if the audio path allocated, locked, did
+// stdio or made a blocking syscall. See rt_check.h.
+//
+// Build: build_tools.sh (Linux only).
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#define SYNTH_RTCHECK 1
+#include <stdio.h>
+#include <stdlib.h>
+#include "midi.h"
+#include "synth_engine.h"
+#include "synth_parts.h"
+#include "audio_output.h"
+#include "dsp.h"
+#include "pitch.h"
+
+global const u32 sweep_block_sizes[] = {64, 1024};
+global const f32 sweep_shape_params[] = {0.f, 0.5f, 1.f};
+global const u32 sweep_note_counts[] = {1, 4, POLYPHONIC_COUNT};
+
+internal void
+PressNotes(MidiKeyArray *keys, u32 note_count)
+{
+    for (u32 i = 0; i < keys->count; i++)
+    {
+        keys->data[i].is_on = 0;
+    }
+    for (u32 i = 0; i < note_count; i++)
+    {
+        SynthMidiHandleMessage(keys, SynthMidiPackMessage(KEY_ON, (u8)(BASE_MIDI_NOTE - 12 + i * 3), 100));
+    }
+}
+
+// Same order of work as an audio callback: pick up the keys, then render.
+internal void
+RenderBlocks(Synth *synth, MidiKeyArray *keys, u32 block_size, u32 block_count)
+{
+    for (u32 block_i = 0; block_i < block_count; block_i++)
+    {
+        RtScopeBegin();
+        ApplyUiState(synth, keys);
+        RtScopeEnd();
+        SynthRenderBlock(synth, block_size);
+    }
+}
+
+// Returns the number of combinations rendered.
+internal u32
+Sweep(Synth *synth, f32 *signal, MidiKeyArray *keys, NoteCache *note_cache)
+{
+    u32 combination_count = 0;
+    for (u32 carrier_shape = WaveShape_SINE; carrier_shape < WaveShape_COUNT; carrier_shape++)
+    {
+        // modulator_shape == WaveShape_NONE means the carrier is unmodulated.
+        for (u32 modulator_shape = WaveShape_NONE; modulator_shape < WaveShape_COUNT; modulator_shape++)
+        {
+            for (u32 param_i = 0; param_i < ArrayCount(sweep_shape_params); param_i++)
+            {
+                for (u32 notes_i = 0; notes_i < ArrayCount(sweep_note_counts); notes_i++)
+                {
+                    for (u32 block_i = 0; block_i < ArrayCount(sweep_block_sizes); block_i++)
+                    {
+                        const u32 violations_before = RtCheckViolationCount();
+                        SynthInit(synth, signal, sweep_block_sizes[block_i]);
+                        synth->note_cache = note_cache;
+
+                        UiOscillator *carrier = &synth->ui_oscillator[0];
+                        carrier->shape = (WaveShape)carrier_shape;
+                        carrier->freq = BASE_NOTE_FREQ;
+                        carrier->amplitude_ratio = 0.1f;
+                        carrier->shape_parameter_0 = sweep_shape_params[param_i];
+                        synth->ui_oscillator_count = 1;
+                        if (modulator_shape != WaveShape_NONE)
+                        {
+                            UiOscillator *modulator = &synth->ui_oscillator[1];
+                            modulator->shape = (WaveShape)modulator_shape;
+                            modulator->freq = 5.f;
+                            modulator->amplitude_ratio = 1.f;
+                            modulator->shape_parameter_0 = sweep_shape_params[param_i];
+                            carrier->modulation_state = 2; // modulated by ui oscillator 1.
+                            synth->ui_oscillator_count = 2;
+                        }
+
+                        PressNotes(keys, sweep_note_counts[notes_i]);
+                        RenderBlocks(synth, keys, sweep_block_sizes[block_i], 8);
+                        PressNotes(keys, 0);
+                        RenderBlocks(synth, keys, sweep_block_sizes[block_i], 2);
+
+                        combination_count += 1;
+                        if (RtCheckViolationCount() != violations_before)
+                        {
+                            printf("  in carrier %u, modulator %u, shape param %.1f, %u notes, block %u%s\n",
+                                   carrier_shape, modulator_shape, sweep_shape_params[param_i],
+                                   sweep_note_counts[notes_i], sweep_block_sizes[block_i],
+                                   note_cache ? ", note cache" : "");
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return combination_count;
+}
+
+// Every part playing on its own channel with a different wave shape.
+internal void
+SetUpParts(SynthParts *parts, MidiChannelKeys *keys)
+{
+    parts->part_count = MAX_SYNTH_PARTS;
+    for (u32 part_i = 0; part_i < parts->part_count; part_i++)
+    {
+        Synth *synth = &parts->part[part_i].synth;
+        UiOscillator *carrier = &synth->ui_oscillator[synth->ui_oscillator_count++];
+        carrier->shape = (WaveShape)((part_i % (WaveShape_COUNT - 1)) + 1);
+        carrier->freq = BASE_NOTE_FREQ;
+        carrier->amplitude_ratio = 0.1f;
+        carrier->shape_parameter_0 = 0.5f;
+        PressNotes(&keys->channel[part_i], 4);
+    }
+}
+
+// Rendered by the worker pool, so the hand-off between the audio thread and
+// the workers is checked too.
+internal u32
+SweepParts(f32 *signal, u32 worker_count)
+{
+    MidiChannelKeys keys;
+    SynthMidiChannelKeysInit(&keys);
+    SynthParts *parts = (SynthParts *)malloc(sizeof(SynthParts));
+    SynthPartsInit(parts, signal, STREAM_BUFFER_SIZE, &keys);
+    SetUpParts(parts, &keys);
+    SynthPartsStartWorkers(parts, worker_count, false);
+
+    f32 samples[STREAM_BUFFER_SIZE];
+    for (u32 period_i = 0; period_i < 16; period_i++)
+    {
+        SynthPartsAudioRender(parts, samples, 256);
+    }
+
+    SynthPartsStopWorkers(parts);
+    free(parts);
+    return 1;
+}
+
+// The whole callback the way synth.c runs it: audio_output.h's thread opens
+// the scope, then SynthPartsAudioRender picks up the patches published from
+// the ui side, waits on the workers, feeds the tap and fills the scope copy.
+internal u32
+SweepAudioOutput(f32 *signal, u32 worker_count, SynthTapFn *tap, void *tap_user_data)
+{
+    MidiChannelKeys keys;
+    SynthMidiChannelKeysInit(&keys);
+    SynthParts *ui_parts = (SynthParts *)malloc(sizeof(SynthParts));
+    SynthPartsInit(ui_parts, signal, STREAM_BUFFER_SIZE, &keys);
+    SetUpParts(ui_parts, &keys);
+
+    local_static f32 audio_signal[STREAM_BUFFER_SIZE];
+    local_static f32 scope[STREAM_BUFFER_SIZE];
+    SynthParts *audio_parts = (SynthParts *)malloc(sizeof(SynthParts));
+    SynthPartsInit(audio_parts, audio_signal, ArrayCount(audio_signal), &keys);
+    audio_parts->uses_ui_exchange = true;
+    audio_parts->scope = scope;
+    audio_parts->scope_count = ArrayCount(scope);
+    audio_parts->tap = tap;
+    audio_parts->tap_user_data = tap_user_data;
+    SynthPartsPublishUi(audio_parts, ui_parts);
+    SynthPartsStartWorkers(audio_parts, worker_count, false);
+
+    AudioOutputConfig config = AudioOutputDefaultConfig();
+    config.backend = AudioBackend_NULL;
+    config.freewheel = true;
+    config.max_periods = 16;
+    AudioOutput output;
+    u32 combination_count = 0;
+    if (AudioOutputStart(&output, &config, SynthPartsAudioRender, audio_parts))
+    {
+        AudioOutputWait(&output);
+        AudioOutputStop(&output);
+        combination_count = 1;
+    }
+    else
+    {
+        printf("Could not start the null audio output.\n");
+    }
+
+    SynthPartsStopWorkers(audio_parts);
+    free(audio_parts);
+    free(ui_parts);
+    return combination_count;
+}
+
+// Same as synth.c's tap: the pitch readout's tracker, fed every block of the
+// mix on the audio thread.
+internal void
+PitchTap(void *user_data, f32 *samples, usize sample_count)
+{
+    PitchTrackerPush((pitch_tracker *)user_data, samples, (u32)sample_count);
+}
+
+// Gives the core away after the mix, outside anything SynthRenderBlock
+// covers, so only the scope around the whole callback can catch it.
+internal void
+YieldingTap(void *user_data, f32 *samples, usize sample_count)
+{
+    sched_yield();
+}
+
+i32
+main(i32 argc, char **argv)
+{
+    RtCheckInit();
+
+    // Make sure the interceptors are actually live before trusting a clean
+    // run. None of these block here, but each must still be reported.
+    struct timespec no_time = {0};
+    sem_t probe_semaphore;
+    sem_init(&probe_semaphore, 0, 1);
+    rt_check_quiet = true;
+    RtScopeBegin();
+    void *probe = malloc(16);
+    free(probe);
+    probe = memalign(64, 64);
+    free(probe);
+    sched_yield();
+    clock_nanosleep(CLOCK_MONOTONIC, 0, &no_time, 0);
+    sem_timedwait(&probe_semaphore, &no_time);
+    RtScopeEnd();
+    rt_check_quiet = false;
+    sem_destroy(&probe_semaphore);
+    if (RtCheckViolationCount() != 7)
+    {
+        printf("Checker self-test failed: expected 7 violations, saw %u.\n", RtCheckViolationCount());
+        return 1;
+    }
+    rt_check_violation_count = 0;
+
+    f32 *signal = (f32 *)calloc(STREAM_BUFFER_SIZE, sizeof(f32));
+
+    // And that the scope really spans the whole callback: 16 periods of 256
+    // samples are one tap call each.
+    rt_check_quiet = true;
+    SweepAudioOutput(signal, 0, YieldingTap, 0);
+    rt_check_quiet = false;
+    if (RtCheckViolationCount() != 16)
+    {
+        printf("Checker self-test failed: expected 16 violations from the tap, saw %u.\n", RtCheckViolationCount());
+        return 1;
+    }
+    rt_check_violation_count = 0;
+
+    Synth *synth = (Synth *)malloc(sizeof(Synth));
+    MidiKeyArray keys = {0};
+    keys.count = ArrayCount(keys.data);
+
+    // Every combination runs once live and once through the note cache, which
+    // must only ever fill its preallocated slots on a miss.
+    NoteCache *note_cache = NoteCacheCreate(NOTE_CACHE_DEFAULT_BUDGET);
+    u32 combination_count = Sweep(synth, signal, &keys, 0);
+    combination_count += Sweep(synth, signal, &keys, note_cache);
+    combination_count += SweepParts(signal, 0);
+    combination_count += SweepParts(signal, 3);
+    combination_count += SweepAudioOutput(signal, 0, 0, 0);
+    combination_count += SweepAudioOutput(signal, 3, 0, 0);
+
+    // And with the pitch tap installed, set up the way synth.c does it: 16
+    // periods of 256 samples fill the window and run several detections.
+    fft_planner pitch_planner = FFTPlannerCreate(FFTPlanner_Estimate, 0);
+    pitch_config pitch_settings = {0};
+    pitch_settings.SampleRate = SAMPLE_RATE;
+    pitch_tracker pitch = PitchTrackerCreate(&pitch_planner, pitch_settings);
+    combination_count += SweepAudioOutput(signal, 0, PitchTap, &pitch);
+    combination_count += SweepAudioOutput(signal, 3, PitchTap, &pitch);
+    PitchTrackerDestroy(&pitch);
+    FFTPlannerDestroy(&pitch_planner);
+
+    printf("Rendered %u combinations, %u real-time violations.\n",
+           combination_count, RtCheckViolationCount());
+    NoteCacheDestroy(note_cache);
+    free(synth);
+    free(signal);
+    return (RtCheckViolationCount() == 0) ? 0 : 1;
+}
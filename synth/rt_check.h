@@ -0,0 +1,449 @@
+/* date = October 18th 2026 */
+
+#ifndef RT_CHECK_H
+#define RT_CHECK_H
+
+// Real-time safety checker for the audio path.
+//
+// Build with SYNTH_RTCHECK defined (Linux/glibc only) and every call to the
+// allocator, a blocking pthread primitive, stdio or a blocking syscall made
+// between RtScopeBegin() and RtScopeEnd() on the same thread is reported with
+// a stack trace. The checker works by defining those functions in the
+// executable, which takes precedence over libc for the whole process, and
+// forwarding to the real ones. Without SYNTH_RTCHECK the scope markers compile
+// to nothing.
+//
+// Link with -rdynamic to get function names in the stack traces.
+
+#ifdef SYNTH_RTCHECK
+
+#ifndef __linux__
+#error "SYNTH_RTCHECK is only supported on Linux."
+#endif
+#ifndef _GNU_SOURCE
+#error "SYNTH_RTCHECK needs _GNU_SOURCE defined before any #include."
+#endif
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <malloc.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sched.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <sys/syscall.h>
+#include "synth_platform.h"
+
+#define RT_CHECK_MAX_REPORTS 16 // stack traces printed; later violations are only counted.
+#define RT_CHECK_STACK_DEPTH 32
+
+global __thread i32 rt_check_depth;
+global __thread i32 rt_check_reporting;
+global u32 rt_check_violation_count;
+global bool rt_check_quiet;
+
+#define RtScopeBegin() (rt_check_depth += 1)
+#define RtScopeEnd() (rt_check_depth -= 1)
+
+// glibc's own entry points, so forwarding the allocator never has to go
+// through dlsym (which itself allocates).
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+extern void *__libc_memalign(size_t alignment, size_t size);
+
+internal void
+RtCheckWrite(const char *text)
+{
+    // Raw syscall so reporting can't recurse into the write() interceptor.
+    syscall(SYS_write, 2, text, strlen(text));
+}
+
+internal void
+RtCheckViolation(const char *what)
+{
+    if (rt_check_depth <= 0 || rt_check_reporting > 0) return;
+    __atomic_add_fetch(&rt_check_violation_count, 1, __ATOMIC_RELAXED);
+    if (rt_check_quiet || rt_check_violation_count > RT_CHECK_MAX_REPORTS) return;
+
+    rt_check_reporting = 1;
+    char line[256];
+    snprintf(line, sizeof(line), "RT CHECK: %s called inside the audio render scope\n", what);
+    RtCheckWrite(line);
+    void *frames[RT_CHECK_STACK_DEPTH];
+    i32 frame_count = backtrace(frames, RT_CHECK_STACK_DEPTH);
+    // Skip this function and the interceptor.
+    backtrace_symbols_fd(frames + 2, frame_count - 2, 2);
+    rt_check_reporting = 0;
+}
+
+internal void
+RtCheckInit(void)
+{
+    // backtrace() loads libgcc_s (and allocates) on its first call, so get
+    // that out of the way before anything is being checked.
+    void *frames[1];
+    backtrace(frames, 1);
+    rt_check_violation_count = 0;
+}
+
+internal u32
+RtCheckViolationCount(void)
+{
+    return __atomic_load_n(&rt_check_violation_count, __ATOMIC_RELAXED);
+}
+
+internal void *
+RtCheckResolve(const char *name)
+{
+    // dlsym can allocate and lock on its first lookups; that's the checker's
+    // own business, not the audio path's.
+    rt_check_reporting += 1;
+    void *fn = dlsym(RTLD_NEXT, name);
+    rt_check_reporting -= 1;
+    return fn;
+}
+
+// Looks the real function up once and keeps it in a local static.
+#define RtCheckNext(name) \
+local_static name##_fn next_##name; \
+if (!next_##name) next_##name = (name##_fn)RtCheckResolve(#name)
+
+// @rtcheck allocation
+void *
+malloc(size_t size)
+{
+    RtCheckViolation("malloc");
+    return __libc_malloc(size);
+}
+
+void *
+calloc(size_t count, size_t size)
+{
+    RtCheckViolation("calloc");
+    return __libc_calloc(count, size);
+}
+
+void *
+realloc(void *ptr, size_t size)
+{
+    RtCheckViolation("realloc");
+    return __libc_realloc(ptr, size);
+}
+
+void
+free(void *ptr)
+{
+    if (ptr) RtCheckViolation("free");
+    __libc_free(ptr);
+}
+
+void *
+aligned_alloc(size_t alignment, size_t size)
+{
+    RtCheckViolation("aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+int
+posix_memalign(void **out, size_t alignment, size_t size)
+{
+    RtCheckViolation("posix_memalign");
+    *out = __libc_memalign(alignment, size);
+    return (*out) ? 0 : 12; // ENOMEM
+}
+
+void *
+memalign(size_t alignment, size_t size)
+{
+    RtCheckViolation("memalign");
+    return __libc_memalign(alignment, size);
+}
+
+// @rtcheck locks
+typedef int (*pthread_mutex_lock_fn)(pthread_mutex_t *);
+typedef int (*pthread_cond_wait_fn)(pthread_cond_t *, pthread_mutex_t *);
+typedef int (*pthread_cond_timedwait_fn)(pthread_cond_t *, pthread_mutex_t *, const struct timespec *);
+typedef int (*pthread_rwlock_rdlock_fn)(pthread_rwlock_t *);
+typedef int (*pthread_rwlock_wrlock_fn)(pthread_rwlock_t *);
+typedef int (*pthread_join_fn)(pthread_t, void **);
+typedef int (*sem_wait_fn)(sem_t *);
+typedef int (*sem_timedwait_fn)(sem_t *, const struct timespec *);
+
+int
+pthread_mutex_lock(pthread_mutex_t *m)
+{
+    RtCheckViolation("pthread_mutex_lock");
+    RtCheckNext(pthread_mutex_lock);
+    return next_pthread_mutex_lock(m);
+}
+
+int
+pthread_cond_wait(pthread_cond_t *c, pthread_mutex_t *m)
+{
+    RtCheckViolation("pthread_cond_wait");
+    RtCheckNext(pthread_cond_wait);
+    return next_pthread_cond_wait(c, m);
+}
+
+int
+pthread_cond_timedwait(pthread_cond_t *c, pthread_mutex_t *m, const struct timespec *t)
+{
+    RtCheckViolation("pthread_cond_timedwait");
+    RtCheckNext(pthread_cond_timedwait);
+    return next_pthread_cond_timedwait(c, m, t);
+}
+
+int
+pthread_rwlock_rdlock(pthread_rwlock_t *l)
+{
+    RtCheckViolation("pthread_rwlock_rdlock");
+    RtCheckNext(pthread_rwlock_rdlock);
+    return next_pthread_rwlock_rdlock(l);
+}
+
+int
+pthread_rwlock_wrlock(pthread_rwlock_t *l)
+{
+    RtCheckViolation("pthread_rwlock_wrlock");
+    RtCheckNext(pthread_rwlock_wrlock);
+    return next_pthread_rwlock_wrlock(l);
+}
+
+int
+pthread_join(pthread_t t, void **r)
+{
+    RtCheckViolation("pthread_join");
+    RtCheckNext(pthread_join);
+    return next_pthread_join(t, r);
+}
+
+int
+sem_wait(sem_t *s)
+{
+    RtCheckViolation("sem_wait");
+    RtCheckNext(sem_wait);
+    return next_sem_wait(s);
+}
+
+int
+sem_timedwait(sem_t *s, const struct timespec *t)
+{
+    RtCheckViolation("sem_timedwait");
+    RtCheckNext(sem_timedwait);
+    return next_sem_timedwait(s, t);
+}
+
+
+// @rtcheck syscalls
+typedef ssize_t (*write_fn)(int, const void *, size_t);
+typedef ssize_t (*read_fn)(int, void *, size_t);
+typedef int (*nanosleep_fn)(const struct timespec *, struct timespec *);
+typedef int (*clock_nanosleep_fn)(clockid_t, int, const struct timespec *, struct timespec *);
+typedef int (*sched_yield_fn)(void);
+typedef int (*usleep_fn)(useconds_t);
+typedef unsigned int (*sleep_fn)(unsigned int);
+typedef FILE *(*fopen_fn)(const char *, const char *);
+typedef int (*fclose_fn)(FILE *);
+typedef int (*fflush_fn)(FILE *);
+
+ssize_t
+write(int fd, const void *buf, size_t count)
+{
+    RtCheckViolation("write");
+    RtCheckNext(write);
+    return next_write(fd, buf, count);
+}
+
+ssize_t
+read(int fd, void *buf, size_t count)
+{
+    RtCheckViolation("read");
+    RtCheckNext(read);
+    return next_read(fd, buf, count);
+}
+
+int
+nanosleep(const struct timespec *req, struct timespec *rem)
+{
+    RtCheckViolation("nanosleep");
+    RtCheckNext(nanosleep);
+    return next_nanosleep(req, rem);
+}
+
+int
+clock_nanosleep(clockid_t clock, int flags, const struct timespec *req, struct timespec *rem)
+{
+    RtCheckViolation("clock_nanosleep");
+    RtCheckNext(clock_nanosleep);
+    return next_clock_nanosleep(clock, flags, req, rem);
+}
+
+// Gives the core away for as long as the scheduler likes; with SCHED_FIFO it
+// only helps threads of the same priority.
+int
+sched_yield(void)
+{
+    RtCheckViolation("sched_yield");
+    RtCheckNext(sched_yield);
+    return next_sched_yield();
+}
+
+int
+usleep(useconds_t usec)
+{
+    RtCheckViolation("usleep");
+    RtCheckNext(usleep);
+    return next_usleep(usec);
+}
+
+unsigned int
+sleep(unsigned int seconds)
+{
+    RtCheckViolation("sleep");
+    RtCheckNext(sleep);
+    return next_sleep(seconds);
+}
+
+FILE *
+fopen(const char *path, const char *mode)
+{
+    RtCheckViolation("fopen");
+    RtCheckNext(fopen);
+    return next_fopen(path, mode);
+}
+
+int
+fclose(FILE *file)
+{
+    RtCheckViolation("fclose");
+    RtCheckNext(fclose);
+    return next_fclose(file);
+}
+
+int
+fflush(FILE *file)
+{
+    RtCheckViolation("fflush");
+    RtCheckNext(fflush);
+    return next_fflush(file);
+}
+
+
+// @rtcheck stdio
+// glibc's printf family writes through internal calls that never reach the
+// write() interceptor, so catch them at the call instead of at the flush.
+typedef size_t (*fwrite_fn)(const void *, size_t, size_t, FILE *);
+typedef int (*puts_fn)(const char *);
+typedef int (*fputs_fn)(const char *, FILE *);
+
+typedef int (*vfprintf_fn)(FILE *, const char *, va_list);
+typedef int (*putchar_fn)(int);
+typedef int (*fputc_fn)(int, FILE *);
+typedef int (*putc_fn)(int, FILE *);
+
+int
+vfprintf(FILE *file, const char *format, va_list args)
+{
+    RtCheckViolation("vfprintf");
+    RtCheckNext(vfprintf);
+    return next_vfprintf(file, format, args);
+}
+
+int
+vprintf(const char *format, va_list args)
+{
+    RtCheckViolation("vprintf");
+    RtCheckNext(vfprintf);
+    return next_vfprintf(stdout, format, args);
+}
+
+int
+printf(const char *format, ...)
+{
+    RtCheckViolation("printf");
+    RtCheckNext(vfprintf);
+    va_list args;
+    va_start(args, format);
+    int result = next_vfprintf(stdout, format, args);
+    va_end(args);
+    return result;
+}
+
+int
+fprintf(FILE *file, const char *format, ...)
+{
+    RtCheckViolation("fprintf");
+    RtCheckNext(vfprintf);
+    va_list args;
+    va_start(args, format);
+    int result = next_vfprintf(file, format, args);
+    va_end(args);
+    return result;
+}
+
+// The compiler turns simple printf calls into these.
+int
+putchar(int c)
+{
+    RtCheckViolation("putchar");
+    RtCheckNext(putchar);
+    return next_putchar(c);
+}
+
+int
+fputc(int c, FILE *file)
+{
+    RtCheckViolation("fputc");
+    RtCheckNext(fputc);
+    return next_fputc(c, file);
+}
+
+int
+putc(int c, FILE *file)
+{
+    RtCheckViolation("putc");
+    RtCheckNext(putc);
+    return next_putc(c, file);
+}
+
+int
+puts(const char *text)
+{
+    RtCheckViolation("puts");
+    RtCheckNext(puts);
+    return next_puts(text);
+}
+
+int
+fputs(const char *text, FILE *file)
+{
+    RtCheckViolation("fputs");
+    RtCheckNext(fputs);
+    return next_fputs(text, file);
+}
+
+size_t
+fwrite(const void *ptr, size_t size, size_t count, FILE *file)
+{
+    RtCheckViolation("fwrite");
+    RtCheckNext(fwrite);
+    return next_fwrite(ptr, size, count, file);
+}
+
+
+#else
+
+#define RtScopeBegin()
+#define RtScopeEnd()
+
+#endif //SYNTH_RTCHECK
+
+#endif //RT_CHECK_H
@@ -6,331 +6,61 @@
 #define RAYGUI_IMPLEMENTATION
 #include "raygui.h"
 #include "midi.h"
+#include "synth_engine.h"
+#include "synth_parts.h"
+#include "audio_output.h"
+#include "note_view.h"
+#include "pitch.h"
 
 #define SYNTH_SLOW 1 // run assertions.
+#define SYNTH_NOTE_CACHE 0 // pre-render unmodulated notes, see note_cache.h.
+#define SYNTH_NATIVE_AUDIO 0 // Linux: render on an ALSA callback thread, see audio_output.h.
 #define SCREEN_WIDTH 1024
 #define SCREEN_HEIGHT 768
 #define TARGET_FPS 60
-#define SAMPLE_RATE 44100
-#define SAMPLE_DURATION (1.0f / SAMPLE_RATE)
-#define STREAM_BUFFER_SIZE 1024
-#define MAX_OSCILLATORS 32
-#define MAX_UI_OSCILLATORS 32
 #define UI_PANEL_WIDTH 350
-#define BASE_NOTE_FREQ 440
+#define PITCH_DISPLAY_CONFIDENCE 0.8f // below this the tracker's guess isn't shown.
 
-global MidiKeyArray midi_keys = {0};
+global MidiChannelKeys midi_keys = {0};
 global MidiHandle midi_input_handle = 0;
 
-typedef f32 (*WaveShapeFn)(const f32 phase_ratio, 
-                           const f32 phase_dt, 
-                           const f32 shape_param);
-
-#define WAVE_SHAPE_OPTIONS "None;Sine;Sawtooth;Square;Triangle;Rounded Square"
-typedef enum WaveShape {
-    WaveShape_NONE = 0,
-    WaveShape_SINE = 1,
-    WaveShape_SAWTOOTH = 2,
-    WaveShape_SQUARE = 3,
-    WaveShape_TRIANGLE = 4,
-    WaveShape_ROUNDEDSQUARE = 5,
-    WaveShape_COUNT
-} WaveShape;
-
-typedef struct UiOscillator {
-    f32 freq;
-    f32 amplitude_ratio;
-    f32 shape_parameter_0;
-    WaveShape shape;
-    bool is_dropdown_open;
-    Rectangle shape_dropdown_rect;
-    u8 modulation_state; // 0 = no modulation.
-} UiOscillator;
-
-typedef struct Oscillator {
-    f32 phase_ratio;
-    f32 phase_dt;
-    f32 freq;
-    f32 amplitude_ratio;
-    f32 shape_parameter_0;
-    u16 ui_id;
-    bool is_modulator;
-    f32 buffer[STREAM_BUFFER_SIZE];
-} Oscillator;
-
-typedef struct OscillatorArray {
-    Oscillator osc[MAX_OSCILLATORS];
-    usize count;
-    WaveShapeFn wave_shape_fn;
-} OscillatorArray;
-
-typedef struct ModulationPair {
-    Oscillator *modulator;
-    Oscillator *carrier;
-    u16 modulation_id;
-    f32 modulation_ratio;
-} ModulationPair;
-
-typedef struct ModulationPairArray {
-    ModulationPair data[MAX_OSCILLATORS];
-    usize count;
-} ModulationPairArray;
-
-typedef struct Synth {
-    OscillatorArray oscillator_groups[WaveShape_COUNT-1];
-    usize oscillator_groups_count;
-    
-    f32 *signal;
-    usize signal_count;
-    f32 audio_frame_duration;
-    
-    UiOscillator ui_oscillator[MAX_UI_OSCILLATORS];
-    usize ui_oscillator_count;
-    
-    ModulationPairArray modulation_pairs;
-} Synth;
-
-internal f32
-FrequencyFromSemitone(f32 semitone)
-{
-    return powf(2.f, semitone/12.f) * BASE_NOTE_FREQ;
-}
-
-internal f32
-SemitoneFromFrequency(f32 freq)
-{
-    return 12.f * Log2f(freq / BASE_NOTE_FREQ);
-}
-
-internal Oscillator*
-NextOscillator(OscillatorArray* osc_array)
-{
-    Assert(osc_array->count < MAX_OSCILLATORS);
-    return osc_array->osc + (osc_array->count++);
-}
-
-internal void
-ClearOscillatorArray(OscillatorArray* osc_array)
-{
-    osc_array->count = 0;
-}
-
-internal void 
-UpdatePhase(f32 *phase_ratio, f32 *phase_dt, f32 freq, f32 freq_mod)
-{
-    *phase_dt = ((freq + freq_mod) * SAMPLE_DURATION);
-    *phase_ratio = *phase_ratio + *phase_dt;
-    if (*phase_ratio < 0.0f)
-        *phase_ratio += 1.0f;
-    if (*phase_ratio >= 1.0f)
-        *phase_ratio -= 1.0f;
-}
-
-internal void 
-UpdatePhaseInOsc(Oscillator *osc)
-{
-    osc->phase_dt = ((osc->freq) * SAMPLE_DURATION);
-    osc->phase_ratio += osc->phase_dt;
-    if (osc->phase_ratio < 0.0f)
-        osc->phase_ratio += 1.0f;
-    if (osc->phase_ratio >= 1.0f)
-        osc->phase_ratio -= 1.0f;
-}
-
-internal void 
-ZeroSignal(f32* signal)
-{
-    for(usize t = 0; t < STREAM_BUFFER_SIZE; t++)
-    {
-        signal[t] = 0.0f;
-    }
-}
-
-// @shapefn
-internal f32 
-BandlimitedRipple(f32 phase_ratio, f32 phase_dt)
-{
-    if (phase_ratio < phase_dt)
-    {
-        phase_ratio /= phase_dt;
-        return (phase_ratio+phase_ratio) - (phase_ratio*phase_ratio) - 1.0f;
-    }
-    else if (phase_ratio > 1.0f - phase_dt) 
-    {
-        phase_ratio = (phase_ratio - 1.0f) / phase_dt;
-        return (phase_ratio*phase_ratio) + (phase_ratio+phase_ratio) + 1.0f;
-    }
-    else return 0.0f;
-}
-
-
-// NOTE(luke): Remove this before next episode
-inline f32
-SineFast(f32 x)
-{
-    //x = fmodf(x, 2*PI);
-    f32 a = 0.083f;
-    f32 a2 = 9.424778f * a;
-    f32 a3 = 19.739209f * a;
-    f32 xx = x*x;
-    f32 xxx = xx*x;
-    return (a * xxx) - (a2 * xx) + (a3 * x);
-}
-
-// @shapefn
-internal f32
-SineShape(const f32 phase_ratio, const f32 phase_dt, const f32 shape_param)
-{
-    return SineFast(2.f * PI * phase_ratio);
-}
-
-// @shapefn
-internal f32 
-SawtoothShape(const f32 phase_ratio, const f32 phase_dt, const f32 shape_param)
-{
-    f32 sample = (phase_ratio * 2.0f) - 1.0f;
-    sample -= BandlimitedRipple(phase_ratio, phase_dt);
-    return sample;
-}
-
-// @shapefn
-internal f32 
-TriangleShape(const f32 phase_ratio, const f32 phase_dt, const f32 shape_param)
-{
-    // TODO: Make this band-limited.
-    if (phase_ratio < 0.5f)
-        return (phase_ratio * 4.0f) - 1.0f;
-    else
-        return (phase_ratio * -4.0f) + 3.0f;
-}
-
-// @shapefn
-internal f32 
-SquareShape(const f32 phase_ratio, const f32 phase_dt, const f32 shape_param)
-{
-    f32 duty_cycle = shape_param;
-    f32 sample = (phase_ratio < duty_cycle) ? 1.0f : -1.0f;
-    sample += BandlimitedRipple(phase_ratio, phase_dt);
-    sample -= BandlimitedRipple(fmodf(phase_ratio + (1.f - duty_cycle), 1.0f), phase_dt);
-    return sample;
-}
-
-// @shapefn
-internal f32
-RoundedSquareShape(const f32 phase_ratio, const f32 phase_dt, const f32 shape_param)
-{
-    f32 s = (shape_param * 8.f) + 2.f;
-    f32 base = (f32)fabs(s);
-    f32 power = s * sinf(phase_ratio * PI * 2);
-    f32 denominator = powf(base, power) + 1.f;
-    f32 sample = (2.f / denominator) - 1.f;
-    return sample;
-}
-
-internal void 
-UpdateOscArray(OscillatorArray *osc_array, ModulationPairArray *mod_array)
-{
-    for (i32 i = 0; i < osc_array->count; i++)
-    {
-        Oscillator *osc = &(osc_array->osc[i]);
-        if (osc->freq > (SAMPLE_RATE/2) || osc->freq < -(SAMPLE_RATE/2)) continue;
-        
-        ModulationPair *modulation = 0;
-        for(usize mod_i = 0;
-            mod_i < mod_array->count;
-            mod_i++)
-        {
-            if (mod_array->data[mod_i].carrier == osc)
-            {
-                modulation = &mod_array->data[mod_i];
-                break;
-            }
-        }
-        
-        
-        for(usize t = 0; t < STREAM_BUFFER_SIZE; t++)
-        {
-            f32 freq_mod = 0.0f;
-            if (modulation)
-            {
-                freq_mod = modulation->modulator->buffer[t] * modulation->modulation_ratio;
-            }
-            
-            UpdatePhase(&osc->phase_ratio, 
-                        &osc->phase_dt, 
-                        osc->freq, 
-                        freq_mod);
-            
-            f32 sample = osc_array->wave_shape_fn(osc->phase_ratio,
-                                                  osc->phase_dt,
-                                                  osc->shape_parameter_0);
-            sample *= osc->amplitude_ratio;
-            osc->buffer[t] = sample;
-        }
-    }
-}
-
-internal void
-AccumulateOscillatorsIntoSignal(Synth *synth)
-{
-    for (usize i = 0; 
-         i < synth->oscillator_groups_count; 
-         i++)
-    {
-        OscillatorArray *osc_array = &synth->oscillator_groups[i];
-        for (usize osc_i = 0; 
-             osc_i < osc_array->count; 
-             osc_i++)
-        {
-            Oscillator *osc = &(osc_array->osc[osc_i]);
-            
-            if (osc->is_modulator) continue;
-            
-            for (usize t = 0;
-                 t < STREAM_BUFFER_SIZE;
-                 t++)
-            {
-                synth->signal[t] += osc->buffer[t];
-            }
-        }
-    }
-}
-
 // @mainloop
 internal void 
-HandleAudioStream(AudioStream stream, Synth* synth)
+HandleAudioStream(AudioStream stream, SynthParts *parts, NoteView *note_view)
 {
     f32 audio_frame_duration = 0.0f;
     if (IsAudioStreamProcessed(stream))
     {                                                            
         const f32 audio_frame_start_time = GetTime();
-        ZeroSignal(synth->signal);
-        for (usize i = 0;
-             i < synth->oscillator_groups_count;
-             i++)
-        {
-            OscillatorArray *osc_array = &synth->oscillator_groups[i];
-            UpdateOscArray(osc_array, &synth->modulation_pairs);
-        }
-        
-        AccumulateOscillatorsIntoSignal(synth);
-        UpdateAudioStream(stream, synth->signal, synth->signal_count);
-        synth->audio_frame_duration = GetTime() - audio_frame_start_time;
+        SynthPartsRenderBlock(parts, parts->signal_count);
+        UpdateAudioStream(stream, parts->signal, parts->signal_count);
+        if (parts->tap) parts->tap(parts->tap_user_data, parts->signal, parts->signal_count);
+        NoteViewPush(note_view, parts->signal, parts->signal_count);
+        parts->audio_frame_duration = GetTime() - audio_frame_start_time;
     }
 }
 
+// SynthTapFn: user_data is the pitch_tracker. With SYNTH_NATIVE_AUDIO this
+// runs on the audio thread and the ui reads the estimate racily, like the
+// scope.
+internal void
+PitchTap(void *user_data, f32 *samples, usize sample_count)
+{
+    PitchTrackerPush((pitch_tracker *)user_data, samples, (u32)sample_count);
+}
+
 // @drawfn
 internal void
-DrawSignal(Synth *synth)
+DrawSignal(f32 *signal, usize signal_count)
 {
     // Drawing the signal.
     {
         i32 zero_crossing_index = 0;
         for (i32 i = 1; 
-             i < synth->signal_count; 
+             i < signal_count; 
              i++)
         {
-            if (synth->signal[i] >= 0.0f && synth->signal[i-1] < 0.0f) // zero-crossing
+            if (signal[i] >= 0.0f && signal[i-1] < 0.0f) // zero-crossing
             {
                 zero_crossing_index = i;
                 break;
@@ -340,21 +70,46 @@ DrawSignal(Synth *synth)
         Vector2 signal_points[STREAM_BUFFER_SIZE];
         const f32 screen_vertical_midpoint = (SCREEN_HEIGHT/2);
         for (i32 point_idx = 0; 
-             point_idx < synth->signal_count; 
+             point_idx < signal_count; 
              point_idx++)
         {
             const i32 signal_idx = (point_idx + zero_crossing_index) % STREAM_BUFFER_SIZE;
             signal_points[point_idx].x = (f32)point_idx + UI_PANEL_WIDTH;
-            signal_points[point_idx].y = screen_vertical_midpoint + (i32)(synth->signal[signal_idx] * 300);
+            signal_points[point_idx].y = screen_vertical_midpoint + (i32)(signal[signal_idx] * 300);
         }
         DrawLineStrip(signal_points, STREAM_BUFFER_SIZE - zero_crossing_index, RED);
     }
 }
 
+// @drawfn
+internal void
+DrawNoteView(NoteView *view)
+{
+    // One bar per semitone along the bottom, in dB, with the Cs labelled.
+    const i32 view_height = 160;
+    const i32 baseline_y = SCREEN_HEIGHT - 20;
+    const f32 bar_width = (f32)(SCREEN_WIDTH - UI_PANEL_WIDTH - 20) / view->band_count;
+    char name[16];
+    for (u32 band_i = 0; band_i < view->band_count; band_i++)
+    {
+        const f32 level = (view->levels_db[band_i] - NOTE_VIEW_FLOOR_DB) / -NOTE_VIEW_FLOOR_DB;
+        const i32 bar_height = (i32)(level * view_height);
+        const i32 x = UI_PANEL_WIDTH + 10 + (i32)(band_i * bar_width);
+        DrawRectangle(x, baseline_y - bar_height, (i32)bar_width - 1, bar_height,
+                      (band_i == view->loudest_band) ? ORANGE : MAROON);
+        if ((NOTE_VIEW_LOWEST_SEMITONE + (i32)band_i + 9) % 12 == 0)
+        {
+            DrawText(NoteViewBandName(view, band_i, name, sizeof(name)), x, baseline_y + 4, 10, RED);
+        }
+    }
+    DrawText(FormatText("Loudest note: %s", NoteViewBandName(view, view->loudest_band, name, sizeof(name))),
+             UI_PANEL_WIDTH + 10, baseline_y - view_height - 24, 20, RED);
+}
+
 
 // @drawfn
 internal void 
-DrawUi(Synth *synth)
+DrawUi(SynthParts *parts, u32 *selected_part)
 {
     const i32 panel_x_start = 0;
     const i32 panel_y_start = 0;
@@ -372,9 +127,29 @@ DrawUi(Synth *synth)
                  panel_height
              });
     
+    // Part select. Each part is a patch of its own on the MIDI channel of
+    // the same number; stepping past the last part adds one.
+    Rectangle part_rect = {panel_x_start + 10, panel_y_start + 10, 30, 25};
+    if (GuiButton(part_rect, "<") && *selected_part > 0)
+    {
+        *selected_part -= 1;
+    }
+    part_rect.x = panel_x_start + panel_width - 40;
+    if (GuiButton(part_rect, ">") && *selected_part < MAX_SYNTH_PARTS - 1)
+    {
+        *selected_part += 1;
+        if (parts->part_count < *selected_part + 1) parts->part_count = *selected_part + 1;
+    }
+    SynthPart *part = &parts->part[*selected_part];
+    part_rect.x = panel_x_start + 50;
+    part_rect.width = panel_width - 100;
+    GuiLabel(part_rect, TextFormat("Part %u of %u, MIDI channel %u",
+                                   *selected_part + 1, parts->part_count, part->channel + 1));
+    Synth *synth = &part->synth;
+    
     bool click_add_oscillator = GuiButton((Rectangle){
                                               panel_x_start + 10,
-                                              panel_y_start + 10,
+                                              panel_y_start + 45,
                                               panel_width - 20,
                                               25
                                           }, "Add Oscillator");
@@ -398,7 +173,7 @@ DrawUi(Synth *synth)
         const i32 osc_panel_width = panel_width - 20;
         const i32 osc_panel_height = has_shape_param ? 130 : 100;
         const i32 osc_panel_x = panel_x_start + 10;
-        const i32 osc_panel_y = panel_y_start + 50 + panel_y_offset;
+        const i32 osc_panel_y = panel_y_start + 85 + panel_y_offset;
         panel_y_offset += osc_panel_height + 5;
         GuiPanel((Rectangle){
                      osc_panel_x,
@@ -515,84 +290,6 @@ DrawUi(Synth *synth)
     }
 }
 
-internal void
-ApplyUiState(Synth *synth)
-{
-    // Reset synth
-    // TODO(luke): make this something we can iterate.
-    for (usize i = 0;
-         i < synth->oscillator_groups_count;
-         i++)
-    {
-        ClearOscillatorArray(&synth->oscillator_groups[i]);
-    }
-    synth->modulation_pairs.count = 0;
-    
-    for (i32 ui_osc_i = 0; 
-         ui_osc_i < synth->ui_oscillator_count; 
-         ui_osc_i++)
-    {
-        UiOscillator ui_osc = synth->ui_oscillator[ui_osc_i];
-        
-        for(i32 note_idx = midi_keys.count-1;
-            note_idx >= 0;
-            note_idx--)
-        {
-            MidiKey midi_key = midi_keys.data[note_idx];
-            if (!midi_key.is_on) continue;
-            
-            Oscillator *osc = NULL;
-            if (ui_osc.shape > 0 && ui_osc.shape < WaveShape_COUNT)
-            {
-                osc = NextOscillator(&synth->oscillator_groups[ui_osc.shape-1]);
-            }
-            
-            if (osc != NULL)
-            {
-                osc->ui_id = ui_osc_i;
-                f32 ui_semitone = SemitoneFromFrequency(ui_osc.freq);
-                f32 midi_semitone = (f32)(midi_key.note - BASE_MIDI_NOTE);
-                f32 osc_freq = FrequencyFromSemitone(ui_semitone + midi_semitone);
-                osc->freq = osc_freq;
-                osc->amplitude_ratio = ui_osc.amplitude_ratio;
-                osc->shape_parameter_0 = ui_osc.shape_parameter_0;
-                osc->is_modulator = false;
-                
-                if (ui_osc.modulation_state > 0 && (ui_osc.modulation_state-1) < synth->ui_oscillator_count)
-                {
-                    ModulationPair *mod_pair = synth->modulation_pairs.data + synth->modulation_pairs.count++;
-                    mod_pair->modulator = 0;
-                    mod_pair->carrier = osc;
-                    mod_pair->modulation_id = ui_osc.modulation_state - 1;
-                    mod_pair->modulation_ratio = 100.0f;
-                }
-            }
-        }
-    }
-    
-    for(usize mod_i = 0;
-        mod_i < synth->modulation_pairs.count;
-        mod_i++)
-    {
-        ModulationPair *mod_pair = &synth->modulation_pairs.data[mod_i];
-        u16 shape_id = (u16)synth->ui_oscillator[mod_pair->modulation_id].shape;
-        OscillatorArray *osc_array = &synth->oscillator_groups[shape_id-1];
-        // TODO(luke): modulators (LFOs) should not be per-note.
-        for (usize osc_i = 0;
-             osc_i < osc_array->count;
-             osc_i++)
-        {
-            Oscillator *osc = &osc_array->osc[osc_i];
-            if (osc->ui_id == mod_pair->modulation_id)
-            {
-                if (mod_pair->modulator == 0)
-                    mod_pair->modulator = osc;
-                osc->is_modulator = true;
-            }
-        }
-    }
-}
-
 i32 
 main(i32 argc, char **argv)
 {
@@ -600,19 +297,10 @@ main(i32 argc, char **argv)
     const i32 screen_height = 768;
     InitWindow(screen_width, screen_height, "Synth");
     SetTargetFPS(TARGET_FPS);
-    InitAudioDevice();
-    midi_keys.count = ArrayCount(midi_keys.data);
+    SynthMidiChannelKeysInit(&midi_keys);
     midi_input_handle = SynthMidiInit(0, &midi_keys);
     GuiLoadStyle(".\\styles\\jungle\\jungle.rgs");
     
-    u32 sample_rate = SAMPLE_RATE;
-    SetAudioStreamBufferSizeDefault(STREAM_BUFFER_SIZE);
-    AudioStream synth_stream = InitAudioStream(sample_rate, 
-                                               sizeof(f32) * 8, 
-                                               1);
-    SetAudioStreamVolume(synth_stream, 0.01f);
-    PlayAudioStream(synth_stream);
-    
     ModulationPair modulation_pairs[256] = {0};
     f32 signal[STREAM_BUFFER_SIZE] = {0};
     
@@ -621,23 +309,66 @@ main(i32 argc, char **argv)
     printf("OscillatorArray size: %lld\n", sizeof(OscillatorArray));
     printf("Synth size: %lld\n", sizeof(Synth));
     
-    Synth *synth = (Synth *)malloc(sizeof(Synth));
-    synth->oscillator_groups_count = ArrayCount(synth->oscillator_groups);
-    synth->signal = signal;
-    synth->signal_count = ArrayCount(signal);
+    SynthParts *parts = (SynthParts *)malloc(sizeof(SynthParts));
+    SynthPartsInit(parts, signal, ArrayCount(signal), &midi_keys);
+    SynthParts *rendered_parts = parts;
+    u32 selected_part = 0;
+    fft_planner planner = FFTPlannerCreate(FFTPlanner_Estimate, 0);
+    NoteView *note_view = (NoteView *)malloc(sizeof(NoteView));
+    NoteViewInit(note_view, &planner, SAMPLE_RATE);
+    // The tracker runs on the audio thread with SYNTH_NATIVE_AUDIO and the
+    // note view on the ui thread, and a plan can't run on two threads at
+    // once, so the tracker plans on its own planner that nothing else uses.
+    fft_planner pitch_planner = FFTPlannerCreate(FFTPlanner_Estimate, 0);
+    pitch_config pitch_settings = {0};
+    pitch_settings.SampleRate = SAMPLE_RATE;
+    pitch_tracker pitch = PitchTrackerCreate(&pitch_planner, pitch_settings);
     
-    synth->oscillator_groups[WaveShape_SINE-1].count = 0;
-    synth->oscillator_groups[WaveShape_SINE-1].wave_shape_fn = SineShape;
-    synth->oscillator_groups[WaveShape_SAWTOOTH-1].count = 0;
-    synth->oscillator_groups[WaveShape_SAWTOOTH-1].wave_shape_fn = SawtoothShape;
-    synth->oscillator_groups[WaveShape_TRIANGLE-1].count = 0;
-    synth->oscillator_groups[WaveShape_TRIANGLE-1].wave_shape_fn = TriangleShape;
-    synth->oscillator_groups[WaveShape_SQUARE-1].count = 0;
-    synth->oscillator_groups[WaveShape_SQUARE-1].wave_shape_fn = SquareShape;
-    synth->oscillator_groups[WaveShape_ROUNDEDSQUARE-1].count = 0;
-    synth->oscillator_groups[WaveShape_ROUNDEDSQUARE-1].wave_shape_fn = RoundedSquareShape;
+#if SYNTH_NATIVE_AUDIO
+    // The audio thread renders its own parts. The ones above only hold the
+    // ui state, which is published to the audio thread every frame, and the
+    // scope copy of the last block that DrawSignal reads.
+    f32 audio_signal[STREAM_BUFFER_SIZE] = {0};
+    SynthParts *audio_parts = (SynthParts *)malloc(sizeof(SynthParts));
+    SynthPartsInit(audio_parts, audio_signal, ArrayCount(audio_signal), &midi_keys);
+    audio_parts->uses_ui_exchange = true;
+    audio_parts->scope = signal;
+    audio_parts->scope_count = ArrayCount(signal);
+    rendered_parts = audio_parts;
+#endif
+    rendered_parts->tap = PitchTap;
+    rendered_parts->tap_user_data = &pitch;
     
-    synth->modulation_pairs.count = 0;
+#if SYNTH_NOTE_CACHE
+    for (u32 part_i = 0; part_i < MAX_SYNTH_PARTS; part_i++)
+    {
+        rendered_parts->part[part_i].synth.note_cache = NoteCacheCreate(NOTE_CACHE_DEFAULT_BUDGET);
+    }
+#endif
+    
+#if SYNTH_NATIVE_AUDIO
+    AudioOutputConfig audio_config = AudioOutputDefaultConfig();
+    audio_config.backend = AudioBackend_ALSA;
+    audio_config.sample_rate = SAMPLE_RATE;
+    audio_config.realtime = true;
+    SynthPartsStartWorkers(audio_parts, SynthPartsDefaultWorkerCount(), audio_config.realtime);
+    AudioOutput audio_output;
+    if (!AudioOutputStart(&audio_output, &audio_config, SynthPartsAudioRender, audio_parts))
+    {
+        CloseWindow();
+        return 1;
+    }
+#else
+    SynthPartsStartWorkers(parts, SynthPartsDefaultWorkerCount(), false);
+    InitAudioDevice();
+    u32 sample_rate = SAMPLE_RATE;
+    SetAudioStreamBufferSizeDefault(STREAM_BUFFER_SIZE);
+    AudioStream synth_stream = InitAudioStream(sample_rate, 
+                                               sizeof(f32) * 8, 
+                                               1);
+    SetAudioStreamVolume(synth_stream, 0.01f);
+    PlayAudioStream(synth_stream);
+#endif
     
 #if 0
     synth->modulation_pairs.count = 1;
@@ -646,28 +377,71 @@ main(i32 argc, char **argv)
     synth->modulation_pairs.data[0].modulation_ratio = 100.0f;
 #endif
     
+#if SYNTH_NATIVE_AUDIO
+    u32 pushed_scope_serial = 0;
+#endif
+    
     // @mainloop
     while(!WindowShouldClose())
     {
-        HandleAudioStream(synth_stream, synth);
+#if !SYNTH_NATIVE_AUDIO
+        HandleAudioStream(synth_stream, parts, note_view);
+#else
+        u32 scope_serial = AtomicLoadU32(&audio_parts->scope_serial);
+        if (scope_serial != pushed_scope_serial)
+        {
+            NoteViewPush(note_view, signal, ArrayCount(signal));
+            pushed_scope_serial = scope_serial;
+        }
+#endif
+        NoteViewUpdate(note_view);
         BeginDrawing();
         ClearBackground(BLACK);
-        DrawUi(synth);
-        ApplyUiState(synth);
-        DrawSignal(synth);
+        DrawUi(parts, &selected_part);
+        SynthPartsApplyUiState(parts);
+#if SYNTH_NATIVE_AUDIO
+        SynthPartsPublishUi(audio_parts, parts);
+#endif
+        DrawSignal(signal, ArrayCount(signal));
+        DrawNoteView(note_view);
         
         const f32 total_frame_duration = GetFrameTime();
         DrawText(FormatText("Frame time: %.3f%%, Audio budget: %.3f%%", 
                             (100.0f / (total_frame_duration * TARGET_FPS)), 
-                            100.0f / ((1.0f / synth->audio_frame_duration) / ((f32)SAMPLE_RATE/STREAM_BUFFER_SIZE))),
+                            100.0f / ((1.0f / rendered_parts->audio_frame_duration) / ((f32)SAMPLE_RATE/STREAM_BUFFER_SIZE))),
                  UI_PANEL_WIDTH + 10, 10,
                  20,
                  RED);
-        DrawText(FormatText("Fundemental Freq: %.1f", 
-                            synth->oscillator_groups[0].osc[0].freq),
-                 UI_PANEL_WIDTH + 10, 30,
-                 20,
-                 RED);
+        const pitch_estimate estimate = pitch.Estimate;
+        if (estimate.Confidence >= PITCH_DISPLAY_CONFIDENCE)
+        {
+            const f32 semitone = SemitoneFromFrequency(estimate.Freq);
+            const i32 nearest_semitone = (i32)roundf(semitone);
+            char note_name[16];
+            DrawText(FormatText("Pitch: %.1f Hz, %s %+d cents, confidence %.2f",
+                                estimate.Freq, NoteName(nearest_semitone, note_name, sizeof(note_name)),
+                                (i32)roundf(100.0f * (semitone - nearest_semitone)), estimate.Confidence),
+                     UI_PANEL_WIDTH + 10, 30,
+                     20,
+                     RED);
+        }
+        else
+        {
+            DrawText(FormatText("Pitch: none, confidence %.2f", estimate.Confidence),
+                     UI_PANEL_WIDTH + 10, 30,
+                     20,
+                     RED);
+        }
+        
+        // CPU per part, to balance layered sets across channels.
+        for (u32 part_i = 0; part_i < rendered_parts->part_count; part_i++)
+        {
+            SynthPart *part = &rendered_parts->part[part_i];
+            DrawText(FormatText("Part %u: %.3f%%", part_i + 1, 100.0f * part->load),
+                     UI_PANEL_WIDTH + 10, 50 + 20 * part_i,
+                     20,
+                     (part_i == selected_part) ? ORANGE : RED);
+        }
         EndDrawing();
     }
     
@@ -675,9 +449,27 @@ main(i32 argc, char **argv)
     {
         SynthMidiStop(midi_input_handle);
     }
+#if SYNTH_NATIVE_AUDIO
+    AudioOutputStop(&audio_output);
+#else
     CloseAudioStream(synth_stream);
     CloseAudioDevice();
+#endif
+    SynthPartsStopWorkers(rendered_parts);
+    for (u32 part_i = 0; part_i < MAX_SYNTH_PARTS; part_i++)
+    {
+        NoteCacheDestroy(rendered_parts->part[part_i].synth.note_cache);
+    }
+#if SYNTH_NATIVE_AUDIO
+    free(audio_parts);
+#endif
+    PitchTrackerDestroy(&pitch);
+    FFTPlannerDestroy(&pitch_planner);
+    NoteViewDestroy(note_view);
+    free(note_view);
+    FFTPlannerDestroy(&planner);
+    free(parts);
     CloseWindow();
     
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,459 @@
+/* date = October 18th 2026 */
+
+#ifndef SYNTH_ENGINE_H
+#define SYNTH_ENGINE_H
+
+// The engine only needs raylib for its types (Rectangle, PI, bool), so it can
+// be compiled into headless tools without linking raylib.
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "raylib.h"
+#include "synth_thread.h"
+#include "midi.h"
+#include "rt_check.h"
+#include "dsp_math.h"
+#include "dsp_simd_math.h"
+#include "dsp_oscillator.h"
+#include "dsp_fixed.h"
+
+#define SAMPLE_RATE 44100
+#define SAMPLE_DURATION (1.0f / SAMPLE_RATE)
+#define STREAM_BUFFER_SIZE 1024 // also the largest block the engine renders.
+#define MAX_OSCILLATORS 32
+#define MAX_UI_OSCILLATORS 32
+#define BASE_NOTE_FREQ 440
+
+typedef f32 (*WaveShapeFn)(const f32 phase_ratio,
+                           const f32 phase_dt,
+                           const f32 shape_param);
+
+#define WAVE_SHAPE_OPTIONS "None;Sine;Sawtooth;Square;Triangle;Rounded Square"
+typedef enum WaveShape {
+    WaveShape_NONE = 0,
+    WaveShape_SINE = 1,
+    WaveShape_SAWTOOTH = 2,
+    WaveShape_SQUARE = 3,
+    WaveShape_TRIANGLE = 4,
+    WaveShape_ROUNDEDSQUARE = 5,
+    WaveShape_COUNT
+} WaveShape;
+
+typedef struct UiOscillator {
+    f32 freq;
+    f32 amplitude_ratio;
+    f32 shape_parameter_0;
+    WaveShape shape;
+    bool is_dropdown_open;
+    Rectangle shape_dropdown_rect;
+    u8 modulation_state; // 0 = no modulation.
+} UiOscillator;
+
+typedef struct Oscillator {
+    f32 phase_ratio;
+    f32 phase_dt;
+    f32 freq;
+    f32 amplitude_ratio;
+    f32 shape_parameter_0;
+    u16 ui_id;
+    bool is_modulator;
+    f32 buffer[STREAM_BUFFER_SIZE];
+} Oscillator;
+
+typedef struct OscillatorArray {
+    Oscillator osc[MAX_OSCILLATORS];
+    usize count;
+    WaveShapeFn wave_shape_fn;
+} OscillatorArray;
+
+typedef struct ModulationPair {
+    Oscillator *modulator;
+    Oscillator *carrier;
+    u16 modulation_id;
+    f32 modulation_ratio;
+} ModulationPair;
+
+typedef struct ModulationPairArray {
+    ModulationPair data[MAX_OSCILLATORS];
+    usize count;
+} ModulationPairArray;
+
+typedef struct Synth {
+    OscillatorArray oscillator_groups[WaveShape_COUNT-1];
+    usize oscillator_groups_count;
+
+    f32 *signal;
+    usize signal_count;
+    f32 audio_frame_duration;
+
+    UiOscillator ui_oscillator[MAX_UI_OSCILLATORS];
+    usize ui_oscillator_count;
+
+    ModulationPairArray modulation_pairs;
+
+    struct NoteCache *note_cache; // optional, 0 renders every oscillator live.
+} Synth;
+
+typedef struct UiOscillatorSet {
+    UiOscillator data[MAX_UI_OSCILLATORS];
+    usize count;
+} UiOscillatorSet;
+
+// Triple buffer that hands the ui oscillators from the UI thread to an audio
+// thread without locks: the UI fills its back slot and swaps it into the
+// middle, the audio thread swaps the middle into its front slot when there's
+// something new there.
+#define UI_EXCHANGE_NEW 4u
+typedef struct SynthUiExchange {
+    UiOscillatorSet slots[3];
+    u32 back;   // UI thread only.
+    u32 middle; // slot index, | UI_EXCHANGE_NEW when unread.
+    u32 front;  // audio thread only.
+} SynthUiExchange;
+
+internal f32
+FrequencyFromSemitone(f32 semitone)
+{
+    return DSPRatioFromSemitones(semitone) * BASE_NOTE_FREQ;
+}
+
+internal f32
+SemitoneFromFrequency(f32 freq)
+{
+    return DSPSemitonesFromRatio(freq / BASE_NOTE_FREQ);
+}
+
+internal Oscillator*
+NextOscillator(OscillatorArray* osc_array)
+{
+    Assert(osc_array->count < MAX_OSCILLATORS);
+    return osc_array->osc + (osc_array->count++);
+}
+
+internal void
+ClearOscillatorArray(OscillatorArray* osc_array)
+{
+    osc_array->count = 0;
+}
+
+internal void
+UpdatePhase(f32 *phase_ratio, f32 *phase_dt, f32 freq, f32 freq_mod)
+{
+    *phase_dt = ((freq + freq_mod) * SAMPLE_DURATION);
+    DSPAdvancePhase(phase_ratio, *phase_dt);
+}
+
+internal void
+UpdatePhaseInOsc(Oscillator *osc)
+{
+    osc->phase_dt = ((osc->freq) * SAMPLE_DURATION);
+    DSPAdvancePhase(&osc->phase_ratio, osc->phase_dt);
+}
+
+internal void
+ZeroSignal(f32* signal, usize sample_count)
+{
+    for(usize t = 0; t < sample_count; t++)
+    {
+        signal[t] = 0.0f;
+    }
+}
+
+// The shapes are in dsp/dsp_oscillator.h. A fixed-point build (DSP_FIXED, see
+// dsp/dsp_fixed.h) runs dsp_fixed's instead, on the phase converted to an
+// integer one, and rounds them to its format; the engine's phase and mix stay
+// float either way.
+#if DSP_FIXED
+#define FixedPhase(cycles) DSPFixedPhaseFromCycles(cycles)
+#define FixedShape(sample) DSPF32FromFixed(DSPFixedFromQ31(sample))
+#endif
+
+// @shapefn
+internal f32
+SineShape(const f32 phase_ratio, const f32 phase_dt, const f32 shape_param)
+{
+#if DSP_FIXED
+    return FixedShape(DSPFixedSineWave(FixedPhase(phase_ratio)));
+#else
+    return DSPSineWave(phase_ratio);
+#endif
+}
+
+// @shapefn
+internal f32
+SawtoothShape(const f32 phase_ratio, const f32 phase_dt, const f32 shape_param)
+{
+#if DSP_FIXED
+    return FixedShape(DSPFixedSawWave(FixedPhase(phase_ratio), FixedPhase(phase_dt)));
+#else
+    return DSPSawWave(phase_ratio, phase_dt);
+#endif
+}
+
+// @shapefn
+internal f32
+TriangleShape(const f32 phase_ratio, const f32 phase_dt, const f32 shape_param)
+{
+    // TODO: Make this band-limited.
+#if DSP_FIXED
+    return FixedShape(DSPFixedTriangleWave(FixedPhase(phase_ratio)));
+#else
+    return DSPTriangleWave(phase_ratio);
+#endif
+}
+
+// @shapefn
+internal f32
+SquareShape(const f32 phase_ratio, const f32 phase_dt, const f32 shape_param)
+{
+#if DSP_FIXED
+    u32 duty = (shape_param < 1.0f) ? FixedPhase(shape_param) : 0xFFFFFFFFu;
+    return FixedShape(DSPFixedSquareWave(FixedPhase(phase_ratio), FixedPhase(phase_dt), duty));
+#else
+    return DSPSquareWave(phase_ratio, phase_dt, shape_param);
+#endif
+}
+
+// @shapefn
+internal f32
+RoundedSquareShape(const f32 phase_ratio, const f32 phase_dt, const f32 shape_param)
+{
+#if DSP_FIXED
+    q31 drive = DSPFixedRoundedSquareDrive(DSPQ31FromF32(shape_param));
+    return FixedShape(DSPFixedRoundedSquareWave(FixedPhase(phase_ratio), drive));
+#else
+    return DSPRoundedSquareWave(phase_ratio, shape_param);
+#endif
+}
+
+#include "note_cache.h"
+
+internal void
+UpdateOscArray(OscillatorArray *osc_array, WaveShape shape, ModulationPairArray *mod_array,
+               NoteCache *note_cache, usize sample_count)
+{
+    for (i32 i = 0; i < osc_array->count; i++)
+    {
+        Oscillator *osc = &(osc_array->osc[i]);
+        if (osc->freq > (SAMPLE_RATE/2) || osc->freq < -(SAMPLE_RATE/2)) continue;
+
+        ModulationPair *modulation = 0;
+        for(usize mod_i = 0;
+            mod_i < mod_array->count;
+            mod_i++)
+        {
+            if (mod_array->data[mod_i].carrier == osc)
+            {
+                modulation = &mod_array->data[mod_i];
+                break;
+            }
+        }
+
+        if (note_cache && !modulation &&
+            NoteCacheRenderOsc(note_cache, osc, shape, osc_array->wave_shape_fn, sample_count))
+        {
+            continue;
+        }
+
+        for(usize t = 0; t < sample_count; t++)
+        {
+            f32 freq_mod = 0.0f;
+            if (modulation)
+            {
+                freq_mod = modulation->modulator->buffer[t] * modulation->modulation_ratio;
+            }
+
+            UpdatePhase(&osc->phase_ratio,
+                        &osc->phase_dt,
+                        osc->freq,
+                        freq_mod);
+
+            f32 sample = osc_array->wave_shape_fn(osc->phase_ratio,
+                                                  osc->phase_dt,
+                                                  osc->shape_parameter_0);
+            sample *= osc->amplitude_ratio;
+            osc->buffer[t] = sample;
+        }
+    }
+}
+
+internal void
+AccumulateOscillatorsIntoSignal(Synth *synth, usize sample_count)
+{
+    for (usize i = 0;
+         i < synth->oscillator_groups_count;
+         i++)
+    {
+        OscillatorArray *osc_array = &synth->oscillator_groups[i];
+        for (usize osc_i = 0;
+             osc_i < osc_array->count;
+             osc_i++)
+        {
+            Oscillator *osc = &(osc_array->osc[osc_i]);
+
+            if (osc->is_modulator) continue;
+
+            for (usize t = 0;
+                 t < sample_count;
+                 t++)
+            {
+                synth->signal[t] += osc->buffer[t];
+            }
+        }
+    }
+}
+
+// Renders the first sample_count samples of synth->signal from the current
+// oscillator state. sample_count must not exceed STREAM_BUFFER_SIZE.
+internal void
+SynthRenderBlock(Synth *synth, usize sample_count)
+{
+    Assert(sample_count <= STREAM_BUFFER_SIZE);
+    RtScopeBegin();
+    ZeroSignal(synth->signal, sample_count);
+    if (synth->note_cache) NoteCacheBeginBlock(synth->note_cache);
+    for (usize i = 0;
+         i < synth->oscillator_groups_count;
+         i++)
+    {
+        OscillatorArray *osc_array = &synth->oscillator_groups[i];
+        UpdateOscArray(osc_array, (WaveShape)(i + 1), &synth->modulation_pairs,
+                       synth->note_cache, sample_count);
+    }
+
+    AccumulateOscillatorsIntoSignal(synth, sample_count);
+    RtScopeEnd();
+}
+
+internal void
+ApplyUiState(Synth *synth, MidiKeyArray *keys)
+{
+    // Reset synth
+    // TODO(luke): make this something we can iterate.
+    for (usize i = 0;
+         i < synth->oscillator_groups_count;
+         i++)
+    {
+        ClearOscillatorArray(&synth->oscillator_groups[i]);
+    }
+    synth->modulation_pairs.count = 0;
+    if (synth->note_cache)
+    {
+        NoteCacheSyncUi(synth->note_cache, synth->ui_oscillator, synth->ui_oscillator_count);
+    }
+
+    for (i32 ui_osc_i = 0;
+         ui_osc_i < synth->ui_oscillator_count;
+         ui_osc_i++)
+    {
+        UiOscillator ui_osc = synth->ui_oscillator[ui_osc_i];
+
+        for(i32 note_idx = keys->count-1;
+            note_idx >= 0;
+            note_idx--)
+        {
+            MidiKey midi_key = keys->data[note_idx];
+            if (!midi_key.is_on) continue;
+
+            Oscillator *osc = NULL;
+            if (ui_osc.shape > 0 && ui_osc.shape < WaveShape_COUNT)
+            {
+                osc = NextOscillator(&synth->oscillator_groups[ui_osc.shape-1]);
+            }
+
+            if (osc != NULL)
+            {
+                osc->ui_id = ui_osc_i;
+                f32 ui_semitone = SemitoneFromFrequency(ui_osc.freq);
+                f32 midi_semitone = (f32)(midi_key.note - BASE_MIDI_NOTE);
+                f32 osc_freq = FrequencyFromSemitone(ui_semitone + midi_semitone);
+                osc->freq = osc_freq;
+                osc->amplitude_ratio = ui_osc.amplitude_ratio;
+                osc->shape_parameter_0 = ui_osc.shape_parameter_0;
+                osc->is_modulator = false;
+
+                if (ui_osc.modulation_state > 0 && (ui_osc.modulation_state-1) < synth->ui_oscillator_count)
+                {
+                    ModulationPair *mod_pair = synth->modulation_pairs.data + synth->modulation_pairs.count++;
+                    mod_pair->modulator = 0;
+                    mod_pair->carrier = osc;
+                    mod_pair->modulation_id = ui_osc.modulation_state - 1;
+                    mod_pair->modulation_ratio = 100.0f;
+                }
+            }
+        }
+    }
+
+    for(usize mod_i = 0;
+        mod_i < synth->modulation_pairs.count;
+        mod_i++)
+    {
+        ModulationPair *mod_pair = &synth->modulation_pairs.data[mod_i];
+        u16 shape_id = (u16)synth->ui_oscillator[mod_pair->modulation_id].shape;
+        OscillatorArray *osc_array = &synth->oscillator_groups[shape_id-1];
+        // TODO(luke): modulators (LFOs) should not be per-note.
+        for (usize osc_i = 0;
+             osc_i < osc_array->count;
+             osc_i++)
+        {
+            Oscillator *osc = &osc_array->osc[osc_i];
+            if (osc->ui_id == mod_pair->modulation_id)
+            {
+                if (mod_pair->modulator == 0)
+                    mod_pair->modulator = osc;
+                osc->is_modulator = true;
+            }
+        }
+    }
+}
+
+internal void
+SynthInit(Synth *synth, f32 *signal, usize signal_count)
+{
+    memset(synth, 0, sizeof(Synth));
+    synth->oscillator_groups_count = ArrayCount(synth->oscillator_groups);
+    synth->signal = signal;
+    synth->signal_count = signal_count;
+#if DSP_FIXED
+    DSPFixedInit();
+#endif
+
+    synth->oscillator_groups[WaveShape_SINE-1].wave_shape_fn = SineShape;
+    synth->oscillator_groups[WaveShape_SAWTOOTH-1].wave_shape_fn = SawtoothShape;
+    synth->oscillator_groups[WaveShape_TRIANGLE-1].wave_shape_fn = TriangleShape;
+    synth->oscillator_groups[WaveShape_SQUARE-1].wave_shape_fn = SquareShape;
+    synth->oscillator_groups[WaveShape_ROUNDEDSQUARE-1].wave_shape_fn = RoundedSquareShape;
+}
+
+internal void
+SynthUiExchangeInit(SynthUiExchange *exchange)
+{
+    memset(exchange, 0, sizeof(SynthUiExchange));
+    exchange->back = 0;
+    exchange->middle = 1;
+    exchange->front = 2;
+}
+
+// UI thread.
+internal void
+SynthUiExchangePublish(SynthUiExchange *exchange, Synth *synth)
+{
+    UiOscillatorSet *set = &exchange->slots[exchange->back];
+    memcpy(set->data, synth->ui_oscillator, sizeof(set->data));
+    set->count = synth->ui_oscillator_count;
+    exchange->back = AtomicExchangeU32(&exchange->middle, exchange->back | UI_EXCHANGE_NEW) & ~UI_EXCHANGE_NEW;
+}
+
+// Audio thread. Copies the newest published ui oscillators into synth, if
+// there are any it hasn't seen.
+internal void
+SynthUiExchangeConsume(SynthUiExchange *exchange, Synth *synth)
+{
+    if (!(AtomicLoadU32(&exchange->middle) & UI_EXCHANGE_NEW)) return;
+    exchange->front = AtomicExchangeU32(&exchange->middle, exchange->front) & ~UI_EXCHANGE_NEW;
+    UiOscillatorSet *set = &exchange->slots[exchange->front];
+    memcpy(synth->ui_oscillator, set->data, sizeof(set->data));
+    synth->ui_oscillator_count = set->count;
+}
+
+#endif //SYNTH_ENGINE_H
@@ -0,0 +1,290 @@
+/* date = October 18th 2026 */
+
+#ifndef SYNTH_PARTS_H
+#define SYNTH_PARTS_H
+
+// Multi-timbral engine.
+//
+// A part is a whole Synth (its own patch and voice pool) that plays the notes
+// of one MIDI channel. Up to MAX_SYNTH_PARTS parts are rendered each block and
+// mixed into one signal. Parts render concurrently: the thread calling
+// SynthPartsRenderBlock claims parts off a shared counter alongside a small
+// pool of worker threads, then waits for the stragglers. With no workers it
+// all runs inline on the calling thread.
+//
+// Every part keeps its own render timings so layered sets can be balanced
+// across channels (SynthPartLoad).
+
+#include "synth_platform.h"
+#include "synth_thread.h"
+#include "midi.h"
+#include "synth_engine.h"
+
+#define MAX_SYNTH_PARTS MIDI_CHANNEL_COUNT
+#define MAX_SYNTH_PART_WORKERS (MAX_SYNTH_PARTS - 1)
+
+// Called on the audio thread with every block of the final mix, e.g. to feed
+// an analyser. It must not block.
+typedef void SynthTapFn(void *user_data, f32 *samples, usize sample_count);
+
+typedef struct SynthPart {
+    Synth synth;
+    f32 signal[STREAM_BUFFER_SIZE];
+    u8 channel;
+    f32 gain;
+
+    // Only used when the ui state comes from another thread.
+    SynthUiExchange ui_exchange;
+
+    // Written by whichever thread rendered the part, read racily by the UI.
+    f64 render_seconds_total;
+    u64 samples_rendered;
+    f32 load; // of the last block, as a fraction of its duration.
+} SynthPart;
+
+typedef struct SynthParts {
+    SynthPart part[MAX_SYNTH_PARTS];
+    u32 part_count;
+
+    f32 *signal;
+    usize signal_count;
+    f32 audio_frame_duration;
+    MidiChannelKeys *keys;
+    bool uses_ui_exchange; // SynthPartsAudioRender consumes each part's exchange.
+    u32 published_part_count;
+    f32 *scope;            // last block, for drawing. Read racily by the UI.
+    usize scope_count;
+    u32 scope_serial;      // bumped after each scope copy.
+    SynthTapFn *tap;       // optional, gets every block.
+    void *tap_user_data;
+
+    // Worker pool. block_sample_count is set before next_part is reset, so a
+    // worker that wakes late still renders the current block correctly.
+    SynthThread workers[MAX_SYNTH_PART_WORKERS];
+    u32 worker_count;
+    bool workers_realtime;
+    SynthSemaphore work_ready;
+    u32 is_running;
+    u32 block_sample_count;
+    u32 next_part;
+    u32 parts_done;
+} SynthParts;
+
+// Part i starts on MIDI channel i with an empty patch.
+internal void
+SynthPartsInit(SynthParts *parts, f32 *signal, usize signal_count, MidiChannelKeys *keys)
+{
+    memset(parts, 0, sizeof(SynthParts));
+    parts->signal = signal;
+    parts->signal_count = signal_count;
+    parts->keys = keys;
+    parts->part_count = 1;
+    parts->published_part_count = 1;
+    for (u32 part_i = 0; part_i < MAX_SYNTH_PARTS; part_i++)
+    {
+        SynthPart *part = &parts->part[part_i];
+        SynthInit(&part->synth, part->signal, ArrayCount(part->signal));
+        SynthUiExchangeInit(&part->ui_exchange);
+        part->channel = (u8)part_i;
+        part->gain = 1.f;
+    }
+}
+
+internal void
+SynthPartRender(SynthPart *part, usize sample_count)
+{
+    const f64 start_time = SynthTimeSeconds();
+    SynthRenderBlock(&part->synth, sample_count);
+    const f64 render_seconds = SynthTimeSeconds() - start_time;
+    part->render_seconds_total += render_seconds;
+    part->samples_rendered += sample_count;
+    part->load = (f32)(render_seconds / (sample_count * SAMPLE_DURATION));
+}
+
+// Renders parts until there are none left to claim in the current block.
+internal void
+SynthPartsRenderClaimed(SynthParts *parts)
+{
+    for (;;)
+    {
+        u32 part_i = AtomicAddU32(&parts->next_part, 1) - 1;
+        if (part_i >= parts->part_count) break;
+        SynthPartRender(&parts->part[part_i], AtomicLoadU32(&parts->block_sample_count));
+        AtomicAddU32(&parts->parts_done, 1);
+    }
+}
+
+internal void
+SynthPartsWorker(void *user_data)
+{
+    SynthParts *parts = (SynthParts *)user_data;
+    if (parts->workers_realtime)
+    {
+        // Same priority as the audio thread, which spins waiting on us.
+        SynthThreadSetRealtime(70);
+    }
+    for (;;)
+    {
+        SynthSemaphoreWait(&parts->work_ready);
+        if (!AtomicLoadU32(&parts->is_running)) break;
+        SynthPartsRenderClaimed(parts);
+    }
+}
+
+// Spare cores minus the one the audio thread runs on.
+internal u32
+SynthPartsDefaultWorkerCount(void)
+{
+    u32 cpu_count = SynthCpuCount();
+    u32 worker_count = (cpu_count > 1) ? cpu_count - 1 : 0;
+    return (worker_count > MAX_SYNTH_PART_WORKERS) ? MAX_SYNTH_PART_WORKERS : worker_count;
+}
+
+// realtime should match the thread that calls SynthPartsRenderBlock.
+internal void
+SynthPartsStartWorkers(SynthParts *parts, u32 worker_count, bool realtime)
+{
+    if (worker_count > MAX_SYNTH_PART_WORKERS) worker_count = MAX_SYNTH_PART_WORKERS;
+    SynthSemaphoreInit(&parts->work_ready);
+    parts->workers_realtime = realtime;
+    parts->next_part = MAX_SYNTH_PARTS; // nothing to claim until the first block.
+    AtomicStoreU32(&parts->is_running, 1);
+    for (u32 worker_i = 0; worker_i < worker_count; worker_i++)
+    {
+        if (!SynthThreadStart(&parts->workers[worker_i], SynthPartsWorker, parts)) break;
+        parts->worker_count += 1;
+    }
+}
+
+internal void
+SynthPartsStopWorkers(SynthParts *parts)
+{
+    if (!AtomicLoadU32(&parts->is_running)) return;
+    AtomicStoreU32(&parts->is_running, 0);
+    SynthSemaphorePost(&parts->work_ready, parts->worker_count);
+    for (u32 worker_i = 0; worker_i < parts->worker_count; worker_i++)
+    {
+        SynthThreadJoin(&parts->workers[worker_i]);
+    }
+    SynthSemaphoreDestroy(&parts->work_ready);
+    parts->worker_count = 0;
+}
+
+// Renders every part and mixes them into the first sample_count samples of
+// parts->signal. sample_count must not exceed STREAM_BUFFER_SIZE.
+internal void
+SynthPartsRenderBlock(SynthParts *parts, usize sample_count)
+{
+    Assert(sample_count <= STREAM_BUFFER_SIZE);
+    if (parts->worker_count > 0 && parts->part_count > 1)
+    {
+        AtomicStoreU32(&parts->block_sample_count, (u32)sample_count);
+        AtomicStoreU32(&parts->parts_done, 0);
+        AtomicStoreU32(&parts->next_part, 0);
+        u32 wake_count = parts->part_count - 1;
+        if (wake_count > parts->worker_count) wake_count = parts->worker_count;
+        SynthSemaphorePost(&parts->work_ready, wake_count);
+
+        // The parts still outstanding are being rendered right now by
+        // running workers, so spin rather than give the core away.
+        SynthPartsRenderClaimed(parts);
+        while (AtomicLoadU32(&parts->parts_done) < parts->part_count)
+        {
+            SynthThreadPause();
+        }
+    }
+    else
+    {
+        for (u32 part_i = 0; part_i < parts->part_count; part_i++)
+        {
+            SynthPartRender(&parts->part[part_i], sample_count);
+        }
+    }
+
+    RtScopeBegin();
+    ZeroSignal(parts->signal, sample_count);
+    for (u32 part_i = 0; part_i < parts->part_count; part_i++)
+    {
+        SynthPart *part = &parts->part[part_i];
+        for (usize t = 0; t < sample_count; t++)
+        {
+            parts->signal[t] += part->signal[t] * part->gain;
+        }
+    }
+    RtScopeEnd();
+}
+
+// Rebuilds every part's voices from its patch and its channel's keys.
+internal void
+SynthPartsApplyUiState(SynthParts *parts)
+{
+    for (u32 part_i = 0; part_i < parts->part_count; part_i++)
+    {
+        SynthPart *part = &parts->part[part_i];
+        ApplyUiState(&part->synth, &parts->keys->channel[part->channel]);
+    }
+}
+
+// UI thread. Hands the patches edited in ui_parts to the parts the audio
+// thread renders.
+internal void
+SynthPartsPublishUi(SynthParts *audio_parts, SynthParts *ui_parts)
+{
+    for (u32 part_i = 0; part_i < MAX_SYNTH_PARTS; part_i++)
+    {
+        SynthUiExchangePublish(&audio_parts->part[part_i].ui_exchange, &ui_parts->part[part_i].synth);
+        audio_parts->part[part_i].channel = ui_parts->part[part_i].channel;
+        audio_parts->part[part_i].gain = ui_parts->part[part_i].gain;
+    }
+    AtomicStoreU32(&audio_parts->published_part_count, ui_parts->part_count);
+}
+
+// Fraction of real time the part has spent rendering so far.
+internal f32
+SynthPartLoad(SynthPart *part)
+{
+    if (part->samples_rendered == 0) return 0.f;
+    return (f32)(part->render_seconds_total / (part->samples_rendered * (f64)SAMPLE_DURATION));
+}
+
+// @audiothread
+// AudioRenderFn for audio_output.h: picks up ui and MIDI state once per
+// period, then renders it in blocks of at most STREAM_BUFFER_SIZE.
+internal void
+SynthPartsAudioRender(void *user_data, f32 *samples, u32 sample_count)
+{
+    SynthParts *parts = (SynthParts *)user_data;
+    RtScopeBegin();
+    if (parts->uses_ui_exchange)
+    {
+        parts->part_count = AtomicLoadU32(&parts->published_part_count);
+        for (u32 part_i = 0; part_i < parts->part_count; part_i++)
+        {
+            SynthPart *part = &parts->part[part_i];
+            SynthUiExchangeConsume(&part->ui_exchange, &part->synth);
+        }
+    }
+    SynthPartsApplyUiState(parts);
+
+    const f64 start_time = SynthTimeSeconds();
+    usize block_count = 0;
+    for (u32 offset = 0; offset < sample_count; offset += block_count)
+    {
+        block_count = sample_count - offset;
+        if (block_count > STREAM_BUFFER_SIZE) block_count = STREAM_BUFFER_SIZE;
+        SynthPartsRenderBlock(parts, block_count);
+        memcpy(samples + offset, parts->signal, block_count * sizeof(f32));
+        if (parts->tap) parts->tap(parts->tap_user_data, parts->signal, block_count);
+    }
+    parts->audio_frame_duration = (f32)((SynthTimeSeconds() - start_time) * STREAM_BUFFER_SIZE / sample_count);
+
+    if (parts->scope)
+    {
+        usize scope_count = (block_count < parts->scope_count) ? block_count : parts->scope_count;
+        memcpy(parts->scope, parts->signal, scope_count * sizeof(f32));
+        AtomicAddU32(&parts->scope_serial, 1);
+    }
+    RtScopeEnd();
+}
+
+#endif //SYNTH_PARTS_H
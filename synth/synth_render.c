@@ -0,0 +1,317 @@
+// Plays a patch through the audio output layer (audio_output.h) without a
+// window. With the file backend and --freewheel it's an offline renderer;
+// with the null backend it benchmarks the render path exactly as the audio
+// thread runs it.
+//
+// --parts N layers N parts (synth_parts.h) on MIDI channels 1..N, each
+// playing the same chord with the next wave shape along, and reports the
+// CPU each part used.
+//
+// --tap FILE writes the mix as it's rendered to FILE as raw native-endian
+// 32-bit floats, whatever the backend. With "-" it goes to stdout (and the
+// report to stderr), so it can be piped into an analyser, e.g.
+//   synth_render --freewheel --tap - | stft_stream --raw -
+//
+// --compare FILE checks the mix, as it's rendered, against a recording made
+// earlier (any WAV or RF64 file at the same rate, read through the mapped
+// reader in wav_reader.h) and fails if they differ, which catches changes
+// to the sound of a patch.
+//
+// Usage: synth_render [--backend null|file|alsa] [--device NAME] [--out FILE]
+//                     [--period 256] [--periods 2] [--rt] [--cpu N]
+//                     [--freewheel] [--seconds 5] [--shape 1-5]
+//                     [--shape-param 0.5] [--notes 4] [--modulate 1-5]
+//                     [--note-cache] [--parts 1-16] [--workers N]
+//                     [--tap FILE] [--compare FILE]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
+#include "midi.h"
+#include "synth_engine.h"
+#include "synth_parts.h"
+#include "audio_output.h"
+#include "wav_reader.h"
+
+#define COMPARE_TOLERANCE 1e-5f
+
+internal AudioBackend
+ParseBackend(const char *name)
+{
+    if (strcmp(name, "file") == 0) return AudioBackend_FILE;
+    if (strcmp(name, "alsa") == 0) return AudioBackend_ALSA;
+    if (strcmp(name, "null") == 0) return AudioBackend_NULL;
+    return AudioBackend_COUNT;
+}
+
+// A reference recording and how far the mix has got through it.
+typedef struct ReferenceCheck {
+    wav_reader reader;
+    f32 *converted;           // STREAM_BUFFER_SIZE samples.
+    u64 position;
+    u64 missing;              // samples rendered past the reference's end.
+    f32 max_difference;
+} ReferenceCheck;
+
+typedef struct TapTargets {
+    FILE *file;
+    ReferenceCheck *reference;
+} TapTargets;
+
+internal void
+CompareWithReference(ReferenceCheck *check, f32 *samples, usize sample_count)
+{
+    // A mono float reference is compared in place; anything else is converted
+    // a block at a time.
+    f32 *view = WavViewF32(&check->reader);
+    bool in_place = (view && check->reader.Channels == 1);
+    while (sample_count > 0)
+    {
+        u32 chunk = (sample_count < STREAM_BUFFER_SIZE) ? (u32)sample_count : STREAM_BUFFER_SIZE;
+        const f32 *reference = 0;
+        u32 available = 0;
+        if (in_place)
+        {
+            u64 left = (check->position < check->reader.FrameCount) ? check->reader.FrameCount - check->position : 0;
+            available = (left < chunk) ? (u32)left : chunk;
+            reference = view + check->position;
+        }
+        else
+        {
+            available = WavConvert(&check->reader, check->position, chunk, check->converted);
+            reference = check->converted;
+        }
+        for (u32 i = 0; i < available; i++)
+        {
+            f32 difference = fabsf(samples[i] - reference[i]);
+            if (difference > check->max_difference) check->max_difference = difference;
+        }
+        check->missing += chunk - available;
+        check->position += chunk;
+        samples += chunk;
+        sample_count -= chunk;
+    }
+}
+
+// SynthTapFn: user_data is the TapTargets.
+internal void
+Tap(void *user_data, f32 *samples, usize sample_count)
+{
+    TapTargets *targets = (TapTargets *)user_data;
+    if (targets->file) fwrite(samples, sizeof(f32), sample_count, targets->file);
+    if (targets->reference) CompareWithReference(targets->reference, samples, sample_count);
+}
+
+i32
+main(i32 argc, char **argv)
+{
+    AudioOutputConfig config = AudioOutputDefaultConfig();
+    config.sample_rate = SAMPLE_RATE;
+    f64 seconds = 5.0;
+    WaveShape shape = WaveShape_SAWTOOTH;
+    f32 shape_param = 0.5f;
+    u32 note_count = 4;
+    WaveShape modulator_shape = WaveShape_NONE;
+    bool use_note_cache = false;
+    u32 part_count = 1;
+    u32 worker_count = SynthPartsDefaultWorkerCount();
+    const char *tap_path = 0;
+    const char *compare_path = 0;
+
+    for (i32 arg_i = 1; arg_i < argc; arg_i++)
+    {
+        const char *arg = argv[arg_i];
+        const char *value = (arg_i + 1 < argc) ? argv[arg_i + 1] : "";
+        if (strcmp(arg, "--backend") == 0) { config.backend = ParseBackend(value); arg_i++; }
+        else if (strcmp(arg, "--device") == 0) { config.device_name = value; arg_i++; }
+        else if (strcmp(arg, "--out") == 0) { config.file_path = value; arg_i++; }
+        else if (strcmp(arg, "--period") == 0) { config.period_size = (u32)atoi(value); arg_i++; }
+        else if (strcmp(arg, "--periods") == 0) { config.period_count = (u32)atoi(value); arg_i++; }
+        else if (strcmp(arg, "--rt") == 0) { config.realtime = true; }
+        else if (strcmp(arg, "--cpu") == 0) { config.cpu = atoi(value); arg_i++; }
+        else if (strcmp(arg, "--freewheel") == 0) { config.freewheel = true; }
+        else if (strcmp(arg, "--seconds") == 0) { seconds = atof(value); arg_i++; }
+        else if (strcmp(arg, "--shape") == 0) { shape = (WaveShape)atoi(value); arg_i++; }
+        else if (strcmp(arg, "--shape-param") == 0) { shape_param = (f32)atof(value); arg_i++; }
+        else if (strcmp(arg, "--notes") == 0) { note_count = (u32)atoi(value); arg_i++; }
+        else if (strcmp(arg, "--modulate") == 0) { modulator_shape = (WaveShape)atoi(value); arg_i++; }
+        else if (strcmp(arg, "--note-cache") == 0) { use_note_cache = true; }
+        else if (strcmp(arg, "--parts") == 0) { part_count = (u32)atoi(value); arg_i++; }
+        else if (strcmp(arg, "--workers") == 0) { worker_count = (u32)atoi(value); arg_i++; }
+        else if (strcmp(arg, "--tap") == 0) { tap_path = value; arg_i++; }
+        else if (strcmp(arg, "--compare") == 0) { compare_path = value; arg_i++; }
+        else
+        {
+            printf("Unknown argument: %s\n", arg);
+            return 2;
+        }
+    }
+    if (config.backend == AudioBackend_COUNT)
+    {
+        printf("Backend must be one of: %s\n", AUDIO_BACKEND_OPTIONS);
+        return 2;
+    }
+    if (shape <= WaveShape_NONE || shape >= WaveShape_COUNT || modulator_shape >= WaveShape_COUNT)
+    {
+        printf("Shapes are 1-%d: %s\n", WaveShape_COUNT - 1, WAVE_SHAPE_OPTIONS);
+        return 2;
+    }
+    if (config.period_size == 0 || config.period_count == 0)
+    {
+        printf("Period size and count must be at least 1.\n");
+        return 2;
+    }
+    if (part_count == 0 || part_count > MAX_SYNTH_PARTS)
+    {
+        printf("Parts must be 1-%d.\n", MAX_SYNTH_PARTS);
+        return 2;
+    }
+
+    f32 *signal = (f32 *)calloc(STREAM_BUFFER_SIZE, sizeof(f32));
+    MidiChannelKeys keys;
+    SynthMidiChannelKeysInit(&keys);
+    SynthParts *parts = (SynthParts *)malloc(sizeof(SynthParts));
+    SynthPartsInit(parts, signal, STREAM_BUFFER_SIZE, &keys);
+    parts->part_count = part_count;
+    for (u32 part_i = 0; part_i < part_count; part_i++)
+    {
+        Synth *synth = &parts->part[part_i].synth;
+        if (use_note_cache)
+        {
+            synth->note_cache = NoteCacheCreate(NOTE_CACHE_DEFAULT_BUDGET);
+        }
+        UiOscillator *carrier = &synth->ui_oscillator[synth->ui_oscillator_count++];
+        carrier->shape = (WaveShape)(((shape - 1 + part_i) % (WaveShape_COUNT - 1)) + 1);
+        carrier->freq = BASE_NOTE_FREQ;
+        carrier->amplitude_ratio = 0.1f / part_count;
+        carrier->shape_parameter_0 = shape_param;
+        if (modulator_shape != WaveShape_NONE)
+        {
+            UiOscillator *modulator = &synth->ui_oscillator[synth->ui_oscillator_count++];
+            modulator->shape = modulator_shape;
+            modulator->freq = 5.f;
+            modulator->amplitude_ratio = 1.f;
+            modulator->shape_parameter_0 = shape_param;
+            carrier->modulation_state = 2;
+        }
+
+        const u8 channel = parts->part[part_i].channel;
+        for (u32 i = 0; i < note_count && i < POLYPHONIC_COUNT; i++)
+        {
+            SynthMidiRouteMessage(&keys, SynthMidiPackMessage(KEY_ON | channel, (u8)(BASE_MIDI_NOTE - 12 + i * 4), 100));
+        }
+    }
+    SynthPartsStartWorkers(parts, worker_count, config.realtime);
+
+    FILE *report = stdout;
+    FILE *tap_file = 0;
+    ReferenceCheck *reference = 0;
+    if (compare_path)
+    {
+        reference = (ReferenceCheck *)calloc(1, sizeof(ReferenceCheck));
+        if (!WavOpen(&reference->reader, compare_path))
+        {
+            printf("%s: %s\n", compare_path, reference->reader.Error);
+            return 1;
+        }
+        if (reference->reader.SampleRate != config.sample_rate)
+        {
+            printf("%s is %u Hz, the synth renders at %u Hz\n", compare_path, reference->reader.SampleRate,
+                   config.sample_rate);
+            return 1;
+        }
+        reference->converted = (f32 *)malloc(STREAM_BUFFER_SIZE * sizeof(f32));
+    }
+    if (tap_path)
+    {
+        if (strcmp(tap_path, "-") == 0)
+        {
+#ifdef _WIN32
+            _setmode(_fileno(stdout), _O_BINARY);
+#endif
+            tap_file = stdout;
+            report = stderr;
+        }
+        else
+        {
+            tap_file = fopen(tap_path, "wb");
+            if (!tap_file)
+            {
+                printf("Can't open %s\n", tap_path);
+                return 1;
+            }
+        }
+    }
+    TapTargets tap_targets = {tap_file, reference};
+    if (tap_file || reference)
+    {
+        parts->tap = Tap;
+        parts->tap_user_data = &tap_targets;
+    }
+
+    // Ask for a whole number of periods covering the requested length.
+    config.max_periods = (u64)((seconds * config.sample_rate) / config.period_size) + 1;
+
+    AudioOutput output;
+    const f64 start_time = SynthTimeSeconds();
+    if (!AudioOutputStart(&output, &config, SynthPartsAudioRender, parts)) return 1;
+    AudioOutputWait(&output);
+    AudioOutputStop(&output);
+    const f64 wall_seconds = SynthTimeSeconds() - start_time;
+
+    const f64 audio_seconds = (f64)output.periods_rendered * output.config.period_size / output.config.sample_rate;
+    const f64 period_seconds = (f64)output.config.period_size / output.config.sample_rate;
+    const f64 mean_render = output.render_seconds_total / output.periods_rendered;
+    fprintf(report, "backend %s, %u Hz, period %u x %u, realtime %s, cpu %s\n",
+                    (config.backend == AudioBackend_ALSA) ? "alsa" : (config.backend == AudioBackend_FILE) ? "file" : "null",
+                    output.config.sample_rate, output.config.period_size, output.config.period_count,
+                    config.realtime ? (output.got_realtime ? "yes" : "refused") : "no",
+                    (config.cpu >= 0) ? (output.got_cpu ? "pinned" : "refused") : "any");
+    fprintf(report, "rendered %.2fs of audio in %.2fs (%u periods, %u xruns)\n",
+                    audio_seconds, wall_seconds, output.periods_rendered, output.xruns);
+    fprintf(report, "render per period: mean %.1fus (%.2f%% of budget), max %.1fus (%.2f%%), %.1fx real time\n",
+                    mean_render * 1e6, 100.0 * mean_render / period_seconds,
+                    output.render_seconds_max * 1e6, 100.0 * output.render_seconds_max / period_seconds,
+                    output.render_seconds_total > 0.0 ? audio_seconds / output.render_seconds_total : 0.0);
+    if (part_count > 1)
+    {
+        fprintf(report, "%u parts on %u worker threads + the audio thread:\n", part_count, parts->worker_count);
+        for (u32 part_i = 0; part_i < part_count; part_i++)
+        {
+            SynthPart *part = &parts->part[part_i];
+            fprintf(report, "  part %2u  channel %2u  shape %u  cpu %.2f%%\n", part_i + 1, part->channel + 1,
+                            part->synth.ui_oscillator[0].shape, 100.f * SynthPartLoad(part));
+        }
+    }
+
+    i32 exit_code = 0;
+    if (reference)
+    {
+        u64 reference_length = reference->reader.FrameCount;
+        bool same_length = (reference->missing == 0 && reference->position == reference_length);
+        bool passed = same_length && reference->max_difference <= COMPARE_TOLERANCE;
+        fprintf(report, "compared with %s (%s x %u): max difference %.2e, %llu samples rendered, %llu in the reference: %s\n",
+                        compare_path, WavSampleTypeName(reference->reader.Type), reference->reader.Channels,
+                        reference->max_difference, (unsigned long long)reference->position,
+                        (unsigned long long)reference_length, passed ? "same" : "DIFFERENT");
+        exit_code = passed ? 0 : 1;
+        WavClose(&reference->reader);
+        free(reference->converted);
+        free(reference);
+    }
+
+    SynthPartsStopWorkers(parts);
+    if (tap_file && tap_file != stdout) fclose(tap_file);
+    if (tap_file == stdout) fflush(stdout);
+    for (u32 part_i = 0; part_i < part_count; part_i++)
+    {
+        NoteCacheDestroy(parts->part[part_i].synth.note_cache);
+    }
+    free(parts);
+    free(signal);
+    return exit_code;
+}